@@ -11,7 +11,8 @@ from ._library import Jet as _Jet_C
 from . import version
 from .version import module as __version__
 from .version import api as __api_version__
-from .auxiliar import load_jets, save_jets
+from .auxiliar import load_jets, save_jets, engine_report
+from . import pickling
 
 def get_config():
   """Returns a string containing the configuration information.
@@ -26,13 +27,13 @@ __all__ = [_ for _ in dir() if not _.startswith('_')]
 class Jet(_Jet_C):
     __doc__ = _Jet_C.__doc__
 
-    def __getstate__(self):
-        d = dict(self.__dict__)
-        d["jet"] = self.jet
-        d["length"] = self.length
-        return d
-
+    # Gabor jets are pickled by bob.ip.gabor.pickling;
+    # this is only used to load Gabor jets that were pickled with older versions
     def __setstate__(self, d):
         self.__dict__ = d
-        self.__init__(d["length"])
-        self.jet = d["jet"]        
+        self.__init__(d.pop("length"))
+        self.jet = d.pop("jet")
+
+
+pickling.register(Jet)
+
@@ -1,4 +1,4 @@
-from ._library import Jet
+from ._library import Jet, Transform
 import bob.io.base
 import numpy
 
@@ -54,3 +54,62 @@ def load_jets(hdf5):
     hdf5.cd("..")
   return jets
 
+
+
+def engine_report(image, transform = None, engines = ('frequency', 'spatial', 'recursive'), repetitions = 3):
+  """engine_report(image, [transform], [engines], [repetitions]) -> report
+
+  Compares the accuracy and the speed of the given engines of the Gabor wavelet transform with the ``'frequency'`` engine, which serves as reference.
+
+  **Parameters**:
+
+    ``image`` : array_like (2D)
+      The image that should be transformed
+
+    ``transform`` : :py:class:`bob.ip.gabor.Transform`
+      The Gabor wavelet transform to test; its :py:attr:`bob.ip.gabor.Transform.engine` is restored afterwards; if not given, the default transform is used
+
+    ``engines`` : [str]
+      The engines to compare, see :py:attr:`bob.ip.gabor.Transform.engine`
+
+    ``repetitions`` : int
+      The number of transforms, over which the time is measured; the fastest transform is reported
+
+  **Returns**:
+
+    ``report`` : [dict]
+      One entry for each engine, containing the ``'engine'``, the fastest time in ``'seconds'``, the ``'speedup'`` with respect to the reference, the largest absolute difference ``'max_error'`` and the ``'relative_error'``, i.e., the RMS difference divided by the RMS of the reference
+  """
+  import timeit
+  if transform is None:
+    transform = Transform()
+  image = numpy.asarray(image)
+  original_engine = transform.engine
+
+  def _run(engine):
+    transform.engine = engine
+    trafo_image = numpy.ndarray((transform.number_of_wavelets,) + image.shape, numpy.complex128)
+    times = []
+    for i in range(repetitions):
+      start = timeit.default_timer()
+      transform.transform(image, trafo_image)
+      times.append(timeit.default_timer() - start)
+    return trafo_image, min(times)
+
+  try:
+    reference, reference_time = _run('frequency')
+    reference_rms = numpy.sqrt(numpy.mean(numpy.abs(reference)**2))
+    report = []
+    for engine in engines:
+      trafo_image, seconds = _run(engine)
+      difference = numpy.abs(trafo_image - reference)
+      report.append({
+        'engine' : engine,
+        'seconds' : seconds,
+        'speedup' : reference_time / seconds if seconds > 0 else float('inf'),
+        'max_error' : numpy.max(difference),
+        'relative_error' : numpy.sqrt(numpy.mean(difference**2)) / reference_rms
+      })
+  finally:
+    transform.engine = original_engine
+  return report
@@ -0,0 +1,98 @@
+/**
+ * @brief Standalone executable that runs the benchmark of bob.ip.gabor and counts the heap allocations
+ *
+ * Compile it against the installed library, e.g.:
+ *   g++ -std=c++11 -O2 bob_ip_gabor_benchmark.cpp -I<bob.ip.gabor>/include -I<bob.*>/include -L<bob.ip.gabor> -lbob_ip_gabor -o bob_ip_gabor_benchmark
+ * and call it as:
+ *   bob_ip_gabor_benchmark [--sizes 128x128,256x256] [--wavelets 5x8,3x4] [--repetitions 20] [--output result.json]
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/Benchmark.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+// Replacing the global operator new in the executable counts all allocations of the library, including the ones of blitz and std containers
+static std::atomic<unsigned long> allocations(0);
+
+void* operator new(std::size_t size){
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size){
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+static unsigned long count_allocations(){
+  return allocations.load(std::memory_order_relaxed);
+}
+
+// parses a comma-separated list of pairs like "128x128,256x256"
+static std::vector<blitz::TinyVector<int,2>> parse_pairs(const char* text){
+  std::vector<blitz::TinyVector<int,2>> pairs;
+  std::string list(text);
+  size_t start = 0;
+  while (start < list.size()){
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) end = list.size();
+    blitz::TinyVector<int,2> pair;
+    if (std::sscanf(list.substr(start, end - start).c_str(), "%dx%d", &pair[0], &pair[1]) != 2)
+      throw std::runtime_error("Cannot parse '" + list.substr(start, end - start) + "'; expected a pair like 128x128");
+    pairs.push_back(pair);
+    start = end + 1;
+  }
+  return pairs;
+}
+
+int main(int argc, char** argv){
+  try {
+    std::vector<blitz::TinyVector<int,2>> sizes = {blitz::TinyVector<int,2>(128, 128), blitz::TinyVector<int,2>(256, 256)};
+    std::vector<blitz::TinyVector<int,2>> wavelets = {blitz::TinyVector<int,2>(5, 8)};
+    int repetitions = 20;
+    const char* output = 0;
+
+    for (int i = 1; i < argc; ++i){
+      if (i + 1 < argc && !std::strcmp(argv[i], "--sizes")) sizes = parse_pairs(argv[++i]);
+      else if (i + 1 < argc && !std::strcmp(argv[i], "--wavelets")) wavelets = parse_pairs(argv[++i]);
+      else if (i + 1 < argc && !std::strcmp(argv[i], "--repetitions")) repetitions = std::atoi(argv[++i]);
+      else if (i + 1 < argc && !std::strcmp(argv[i], "--output")) output = argv[++i];
+      else {
+        std::cerr << "usage: " << argv[0] << " [--sizes HxW,...] [--wavelets SCALESxDIRECTIONS,...] [--repetitions N] [--output FILE]" << std::endl;
+        return 1;
+      }
+    }
+
+    bob::ip::gabor::Benchmark::allocationCounter(count_allocations);
+    bob::ip::gabor::Benchmark benchmark(sizes, wavelets, repetitions);
+    std::string json = bob::ip::gabor::Benchmark::json(benchmark.run());
+
+    if (output){
+      std::ofstream file(output);
+      file << json;
+    } else {
+      std::cout << json;
+    }
+  } catch (std::exception& e){
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
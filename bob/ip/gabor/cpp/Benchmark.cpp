@@ -0,0 +1,296 @@
+/**
+ * @brief C++ implementations of the benchmark of the Gabor wavelet transform, the Gabor jet extraction, the similarities and the jet statistics
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/Benchmark.h>
+#include <bob.ip.gabor/Graph.h>
+#include <bob.ip.gabor/Index.h>
+#include <bob.ip.gabor/JetStatistics.h>
+#include <bob.ip.gabor/PhaseCode.h>
+#include <bob.ip.gabor/Simd.h>
+#include <bob.ip.gabor/Similarity.h>
+#include <bob.ip.gabor/Transform.h>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+// the function that counts the heap allocations; set by executables that replace the global operator new
+static unsigned long (*allocation_counter)() = 0;
+
+void bob::ip::gabor::Benchmark::allocationCounter(unsigned long (*counter)()){
+  allocation_counter = counter;
+}
+
+/**
+ * Creates the benchmark
+ * @param image_sizes  The image resolutions (height, width), for which the transform is timed; the jets are extracted from the first resolution
+ * @param wavelets  The wavelet families (number of scales, number of directions), for which the transform is timed; the jets use the first family
+ * @param repetitions  The number of timed runs of each operation
+ */
+bob::ip::gabor::Benchmark::Benchmark(
+  const std::vector<blitz::TinyVector<int,2>>& image_sizes,
+  const std::vector<blitz::TinyVector<int,2>>& wavelets,
+  int repetitions
+)
+: m_image_sizes(image_sizes),
+  m_wavelets(wavelets),
+  m_repetitions(repetitions)
+{
+  if (image_sizes.empty() || wavelets.empty())
+    throw std::runtime_error("Benchmark: at least one image size and one wavelet family are required");
+  for (auto it = image_sizes.begin(); it != image_sizes.end(); ++it)
+    if ((*it)[0] < 32 || (*it)[1] < 32)
+      throw std::runtime_error((boost::format("Benchmark: the image size (%d, %d) must be at least (32, 32)") % (*it)[0] % (*it)[1]).str());
+  for (auto it = wavelets.begin(); it != wavelets.end(); ++it)
+    if ((*it)[0] <= 0 || (*it)[1] <= 0)
+      throw std::runtime_error((boost::format("Benchmark: the number of scales (%d) and directions (%d) must be positive") % (*it)[0] % (*it)[1]).str());
+  if (repetitions <= 0)
+    throw std::runtime_error((boost::format("Benchmark: the number of repetitions (%d) must be positive") % repetitions).str());
+}
+
+/**
+ * Runs the given function once to warm up (e.g., to generate the wavelets), and times the given number of repetitions
+ */
+template <typename F>
+static bob::ip::gabor::Benchmark::Measurement measure(
+  const std::string& name,
+  const std::string& variant,
+  const std::map<std::string, int>& parameters,
+  int items,
+  int repetitions,
+  F function
+){
+  bob::ip::gabor::Benchmark::Measurement measurement;
+  measurement.name = name;
+  measurement.variant = variant;
+  measurement.parameters = parameters;
+  measurement.items = items;
+  measurement.seconds.resize(repetitions);
+
+  function();
+
+  const unsigned long allocations = allocation_counter ? allocation_counter() : 0;
+  for (int r = 0; r < repetitions; ++r){
+    auto start = std::chrono::steady_clock::now();
+    function();
+    measurement.seconds[r] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  measurement.allocations = allocation_counter ? static_cast<double>(allocation_counter() - allocations) / repetitions : -1.;
+  return measurement;
+}
+
+std::vector<bob::ip::gabor::Benchmark::Measurement> bob::ip::gabor::Benchmark::run() const {
+  std::vector<Measurement> measurements;
+  // the images are filled with reproducible uniform noise
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> pixel(0., 255.);
+
+  // Transform::transform for all image sizes and wavelet families
+  for (auto wit = m_wavelets.begin(); wit != m_wavelets.end(); ++wit){
+    bob::ip::gabor::Transform gwt((*wit)[0], (*wit)[1]);
+    for (auto sit = m_image_sizes.begin(); sit != m_image_sizes.end(); ++sit){
+      blitz::Array<double,2> image((*sit)[0], (*sit)[1]);
+      for (auto it = image.begin(); it != image.end(); ++it) *it = pixel(generator);
+      blitz::Array<std::complex<double>,3> trafo_image(gwt.numberOfWavelets(), (*sit)[0], (*sit)[1]);
+      std::map<std::string, int> parameters = {{"height", (*sit)[0]}, {"width", (*sit)[1]}, {"scales", (*wit)[0]}, {"directions", (*wit)[1]}};
+      measurements.push_back(measure("transform", bob::ip::gabor::Transform::engine_to_name(gwt.engine()), parameters, 1, m_repetitions,
+        [&](){gwt.transform(image, trafo_image);}
+      ));
+    }
+  }
+
+  // all other operations use the Gabor jets of a regular grid graph in the first image size with the first wavelet family
+  const int height = m_image_sizes[0][0], width = m_image_sizes[0][1];
+  boost::shared_ptr<bob::ip::gabor::Transform> gwt(new bob::ip::gabor::Transform(m_wavelets[0][0], m_wavelets[0][1]));
+  blitz::Array<double,2> image(height, width);
+  for (auto it = image.begin(); it != image.end(); ++it) *it = pixel(generator);
+  blitz::Array<std::complex<double>,3> trafo_image(gwt->numberOfWavelets(), height, width);
+  gwt->transform(image, trafo_image);
+  bob::ip::gabor::Graph graph(blitz::TinyVector<int,2>(8, 8), blitz::TinyVector<int,2>(height - 9, width - 9), blitz::TinyVector<int,2>(4, 4));
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  const int nodes = graph.numberOfNodes();
+  std::map<std::string, int> parameters = {{"height", height}, {"width", width}, {"scales", m_wavelets[0][0]}, {"directions", m_wavelets[0][1]}, {"jets", nodes}};
+
+  // Graph::extract
+  measurements.push_back(measure("graph_extract", "", parameters, nodes, m_repetitions,
+    [&](){graph.extract(trafo_image, jets, true);}
+  ));
+
+  // Similarity::similarity for all types, comparing each Gabor jet with its successor in the graph
+  const bob::ip::gabor::Similarity::SimilarityType types[] = {
+    bob::ip::gabor::Similarity::SCALAR_PRODUCT,
+    bob::ip::gabor::Similarity::CANBERRA,
+    bob::ip::gabor::Similarity::ABS_PHASE,
+    bob::ip::gabor::Similarity::DISPARITY,
+    bob::ip::gabor::Similarity::PHASE_DIFF,
+    bob::ip::gabor::Similarity::PHASE_DIFF_PLUS_CANBERRA
+  };
+  // the results are written to a volatile, so that the compiler cannot remove the computations
+  volatile double sink = 0.;
+  for (auto type : types){
+    bob::ip::gabor::Similarity similarity(type, gwt);
+    measurements.push_back(measure("similarity", bob::ip::gabor::Similarity::type_to_name(type), parameters, nodes, m_repetitions,
+      [&](){for (int i = 0; i < nodes; ++i) sink += similarity.similarity(*jets[i], *jets[(i+1) % nodes]);}
+    ));
+  }
+
+  // PhaseCode::encode directly from the trafo image, and PhaseCode::similarity of the same pairs of Gabor jets
+  bob::ip::gabor::PhaseCode phase_code;
+  const int words = bob::ip::gabor::PhaseCode::words(gwt->numberOfWavelets());
+  blitz::Array<uint64_t,2> codes(nodes, words), masks(nodes, words);
+  measurements.push_back(measure("phase_code", "encode", parameters, nodes, m_repetitions,
+    [&](){phase_code.encode(graph, trafo_image, codes, masks);}
+  ));
+  measurements.push_back(measure("similarity", "PhaseCode", parameters, nodes, m_repetitions,
+    [&](){for (int i = 0; i < nodes; ++i) sink += bob::ip::gabor::PhaseCode::similarity(&codes(i,0), &masks(i,0), &codes((i+1) % nodes,0), &masks((i+1) % nodes,0), words);}
+  ));
+
+  // Similarity::disparity
+  bob::ip::gabor::Similarity disparity(bob::ip::gabor::Similarity::DISPARITY, gwt);
+  measurements.push_back(measure("disparity", "", parameters, nodes, m_repetitions,
+    [&](){for (int i = 0; i < nodes; ++i) sink += disparity.disparity(*jets[i], *jets[(i+1) % nodes])[0];}
+  ));
+
+  // Similarity::disparities, estimating the same disparities in SIMD lanes
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> successors(jets.begin() + 1, jets.end());
+  successors.push_back(jets.front());
+  blitz::Array<double,2> disparities(nodes, 2);
+  measurements.push_back(measure("disparity", "batched", parameters, nodes, m_repetitions,
+    [&](){disparity.disparities(jets, successors, disparities); sink += disparities(0,0);}
+  ));
+
+  // JetStatistics::logLikelihood, with and without estimating the disparity
+  bob::ip::gabor::JetStatistics statistics(jets, gwt);
+  for (bool estimate : {true, false}){
+    measurements.push_back(measure("log_likelihood", estimate ? "estimate_phase" : "fixed_phase", parameters, nodes, m_repetitions,
+      [&](){for (int i = 0; i < nodes; ++i) sink += statistics.logLikelihood(*jets[i], estimate);}
+    ));
+  }
+
+  // gallery search, exhaustive with Similarity::search and approximate with Index::search;
+  // the gallery contains noisy versions of a few random graphs, and the queries are noisy versions of gallery graphs
+  const int gallery_size = 1000, gallery_nodes = 16, length = gwt->numberOfWavelets(), identities = 32, queries = 10, k = 10;
+  std::normal_distribution<double> noise(0., 0.1);
+  blitz::Array<double,4> bases(identities, gallery_nodes, 2, length), gallery(gallery_size, gallery_nodes, 2, length);
+  blitz::Array<double,4> probes(queries, gallery_nodes, 2, length);
+  for (auto it = bases.begin(); it != bases.end(); ++it) *it = pixel(generator) / 255.;
+  auto noisy = [&](blitz::Array<double,3> source, blitz::Array<double,3> target){
+    for (int n = 0; n < gallery_nodes; ++n){
+      double norm = 0.;
+      for (int j = 0; j < length; ++j){
+        target(n,0,j) = std::abs(source(n,0,j) + noise(generator));
+        target(n,1,j) = source(n,1,j) + noise(generator);
+        norm += target(n,0,j) * target(n,0,j);
+      }
+      for (int j = 0; j < length; ++j) target(n,0,j) /= std::sqrt(norm);
+    }
+  };
+  const blitz::Range all = blitz::Range::all();
+  for (int i = 0; i < gallery_size; ++i) noisy(bases(i % identities, all, all, all), gallery(i, all, all, all));
+  for (int q = 0; q < queries; ++q) noisy(gallery(q * (gallery_size / queries), all, all, all), probes(q, all, all, all));
+
+  bob::ip::gabor::Similarity scalar_product(bob::ip::gabor::Similarity::SCALAR_PRODUCT);
+  blitz::Array<int,2> exact(queries, k), approximate(queries, k);
+  blitz::Array<double,1> scores(k);
+  std::map<std::string, int> search_parameters = {{"scales", m_wavelets[0][0]}, {"directions", m_wavelets[0][1]}, {"gallery", gallery_size}, {"nodes", gallery_nodes}, {"k", k}};
+  measurements.push_back(measure("gallery_search", "exhaustive", search_parameters, queries, m_repetitions,
+    [&](){
+      for (int q = 0; q < queries; ++q){
+        blitz::Array<int,1> ids = exact(q, all);
+        scalar_product.search(probes(q, all, all, all), gallery, ids, scores);
+      }
+    }
+  ));
+
+  // the recall/latency trade-off is controlled by the number of visited lists; the recall of the exact top k is reported in percent
+  const int lists = 32, subquantizers = 16, centroids = 64, shortlist = 10 * k;
+  bob::ip::gabor::Index index(gallery_nodes * length, lists, subquantizers, centroids);
+  blitz::Array<double,2> features(gallery_size, gallery_nodes * length);
+  bob::ip::gabor::Index::features(gallery, features);
+  index.train(features);
+  index.add(features);
+  for (int visited : {1, 4, lists}){
+    std::map<std::string, int> index_parameters = search_parameters;
+    index_parameters["lists"] = lists;
+    index_parameters["subquantizers"] = subquantizers;
+    index_parameters["centroids"] = centroids;
+    index_parameters["probes"] = visited;
+    index_parameters["shortlist"] = shortlist;
+    auto search = [&](){
+      for (int q = 0; q < queries; ++q){
+        blitz::Array<int,1> ids = approximate(q, all);
+        index.search(scalar_product, probes(q, all, all, all), gallery, visited, shortlist, ids, scores);
+      }
+    };
+    search();
+    int found = 0;
+    for (int q = 0; q < queries; ++q){
+      for (int i = 0; i < k; ++i){
+        found += std::count(&approximate(q,0), &approximate(q,0) + k, exact(q,i));
+      }
+    }
+    index_parameters["recall_percent"] = 100 * found / (queries * k);
+    measurements.push_back(measure("gallery_search", "index", index_parameters, queries, m_repetitions, search));
+  }
+
+  return measurements;
+}
+
+// nearest-rank percentile of the given sorted values
+static double percentile(const std::vector<double>& sorted, double p){
+  const int rank = static_cast<int>(std::ceil(p / 100. * sorted.size()));
+  return sorted[std::max(rank, 1) - 1];
+}
+
+// prints the given number without loss of precision
+static std::string number(double value){
+  std::ostringstream stream;
+  stream.precision(17);
+  stream << value;
+  return stream.str();
+}
+
+std::string bob::ip::gabor::Benchmark::json(const std::vector<bob::ip::gabor::Benchmark::Measurement>& measurements){
+  std::ostringstream out;
+  out << "{\n";
+  out << "  \"simd_level\": \"" << bob::ip::gabor::Simd::level_to_name(bob::ip::gabor::Simd::level()) << "\",\n";
+  out << "  \"approximate_phase\": " << (bob::ip::gabor::Simd::approximatePhase() ? "true" : "false") << ",\n";
+  out << "  \"measurements\": [";
+  for (auto it = measurements.begin(); it != measurements.end(); ++it){
+    std::vector<double> sorted(it->seconds);
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0.;
+    for (auto s : sorted) mean += s;
+    mean /= sorted.size();
+
+    out << (it == measurements.begin() ? "\n" : ",\n");
+    out << "    {\n";
+    out << "      \"name\": \"" << it->name << "\",\n";
+    out << "      \"variant\": \"" << it->variant << "\",\n";
+    out << "      \"parameters\": {";
+    for (auto pit = it->parameters.begin(); pit != it->parameters.end(); ++pit)
+      out << (pit == it->parameters.begin() ? "" : ", ") << "\"" << pit->first << "\": " << pit->second;
+    out << "},\n";
+    out << "      \"repetitions\": " << sorted.size() << ",\n";
+    out << "      \"items\": " << it->items << ",\n";
+    out << "      \"latency\": {"
+        << "\"mean\": " << number(mean) << ", "
+        << "\"min\": " << number(sorted.front()) << ", "
+        << "\"p50\": " << number(percentile(sorted, 50.)) << ", "
+        << "\"p90\": " << number(percentile(sorted, 90.)) << ", "
+        << "\"p99\": " << number(percentile(sorted, 99.)) << ", "
+        << "\"max\": " << number(sorted.back()) << "},\n";
+    out << "      \"throughput\": " << number(it->items / mean) << ",\n";
+    out << "      \"allocations\": " << (it->allocations < 0. ? std::string("null") : number(it->allocations)) << "\n";
+    out << "    }";
+  }
+  out << "\n  ]\n}\n";
+  return out.str();
+}
@@ -0,0 +1,315 @@
+/**
+ * @brief C++ implementations of the FFT backends used by the Gabor wavelet transform
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/FFT.h>
+#include <bob.ip.gabor/Stats.h>
+#include <bob.core/assert.h>
+#include <boost/assign.hpp>
+#include <boost/format.hpp>
+
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#ifdef HAVE_FFTW3
+#include <fftw3.h>
+#endif
+
+
+static const std::map<bob::ip::gabor::FFT::Backend, std::string> backend_map = boost::assign::map_list_of
+  (bob::ip::gabor::FFT::BOB_SP, "bob.sp")
+  (bob::ip::gabor::FFT::FFTW, "fftw")
+  ;
+
+const std::string& bob::ip::gabor::FFT::backend_to_name(bob::ip::gabor::FFT::Backend backend){
+  return backend_map.find(backend)->second;
+}
+
+bob::ip::gabor::FFT::Backend bob::ip::gabor::FFT::name_to_backend(const std::string& backend){
+  for (auto it = backend_map.begin(); it != backend_map.end(); ++it)
+    if (it->second == backend)
+      return it->first;
+  throw std::runtime_error("The given backend name '" + backend + "' does not name an appropriate FFT backend.");
+}
+
+bool bob::ip::gabor::FFT::available(bob::ip::gabor::FFT::Backend backend){
+#ifdef HAVE_FFTW3
+  return true;
+#else
+  return backend == BOB_SP;
+#endif
+}
+
+
+#ifdef HAVE_FFTW3
+// The FFTW planner is not thread-safe, so all planning and wisdom functions are guarded by this mutex.
+// The plans themselves are kept for the lifetime of the process, and fftw_execute_dft can be called concurrently.
+static std::mutex planner_mutex;
+static std::map<std::pair<int,int>, std::pair<fftw_plan, fftw_plan>> plans;
+
+static std::pair<fftw_plan, fftw_plan> get_plans(int height, int width){
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  auto key = std::make_pair(height, width);
+  auto it = plans.find(key);
+  if (it != plans.end()) return it->second;
+
+  // measuring overwrites the arrays, so we plan on temporary memory;
+  // FFTW_UNALIGNED allows to execute the plans on any (blitz) array
+  fftw_complex* in = fftw_alloc_complex(height * width);
+  fftw_complex* out = fftw_alloc_complex(height * width);
+  fftw_plan forward = fftw_plan_dft_2d(height, width, in, out, FFTW_FORWARD, FFTW_MEASURE | FFTW_UNALIGNED);
+  fftw_plan inverse = fftw_plan_dft_2d(height, width, in, out, FFTW_BACKWARD, FFTW_MEASURE | FFTW_UNALIGNED);
+  fftw_free(in);
+  fftw_free(out);
+  if (!forward || !inverse){
+    throw std::runtime_error((boost::format("FFTW could not create a plan for resolution %d x %d") % height % width).str());
+  }
+  return plans[key] = std::make_pair(forward, inverse);
+}
+
+static std::map<int, fftw_plan> line_plans;
+
+static fftw_plan get_line_plan(int length){
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  auto it = line_plans.find(length);
+  if (it != line_plans.end()) return it->second;
+
+  fftw_complex* in = fftw_alloc_complex(length);
+  fftw_complex* out = fftw_alloc_complex(length);
+  fftw_plan inverse = fftw_plan_dft_1d(length, in, out, FFTW_BACKWARD, FFTW_MEASURE | FFTW_UNALIGNED);
+  fftw_free(in);
+  fftw_free(out);
+  if (!inverse){
+    throw std::runtime_error((boost::format("FFTW could not create a plan for length %d") % length).str());
+  }
+  return line_plans[length] = inverse;
+}
+#endif // HAVE_FFTW3
+
+
+bob::ip::gabor::FFT::FFT(bob::ip::gabor::FFT::Backend backend)
+: m_backend(backend),
+  m_height(0),
+  m_width(0),
+  m_fft(),
+  m_ifft(),
+  m_forward_plan(0),
+  m_inverse_plan(0),
+  m_ifft_x(1),
+  m_ifft_y(1),
+  m_inverse_plan_x(0),
+  m_inverse_plan_y(0)
+{
+  if (!available(backend))
+    throw std::runtime_error("The FFT backend '" + backend_to_name(backend) + "' is not available; please compile bob.ip.gabor with FFTW3 support.");
+}
+
+bob::ip::gabor::FFT::FFT(const bob::ip::gabor::FFT& other)
+: m_backend(other.m_backend),
+  m_height(0),
+  m_width(0),
+  m_fft(),
+  m_ifft(),
+  m_forward_plan(0),
+  m_inverse_plan(0),
+  m_ifft_x(1),
+  m_ifft_y(1),
+  m_inverse_plan_x(0),
+  m_inverse_plan_y(0)
+{
+  setShape(other.m_height, other.m_width);
+}
+
+bob::ip::gabor::FFT& bob::ip::gabor::FFT::operator =(const bob::ip::gabor::FFT& other){
+  m_backend = other.m_backend;
+  setShape(other.m_height, other.m_width);
+  return *this;
+}
+
+void bob::ip::gabor::FFT::backend(bob::ip::gabor::FFT::Backend backend){
+  if (!available(backend))
+    throw std::runtime_error("The FFT backend '" + backend_to_name(backend) + "' is not available; please compile bob.ip.gabor with FFTW3 support.");
+  m_backend = backend;
+  setup();
+}
+
+void bob::ip::gabor::FFT::setShape(int height, int width){
+  m_height = height;
+  m_width = width;
+  setup();
+}
+
+void bob::ip::gabor::FFT::setup(){
+  m_forward_plan = m_inverse_plan = m_inverse_plan_x = m_inverse_plan_y = 0;
+  // nothing to prepare before the shape is known
+  if (m_height <= 0 || m_width <= 0) return;
+  if (m_backend == BOB_SP){
+    m_fft.setShape(m_height, m_width);
+    m_ifft.setShape(m_height, m_width);
+  }
+#ifdef HAVE_FFTW3
+  else {
+    auto p = get_plans(m_height, m_width);
+    m_forward_plan = p.first;
+    m_inverse_plan = p.second;
+  }
+#endif
+}
+
+// checks that the given array is stored row-major without gaps
+static inline bool is_contiguous(const blitz::Array<std::complex<double>,2>& a){
+  return a.stride(1) == 1 && a.stride(0) == a.extent(1);
+}
+
+void bob::ip::gabor::FFT::forward(
+  const blitz::Array<std::complex<double>,2>& input,
+  blitz::Array<std::complex<double>,2>& output
+)
+{
+  BOB_IP_GABOR_STATS_TIME(FORWARD_FFT);
+  if (m_backend == BOB_SP){
+    m_fft(input, output);
+    return;
+  }
+#ifdef HAVE_FFTW3
+  bob::core::array::assertSameShape(input, blitz::shape(m_height, m_width));
+  bob::core::array::assertSameShape(output, input);
+  const bool copy_input = !is_contiguous(input) || input.data() == output.data(), copy_output = !is_contiguous(output);
+  if (copy_input){m_input.resize(input.shape()); m_input = input;}
+  if (copy_output) m_output.resize(output.shape());
+  fftw_execute_dft(
+    (fftw_plan)m_forward_plan,
+    reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>*>(copy_input ? m_input.data() : input.data())),
+    reinterpret_cast<fftw_complex*>(copy_output ? m_output.data() : output.data())
+  );
+  if (copy_output) output = m_output;
+#endif
+}
+
+void bob::ip::gabor::FFT::inverse(
+  const blitz::Array<std::complex<double>,2>& input,
+  blitz::Array<std::complex<double>,2>& output
+)
+{
+  BOB_IP_GABOR_STATS_TIME(INVERSE_FFT);
+  if (m_backend == BOB_SP){
+    m_ifft(input, output);
+    return;
+  }
+#ifdef HAVE_FFTW3
+  bob::core::array::assertSameShape(input, blitz::shape(m_height, m_width));
+  bob::core::array::assertSameShape(output, input);
+  const bool copy_input = !is_contiguous(input) || input.data() == output.data(), copy_output = !is_contiguous(output);
+  if (copy_input){m_input.resize(input.shape()); m_input = input;}
+  if (copy_output) m_output.resize(output.shape());
+  fftw_execute_dft(
+    (fftw_plan)m_inverse_plan,
+    reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>*>(copy_input ? m_input.data() : input.data())),
+    reinterpret_cast<fftw_complex*>(copy_output ? m_output.data() : output.data())
+  );
+  // FFTW does not normalize the inverse transform
+  if (copy_output) output = m_output / (double)(m_height * m_width);
+  else output /= (double)(m_height * m_width);
+#endif
+}
+
+/**
+ * Computes the inverse FFT only inside the given window.
+ * The 2D inverse FFT is separated into 1D inverse FFTs along the lines of both axes.
+ * The first pass transforms all lines, while the second pass transforms only the lines that cross the window.
+ * The axis of the first pass is chosen such that the costs are minimal.
+ * @param input  The spectrum of shape (getHeight(), getWidth())
+ * @param offset  The upper left position of the window in the spatial domain
+ * @param output  The inverse FFT inside the window; its shape defines the size of the window
+ */
+void bob::ip::gabor::FFT::inverse(
+  const blitz::Array<std::complex<double>,2>& input,
+  const blitz::TinyVector<int,2>& offset,
+  blitz::Array<std::complex<double>,2>& output
+)
+{
+  const int height = output.extent(0), width = output.extent(1);
+  bob::core::array::assertSameShape(input, blitz::shape(m_height, m_width));
+  if (offset[0] < 0 || offset[1] < 0 || offset[0] + height > m_height || offset[1] + width > m_width)
+    throw std::runtime_error((boost::format("The window of size %d x %d at (%d,%d) is out of the image boundaries %d x %d") % height % width % offset[0] % offset[1] % m_height % m_width).str());
+  if (height == m_height && width == m_width){
+    inverse(input, output);
+    return;
+  }
+  BOB_IP_GABOR_STATS_TIME(INVERSE_FFT);
+
+  // roughly N log2(N) operations for each 1D FFT of length N
+  const double rows_first = (double)m_height * m_width * std::log2(m_width) + (double)width * m_height * std::log2(m_height);
+  const double columns_first = (double)m_width * m_height * std::log2(m_height) + (double)height * m_width * std::log2(m_width);
+  const blitz::Range all = blitz::Range::all();
+  if (rows_first <= columns_first){
+    m_pruned.resize(m_height, width);
+    for (int y = 0; y < m_height; ++y){
+      inverseLine(true, input(y, all), offset[1], m_pruned(y, all));
+    }
+    for (int x = 0; x < width; ++x){
+      inverseLine(false, m_pruned(all, x), offset[0], output(all, x));
+    }
+  } else {
+    m_pruned.resize(height, m_width);
+    for (int x = 0; x < m_width; ++x){
+      inverseLine(false, input(all, x), offset[0], m_pruned(all, x));
+    }
+    for (int y = 0; y < height; ++y){
+      inverseLine(true, m_pruned(y, all), offset[1], output(y, all));
+    }
+  }
+#ifdef HAVE_FFTW3
+  // FFTW does not normalize the inverse transform
+  if (m_backend == FFTW) output /= (double)(m_height * m_width);
+#endif
+}
+
+void bob::ip::gabor::FFT::inverseLine(
+  bool along_x,
+  const blitz::Array<std::complex<double>,1>& input,
+  int start,
+  blitz::Array<std::complex<double>,1> output
+)
+{
+  const int length = along_x ? m_width : m_height;
+  m_line_input.resize(length);
+  m_line_output.resize(length);
+  m_line_input = input;
+  if (m_backend == BOB_SP){
+    bob::sp::IFFT1D& ifft = along_x ? m_ifft_x : m_ifft_y;
+    if ((int)ifft.getLength() != length) ifft.setLength(length);
+    ifft(m_line_input, m_line_output);
+  }
+#ifdef HAVE_FFTW3
+  else {
+    void*& plan = along_x ? m_inverse_plan_x : m_inverse_plan_y;
+    if (!plan) plan = get_line_plan(length);
+    fftw_execute_dft((fftw_plan)plan, reinterpret_cast<fftw_complex*>(m_line_input.data()), reinterpret_cast<fftw_complex*>(m_line_output.data()));
+  }
+#endif
+  output = m_line_output(blitz::Range(start, start + output.extent(0) - 1));
+}
+
+void bob::ip::gabor::FFT::loadWisdom(const std::string& filename){
+#ifdef HAVE_FFTW3
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  if (!fftw_import_wisdom_from_filename(filename.c_str()))
+    throw std::runtime_error("Could not read FFTW wisdom from file '" + filename + "'");
+#else
+  throw std::runtime_error("Cannot load FFTW wisdom from file '" + filename + "' since bob.ip.gabor was compiled without FFTW3 support.");
+#endif
+}
+
+void bob::ip::gabor::FFT::saveWisdom(const std::string& filename){
+#ifdef HAVE_FFTW3
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  if (!fftw_export_wisdom_to_filename(filename.c_str()))
+    throw std::runtime_error("Could not write FFTW wisdom to file '" + filename + "'");
+#else
+  throw std::runtime_error("Cannot save FFTW wisdom to file '" + filename + "' since bob.ip.gabor was compiled without FFTW3 support.");
+#endif
+}
@@ -0,0 +1,95 @@
+/**
+ * @brief C++ implementations of the extraction of block-pooled Gabor magnitude and phase features
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/FeatureExtractor.h>
+#include <bob.ip.gabor/Simd.h>
+#include <boost/format.hpp>
+
+/**
+ * Creates a feature extractor
+ * @param transform  The Gabor wavelet transform; the wavelets are always applied in frequency domain
+ * @param block_size  The size of the blocks, in which the responses are pooled
+ * @param phase_bins  The number of bins of the phase histograms; if 0, only magnitudes are pooled
+ */
+bob::ip::gabor::FeatureExtractor::FeatureExtractor(
+  boost::shared_ptr<bob::ip::gabor::Transform> transform,
+  const blitz::TinyVector<int,2>& block_size,
+  int phase_bins
+)
+: m_transform(transform),
+  m_block_size(block_size),
+  m_phase_bins(phase_bins),
+  m_index(1)
+{
+  if (!m_transform)
+    throw std::runtime_error("FeatureExtractor: the transform must not be empty");
+  if (block_size[0] <= 0 || block_size[1] <= 0 || phase_bins < 0)
+    throw std::runtime_error((boost::format("FeatureExtractor: the block size (%d, %d) must be positive and the number of phase bins (%d) must not be negative") % block_size[0] % block_size[1] % phase_bins).str());
+}
+
+blitz::TinyVector<int,3> bob::ip::gabor::FeatureExtractor::magnitudeShape(int height, int width) const{
+  return blitz::TinyVector<int,3>(m_transform->numberOfWavelets(), height / m_block_size[0], width / m_block_size[1]);
+}
+
+/**
+ * Computes the pooled features of the given image.
+ * The FFT of the image is computed once, and each wavelet is transformed back to spatial domain and pooled separately.
+ * @param gray_image  The image in spatial domain
+ * @param magnitudes  The average magnitudes per wavelet and block
+ * @param phase_histograms  The normalized phase histograms per wavelet and block; might be NULL
+ */
+void bob::ip::gabor::FeatureExtractor::extract_inner(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  blitz::Array<double,3>& magnitudes,
+  blitz::Array<double,4>* phase_histograms
+)
+{
+  const blitz::TinyVector<int,3> shape = magnitudeShape(gray_image.extent(0), gray_image.extent(1));
+  if (!shape[1] || !shape[2])
+    throw std::runtime_error((boost::format("FeatureExtractor: the image of size (%d, %d) is smaller than one block") % gray_image.extent(0) % gray_image.extent(1)).str());
+  bob::core::array::assertSameShape(magnitudes, shape);
+  if (phase_histograms){
+    if (!m_phase_bins)
+      throw std::runtime_error("FeatureExtractor: phase histograms are only computed when the number of phase bins is positive");
+    bob::core::array::assertSameShape(*phase_histograms, blitz::shape(shape[0], shape[1], shape[2], m_phase_bins));
+    *phase_histograms = 0.;
+  }
+
+  // compute the FFT of the image only once
+  m_transform->spectrum(gray_image, m_spectrum);
+  const int width = gray_image.extent(1);
+  m_layer.resize(1, gray_image.extent(0), width);
+  m_abs.resize(width);
+  m_phase.resize(width);
+
+  const int bh = m_block_size[0], bw = m_block_size[1];
+  const double norm = 1. / (bh * bw), bin_scale = m_phase_bins / (2. * M_PI);
+  for (int j = 0; j < shape[0]; ++j){
+    // compute the responses of the current wavelet only
+    m_index[0] = j;
+    m_transform->transform(m_spectrum, m_index, m_layer);
+
+    // pool the responses in the blocks; the absolute values and phases are computed row by row with the vectorized kernel
+    for (int by = 0; by < shape[1]; ++by){
+      blitz::Array<double,1> sums = magnitudes(j, by, blitz::Range::all());
+      sums = 0.;
+      for (int y = by * bh; y < (by + 1) * bh; ++y){
+        bob::ip::gabor::Simd::polar(&m_layer(0,y,0), 1, m_abs.data(), m_phase.data(), shape[2] * bw);
+        for (int bx = 0; bx < shape[2]; ++bx){
+          for (int x = bx * bw; x < (bx + 1) * bw; ++x){
+            sums(bx) += m_abs(x);
+            if (phase_histograms){
+              // map the phase from [-pi, pi] to the bins
+              const int bin = std::max(std::min(static_cast<int>((m_phase(x) + M_PI) * bin_scale), m_phase_bins - 1), 0);
+              (*phase_histograms)(j, by, bx, bin) += norm;
+            }
+          }
+        }
+      }
+      sums *= norm;
+    }
+  }
+}
@@ -8,6 +8,10 @@
  */
 
 #include <bob.ip.gabor/Graph.h>
+#include <bob.ip.gabor/Simd.h>
+#include <bob.core/check.h>
+
+#include <thread>
 
 /**
  * Generates grid graphs which will be placed according to the given eye positions
@@ -173,6 +177,125 @@ void bob::ip::gabor::Graph::extract(
   }
 }
 
+/**
+ * Extracts a single Gabor jet from the given (strided) wavelet responses, see Jet::init and Jet::normalize
+ * @param responses  The first wavelet response of the Gabor jet
+ * @param stride  The distance between two wavelet responses
+ * @param jet  The absolute values, which are followed by the phases
+ * @param length  The number of wavelets
+ * @param normalize  Normalize the absolute values to unit Euclidean length?
+ */
+static void extract_jet(const std::complex<double>* responses, int stride, double* jet, int length, bool normalize){
+  bob::ip::gabor::Simd::polar(responses, stride, jet, jet + length, length);
+  if (normalize){
+    double norm = bob::ip::gabor::Simd::dot(jet, jet, length);
+    if (std::abs(norm - 1.) > 1e-8){
+      norm = sqrt(norm);
+      for (int j = 0; j < length; ++j) jet[j] /= norm;
+    }
+  }
+}
+
+/**
+ * Extracts the Gabor jets from a stack of trafo images, where the nodes have already been checked
+ * @param trafo_images  The trafo images of shape (N, wavelets, height, width)
+ * @param node  A function returning the position of the given node in the given image
+ * @param number_of_nodes  The number of nodes per image
+ * @param jets  The C-contiguous jets of shape (N, number_of_nodes, 2, wavelets)
+ * @param normalize  Normalize the Gabor jets?
+ * @param number_of_threads  The number of threads, among which the images are distributed; 0 for one thread per core
+ */
+template <typename Node>
+static void extract_stack(
+  const blitz::Array<std::complex<double>,4>& trafo_images,
+  Node node,
+  int number_of_nodes,
+  blitz::Array<double,4>& jets,
+  bool normalize,
+  int number_of_threads
+){
+  const int count = trafo_images.extent(0), length = trafo_images.extent(1);
+  bob::core::array::assertSameShape(jets, blitz::shape(count, number_of_nodes, 2, length));
+  if (!bob::core::array::isCZeroBaseContiguous(jets))
+    throw std::runtime_error("Graph: the array of extracted Gabor jets must be C-contiguous");
+  if (number_of_threads < 0)
+    throw std::runtime_error((boost::format("Graph: the number of threads (%d) must not be negative") % number_of_threads).str());
+
+  auto extract_images = [&](int first, int last){
+    for (int i = first; i < last; ++i){
+      for (int n = 0; n < number_of_nodes; ++n){
+        const blitz::TinyVector<int,2> position = node(i, n);
+        const std::complex<double>* responses = trafo_images.data() + i * trafo_images.stride(0) + position[0] * trafo_images.stride(2) + position[1] * trafo_images.stride(3);
+        extract_jet(responses, trafo_images.stride(1), jets.data() + (i * number_of_nodes + n) * 2 * length, length, normalize);
+      }
+    }
+  };
+
+  if (!number_of_threads) number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+  number_of_threads = std::min(number_of_threads, count);
+  if (number_of_threads <= 1){
+    extract_images(0, count);
+    return;
+  }
+
+  // each thread extracts a consecutive block of images
+  std::vector<std::thread> threads;
+  try {
+    for (int t = 0; t < number_of_threads; ++t){
+      threads.push_back(std::thread(extract_images, t * count / number_of_threads, (t+1) * count / number_of_threads));
+    }
+  } catch (...){
+    for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+    throw;
+  }
+  for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+}
+
+/**
+ * Extracts the Gabor jets at the node positions from all images of the given stack
+ * @param trafo_images  The trafo images of shape (N, wavelets, height, width)
+ * @param jets  The C-contiguous array of shape (N, numberOfNodes(), 2, wavelets) that will be filled
+ * @param normalize  Normalize the Gabor jets?
+ * @param number_of_threads  The number of threads to use; 0 for one thread per core
+ */
+void bob::ip::gabor::Graph::extract(
+  const blitz::Array<std::complex<double>,4>& trafo_images,
+  blitz::Array<double,4>& jets,
+  bool normalize,
+  int number_of_threads
+) const {
+  // check the positions only once for all images
+  checkNodes(trafo_images.extent(2), trafo_images.extent(3));
+  extract_stack(trafo_images, [this](int, int n){return m_nodes[n];}, numberOfNodes(), jets, normalize, number_of_threads);
+}
+
+/**
+ * Extracts the Gabor jets at individual node positions from all images of the given stack
+ * @param trafo_images  The trafo images of shape (N, wavelets, height, width)
+ * @param nodes  The node positions (y, x) for each image, of shape (N, nodes, 2)
+ * @param jets  The C-contiguous array of shape (N, nodes, 2, wavelets) that will be filled
+ * @param normalize  Normalize the Gabor jets?
+ * @param number_of_threads  The number of threads to use; 0 for one thread per core
+ */
+void bob::ip::gabor::Graph::extract(
+  const blitz::Array<std::complex<double>,4>& trafo_images,
+  const blitz::Array<int,3>& nodes,
+  blitz::Array<double,4>& jets,
+  bool normalize,
+  int number_of_threads
+){
+  const int height = trafo_images.extent(2), width = trafo_images.extent(3);
+  if (nodes.extent(0) != trafo_images.extent(0) || nodes.extent(2) != 2)
+    throw std::runtime_error((boost::format("Graph: the nodes must have shape (%d, nodes, 2), but have shape (%d, %d, %d)") % trafo_images.extent(0) % nodes.extent(0) % nodes.extent(1) % nodes.extent(2)).str());
+  for (int i = 0; i < nodes.extent(0); ++i){
+    for (int n = 0; n < nodes.extent(1); ++n){
+      if (nodes(i,n,0) < 0 || nodes(i,n,0) >= height || nodes(i,n,1) < 0 || nodes(i,n,1) >= width)
+        throw std::runtime_error((boost::format("The position (%i,%i) is out of the image boundaries %i x %i") % nodes(i,n,0) % nodes(i,n,1) % height % width).str());
+    }
+  }
+  extract_stack(trafo_images, [&nodes](int i, int n){return blitz::TinyVector<int,2>(nodes(i,n,0), nodes(i,n,1));}, nodes.extent(1), jets, normalize, number_of_threads);
+}
+
 void bob::ip::gabor::Graph::save(bob::io::base::HDF5File& file) const{
   blitz::Array<int,2> n(m_nodes.size(), 2);
   int i = 0;
@@ -0,0 +1,405 @@
+/**
+ * @brief C++ implementations of the approximate nearest neighbor index of Gabor graphs
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/Index.h>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+
+// the squared Euclidean distance between the given vectors
+static double distance(const double* a, const double* b, int size){
+  double sum = 0.;
+  for (int i = 0; i < size; ++i){
+    const double d = a[i] - b[i];
+    sum += d * d;
+  }
+  return sum;
+}
+
+// returns the index of the closest of the given centroids
+static int closest(const double* vector, const double* centroids, int count, int size){
+  int best = 0;
+  double best_distance = std::numeric_limits<double>::infinity();
+  for (int c = 0; c < count; ++c){
+    const double d = distance(vector, centroids + c * size, size);
+    if (d < best_distance){
+      best_distance = d;
+      best = c;
+    }
+  }
+  return best;
+}
+
+/**
+ * Clusters the given vectors with Lloyd's k-means algorithm
+ * @param data  The first vector; vector i starts at data + i * stride
+ * @param count  The number of vectors
+ * @param size  The size of the vectors
+ * @param stride  The distance between two vectors
+ * @param k  The number of centroids; must not be larger than count
+ * @param iterations  The maximum number of iterations
+ * @param generator  The random number generator used to initialize the centroids and to re-initialize empty clusters
+ * @param centroids  The C-contiguous (k, size) centroids, which will be filled
+ */
+static void kmeans(const double* data, int count, int size, int stride, int k, int iterations, std::mt19937& generator, double* centroids){
+  // initialize the centroids with distinct random vectors
+  std::vector<int> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), generator);
+  for (int c = 0; c < k; ++c){
+    std::copy(data + order[c] * stride, data + order[c] * stride + size, centroids + c * size);
+  }
+
+  std::vector<int> assignment(count, -1), counts(k);
+  std::vector<double> sums(k * size);
+  std::uniform_int_distribution<int> random_vector(0, count - 1);
+  for (int iteration = 0; iteration < iterations; ++iteration){
+    bool changed = false;
+    for (int i = 0; i < count; ++i){
+      const int c = closest(data + i * stride, centroids, k, size);
+      changed = changed || c != assignment[i];
+      assignment[i] = c;
+    }
+    if (!changed) break;
+
+    std::fill(sums.begin(), sums.end(), 0.);
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int i = 0; i < count; ++i){
+      const double* vector = data + i * stride;
+      double* sum = &sums[assignment[i] * size];
+      for (int j = 0; j < size; ++j) sum[j] += vector[j];
+      ++counts[assignment[i]];
+    }
+    for (int c = 0; c < k; ++c){
+      if (counts[c]){
+        for (int j = 0; j < size; ++j) centroids[c * size + j] = sums[c * size + j] / counts[c];
+      } else {
+        // empty clusters are re-initialized with a random vector
+        const double* vector = data + random_vector(generator) * stride;
+        std::copy(vector, vector + size, centroids + c * size);
+      }
+    }
+  }
+}
+
+// checks the parameters of the index
+static void check(int dimension, int lists, int subquantizers, int centroids){
+  if (dimension <= 0 || lists <= 0 || subquantizers <= 0)
+    throw std::runtime_error((boost::format("Index: the dimension (%d), the number of lists (%d) and the number of sub-quantizers (%d) must be positive") % dimension % lists % subquantizers).str());
+  if (dimension % subquantizers)
+    throw std::runtime_error((boost::format("Index: the dimension (%d) must be divisible by the number of sub-quantizers (%d)") % dimension % subquantizers).str());
+  if (centroids < 1 || centroids > 256)
+    throw std::runtime_error((boost::format("Index: the number of centroids per sub-quantizer (%d) must be in [1, 256]") % centroids).str());
+}
+
+
+/**
+ * Creates an untrained index
+ * @param dimension  The dimension of the feature vectors, see features()
+ * @param number_of_lists  The number of coarse centroids, i.e., of inverted lists
+ * @param number_of_subquantizers  The number of parts of the residuals, each of which is stored in one byte
+ * @param number_of_centroids  The number of centroids of each sub-quantizer
+ */
+bob::ip::gabor::Index::Index(
+  int dimension,
+  int number_of_lists,
+  int number_of_subquantizers,
+  int number_of_centroids
+)
+: m_dimension(dimension),
+  m_trained(false),
+  m_size(0)
+{
+  check(dimension, number_of_lists, number_of_subquantizers, number_of_centroids);
+  m_coarse_centroids.resize(number_of_lists, dimension);
+  m_coarse_centroids = 0.;
+  m_codebooks.resize(number_of_subquantizers, number_of_centroids, dimension / number_of_subquantizers);
+  m_codebooks = 0.;
+  m_ids.resize(number_of_lists);
+  m_codes.resize(number_of_lists);
+}
+
+bob::ip::gabor::Index::Index(bob::io::base::HDF5File& file)
+{
+  load(file);
+}
+
+
+void bob::ip::gabor::Index::features(const blitz::Array<double,3>& graph, blitz::Array<double,1>& features){
+  const int nodes = graph.extent(0), length = graph.extent(2);
+  if (graph.extent(1) != 2)
+    throw std::runtime_error((boost::format("Index: the graph must have the shape (nodes, 2, length), but the second dimension is %d") % graph.extent(1)).str());
+  bob::core::array::assertSameShape(features, blitz::shape(nodes * length));
+  for (int n = 0; n < nodes; ++n){
+    for (int j = 0; j < length; ++j){
+      features(n * length + j) = graph(n, 0, j);
+    }
+  }
+}
+
+void bob::ip::gabor::Index::features(const blitz::Array<double,4>& graphs, blitz::Array<double,2>& features){
+  bob::core::array::assertSameShape(features, blitz::shape(graphs.extent(0), graphs.extent(1) * graphs.extent(3)));
+  for (int i = 0; i < graphs.extent(0); ++i){
+    blitz::Array<double,1> f = features(i, blitz::Range::all());
+    Index::features(graphs(i, blitz::Range::all(), blitz::Range::all(), blitz::Range::all()), f);
+  }
+}
+
+
+int bob::ip::gabor::Index::assign(const double* feature) const{
+  return closest(feature, m_coarse_centroids.data(), numberOfLists(), m_dimension);
+}
+
+/**
+ * Trains the coarse centroids and the sub-quantizers
+ * @param features  The (N, dimension) training feature vectors; N must not be smaller than the number of lists and the number of centroids
+ * @param iterations  The maximum number of k-means iterations
+ * @param seed  The seed of the random initialization of the k-means clustering
+ */
+void bob::ip::gabor::Index::train(const blitz::Array<double,2>& features, int iterations, unsigned seed){
+  const int count = features.extent(0), lists = numberOfLists(), subquantizers = numberOfSubquantizers(), centroids = numberOfCentroids(), size = m_dimension / subquantizers;
+  if (features.extent(1) != m_dimension)
+    throw std::runtime_error((boost::format("Index: the dimension of the training features (%d) differs from the dimension of the index (%d)") % features.extent(1) % m_dimension).str());
+  if (count < lists || count < centroids)
+    throw std::runtime_error((boost::format("Index: at least %d training features are required, but only %d are given") % std::max(lists, centroids) % count).str());
+
+  // copy the training data to get contiguous memory
+  std::vector<double> data(count * m_dimension);
+  for (int i = 0; i < count; ++i){
+    for (int j = 0; j < m_dimension; ++j) data[i * m_dimension + j] = features(i, j);
+  }
+  std::mt19937 generator(seed);
+
+  // the coarse centroids
+  kmeans(data.data(), count, m_dimension, m_dimension, lists, iterations, generator, m_coarse_centroids.data());
+
+  // the sub-quantizers are trained on the residuals to the coarse centroids
+  for (int i = 0; i < count; ++i){
+    const double* centroid = m_coarse_centroids.data() + assign(&data[i * m_dimension]) * m_dimension;
+    for (int j = 0; j < m_dimension; ++j) data[i * m_dimension + j] -= centroid[j];
+  }
+  for (int m = 0; m < subquantizers; ++m){
+    kmeans(data.data() + m * size, count, size, m_dimension, centroids, iterations, generator, m_codebooks.data() + m * centroids * size);
+  }
+
+  // the stored graphs are not valid any more
+  for (int l = 0; l < lists; ++l){
+    m_ids[l].clear();
+    m_codes[l].clear();
+  }
+  m_size = 0;
+  m_trained = true;
+}
+
+void bob::ip::gabor::Index::add(const blitz::Array<double,2>& features){
+  if (!m_trained)
+    throw std::runtime_error("Index: please train the index before adding graphs");
+  if (features.extent(1) != m_dimension)
+    throw std::runtime_error((boost::format("Index: the dimension of the features (%d) differs from the dimension of the index (%d)") % features.extent(1) % m_dimension).str());
+
+  const int subquantizers = numberOfSubquantizers(), centroids = numberOfCentroids(), size = m_dimension / subquantizers;
+  std::vector<double> residual(m_dimension);
+  for (int i = 0; i < features.extent(0); ++i){
+    for (int j = 0; j < m_dimension; ++j) residual[j] = features(i, j);
+    const int list = assign(residual.data());
+    const double* centroid = m_coarse_centroids.data() + list * m_dimension;
+    for (int j = 0; j < m_dimension; ++j) residual[j] -= centroid[j];
+    m_ids[list].push_back(m_size++);
+    for (int m = 0; m < subquantizers; ++m){
+      m_codes[list].push_back(static_cast<uint8_t>(closest(residual.data() + m * size, m_codebooks.data() + m * centroids * size, centroids, size)));
+    }
+  }
+}
+
+/**
+ * Finds the graphs with the smallest approximate distances to the query
+ * @param query  The feature vector of the query
+ * @param probes  The number of closest lists that are visited; the recall increases with the number of probes, and so does the search time
+ * @param ids  The identifiers of the closest graphs, ordered by ascending distance; -1 if less graphs are found
+ * @param distances  The approximate squared Euclidean distances of the closest graphs
+ */
+void bob::ip::gabor::Index::search(const blitz::Array<double,1>& query, int probes, blitz::Array<int,1>& ids, blitz::Array<double,1>& distances) const{
+  if (!m_trained)
+    throw std::runtime_error("Index: please train the index before searching");
+  bob::core::array::assertSameShape(query, blitz::shape(m_dimension));
+  bob::core::array::assertSameShape(distances, ids.shape());
+  if (probes <= 0)
+    throw std::runtime_error((boost::format("Index: the number of probes (%d) must be positive") % probes).str());
+
+  const int lists = numberOfLists(), subquantizers = numberOfSubquantizers(), centroids = numberOfCentroids(), size = m_dimension / subquantizers, k = ids.extent(0);
+  probes = std::min(probes, lists);
+  std::vector<double> q(query.begin(), query.end());
+
+  // the closest lists
+  std::vector<std::pair<double,int>> coarse(lists);
+  for (int l = 0; l < lists; ++l){
+    coarse[l] = std::make_pair(distance(q.data(), m_coarse_centroids.data() + l * m_dimension, m_dimension), l);
+  }
+  std::partial_sort(coarse.begin(), coarse.begin() + probes, coarse.end());
+
+  // a heap of the (distance, id) pairs of the k closest graphs so far, with the farthest on top
+  std::vector<std::pair<double,int>> best;
+  best.reserve(k);
+  std::vector<double> residual(m_dimension), table(subquantizers * centroids);
+  for (int p = 0; p < probes && k; ++p){
+    const int list = coarse[p].second;
+    const double* centroid = m_coarse_centroids.data() + list * m_dimension;
+    for (int j = 0; j < m_dimension; ++j) residual[j] = q[j] - centroid[j];
+    // the distances of the residual of the query to all centroids of the sub-quantizers
+    for (int m = 0; m < subquantizers; ++m){
+      for (int c = 0; c < centroids; ++c){
+        table[m * centroids + c] = distance(residual.data() + m * size, m_codebooks.data() + (m * centroids + c) * size, size);
+      }
+    }
+    // the approximate distances of the graphs in the list are sums of table entries
+    const uint8_t* code = m_codes[list].data();
+    for (std::size_t i = 0; i < m_ids[list].size(); ++i, code += subquantizers){
+      double d = 0.;
+      for (int m = 0; m < subquantizers; ++m) d += table[m * centroids + code[m]];
+      const std::pair<double,int> candidate(d, m_ids[list][i]);
+      if ((int)best.size() < k){
+        best.push_back(candidate);
+        std::push_heap(best.begin(), best.end());
+      } else if (candidate < best.front()){
+        std::pop_heap(best.begin(), best.end());
+        best.back() = candidate;
+        std::push_heap(best.begin(), best.end());
+      }
+    }
+  }
+
+  std::sort_heap(best.begin(), best.end());
+  for (int i = 0; i < k; ++i){
+    ids(i) = i < (int)best.size() ? best[i].second : -1;
+    distances(i) = i < (int)best.size() ? best[i].first : std::numeric_limits<double>::infinity();
+  }
+}
+
+/**
+ * Finds the graphs most similar to the given probe graph
+ * @param similarity  The similarity function used to re-rank the shortlisted graphs
+ * @param probe  The probe graph of shape (nodes, 2, length)
+ * @param loader  The function that provides the shortlisted graphs of shape (nodes, 2, length) by their identifiers
+ * @param probes  The number of closest lists that are visited
+ * @param shortlist  The number of graphs that are re-ranked; must not be smaller than ids.extent(0)
+ * @param ids  The identifiers of the most similar graphs, ordered by descending score; -1 if less graphs are shortlisted
+ * @param scores  The scores of the most similar graphs, see Similarity::search
+ */
+void bob::ip::gabor::Index::search(const Similarity& similarity, const blitz::Array<double,3>& probe, const GraphLoader& loader, int probes, int shortlist, blitz::Array<int,1>& ids, blitz::Array<double,1>& scores) const{
+  const int k = ids.extent(0);
+  bob::core::array::assertSameShape(scores, ids.shape());
+  if (shortlist < k)
+    throw std::runtime_error((boost::format("Index: the shortlist (%d) must not be smaller than the number of returned graphs (%d)") % shortlist % k).str());
+
+  // the approximate search of the shortlist
+  blitz::Array<double,1> query(m_dimension);
+  features(probe, query);
+  blitz::Array<int,1> shortlist_ids(shortlist);
+  blitz::Array<double,1> shortlist_distances(shortlist);
+  search(query, probes, shortlist_ids, shortlist_distances);
+  int found = 0;
+  while (found < shortlist && shortlist_ids(found) >= 0) ++found;
+
+  // the exact re-ranking of the shortlisted graphs, which are loaded one by one
+  const blitz::Range all = blitz::Range::all();
+  blitz::Array<double,3> p(probe.shape());
+  p = probe;
+  blitz::Array<double,4> candidates(found, probe.extent(0), probe.extent(1), probe.extent(2));
+  for (int i = 0; i < found; ++i){
+    blitz::Array<double,3> candidate = candidates(i, all, all, all);
+    loader(shortlist_ids(i), candidate);
+  }
+  const int count = std::min(k, found);
+  blitz::Array<int,1> indices(count);
+  blitz::Array<double,1> similarities(count);
+  similarity.search(p, candidates, indices, similarities);
+
+  for (int i = 0; i < k; ++i){
+    ids(i) = i < count ? shortlist_ids(indices(i)) : -1;
+    scores(i) = i < count ? similarities(i) : std::numeric_limits<double>::quiet_NaN();
+  }
+}
+
+void bob::ip::gabor::Index::search(const Similarity& similarity, const blitz::Array<double,3>& probe, const blitz::Array<double,4>& gallery, int probes, int shortlist, blitz::Array<int,1>& ids, blitz::Array<double,1>& scores) const{
+  if (gallery.extent(0) != m_size)
+    throw std::runtime_error((boost::format("Index: the gallery contains %d graphs, but %d are stored in the index") % gallery.extent(0) % m_size).str());
+  bob::core::array::assertSameShape(gallery, blitz::shape(m_size, probe.extent(0), probe.extent(1), probe.extent(2)));
+  search(similarity, probe, GraphLoader(
+    [&gallery](int id, blitz::Array<double,3>& graph){
+      graph = gallery(id, blitz::Range::all(), blitz::Range::all(), blitz::Range::all());
+    }
+  ), probes, shortlist, ids, scores);
+}
+
+
+void bob::ip::gabor::Index::save(bob::io::base::HDF5File& file) const{
+  file.set("Dimension", m_dimension);
+  file.set("NumberOfLists", numberOfLists());
+  file.set("NumberOfSubquantizers", numberOfSubquantizers());
+  file.set("NumberOfCentroids", numberOfCentroids());
+  file.set("Trained", m_trained);
+  if (!m_trained) return;
+
+  file.setArray("CoarseCentroids", m_coarse_centroids);
+  file.setArray("Codebooks", m_codebooks);
+  file.set("Size", m_size);
+  if (!m_size) return;
+
+  // the inverted lists are stored one after the other
+  blitz::Array<int,1> list_sizes(numberOfLists()), ids(m_size);
+  blitz::Array<uint8_t,2> codes(m_size, numberOfSubquantizers());
+  int i = 0;
+  for (int l = 0; l < numberOfLists(); ++l){
+    list_sizes(l) = m_ids[l].size();
+    std::copy(m_ids[l].begin(), m_ids[l].end(), ids.data() + i);
+    std::copy(m_codes[l].begin(), m_codes[l].end(), codes.data() + i * numberOfSubquantizers());
+    i += m_ids[l].size();
+  }
+  file.setArray("ListSizes", list_sizes);
+  file.setArray("Ids", ids);
+  file.setArray("Codes", codes);
+}
+
+void bob::ip::gabor::Index::load(bob::io::base::HDF5File& file){
+  m_dimension = file.read<int>("Dimension");
+  const int lists = file.read<int>("NumberOfLists"), subquantizers = file.read<int>("NumberOfSubquantizers"), centroids = file.read<int>("NumberOfCentroids");
+  check(m_dimension, lists, subquantizers, centroids);
+  m_trained = file.read<bool>("Trained");
+  m_size = 0;
+  m_ids.assign(lists, std::vector<int>());
+  m_codes.assign(lists, std::vector<uint8_t>());
+  m_coarse_centroids.resize(lists, m_dimension);
+  m_coarse_centroids = 0.;
+  m_codebooks.resize(subquantizers, centroids, m_dimension / subquantizers);
+  m_codebooks = 0.;
+  if (!m_trained) return;
+
+  blitz::Array<double,2> coarse_centroids = file.readArray<double,2>("CoarseCentroids");
+  blitz::Array<double,3> codebooks = file.readArray<double,3>("Codebooks");
+  bob::core::array::assertSameShape(coarse_centroids, m_coarse_centroids);
+  bob::core::array::assertSameShape(codebooks, m_codebooks);
+  m_coarse_centroids = coarse_centroids;
+  m_codebooks = codebooks;
+  m_size = file.read<int>("Size");
+  if (!m_size) return;
+
+  blitz::Array<int,1> list_sizes = file.readArray<int,1>("ListSizes"), ids = file.readArray<int,1>("Ids");
+  blitz::Array<uint8_t,2> codes = file.readArray<uint8_t,2>("Codes");
+  bob::core::array::assertSameShape(list_sizes, blitz::shape(lists));
+  bob::core::array::assertSameShape(ids, blitz::shape(m_size));
+  bob::core::array::assertSameShape(codes, blitz::shape(m_size, subquantizers));
+  if (blitz::sum(list_sizes) != m_size)
+    throw std::runtime_error((boost::format("Index: the sizes of the lists (%d) do not sum up to the size of the index (%d)") % blitz::sum(list_sizes) % m_size).str());
+  int i = 0;
+  for (int l = 0; l < lists; ++l){
+    m_ids[l].assign(ids.data() + i, ids.data() + i + list_sizes(l));
+    m_codes[l].assign(codes.data() + i * subquantizers, codes.data() + (i + list_sizes(l)) * subquantizers);
+    i += list_sizes(l);
+  }
+}
@@ -9,6 +9,8 @@
 
 
 #include <bob.ip.gabor/Jet.h>
+#include <bob.ip.gabor/Simd.h>
+#include <bob.core/check.h>
 
 #include <numeric>
 
@@ -34,11 +36,7 @@ bob::ip::gabor::Jet::Jet(
   }
 
   blitz::Array<std::complex<double>,1> data = trafo_image(blitz::Range::all(), position[0], position[1]);
-  m_jet(0, blitz::Range::all()) = blitz::abs(data);
-  m_jet(1, blitz::Range::all()) = blitz::arg(data);
-
-  if (normalize)
-    this->normalize();
+  init(data, normalize);
 }
 
 bob::ip::gabor::Jet::Jet(
@@ -47,11 +45,7 @@ bob::ip::gabor::Jet::Jet(
 ):
   m_jet(2, data.extent(0))
 {
-  m_jet(0, blitz::Range::all()) = blitz::abs(data);
-  m_jet(1, blitz::Range::all()) = blitz::arg(data);
-
-  if (normalize)
-    this->normalize();
+  init(data, normalize);
 }
 
 
@@ -93,8 +87,9 @@ void bob::ip::gabor::Jet::init(
   bool normalize
 ){
   m_jet.resize(2, data.extent(0));
-  m_jet(0, blitz::Range::all()) = blitz::abs(data);
-  m_jet(1, blitz::Range::all()) = blitz::arg(data);
+  // the absolute values and phases are computed with the vectorized kernel, directly from the (strided) trafo image
+  const int length = data.extent(0);
+  bob::ip::gabor::Simd::polar(data.data(), data.stride(0), m_jet.data(), m_jet.data() + length, length);
 
   if (normalize)
     this->normalize();
@@ -154,7 +149,7 @@ void bob::ip::gabor::Jet::load(bob::io::base::HDF5File& f){
 
 double bob::ip::gabor::Jet::normalize(){
   blitz::Array<double,1> abs_jet = this->abs();
-  double norm = std::inner_product(abs_jet.begin(), abs_jet.end(), abs_jet.begin(), 0.);
+  double norm = bob::ip::gabor::Simd::dot(abs_jet.data(), abs_jet.data(), abs_jet.extent(0));
   // normalize the absolute parts of the jets
   if (std::abs(norm - 1.) > 1e-8)
     abs_jet /= sqrt(norm);
@@ -172,4 +167,12 @@ double bob::ip::gabor::Jet::normalize(){
 
   }
 
+void bob::ip::gabor::Jet::adopt(blitz::Array<double,2>& jet){
+  if (jet.extent(0) != 2)
+    throw std::runtime_error((boost::format("Jet: the adopted array must have 2 rows, but it has %d") % jet.extent(0)).str());
+  if (!bob::core::array::isCZeroBaseContiguous(jet))
+    throw std::runtime_error("Jet: only C-contiguous arrays can be adopted");
+  m_jet.reference(jet);
+}
+
 
@@ -47,6 +47,8 @@ bob::ip::gabor::JetStatistics::JetStatistics(const std::vector<boost::shared_ptr
     m_varAbs(j) /= jets.size() - 1;
     m_varPhase(j) /= jets.size() - 1;
   }
+
+  prepare();
 }
 
 bob::ip::gabor::JetStatistics::JetStatistics(bob::io::base::HDF5File& hdf5){
@@ -57,8 +59,45 @@ bob::ip::gabor::JetStatistics::JetStatistics(bob::io::base::HDF5File& hdf5){
   if (hdf5.hasGroup("Transform")){
     hdf5.cd("Transform");
     m_gwt.reset(new bob::ip::gabor::Transform(hdf5));
+    // all statistics of a model use the same wavelets
+    m_gwt->shareWavelets(true);
     hdf5.cd("..");
   }
+  prepare();
+}
+
+void bob::ip::gabor::JetStatistics::gwt(boost::shared_ptr<bob::ip::gabor::Transform> gwt){
+  m_gwt = gwt;
+  prepare();
+}
+
+void bob::ip::gabor::JetStatistics::prepare(){
+  // new arrays are allocated, so that copies of these statistics share only the means and variances, which are never modified
+  const int jet_length = m_meanAbs.extent(0);
+  m_invVarAbs.reference(blitz::Array<double,1>(jet_length));
+  m_phaseWeights.reference(blitz::Array<double,1>(jet_length));
+  for (int j = jet_length; j--;){
+    m_invVarAbs(j) = 1. / m_varAbs(j);
+    m_phaseWeights(j) = 1. / (m_varPhase(j) * m_meanAbs(j));
+  }
+
+  // the wavelet frequencies are only cached when they fit to these statistics; disparity() will complain otherwise
+  if (!m_gwt || m_gwt->numberOfWavelets() != jet_length){
+    m_kernels.reference(blitz::Array<double,2>(0, 7));
+    return;
+  }
+  const auto& kernels = m_gwt->waveletFrequencies();
+  m_kernels.reference(blitz::Array<double,2>(jet_length, 7));
+  for (int j = jet_length; j--;){
+    const double kjy = kernels[j][0], kjx = kernels[j][1], inv_var = 1. / m_varPhase(j);
+    m_kernels(j,0) = kjy;
+    m_kernels(j,1) = kjx;
+    m_kernels(j,2) = kjy * kjy * inv_var;
+    m_kernels(j,3) = kjy * kjx * inv_var;
+    m_kernels(j,4) = kjx * kjx * inv_var;
+    m_kernels(j,5) = kjy * inv_var;
+    m_kernels(j,6) = kjx * inv_var;
+  }
 }
 
 bool bob::ip::gabor::JetStatistics::operator == (const JetStatistics& other) const {
@@ -85,37 +124,37 @@ void bob::ip::gabor::JetStatistics::save(bob::io::base::HDF5File& hdf5, bool sav
   }
 }
 
-blitz::TinyVector<double,2> bob::ip::gabor::JetStatistics::disparity(const boost::shared_ptr<bob::ip::gabor::Jet> jet) const{
+blitz::TinyVector<double,2> bob::ip::gabor::JetStatistics::disparity(const bob::ip::gabor::Jet& jet) const{
   if (!m_gwt) throw std::runtime_error("The Gabor wavelet transform class has not been set jet");
-  if (m_gwt->numberOfWavelets() != jet->length())
-    throw std::runtime_error((boost::format("The given Gabor jet is of length %d, but the transform has %d wavelets; forgot to set your custom Transform") % jet->length() % m_gwt->numberOfWavelets()).str());
+  if (m_gwt->numberOfWavelets() != jet.length() || m_kernels.extent(0) != jet.length())
+    throw std::runtime_error((boost::format("The given Gabor jet is of length %d, but the transform has %d wavelets; forgot to set your custom Transform") % jet.length() % m_gwt->numberOfWavelets()).str());
 
-  // compute confidences and phase differences once
-  m_confidences.resize(m_meanAbs.shape());
-  m_phaseDifferences.resize(m_meanPhase.shape());
-  m_confidences = m_meanAbs * jet->abs();
-  m_phaseDifferences = m_meanPhase - jet->phase();
+  // access the absolute values and phases of the jet directly, without creating any (reference counted) slices
+  const blitz::Array<double,2>& data = jet.jet();
+  const double* abs = &data(0,0), * phase = &data(1,0);
+  const int stride = data.stride(1);
 
   double gamma_y_y = 0., gamma_y_x = 0., gamma_x_x = 0., phi_y = 0., phi_x = 0.;
   blitz::TinyVector<double,2> disparity(0., 0.);
-  auto kernels = m_gwt->waveletFrequencies();
 
   // iterate through the Gabor jet **backwards** (from highest scale to lowest scale)
-  for (int j = jet->length()-1, scale = m_gwt->numberOfScales(); scale--;){
+  for (int j = jet.length()-1, scale = m_gwt->numberOfScales(); scale--;){
     for (int direction = m_gwt->numberOfDirections(); direction--; --j){
-      const double kjy = kernels[j][0], kjx = kernels[j][1];
-      const double conf = m_confidences(j), diff = m_phaseDifferences(j), var = m_varPhase(j);
+      // the frequency of the kernel and its products with the inverse phase variance
+      const double* k = &m_kernels(j,0);
+      const double conf = m_meanAbs(j) * abs[j * stride], diff = m_meanPhase(j) - phase[j * stride];
       // totalize Gamma matrix
-      gamma_y_y += conf * kjy * kjy / var;
-      gamma_y_x += conf * kjy * kjx / var;
-      gamma_x_x += conf * kjx * kjx / var;
+      gamma_y_y += conf * k[2];
+      gamma_y_x += conf * k[3];
+      gamma_x_x += conf * k[4];
 
       // totalize phi vector
       // estimate the number of cycles that we are off (using the current estimation of the disparity
-      double n = round((diff - disparity[0] * kjy - disparity[1] * kjx) / (2.*M_PI));
+      double n = round((diff - disparity[0] * k[0] - disparity[1] * k[1]) / (2.*M_PI));
       // totalize corrected phi vector elements
-      phi_y += conf * (diff - n * 2. * M_PI) * kjy / var;
-      phi_x += conf * (diff - n * 2. * M_PI) * kjx / var;
+      const double corrected = conf * (diff - n * 2. * M_PI);
+      phi_y += corrected * k[5];
+      phi_x += corrected * k[6];
     }
 
     // re-calculate disparity as d=\Gamma^{-1}\Phi of the (low frequency) wavelet scales that we used up to now
@@ -127,7 +166,14 @@ blitz::TinyVector<double,2> bob::ip::gabor::JetStatistics::disparity(const boost
   return disparity;
 }
 
-double bob::ip::gabor::JetStatistics::logLikelihood(const boost::shared_ptr<bob::ip::gabor::Jet> jet, bool estimate_phase, const blitz::TinyVector<double,2>& offset) const{
+double bob::ip::gabor::JetStatistics::logLikelihood(const bob::ip::gabor::Jet& jet, bool estimate_phase, const blitz::TinyVector<double,2>& offset) const{
+  if (jet.length() != m_meanAbs.extent(0))
+    throw std::runtime_error((boost::format("The given Gabor jet is of length %d, but the statistics were computed for Gabor jets of length %d") % jet.length() % m_meanAbs.extent(0)).str());
+
+  const blitz::Array<double,2>& data = jet.jet();
+  const double* abs = &data(0,0), * phase = &data(1,0);
+  const int stride = data.stride(1);
+
   double q_phase = 0.;
   double factor = 1.;
   if (estimate_phase){
@@ -139,19 +185,19 @@ double bob::ip::gabor::JetStatistics::logLikelihood(const boost::shared_ptr<bob:
     disp[1] -= offset[1] - (int)offset[1];
 
     // .. and the phase part
-    auto kernels = m_gwt->waveletFrequencies();
-    auto abs = jet->abs(), phase = jet->phase();
-    for (int j = jet->length(); j--;){
-      q_phase += sqr(adjust_phase(phase(j) + kernels[j][0] * disp[0] + kernels[j][1] * disp[1] - m_meanPhase(j))) / m_varPhase(j) * abs(j) / m_meanAbs(j);
+    for (int j = jet.length(); j--;){
+      q_phase += sqr(adjust_phase(phase[j * stride] + m_kernels(j,0) * disp[0] + m_kernels(j,1) * disp[1] - m_meanPhase(j))) * abs[j * stride] * m_phaseWeights(j);
     }
 //    q_phase *= blitz::sum(m_varPhase);
     factor = 2.;
   }
   // compute quality measure
   // .. absolute part
-  blitz::Array<double,1> diff(jet->abs() - m_meanAbs);
-  double q_abs = blitz::sum(diff*diff / m_varAbs);
+  double q_abs = 0.;
+  for (int j = jet.length(); j--;){
+    q_abs += sqr(abs[j * stride] - m_meanAbs(j)) * m_invVarAbs(j);
+  }
 //  double q_abs = blitz::sum(diff*diff / m_varAbs) * blitz::sum(m_varAbs);
 
-  return -(q_abs + q_phase)/(factor*jet->length());
+  return -(q_abs + q_phase)/(factor*jet.length());
 }
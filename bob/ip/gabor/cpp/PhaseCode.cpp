@@ -0,0 +1,130 @@
+/**
+ * @brief C++ implementations of the binary phase codes of Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/PhaseCode.h>
+#include <bob.ip.gabor/Simd.h>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+bob::ip::gabor::PhaseCode::PhaseCode(double magnitude_threshold)
+{
+  magnitudeThreshold(magnitude_threshold);
+}
+
+void bob::ip::gabor::PhaseCode::magnitudeThreshold(double magnitude_threshold){
+  if (!(magnitude_threshold >= 0.))
+    throw std::runtime_error((boost::format("PhaseCode: the magnitude threshold (%g) must not be negative") % magnitude_threshold).str());
+  m_magnitude_threshold = magnitude_threshold;
+}
+
+
+// the bits of wavelet j are the bits 2j (non-negative real part) and 2j+1 (non-negative imaginary part)
+void bob::ip::gabor::PhaseCode::encode(const double* abs, const double* phase, int stride, int length, uint64_t* code, uint64_t* mask) const{
+  std::fill(code, code + words(length), 0);
+  std::fill(mask, mask + words(length), 0);
+  double sum = 0.;
+  if (m_magnitude_threshold > 0.){
+    for (int j = 0; j < length; ++j) sum += abs[j * stride];
+  }
+  const double threshold = m_magnitude_threshold * sum / std::max(length, 1);
+  for (int j = 0; j < length; ++j){
+    const double p = phase[j * stride];
+    const uint64_t bits = (std::abs(p) <= M_PI_2 ? 1 : 0) | (p >= 0. ? 2 : 0);
+    code[j >> 5] |= bits << (2 * j & 63);
+    if (m_magnitude_threshold <= 0. || abs[j * stride] >= threshold) mask[j >> 5] |= uint64_t(3) << (2 * j & 63);
+  }
+}
+
+void bob::ip::gabor::PhaseCode::encode(const std::complex<double>* responses, int stride, int length, uint64_t* code, uint64_t* mask) const{
+  std::fill(code, code + words(length), 0);
+  std::fill(mask, mask + words(length), 0);
+  double sum = 0.;
+  if (m_magnitude_threshold > 0.){
+    for (int j = 0; j < length; ++j) sum += std::sqrt(std::norm(responses[j * stride]));
+  }
+  const double threshold = m_magnitude_threshold * sum / std::max(length, 1);
+  for (int j = 0; j < length; ++j){
+    const std::complex<double>& r = responses[j * stride];
+    const uint64_t bits = (r.real() >= 0. ? 1 : 0) | (r.imag() >= 0. ? 2 : 0);
+    code[j >> 5] |= bits << (2 * j & 63);
+    if (m_magnitude_threshold <= 0. || std::sqrt(std::norm(r)) >= threshold) mask[j >> 5] |= uint64_t(3) << (2 * j & 63);
+  }
+}
+
+void bob::ip::gabor::PhaseCode::encode(const bob::ip::gabor::Jet& jet, blitz::Array<uint64_t,1>& code, blitz::Array<uint64_t,1>& mask) const{
+  bob::core::array::assertSameShape(code, blitz::shape(words(jet.length())));
+  bob::core::array::assertSameShape(mask, code);
+  bob::core::array::assertCZeroBaseContiguous(code);
+  bob::core::array::assertCZeroBaseContiguous(mask);
+  const blitz::Array<double,2>& data = jet.jet();
+  if (!jet.length()) return;
+  encode(&data(0,0), &data(1,0), data.stride(1), jet.length(), code.data(), mask.data());
+}
+
+void bob::ip::gabor::PhaseCode::encode(const blitz::Array<double,3>& jets, blitz::Array<uint64_t,2>& codes, blitz::Array<uint64_t,2>& masks) const{
+  const int nodes = jets.extent(0), length = jets.extent(2), w = words(length);
+  if (jets.extent(0) && jets.extent(1) != 2)
+    throw std::runtime_error((boost::format("PhaseCode: the Gabor jets must have the shape (nodes, 2, length), but the second dimension is %d") % jets.extent(1)).str());
+  bob::core::array::assertSameShape(codes, blitz::shape(nodes, w));
+  bob::core::array::assertSameShape(masks, codes);
+  bob::core::array::assertCZeroBaseContiguous(codes);
+  bob::core::array::assertCZeroBaseContiguous(masks);
+  if (!length) return;
+  for (int n = 0; n < nodes; ++n){
+    encode(&jets(n,0,0), &jets(n,1,0), jets.stride(2), length, codes.data() + n * w, masks.data() + n * w);
+  }
+}
+
+void bob::ip::gabor::PhaseCode::encode(const blitz::Array<double,4>& jets, blitz::Array<uint64_t,3>& codes, blitz::Array<uint64_t,3>& masks) const{
+  const int count = jets.extent(0), nodes = jets.extent(1), length = jets.extent(3), w = words(length);
+  if (jets.extent(1) && jets.extent(2) != 2)
+    throw std::runtime_error((boost::format("PhaseCode: the Gabor jets must have the shape (N, nodes, 2, length), but the third dimension is %d") % jets.extent(2)).str());
+  bob::core::array::assertSameShape(codes, blitz::shape(count, nodes, w));
+  bob::core::array::assertSameShape(masks, codes);
+  bob::core::array::assertCZeroBaseContiguous(codes);
+  bob::core::array::assertCZeroBaseContiguous(masks);
+  if (!length) return;
+  for (int i = 0; i < count; ++i){
+    for (int n = 0; n < nodes; ++n){
+      encode(&jets(i,n,0,0), &jets(i,n,1,0), jets.stride(3), length, codes.data() + (i * nodes + n) * w, masks.data() + (i * nodes + n) * w);
+    }
+  }
+}
+
+void bob::ip::gabor::PhaseCode::encode(const bob::ip::gabor::Graph& graph, const blitz::Array<std::complex<double>,3>& trafo_image, blitz::Array<uint64_t,2>& codes, blitz::Array<uint64_t,2>& masks) const{
+  const int nodes = graph.numberOfNodes(), length = trafo_image.extent(0), w = words(length);
+  bob::core::array::assertSameShape(codes, blitz::shape(nodes, w));
+  bob::core::array::assertSameShape(masks, codes);
+  bob::core::array::assertCZeroBaseContiguous(codes);
+  bob::core::array::assertCZeroBaseContiguous(masks);
+  if (!length) return;
+  for (int n = 0; n < nodes; ++n){
+    const blitz::TinyVector<int,2>& node = graph.nodes()[n];
+    if (node[0] < 0 || node[0] >= trafo_image.extent(1) || node[1] < 0 || node[1] >= trafo_image.extent(2))
+      throw std::runtime_error((boost::format("PhaseCode: the node (%d, %d) is outside of the trafo image of size (%d, %d)") % node[0] % node[1] % trafo_image.extent(1) % trafo_image.extent(2)).str());
+    encode(&trafo_image(0, node[0], node[1]), trafo_image.stride(0), length, codes.data() + n * w, masks.data() + n * w);
+  }
+}
+
+
+double bob::ip::gabor::PhaseCode::similarity(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words){
+  int differences, valid;
+  bob::ip::gabor::Simd::hamming(code1, mask1, code2, mask2, words, &differences, &valid);
+  return valid ? 1. - static_cast<double>(differences) / valid : 0.;
+}
+
+void bob::ip::gabor::PhaseCode::similarities(const blitz::Array<uint64_t,2>& code, const blitz::Array<uint64_t,2>& mask, const blitz::Array<uint64_t,3>& codes, const blitz::Array<uint64_t,3>& masks, blitz::Array<double,1>& similarities){
+  const int count = codes.extent(0), size = code.numElements();
+  bob::core::array::assertSameShape(codes, blitz::shape(count, code.extent(0), code.extent(1)));
+  bob::core::array::assertSameShape(similarities, blitz::shape(count));
+  check(code, mask, code, mask);
+  check(codes, masks, codes, masks);
+  for (int i = 0; i < count; ++i){
+    similarities(i) = similarity(code.data(), mask.data(), codes.data() + i * size, masks.data() + i * size, size);
+  }
+}
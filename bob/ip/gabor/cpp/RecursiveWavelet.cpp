@@ -0,0 +1,261 @@
+/**
+ * @brief C++ implementations of the recursive (IIR) Gabor wavelet filter
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/RecursiveWavelet.h>
+#include <bob.ip.gabor/SpatialWavelet.h>
+#include <bob.ip.gabor/Stats.h>
+#include <boost/format.hpp>
+
+// the number of lines that are filtered simultaneously
+static const int STRIP = 16;
+
+static inline int wrap(int i, int n){
+  i %= n;
+  return i < 0 ? i + n : i;
+}
+
+// The fits of the Gaussian exp(-x^2/2) by sums of exponentials g(x) ~ sum_i (a_i cos(w_i x) + c_i sin(w_i x)) exp(-b_i x) for x >= 0.
+// The fourth-order fit is the one of Deriche; the others minimize the squared deviation on [0, 12].
+struct GaussianFit {
+  int terms;
+  double a[4], b[4], c[4], w[4];
+};
+static const GaussianFit gaussian_fits[3] = {
+  // order 4, maximum deviation 5e-4
+  {2, {1.68, -0.6803}, {1.783, 1.723}, {3.735, -0.2598}, {0.6318, 1.997}},
+  // order 6, maximum deviation 8e-6
+  {3, {3.152713686391618, -2.310960116089456, 0.1582385912036859}, {2.182015980365987, 2.150904414979598, 2.078498408503529}, {7.299531953316713, -0.9153927475074308, -0.04427174014739234}, {0.5265713176369495, 1.616024735812242, 2.856538641327464}},
+  // order 8, maximum deviation 1e-7
+  {4, {-6.021394195973044, 0.9036262361166614, 6.137716244399809, -0.01994838222165730}, {2.496849825162101, 2.453892089233705, 2.516730366335848, 2.377358970935500}, {-2.454141354319307, -0.3106661925017841, 14.50128987846348, 0.02323577665889470}, {1.400512634479381, 2.403686866913081, 0.4608762378676126, 3.569741058383056}}
+};
+
+/**
+ * Generates a recursive filter for the Gabor wavelet with the given parameters.
+ * The Gaussian envelope is approximated by a sum of exponentials, see gaussian_fits.
+ * Each term is implemented as a second-order section, and the sections are applied in parallel, which is numerically stable also for large scales.
+ * @param k  The frequency vector (i.e. the center of the Gaussian in frequency domain)
+ * @param sigma  The standard deviation (i.e. the width of the Gabor wavelet)
+ * @param pow_of_k  The power of \f$ k^x \f$ used as a prefactor of the Gabor wavelet
+ * @param dc_free   Make the Gabor wavelet DC-free?
+ * @param epsilon   The relative value of the Gaussian envelope that defines the warm-up margin of the recursions
+ * @param order     The order of the recursive Gaussian, one of 4, 6 or 8
+ */
+bob::ip::gabor::RecursiveWavelet::RecursiveWavelet(
+  const blitz::TinyVector<double,2>& k,
+  const double sigma,
+  const double pow_of_k,
+  const bool dc_free,
+  const double epsilon,
+  const int order
+)
+: m_k(k),
+  m_margin(bob::ip::gabor::SpatialWavelet::radius(k, sigma, epsilon))
+{
+  if (order != 4 && order != 6 && order != 8){
+    throw std::runtime_error((boost::format("The order %d of the recursive Gabor wavelet is not supported; use 4, 6 or 8") % order).str());
+  }
+  const GaussianFit& fit = gaussian_fits[order / 2 - 2];
+  m_sections = fit.terms;
+
+  double k_square = k[0] * k[0] + k[1] * k[1];
+  m_scale = sigma / sqrt(k_square);
+  m_factor = std::pow(k_square, pow_of_k / 2.);
+  m_dc = dc_free ? exp(-sigma * sigma / 2.) : 0.;
+
+  // the sum of exponentials, written as h(n) = sum_i Re(alpha_i * z_i^n)
+  std::complex<double> alpha[4], z[4];
+  // normalize the filter such that its DC gain is one: h(0) + 2 * sum_{n>0} h(n)
+  double norm = 0.;
+  for (int i = 0; i < m_sections; ++i){
+    alpha[i] = std::complex<double>(fit.a[i], -fit.c[i]);
+    z[i] = std::exp(std::complex<double>(-fit.b[i], fit.w[i]) / m_scale);
+    norm += alpha[i].real() + 2. * std::real(alpha[i] * z[i] / (1. - z[i]));
+  }
+
+  for (int i = 0; i < m_sections; ++i){
+    // the term h_i(n) of this section
+    auto h = [&](int n){
+      return std::real(alpha[i] * std::pow(z[i], n)) / norm;
+    };
+    // the denominator has the poles z_i and z_i^*
+    m_denominator[i][0] = -2. * z[i].real();
+    m_denominator[i][1] = std::norm(z[i]);
+    m_causal[i][0] = h(0);
+    m_causal[i][1] = h(1) + m_denominator[i][0] * h(0);
+    m_anticausal[i][0] = h(1);
+    m_anticausal[i][1] = h(2) + m_denominator[i][0] * h(1);
+  }
+}
+
+/**
+ * Filters count lines of the given length with the Gaussian modulated by the given frequency.
+ * The lines are periodically extended by the margin, the causal and the anti-causal filters of all sections are applied, and their results are added.
+ * Several lines are processed simultaneously, so that the innermost loops can be vectorized.
+ * @param input  The pointer to the first element of the first line
+ * @param output  The pointer to the first element of the first result line; must not overlap with the input
+ * @param length  The number of elements in each line
+ * @param count  The number of lines
+ * @param line_stride  The distance between the first elements of two consecutive lines
+ * @param element_stride  The distance between two consecutive elements of a line
+ * @param frequency  The frequency of the modulation in the direction of the lines
+ */
+void bob::ip::gabor::RecursiveWavelet::filter(
+  const std::complex<double>* input,
+  std::complex<double>* output,
+  int length,
+  int count,
+  int line_stride,
+  int element_stride,
+  double frequency
+) const
+{
+  const int extended = length + 2 * m_margin;
+  // the demodulation e^{-i k x} for the extended line x = -margin, ..., length + margin - 1
+  std::vector<std::complex<double>> demodulation(extended);
+  for (int i = 0; i < extended; ++i){
+    demodulation[i] = std::polar(1., -frequency * (i - m_margin));
+  }
+
+  // buffers with two lines of zeros at both ends, so that the recursions do not need any boundary checks
+  const int size = (extended + 4) * STRIP;
+  std::vector<std::complex<double>> line(size), causal(size), anticausal(size), sum(length * STRIP);
+
+  for (int first = 0; first < count; first += STRIP){
+    const int lines = std::min(STRIP, count - first);
+    std::fill(line.begin(), line.end(), std::complex<double>(0.));
+    std::fill(sum.begin(), sum.end(), std::complex<double>(0.));
+
+    // copy the demodulated and periodically extended lines
+    for (int i = 0; i < extended; ++i){
+      const std::complex<double>* src = input + wrap(i - m_margin, length) * element_stride + first * line_stride;
+      std::complex<double>* dst = &line[(i + 2) * STRIP];
+      for (int l = 0; l < lines; ++l){
+        dst[l] = src[l * line_stride] * demodulation[i];
+      }
+    }
+
+    for (int s = 0; s < m_sections; ++s){
+      const double c0 = m_causal[s][0], c1 = m_causal[s][1], a0 = m_anticausal[s][0], a1 = m_anticausal[s][1], d0 = m_denominator[s][0], d1 = m_denominator[s][1];
+      std::fill(causal.begin(), causal.end(), std::complex<double>(0.));
+      std::fill(anticausal.begin(), anticausal.end(), std::complex<double>(0.));
+
+      // causal filter
+      for (int i = 2; i < extended + 2; ++i){
+        std::complex<double>* y = &causal[i * STRIP];
+        const std::complex<double>* x0 = &line[i * STRIP],* x1 = x0 - STRIP,* y1 = y - STRIP,* y2 = y1 - STRIP;
+        for (int l = 0; l < STRIP; ++l) y[l] = c0 * x0[l] + c1 * x1[l] - d0 * y1[l] - d1 * y2[l];
+      }
+
+      // anti-causal filter
+      for (int i = extended + 1; i >= 2; --i){
+        std::complex<double>* y = &anticausal[i * STRIP];
+        const std::complex<double>* x1 = &line[(i + 1) * STRIP],* x2 = x1 + STRIP,* y1 = y + STRIP,* y2 = y1 + STRIP;
+        for (int l = 0; l < STRIP; ++l) y[l] = a0 * x1[l] + a1 * x2[l] - d0 * y1[l] - d1 * y2[l];
+      }
+
+      // add the central part of both filters
+      for (int x = 0; x < length; ++x){
+        const int i = (x + m_margin + 2) * STRIP;
+        std::complex<double>* dst = &sum[x * STRIP];
+        for (int l = 0; l < STRIP; ++l) dst[l] += causal[i + l] + anticausal[i + l];
+      }
+    }
+
+    // modulate the result back
+    for (int x = 0; x < length; ++x){
+      const std::complex<double> modulation = std::conj(demodulation[x + m_margin]);
+      std::complex<double>* dst = output + x * element_stride + first * line_stride;
+      for (int l = 0; l < lines; ++l){
+        dst[l * line_stride] = sum[x * STRIP + l] * modulation;
+      }
+    }
+  }
+}
+
+/**
+ * Filters the image with the Gaussian modulated by the given frequency, first in horizontal, then in vertical direction.
+ */
+void bob::ip::gabor::RecursiveWavelet::filter(
+  const blitz::Array<std::complex<double>,2>& image,
+  blitz::Array<std::complex<double>,2>& result,
+  const blitz::TinyVector<double,2>& frequency
+) const
+{
+  BOB_IP_GABOR_STATS_TIME(RECURSIVE_FILTER);
+  bob::core::array::assertSameShape(image, result);
+  const int height = image.extent(0), width = image.extent(1);
+
+  // copy image into contiguous memory
+  std::vector<std::complex<double>> input(height * width), rows(height * width), columns(height * width);
+  for (int y = 0, i = 0; y < height; ++y){
+    for (int x = 0; x < width; ++x, ++i){
+      input[i] = image(y,x);
+    }
+  }
+
+  filter(&input[0], &rows[0], width, height, width, 1, frequency[1]);
+  filter(&rows[0], &columns[0], height, width, 1, width, frequency[0]);
+
+  for (int y = 0, i = 0; y < height; ++y){
+    for (int x = 0; x < width; ++x, ++i){
+      result(y,x) = columns[i];
+    }
+  }
+}
+
+/**
+ * Smoothes the given image with the Gaussian envelope of this wavelet.
+ * The result can be used for the DC part of all wavelets of the same scale, see transform().
+ * @param image  The image to smooth
+ * @param smoothed  The smoothed image, must have the same shape as the image
+ */
+void bob::ip::gabor::RecursiveWavelet::smooth(
+  const blitz::Array<std::complex<double>,2>& image,
+  blitz::Array<std::complex<double>,2>& smoothed
+) const
+{
+  filter(image, smoothed, blitz::TinyVector<double,2>(0., 0.));
+}
+
+/**
+ * Performs the approximate convolution of the given image with this Gabor wavelet.
+ * The image is considered to be periodic, so that the result is comparable to the FFT based convolution.
+ * @param image  The image to convolve
+ * @param layer  The convolution result, must have the same shape as the image
+ */
+void bob::ip::gabor::RecursiveWavelet::transform(
+  const blitz::Array<std::complex<double>,2>& image,
+  blitz::Array<std::complex<double>,2>& layer
+) const
+{
+  if (m_dc){
+    blitz::Array<std::complex<double>,2> smoothed(image.shape());
+    smooth(image, smoothed);
+    transform(image, smoothed, layer);
+  } else {
+    transform(image, image, layer);
+  }
+}
+
+/**
+ * Performs the approximate convolution of the given image with this Gabor wavelet.
+ * @param image  The image to convolve
+ * @param smoothed  The result of smooth() for the given image; only used if the wavelet is DC-free
+ * @param layer  The convolution result, must have the same shape as the image
+ */
+void bob::ip::gabor::RecursiveWavelet::transform(
+  const blitz::Array<std::complex<double>,2>& image,
+  const blitz::Array<std::complex<double>,2>& smoothed,
+  blitz::Array<std::complex<double>,2>& layer
+) const
+{
+  filter(image, layer, m_k);
+  if (m_dc){
+    bob::core::array::assertSameShape(smoothed, layer);
+    layer -= m_dc * smoothed;
+  }
+  layer *= m_factor;
+}
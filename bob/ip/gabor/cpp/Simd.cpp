@@ -0,0 +1,715 @@
+/**
+ * @brief C++ implementations of the vectorized kernels and their runtime dispatch
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/Simd.h>
+
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BOB_IP_GABOR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Scalar kernels  ///////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double dot_scalar(const double* a, const double* b, int size){
+  double sum = 0.;
+  for (int i = 0; i < size; ++i) sum += a[i] * b[i];
+  return sum;
+}
+
+static double canberra_scalar(const double* a, const double* b, int size){
+  double sum = 0.;
+  for (int i = 0; i < size; ++i) sum += 1. - std::abs(a[i] - b[i]) / (a[i] + b[i]);
+  return sum;
+}
+
+static void abs_scalar(const std::complex<double>* input, int stride, double* output, int size){
+  for (int i = 0; i < size; ++i, input += stride) output[i] = std::sqrt(input->real() * input->real() + input->imag() * input->imag());
+}
+
+static void multiply_scalar(const std::complex<double>* input, const double* weights, std::complex<double>* output, int size){
+  for (int i = 0; i < size; ++i) output[i] = input[i] * weights[i];
+}
+
+// Estimates the disparity of each pair independently, in the same order of operations as bob::ip::gabor::Similarity;
+// the values of wavelet j for pair p are at index j * stride + p
+static void disparity_scalar(const double* k, int scales, int directions, const double* confidences, const double* phase_differences, int stride, int count, double* disparity_y, double* disparity_x){
+  for (int p = 0; p < count; ++p){
+    double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0., d_y = 0., d_x = 0.;
+    for (int level = scales-1; level >= 0; --level){
+      for (int direction = directions-1; direction >= 0; --direction){
+        const int j = level * directions + direction;
+        const double kjy = k[2*j], kjx = k[2*j+1], conf = confidences[j * stride + p], diff = phase_differences[j * stride + p];
+        gamma_x_x += kjx * kjx * conf;
+        gamma_x_y += kjx * kjy * conf;
+        gamma_y_y += kjy * kjy * conf;
+        const double nL = round((diff - d_x * kjx - d_y * kjy) / (2.*M_PI));
+        phi_x += (diff - nL * 2. * M_PI) * conf * kjx;
+        phi_y += (diff - nL * 2. * M_PI) * conf * kjy;
+      }
+      const double gamma_det = gamma_x_x * gamma_y_y - gamma_x_y * gamma_x_y;
+      d_x = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
+      d_y = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
+    }
+    disparity_y[p] = d_y;
+    disparity_x[p] = d_x;
+  }
+}
+
+// The largest double below 0.5; adding it with the sign of x before truncating rounds half away from zero, like round(x)
+static const double ROUND_HALF = 0.49999999999999994;
+
+// The coefficients of the odd minimax polynomial that approximates atan(a) for a in [0,1];
+// its maximum absolute error is 1.67e-6 rad, see bob::ip::gabor::Simd::approximatePhaseError
+static const double ATAN[] = {0.99997721907, -0.332622827476, 0.193540373052, -0.116426473654, 0.0526473418909, -0.0117191318242};
+
+// The approximate atan2: the polynomial is evaluated for min(|x|,|y|) / max(|x|,|y|), and the result is mirrored into the according octant
+static double atan2_fast(double y, double x){
+  const double ax = std::abs(x), ay = std::abs(y);
+  const double a = std::min(ax, ay) / std::max(std::max(ax, ay), DBL_MIN), s = a * a;
+  double r = a * (ATAN[0] + s * (ATAN[1] + s * (ATAN[2] + s * (ATAN[3] + s * (ATAN[4] + s * ATAN[5])))));
+  if (ay > ax) r = M_PI_2 - r;
+  if (x < 0.) r = M_PI - r;
+  return std::copysign(r, y);
+}
+
+static void phase_scalar(const std::complex<double>* input, int stride, double* output, int size){
+  for (int i = 0; i < size; ++i, input += stride) output[i] = atan2_fast(input->imag(), input->real());
+}
+
+// the number of set bits of x
+static int popcount(uint64_t x){
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static void hamming_scalar(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words, int* differences, int* valid){
+  int d = 0, v = 0;
+  for (int i = 0; i < words; ++i){
+    const uint64_t mask = mask1[i] & mask2[i];
+    d += popcount((code1[i] ^ code2[i]) & mask);
+    v += popcount(mask);
+  }
+  *differences = d;
+  *valid = v;
+}
+
+#ifdef BOB_IP_GABOR_X86_KERNELS
+// the same kernel with the popcnt instruction, which the compiler does not use without -mpopcnt
+__attribute__((target("popcnt")))
+static void hamming_popcnt(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words, int* differences, int* valid){
+  int d = 0, v = 0;
+  for (int i = 0; i < words; ++i){
+    const uint64_t mask = mask1[i] & mask2[i];
+    d += __builtin_popcountll((code1[i] ^ code2[i]) & mask);
+    v += __builtin_popcountll(mask);
+  }
+  *differences = d;
+  *valid = v;
+}
+
+static bool popcnt_available(){
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("popcnt");
+}
+#endif
+
+// counts the bits word by word, which is used on the scalar level and for the remaining words of the vectorized kernels
+static void (*const hamming_words)(const uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*, int, int*, int*) =
+#ifdef BOB_IP_GABOR_X86_KERNELS
+  popcnt_available() ? hamming_popcnt : hamming_scalar;
+#else
+  hamming_scalar;
+#endif
+
+
+#ifdef BOB_IP_GABOR_X86_KERNELS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  SSE2 kernels  /////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("sse2")))
+static double hsum(__m128d x){
+  return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+}
+
+__attribute__((target("sse2")))
+static double dot_sse2(const double* a, const double* b, int size){
+  __m128d sum = _mm_setzero_pd();
+  int i = 0;
+  for (; i + 2 <= size; i += 2) sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+  return hsum(sum) + dot_scalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("sse2")))
+static double canberra_sse2(const double* a, const double* b, int size){
+  const __m128d sign = _mm_set1_pd(-0.);
+  __m128d sum = _mm_setzero_pd();
+  int i = 0;
+  for (; i + 2 <= size; i += 2){
+    __m128d x = _mm_loadu_pd(a + i), y = _mm_loadu_pd(b + i);
+    sum = _mm_add_pd(sum, _mm_div_pd(_mm_andnot_pd(sign, _mm_sub_pd(x, y)), _mm_add_pd(x, y)));
+  }
+  return i - hsum(sum) + canberra_scalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("sse2")))
+static void abs_sse2(const std::complex<double>* input, int stride, double* output, int size){
+  const double* in = reinterpret_cast<const double*>(input);
+  int i = 0;
+  for (; i + 2 <= size; i += 2, in += 4 * stride){
+    // one complex number per register
+    __m128d c0 = _mm_loadu_pd(in), c1 = _mm_loadu_pd(in + 2 * stride);
+    c0 = _mm_mul_pd(c0, c0);
+    c1 = _mm_mul_pd(c1, c1);
+    // (re0 + im0, re1 + im1)
+    __m128d s = _mm_add_pd(_mm_unpacklo_pd(c0, c1), _mm_unpackhi_pd(c0, c1));
+    _mm_storeu_pd(output + i, _mm_sqrt_pd(s));
+  }
+  abs_scalar(reinterpret_cast<const std::complex<double>*>(in), stride, output + i, size - i);
+}
+
+__attribute__((target("sse2")))
+static __m128d atan2_sse2(__m128d y, __m128d x){
+  const __m128d sign = _mm_set1_pd(-0.);
+  const __m128d ax = _mm_andnot_pd(sign, x), ay = _mm_andnot_pd(sign, y);
+  const __m128d a = _mm_div_pd(_mm_min_pd(ax, ay), _mm_max_pd(_mm_max_pd(ax, ay), _mm_set1_pd(DBL_MIN))), s = _mm_mul_pd(a, a);
+  __m128d r = _mm_set1_pd(ATAN[5]);
+  for (int k = 4; k >= 0; --k) r = _mm_add_pd(_mm_mul_pd(r, s), _mm_set1_pd(ATAN[k]));
+  r = _mm_mul_pd(r, a);
+  // select without SSE4.1 blends
+  __m128d mask = _mm_cmpgt_pd(ay, ax);
+  r = _mm_or_pd(_mm_and_pd(mask, _mm_sub_pd(_mm_set1_pd(M_PI_2), r)), _mm_andnot_pd(mask, r));
+  mask = _mm_cmplt_pd(x, _mm_setzero_pd());
+  r = _mm_or_pd(_mm_and_pd(mask, _mm_sub_pd(_mm_set1_pd(M_PI), r)), _mm_andnot_pd(mask, r));
+  return _mm_or_pd(r, _mm_and_pd(sign, y));
+}
+
+__attribute__((target("sse2")))
+static void phase_sse2(const std::complex<double>* input, int stride, double* output, int size){
+  const double* in = reinterpret_cast<const double*>(input);
+  int i = 0;
+  for (; i + 2 <= size; i += 2, in += 4 * stride){
+    __m128d c0 = _mm_loadu_pd(in), c1 = _mm_loadu_pd(in + 2 * stride);
+    _mm_storeu_pd(output + i, atan2_sse2(_mm_unpackhi_pd(c0, c1), _mm_unpacklo_pd(c0, c1)));
+  }
+  phase_scalar(reinterpret_cast<const std::complex<double>*>(in), stride, output + i, size - i);
+}
+
+__attribute__((target("sse2")))
+static void multiply_sse2(const std::complex<double>* input, const double* weights, std::complex<double>* output, int size){
+  const double* in = reinterpret_cast<const double*>(input);
+  double* out = reinterpret_cast<double*>(output);
+  for (int i = 0; i < size; ++i){
+    _mm_storeu_pd(out + 2 * i, _mm_mul_pd(_mm_loadu_pd(in + 2 * i), _mm_set1_pd(weights[i])));
+  }
+}
+
+
+// rounds both values with round(), which keeps NaN
+__attribute__((target("sse2")))
+static __m128d round_sse2(__m128d x){
+  double values[2];
+  _mm_storeu_pd(values, x);
+  return _mm_set_pd(round(values[1]), round(values[0]));
+}
+
+__attribute__((target("sse2")))
+static void disparity_sse2(const double* k, int scales, int directions, const double* confidences, const double* phase_differences, int stride, int count, double* disparity_y, double* disparity_x){
+  const __m128d zero = _mm_setzero_pd(), sign = _mm_set1_pd(-0.), half = _mm_set1_pd(ROUND_HALF), two_pi = _mm_set1_pd(2.*M_PI), int_range = _mm_set1_pd(2147483648.);
+  int p = 0;
+  for (; p + 2 <= count; p += 2){
+    __m128d gamma_x_x = zero, gamma_x_y = zero, gamma_y_y = zero, phi_x = zero, phi_y = zero, d_y = zero, d_x = zero;
+    for (int level = scales-1; level >= 0; --level){
+      for (int direction = directions-1; direction >= 0; --direction){
+        const int j = level * directions + direction;
+        const __m128d kjy = _mm_set1_pd(k[2*j]), kjx = _mm_set1_pd(k[2*j+1]);
+        const __m128d conf = _mm_loadu_pd(confidences + j * stride + p), diff = _mm_loadu_pd(phase_differences + j * stride + p);
+        gamma_x_x = _mm_add_pd(gamma_x_x, _mm_mul_pd(_mm_mul_pd(kjx, kjx), conf));
+        gamma_x_y = _mm_add_pd(gamma_x_y, _mm_mul_pd(_mm_mul_pd(kjx, kjy), conf));
+        gamma_y_y = _mm_add_pd(gamma_y_y, _mm_mul_pd(_mm_mul_pd(kjy, kjy), conf));
+        // SSE2 has no rounding instruction, so the numbers of cycles are truncated via int32
+        const __m128d x = _mm_div_pd(_mm_sub_pd(_mm_sub_pd(diff, _mm_mul_pd(d_x, kjx)), _mm_mul_pd(d_y, kjy)), two_pi);
+        const __m128d t = _mm_add_pd(x, _mm_or_pd(_mm_and_pd(x, sign), half));
+        __m128d nL = _mm_cvtepi32_pd(_mm_cvttpd_epi32(t));
+        // the conversion yields INT_MIN for NaN (e.g., after a scale without confidence) and outside of the int32 range, where round() is used instead
+        if (_mm_movemask_pd(_mm_cmpnlt_pd(_mm_andnot_pd(sign, t), int_range))) nL = round_sse2(x);
+        const __m128d corrected = _mm_mul_pd(_mm_sub_pd(diff, _mm_mul_pd(nL, two_pi)), conf);
+        phi_x = _mm_add_pd(phi_x, _mm_mul_pd(corrected, kjx));
+        phi_y = _mm_add_pd(phi_y, _mm_mul_pd(corrected, kjy));
+      }
+      const __m128d gamma_det = _mm_sub_pd(_mm_mul_pd(gamma_x_x, gamma_y_y), _mm_mul_pd(gamma_x_y, gamma_x_y));
+      d_x = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(gamma_y_y, phi_x), _mm_mul_pd(gamma_x_y, phi_y)), gamma_det);
+      d_y = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(gamma_x_x, phi_y), _mm_mul_pd(gamma_x_y, phi_x)), gamma_det);
+    }
+    _mm_storeu_pd(disparity_y + p, d_y);
+    _mm_storeu_pd(disparity_x + p, d_x);
+  }
+  disparity_scalar(k, scales, directions, confidences + p, phase_differences + p, stride, count - p, disparity_y + p, disparity_x + p);
+}
+
+// the number of set bits in each byte of x
+__attribute__((target("sse2")))
+static __m128i popcount_sse2(__m128i x){
+  x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi64(x, 1), _mm_set1_epi8(0x55)));
+  x = _mm_add_epi8(_mm_and_si128(x, _mm_set1_epi8(0x33)), _mm_and_si128(_mm_srli_epi64(x, 2), _mm_set1_epi8(0x33)));
+  return _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi64(x, 4)), _mm_set1_epi8(0x0f));
+}
+
+__attribute__((target("sse2")))
+static void hamming_sse2(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words, int* differences, int* valid){
+  // the byte counts are summed into two 64 bit integers with _mm_sad_epu8
+  const __m128i zero = _mm_setzero_si128();
+  __m128i d = zero, v = zero;
+  int i = 0;
+  for (; i + 2 <= words; i += 2){
+    const __m128i mask = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask1 + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask2 + i)));
+    const __m128i diff = _mm_and_si128(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(code1 + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(code2 + i))), mask);
+    d = _mm_add_epi64(d, _mm_sad_epu8(popcount_sse2(diff), zero));
+    v = _mm_add_epi64(v, _mm_sad_epu8(popcount_sse2(mask), zero));
+  }
+  uint64_t sums[4];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), d);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + 2), v);
+  hamming_words(code1 + i, mask1 + i, code2 + i, mask2 + i, words - i, differences, valid);
+  *differences += static_cast<int>(sums[0] + sums[1]);
+  *valid += static_cast<int>(sums[2] + sums[3]);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  AVX2 kernels  /////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("avx2,fma")))
+static double hsum(__m256d x){
+  __m128d s = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2,fma")))
+static double dot_avx2(const double* a, const double* b, int size){
+  __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= size; i += 8){
+    sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), sum0);
+    sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), sum1);
+  }
+  for (; i + 4 <= size; i += 4){
+    sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), sum0);
+  }
+  return hsum(_mm256_add_pd(sum0, sum1)) + dot_scalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx2,fma")))
+static double canberra_avx2(const double* a, const double* b, int size){
+  const __m256d sign = _mm256_set1_pd(-0.);
+  __m256d sum = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= size; i += 4){
+    __m256d x = _mm256_loadu_pd(a + i), y = _mm256_loadu_pd(b + i);
+    sum = _mm256_add_pd(sum, _mm256_div_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(x, y)), _mm256_add_pd(x, y)));
+  }
+  return i - hsum(sum) + canberra_scalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void abs_avx2(const std::complex<double>* input, int stride, double* output, int size){
+  const double* in = reinterpret_cast<const double*>(input);
+  int i = 0;
+  for (; i + 4 <= size; i += 4, in += 8 * stride){
+    // two complex numbers per register
+    __m256d c01 = _mm256_set_m128d(_mm_loadu_pd(in + 2 * stride), _mm_loadu_pd(in));
+    __m256d c23 = _mm256_set_m128d(_mm_loadu_pd(in + 6 * stride), _mm_loadu_pd(in + 4 * stride));
+    // (|c0|^2, |c2|^2, |c1|^2, |c3|^2) -> (|c0|^2, |c1|^2, |c2|^2, |c3|^2)
+    __m256d s = _mm256_hadd_pd(_mm256_mul_pd(c01, c01), _mm256_mul_pd(c23, c23));
+    s = _mm256_permute4x64_pd(s, 0xD8);
+    _mm256_storeu_pd(output + i, _mm256_sqrt_pd(s));
+  }
+  abs_sse2(reinterpret_cast<const std::complex<double>*>(in), stride, output + i, size - i);
+}
+
+__attribute__((target("avx2,fma")))
+static __m256d atan2_avx2(__m256d y, __m256d x){
+  const __m256d sign = _mm256_set1_pd(-0.);
+  const __m256d ax = _mm256_andnot_pd(sign, x), ay = _mm256_andnot_pd(sign, y);
+  const __m256d a = _mm256_div_pd(_mm256_min_pd(ax, ay), _mm256_max_pd(_mm256_max_pd(ax, ay), _mm256_set1_pd(DBL_MIN))), s = _mm256_mul_pd(a, a);
+  __m256d r = _mm256_set1_pd(ATAN[5]);
+  for (int k = 4; k >= 0; --k) r = _mm256_fmadd_pd(r, s, _mm256_set1_pd(ATAN[k]));
+  r = _mm256_mul_pd(r, a);
+  r = _mm256_blendv_pd(r, _mm256_sub_pd(_mm256_set1_pd(M_PI_2), r), _mm256_cmp_pd(ay, ax, _CMP_GT_OQ));
+  r = _mm256_blendv_pd(r, _mm256_sub_pd(_mm256_set1_pd(M_PI), r), _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_LT_OQ));
+  return _mm256_or_pd(r, _mm256_and_pd(sign, y));
+}
+
+__attribute__((target("avx2,fma")))
+static void phase_avx2(const std::complex<double>* input, int stride, double* output, int size){
+  const double* in = reinterpret_cast<const double*>(input);
+  int i = 0;
+  for (; i + 4 <= size; i += 4, in += 8 * stride){
+    __m256d c01 = _mm256_set_m128d(_mm_loadu_pd(in + 2 * stride), _mm_loadu_pd(in));
+    __m256d c23 = _mm256_set_m128d(_mm_loadu_pd(in + 6 * stride), _mm_loadu_pd(in + 4 * stride));
+    // the phases are computed in the order (c0, c2, c1, c3)
+    __m256d r = atan2_avx2(_mm256_unpackhi_pd(c01, c23), _mm256_unpacklo_pd(c01, c23));
+    _mm256_storeu_pd(output + i, _mm256_permute4x64_pd(r, 0xD8));
+  }
+  phase_sse2(reinterpret_cast<const std::complex<double>*>(in), stride, output + i, size - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void multiply_avx2(const std::complex<double>* input, const double* weights, std::complex<double>* output, int size){
+  const double* in = reinterpret_cast<const double*>(input);
+  double* out = reinterpret_cast<double*>(output);
+  int i = 0;
+  for (; i + 2 <= size; i += 2){
+    // (w0, w0, w1, w1)
+    __m256d w = _mm256_permute4x64_pd(_mm256_castpd128_pd256(_mm_loadu_pd(weights + i)), 0x50);
+    _mm256_storeu_pd(out + 2 * i, _mm256_mul_pd(_mm256_loadu_pd(in + 2 * i), w));
+  }
+  multiply_scalar(input + i, weights + i, output + i, size - i);
+}
+
+
+__attribute__((target("avx2")))
+static void disparity_avx2(const double* k, int scales, int directions, const double* confidences, const double* phase_differences, int stride, int count, double* disparity_y, double* disparity_x){
+  const __m256d zero = _mm256_setzero_pd(), sign = _mm256_set1_pd(-0.), half = _mm256_set1_pd(ROUND_HALF), two_pi = _mm256_set1_pd(2.*M_PI);
+  int p = 0;
+  for (; p + 4 <= count; p += 4){
+    __m256d gamma_x_x = zero, gamma_x_y = zero, gamma_y_y = zero, phi_x = zero, phi_y = zero, d_y = zero, d_x = zero;
+    for (int level = scales-1; level >= 0; --level){
+      for (int direction = directions-1; direction >= 0; --direction){
+        const int j = level * directions + direction;
+        const __m256d kjy = _mm256_set1_pd(k[2*j]), kjx = _mm256_set1_pd(k[2*j+1]);
+        const __m256d conf = _mm256_loadu_pd(confidences + j * stride + p), diff = _mm256_loadu_pd(phase_differences + j * stride + p);
+        // no fused multiply-adds are used, so that the results are identical to the scalar kernel
+        gamma_x_x = _mm256_add_pd(gamma_x_x, _mm256_mul_pd(_mm256_mul_pd(kjx, kjx), conf));
+        gamma_x_y = _mm256_add_pd(gamma_x_y, _mm256_mul_pd(_mm256_mul_pd(kjx, kjy), conf));
+        gamma_y_y = _mm256_add_pd(gamma_y_y, _mm256_mul_pd(_mm256_mul_pd(kjy, kjy), conf));
+        const __m256d x = _mm256_div_pd(_mm256_sub_pd(_mm256_sub_pd(diff, _mm256_mul_pd(d_x, kjx)), _mm256_mul_pd(d_y, kjy)), two_pi);
+        const __m256d nL = _mm256_round_pd(_mm256_add_pd(x, _mm256_or_pd(_mm256_and_pd(x, sign), half)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        const __m256d corrected = _mm256_mul_pd(_mm256_sub_pd(diff, _mm256_mul_pd(nL, two_pi)), conf);
+        phi_x = _mm256_add_pd(phi_x, _mm256_mul_pd(corrected, kjx));
+        phi_y = _mm256_add_pd(phi_y, _mm256_mul_pd(corrected, kjy));
+      }
+      const __m256d gamma_det = _mm256_sub_pd(_mm256_mul_pd(gamma_x_x, gamma_y_y), _mm256_mul_pd(gamma_x_y, gamma_x_y));
+      d_x = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(gamma_y_y, phi_x), _mm256_mul_pd(gamma_x_y, phi_y)), gamma_det);
+      d_y = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(gamma_x_x, phi_y), _mm256_mul_pd(gamma_x_y, phi_x)), gamma_det);
+    }
+    _mm256_storeu_pd(disparity_y + p, d_y);
+    _mm256_storeu_pd(disparity_x + p, d_x);
+  }
+  disparity_sse2(k, scales, directions, confidences + p, phase_differences + p, stride, count - p, disparity_y + p, disparity_x + p);
+}
+
+// the number of set bits in each byte of x, using a lookup table of the nibbles
+__attribute__((target("avx2")))
+static __m256i popcount_avx2(__m256i x){
+  const __m256i table = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4), low = _mm256_set1_epi8(0x0f);
+  return _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, low)), _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+}
+
+__attribute__((target("avx2")))
+static void hamming_avx2(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words, int* differences, int* valid){
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i d = zero, v = zero;
+  int i = 0;
+  for (; i + 4 <= words; i += 4){
+    const __m256i mask = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask1 + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask2 + i)));
+    const __m256i diff = _mm256_and_si256(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(code1 + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(code2 + i))), mask);
+    d = _mm256_add_epi64(d, _mm256_sad_epu8(popcount_avx2(diff), zero));
+    v = _mm256_add_epi64(v, _mm256_sad_epu8(popcount_avx2(mask), zero));
+  }
+  uint64_t sums[8];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums), d);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + 4), v);
+  hamming_sse2(code1 + i, mask1 + i, code2 + i, mask2 + i, words - i, differences, valid);
+  *differences += static_cast<int>(sums[0] + sums[1] + sums[2] + sums[3]);
+  *valid += static_cast<int>(sums[4] + sums[5] + sums[6] + sums[7]);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  AVX-512 kernels  //////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// the AVX-512 intrinsics of GCC 12 pass a self-initialized _mm512_undefined_pd() as the unused source of their masked builtins,
+// which triggers (false) uninitialized warnings at every use
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f,avx2,fma")))
+static double hsum(__m512d x){
+  return hsum(_mm256_add_pd(_mm512_castpd512_pd256(x), _mm512_extractf64x4_pd(x, 1)));
+}
+
+__attribute__((target("avx512f,avx2,fma")))
+static double dot_avx512(const double* a, const double* b, int size){
+  __m512d sum = _mm512_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= size; i += 8){
+    sum = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), sum);
+  }
+  return hsum(sum) + dot_avx2(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx512f,avx2,fma")))
+static double canberra_avx512(const double* a, const double* b, int size){
+  __m512d sum = _mm512_setzero_pd();
+  int i = 0;
+  for (; i + 8 <= size; i += 8){
+    __m512d x = _mm512_loadu_pd(a + i), y = _mm512_loadu_pd(b + i);
+    sum = _mm512_add_pd(sum, _mm512_div_pd(_mm512_abs_pd(_mm512_sub_pd(x, y)), _mm512_add_pd(x, y)));
+  }
+  return i - hsum(sum) + canberra_avx2(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx512f,avx2,fma")))
+static void abs_avx512(const std::complex<double>* input, int stride, double* output, int size){
+  if (stride != 1){
+    // the strided loads are the bottleneck, which are not faster with wider registers
+    abs_avx2(input, stride, output, size);
+    return;
+  }
+  const double* in = reinterpret_cast<const double*>(input);
+  const __m512i even = _mm512_set_epi64(6, 4, 2, 0, 6, 4, 2, 0);
+  int i = 0;
+  for (; i + 4 <= size; i += 4){
+    __m512d c = _mm512_loadu_pd(in + 2 * i);
+    c = _mm512_mul_pd(c, c);
+    // add the squared imaginary parts to the squared real parts, and collect the sums in the lower half
+    c = _mm512_add_pd(c, _mm512_permute_pd(c, 0x55));
+    c = _mm512_permutexvar_pd(even, c);
+    _mm256_storeu_pd(output + i, _mm256_sqrt_pd(_mm512_castpd512_pd256(c)));
+  }
+  abs_avx2(input + i, stride, output + i, size - i);
+}
+
+__attribute__((target("avx512f,avx2,fma")))
+static void phase_avx512(const std::complex<double>* input, int stride, double* output, int size){
+  if (stride != 1){
+    phase_avx2(input, stride, output, size);
+    return;
+  }
+  const double* in = reinterpret_cast<const double*>(input);
+  const __m512i real = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0), imag = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+  const __m512i sign = _mm512_set1_epi64(0x8000000000000000LL);
+  int i = 0;
+  for (; i + 8 <= size; i += 8){
+    __m512d c0 = _mm512_loadu_pd(in + 2 * i), c1 = _mm512_loadu_pd(in + 2 * i + 8);
+    __m512d x = _mm512_permutex2var_pd(c0, real, c1), y = _mm512_permutex2var_pd(c0, imag, c1);
+    __m512d ax = _mm512_abs_pd(x), ay = _mm512_abs_pd(y);
+    __m512d a = _mm512_div_pd(_mm512_min_pd(ax, ay), _mm512_max_pd(_mm512_max_pd(ax, ay), _mm512_set1_pd(DBL_MIN))), s = _mm512_mul_pd(a, a);
+    __m512d r = _mm512_set1_pd(ATAN[5]);
+    for (int k = 4; k >= 0; --k) r = _mm512_fmadd_pd(r, s, _mm512_set1_pd(ATAN[k]));
+    r = _mm512_mul_pd(r, a);
+    r = _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(ay, ax, _CMP_GT_OQ), _mm512_set1_pd(M_PI_2), r);
+    r = _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_LT_OQ), _mm512_set1_pd(M_PI), r);
+    // the logical operations on doubles require AVX512DQ, so the sign is copied with integer operations
+    r = _mm512_castsi512_pd(_mm512_or_epi64(_mm512_castpd_si512(r), _mm512_and_epi64(_mm512_castpd_si512(y), sign)));
+    _mm512_storeu_pd(output + i, r);
+  }
+  phase_avx2(input + i, stride, output + i, size - i);
+}
+
+__attribute__((target("avx512f,avx2,fma")))
+static void multiply_avx512(const std::complex<double>* input, const double* weights, std::complex<double>* output, int size){
+  const double* in = reinterpret_cast<const double*>(input);
+  double* out = reinterpret_cast<double*>(output);
+  const __m512i duplicate = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+  int i = 0;
+  for (; i + 4 <= size; i += 4){
+    // (w0, w0, w1, w1, w2, w2, w3, w3)
+    __m512d w = _mm512_permutexvar_pd(duplicate, _mm512_castpd256_pd512(_mm256_loadu_pd(weights + i)));
+    _mm512_storeu_pd(out + 2 * i, _mm512_mul_pd(_mm512_loadu_pd(in + 2 * i), w));
+  }
+  multiply_avx2(input + i, weights + i, output + i, size - i);
+}
+
+__attribute__((target("avx512f,avx2,fma"), optimize("fp-contract=off")))
+static void disparity_avx512(const double* k, int scales, int directions, const double* confidences, const double* phase_differences, int stride, int count, double* disparity_y, double* disparity_x){
+  const __m512d zero = _mm512_setzero_pd(), half = _mm512_set1_pd(ROUND_HALF), two_pi = _mm512_set1_pd(2.*M_PI);
+  const __m512i sign = _mm512_set1_epi64(0x8000000000000000LL);
+  int p = 0;
+  for (; p + 8 <= count; p += 8){
+    __m512d gamma_x_x = zero, gamma_x_y = zero, gamma_y_y = zero, phi_x = zero, phi_y = zero, d_y = zero, d_x = zero;
+    for (int level = scales-1; level >= 0; --level){
+      for (int direction = directions-1; direction >= 0; --direction){
+        const int j = level * directions + direction;
+        const __m512d kjy = _mm512_set1_pd(k[2*j]), kjx = _mm512_set1_pd(k[2*j+1]);
+        const __m512d conf = _mm512_loadu_pd(confidences + j * stride + p), diff = _mm512_loadu_pd(phase_differences + j * stride + p);
+        gamma_x_x = _mm512_add_pd(gamma_x_x, _mm512_mul_pd(_mm512_mul_pd(kjx, kjx), conf));
+        gamma_x_y = _mm512_add_pd(gamma_x_y, _mm512_mul_pd(_mm512_mul_pd(kjx, kjy), conf));
+        gamma_y_y = _mm512_add_pd(gamma_y_y, _mm512_mul_pd(_mm512_mul_pd(kjy, kjy), conf));
+        const __m512d x = _mm512_div_pd(_mm512_sub_pd(_mm512_sub_pd(diff, _mm512_mul_pd(d_x, kjx)), _mm512_mul_pd(d_y, kjy)), two_pi);
+        // AVX-512F has no floating point logic; the sign is transferred with integer operations
+        const __m512d signed_half = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(_mm512_castpd_si512(x), sign), _mm512_castpd_si512(half)));
+        const __m512d nL = _mm512_roundscale_pd(_mm512_add_pd(x, signed_half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        const __m512d corrected = _mm512_mul_pd(_mm512_sub_pd(diff, _mm512_mul_pd(nL, two_pi)), conf);
+        phi_x = _mm512_add_pd(phi_x, _mm512_mul_pd(corrected, kjx));
+        phi_y = _mm512_add_pd(phi_y, _mm512_mul_pd(corrected, kjy));
+      }
+      const __m512d gamma_det = _mm512_sub_pd(_mm512_mul_pd(gamma_x_x, gamma_y_y), _mm512_mul_pd(gamma_x_y, gamma_x_y));
+      d_x = _mm512_div_pd(_mm512_sub_pd(_mm512_mul_pd(gamma_y_y, phi_x), _mm512_mul_pd(gamma_x_y, phi_y)), gamma_det);
+      d_y = _mm512_div_pd(_mm512_sub_pd(_mm512_mul_pd(gamma_x_x, phi_y), _mm512_mul_pd(gamma_x_y, phi_x)), gamma_det);
+    }
+    _mm512_storeu_pd(disparity_y + p, d_y);
+    _mm512_storeu_pd(disparity_x + p, d_x);
+  }
+  disparity_avx2(k, scales, directions, confidences + p, phase_differences + p, stride, count - p, disparity_y + p, disparity_x + p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // BOB_IP_GABOR_X86_KERNELS
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Dispatch  /////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct Kernels {
+  bob::ip::gabor::Simd::Level level;
+  double (*dot)(const double*, const double*, int);
+  double (*canberra)(const double*, const double*, int);
+  void (*abs)(const std::complex<double>*, int, double*, int);
+  void (*multiply)(const std::complex<double>*, const double*, std::complex<double>*, int);
+  void (*phase)(const std::complex<double>*, int, double*, int);
+  void (*disparity)(const double*, int, int, const double*, const double*, int, int, double*, double*);
+  void (*hamming)(const uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*, int, int*, int*);
+};
+
+// AVX-512F has no byte-wise operations, so that the AVX-512 level counts bits with the AVX2 kernel
+static const Kernels kernel_table[] = {
+  {bob::ip::gabor::Simd::SCALAR, dot_scalar, canberra_scalar, abs_scalar, multiply_scalar, phase_scalar, disparity_scalar, hamming_words},
+#ifdef BOB_IP_GABOR_X86_KERNELS
+  {bob::ip::gabor::Simd::SSE2, dot_sse2, canberra_sse2, abs_sse2, multiply_sse2, phase_sse2, disparity_sse2, hamming_sse2},
+  {bob::ip::gabor::Simd::AVX2, dot_avx2, canberra_avx2, abs_avx2, multiply_avx2, phase_avx2, disparity_avx2, hamming_avx2},
+  {bob::ip::gabor::Simd::AVX512, dot_avx512, canberra_avx512, abs_avx512, multiply_avx512, phase_avx512, disparity_avx512, hamming_avx2},
+#endif
+};
+
+static const std::map<bob::ip::gabor::Simd::Level, std::string> level_map = {
+  {bob::ip::gabor::Simd::SCALAR, "scalar"},
+  {bob::ip::gabor::Simd::SSE2, "sse2"},
+  {bob::ip::gabor::Simd::AVX2, "avx2"},
+  {bob::ip::gabor::Simd::AVX512, "avx512"}
+};
+
+// the kernels in use, which are selected when the library is loaded;
+// these settings might be changed while other threads compute, so they are atomic (but need no ordering)
+static std::atomic<const Kernels*> kernel_set(&kernel_table[bob::ip::gabor::Simd::best()]);
+// whether the phases are computed with the approximate atan2
+static std::atomic<bool> approximate_phase(false);
+
+static const Kernels& kernels(){
+  return *kernel_set.load(std::memory_order_relaxed);
+}
+
+const double bob::ip::gabor::Simd::approximatePhaseError = 2e-6;
+
+const std::string& bob::ip::gabor::Simd::level_to_name(bob::ip::gabor::Simd::Level level){
+  return level_map.find(level)->second;
+}
+
+bob::ip::gabor::Simd::Level bob::ip::gabor::Simd::name_to_level(const std::string& level){
+  for (auto it = level_map.begin(); it != level_map.end(); ++it)
+    if (it->second == level)
+      return it->first;
+  throw std::runtime_error("The given name '" + level + "' does not name an appropriate SIMD level.");
+}
+
+bool bob::ip::gabor::Simd::available(bob::ip::gabor::Simd::Level level){
+#ifdef BOB_IP_GABOR_X86_KERNELS
+  __builtin_cpu_init();
+  switch (level){
+    case SCALAR: return true;
+    case SSE2: return __builtin_cpu_supports("sse2");
+    case AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case AVX512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  return false;
+#else
+  return level == SCALAR;
+#endif
+}
+
+bob::ip::gabor::Simd::Level bob::ip::gabor::Simd::best(){
+  for (int level = AVX512; level > SCALAR; --level)
+    if (available(static_cast<Level>(level)))
+      return static_cast<Level>(level);
+  return SCALAR;
+}
+
+bob::ip::gabor::Simd::Level bob::ip::gabor::Simd::level(){
+  return kernels().level;
+}
+
+void bob::ip::gabor::Simd::level(bob::ip::gabor::Simd::Level level){
+  if (!available(level))
+    throw std::runtime_error("The SIMD level '" + level_to_name(level) + "' is not supported by this CPU or this build of bob.ip.gabor.");
+  kernel_set.store(&kernel_table[level], std::memory_order_relaxed);
+}
+
+double bob::ip::gabor::Simd::dot(const double* a, const double* b, int size){
+  return kernels().dot(a, b, size);
+}
+
+double bob::ip::gabor::Simd::canberra(const double* a, const double* b, int size){
+  return kernels().canberra(a, b, size);
+}
+
+void bob::ip::gabor::Simd::abs(const std::complex<double>* input, int stride, double* output, int size){
+  kernels().abs(input, stride, output, size);
+}
+
+bool bob::ip::gabor::Simd::approximatePhase(){
+  return approximate_phase.load(std::memory_order_relaxed);
+}
+
+void bob::ip::gabor::Simd::approximatePhase(bool approximate){
+  approximate_phase.store(approximate, std::memory_order_relaxed);
+}
+
+void bob::ip::gabor::Simd::polar(const std::complex<double>* input, int stride, double* abs, double* phase, int size){
+  kernels().abs(input, stride, abs, size);
+  if (approximate_phase.load(std::memory_order_relaxed)){
+    kernels().phase(input, stride, phase, size);
+  } else {
+    for (int i = 0; i < size; ++i, input += stride) phase[i] = std::atan2(input->imag(), input->real());
+  }
+}
+
+void bob::ip::gabor::Simd::multiply(const std::complex<double>* input, const double* weights, std::complex<double>* output, int size){
+  kernels().multiply(input, weights, output, size);
+}
+
+void bob::ip::gabor::Simd::disparity(const double* frequencies, int scales, int directions, const double* confidences, const double* phase_differences, int count, double* disparity_y, double* disparity_x){
+  kernels().disparity(frequencies, scales, directions, confidences, phase_differences, count, count, disparity_y, disparity_x);
+}
+
+void bob::ip::gabor::Simd::hamming(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words, int* differences, int* valid){
+  kernels().hamming(code1, mask1, code2, mask2, words, differences, valid);
+}
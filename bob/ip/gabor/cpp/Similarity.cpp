@@ -8,8 +8,13 @@
  */
 
 #include <bob.ip.gabor/Similarity.h>
+#include <bob.ip.gabor/Simd.h>
+#include <bob.ip.gabor/Stats.h>
 #include <boost/assign.hpp>
 
+#include <algorithm>
+#include <thread>
+
 
 static const std::map<bob::ip::gabor::Similarity::SimilarityType, std::string> type_map = boost::assign::map_list_of
   (bob::ip::gabor::Similarity::SCALAR_PRODUCT, "ScalarProduct")
@@ -35,6 +40,7 @@ bob::ip::gabor::Similarity::Similarity(SimilarityType type, boost::shared_ptr<Tr
 :
   m_type(type),
   m_gwt(gwt),
+  m_default_family(false),
   m_disparity(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN())
 {
   // initialize, when required
@@ -46,6 +52,7 @@ bob::ip::gabor::Similarity::Similarity(SimilarityType type, boost::shared_ptr<Tr
 }
 
 bob::ip::gabor::Similarity::Similarity(bob::io::base::HDF5File& file)
+: m_default_family(false)
 {
   // load configuration from file
   load(file);
@@ -53,32 +60,170 @@ bob::ip::gabor::Similarity::Similarity(bob::io::base::HDF5File& file)
 
 static double sqr(double x){return x*x;}
 
+static double adjustPhase(double phase){
+  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
+}
+
+// The number of scales and directions of the default Gabor wavelet family, i.e., of Transform(5, 8)
+static const int DEFAULT_SCALES = 5, DEFAULT_DIRECTIONS = 8;
+
+// The wavelet frequencies (ky, kx) of the default Gabor wavelet family with k_max = pi/2 and k_fac = sqrt(1/2)
+static const double DEFAULT_FREQUENCIES[DEFAULT_SCALES * DEFAULT_DIRECTIONS][2] = {
+  // scale 0
+  {0.0, 1.5707963267948966},
+  {0.6011177298843463, 1.4512265760697154},
+  {1.1107207345395915, 1.1107207345395915},
+  {1.4512265760697154, 0.6011177298843463},
+  {1.5707963267948966, 9.618353468608949e-17},
+  {1.4512265760697154, -0.6011177298843462},
+  {1.1107207345395915, -1.1107207345395915},
+  {0.6011177298843464, -1.4512265760697154},
+  // scale 1
+  {0.0, 1.1107207345395915},
+  {0.4250544230926846, 1.026172152977031},
+  {0.7853981633974482, 0.7853981633974484},
+  {1.026172152977031, 0.42505442309268465},
+  {1.1107207345395915, 6.801202961502539e-17},
+  {1.026172152977031, -0.42505442309268454},
+  {0.7853981633974484, -0.7853981633974482},
+  {0.42505442309268476, -1.026172152977031},
+  // scale 2
+  {0.0, 0.7853981633974484},
+  {0.30055886494217315, 0.7256132880348578},
+  {0.5553603672697958, 0.5553603672697959},
+  {0.7256132880348578, 0.3005588649421732},
+  {0.7853981633974484, 4.8091767343044757e-17},
+  {0.7256132880348578, -0.30055886494217315},
+  {0.5553603672697959, -0.5553603672697958},
+  {0.30055886494217326, -0.7256132880348578},
+  // scale 3
+  {0.0, 0.5553603672697959},
+  {0.21252721154634235, 0.5130860764885156},
+  {0.3926990816987242, 0.39269908169872425},
+  {0.5130860764885156, 0.21252721154634238},
+  {0.5553603672697959, 3.40060148075127e-17},
+  {0.5130860764885156, -0.21252721154634233},
+  {0.39269908169872425, -0.3926990816987242},
+  {0.2125272115463424, -0.5130860764885156},
+  // scale 4
+  {0.0, 0.39269908169872425},
+  {0.1502794324710866, 0.36280664401742896},
+  {0.27768018363489794, 0.277680183634898},
+  {0.36280664401742896, 0.15027943247108663},
+  {0.39269908169872425, 2.404588367152238e-17},
+  {0.36280664401742896, -0.15027943247108658},
+  {0.277680183634898, -0.27768018363489794},
+  {0.15027943247108666, -0.36280664401742896}
+};
+
+/**
+ * The disparity-based similarity functions for Gabor jets of the fixed length SCALES * DIRECTIONS, with the wavelet frequencies known at compile time.
+ * The fixed trip counts let the compiler unroll and vectorize the loops.
+ */
+template <int SCALES, int DIRECTIONS>
+struct FixedLength {
+  static const int LENGTH = SCALES * DIRECTIONS;
+
+  //! computes the confidences and the phase differences of the given Gabor jets
+  static void confidences(const double* a1, const double* a2, const double* p1, const double* p2, double* confidences, double* phase_differences){
+    for (int j = 0; j < LENGTH; ++j){
+      confidences[j] = a1[j] * a2[j];
+      phase_differences[j] = adjustPhase(p1[j] - p2[j]);
+    }
+  }
+
+  //! estimates the disparity from the confidences and the phase differences, starting with the lowest frequencies
+  static void disparity(const double (&k)[LENGTH][2], const double* confidences, const double* phase_differences, blitz::TinyVector<double,2>& disparity){
+    double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0.;
+    disparity = 0.;
+    for (int level = SCALES-1; level >= 0; --level){
+      for (int direction = DIRECTIONS-1; direction >= 0; --direction){
+        const int j = level * DIRECTIONS + direction;
+        const double kjx = k[j][1], kjy = k[j][0], conf = confidences[j], diff = phase_differences[j];
+        gamma_x_x += kjx * kjx * conf;
+        gamma_x_y += kjx * kjy * conf;
+        gamma_y_y += kjy * kjy * conf;
+        double nL = round((diff - disparity[1] * kjx - disparity[0] * kjy) / (2.*M_PI));
+        phi_x += (diff - nL * 2. * M_PI) * conf * kjx;
+        phi_y += (diff - nL * 2. * M_PI) * conf * kjy;
+      }
+      double gamma_det = gamma_x_x * gamma_y_y - sqr(gamma_x_y);
+      disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
+      disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
+    }
+  }
+
+  //! sums the cosines of the phase differences corrected by the disparity, weighted by the confidences, if given
+  static double phaseSimilarity(const double (&k)[LENGTH][2], const double* confidences, const double* phase_differences, const blitz::TinyVector<double,2>& disparity){
+    double sum = 0.;
+    for (int j = 0; j < LENGTH; ++j){
+      const double c = cos(phase_differences[j] - disparity[0] * k[j][0] - disparity[1] * k[j][1]);
+      sum += confidences ? confidences[j] * c : c;
+    }
+    return sum;
+  }
+
+  //! the similarity of absolute values and cosines of phase differences
+  static double absPhase(const double* a1, const double* a2, const double* p1, const double* p2){
+    double sum = 0.;
+    for (int j = 0; j < LENGTH; ++j){
+      sum += a1[j] * a2[j] * cos(p1[j] - p2[j]);
+    }
+    return sum;
+  }
+};
+
+typedef FixedLength<DEFAULT_SCALES, DEFAULT_DIRECTIONS> DefaultLength;
+
 void bob::ip::gabor::Similarity::init(){
   m_confidences.resize(m_gwt->numberOfWavelets());
   m_confidences = 0.;
   m_phase_differences.resize(m_gwt->numberOfWavelets());
   m_phase_differences = 0.;
+
+  // the fixed-length implementation is used when the Gabor wavelet family is the default one
+  m_default_family = m_gwt->numberOfScales() == DEFAULT_SCALES && m_gwt->numberOfDirections() == DEFAULT_DIRECTIONS;
+  const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt->waveletFrequencies();
+  for (int j = 0; m_default_family && j < (int)kernels.size(); ++j){
+    m_default_family = std::abs(kernels[j][0] - DEFAULT_FREQUENCIES[j][0]) < 1e-12 && std::abs(kernels[j][1] - DEFAULT_FREQUENCIES[j][1]) < 1e-12;
+  }
+}
+
+#ifdef BOB_IP_GABOR_STATS
+// the counter of the calls of the given similarity function type
+static bob::ip::gabor::Stats::Counter calls_counter(bob::ip::gabor::Similarity::SimilarityType type){
+  switch (type){
+    case bob::ip::gabor::Similarity::SCALAR_PRODUCT: return bob::ip::gabor::Stats::SCALAR_PRODUCT_CALLS;
+    case bob::ip::gabor::Similarity::CANBERRA: return bob::ip::gabor::Stats::CANBERRA_CALLS;
+    case bob::ip::gabor::Similarity::ABS_PHASE: return bob::ip::gabor::Stats::ABS_PHASE_CALLS;
+    case bob::ip::gabor::Similarity::DISPARITY: return bob::ip::gabor::Stats::DISPARITY_CALLS;
+    case bob::ip::gabor::Similarity::PHASE_DIFF: return bob::ip::gabor::Stats::PHASE_DIFF_CALLS;
+    default: return bob::ip::gabor::Stats::PHASE_DIFF_PLUS_CANBERRA_CALLS;
+  }
 }
+#endif
 
 double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2) const{
+  BOB_IP_GABOR_STATS_TIME(SIMILARITY);
+#ifdef BOB_IP_GABOR_STATS
+  bob::ip::gabor::Stats::increment(calls_counter(m_type));
+#endif
   // compute the disparity, if required
   if (m_type < DISPARITY){
     switch (m_type){
       case SCALAR_PRODUCT:
         // normalized scalar product (we assume normalized Gabor jets here!)
-        return blitz::dot(jet1.abs(), jet2.abs());
+        bob::core::array::assertSameShape(jet1.jet(), jet2.jet());
+        return bob::ip::gabor::Simd::dot(jet1.abs().data(), jet2.abs().data(), jet1.length());
       case CANBERRA:{
         // Canberra similarity
-        double sim = 0.;
-        const auto& a1 = jet1.abs(),& a2 = jet2.abs();
-        int size = jet1.length();
-        for (int j = 0; j < size; ++j){
-          sim += 1. - std::abs(a1(j) - a2(j)) / (a1(j) + a2(j));
-        }
-        return sim / size;
+        bob::core::array::assertSameShape(jet1.jet(), jet2.jet());
+        return bob::ip::gabor::Simd::canberra(jet1.abs().data(), jet2.abs().data(), jet1.length()) / jet1.length();
       }
       case ABS_PHASE:{
         // similarity with absloute values and cosine of phase differences
+        if (jet1.length() == DefaultLength::LENGTH && jet2.length() == DefaultLength::LENGTH)
+          return DefaultLength::absPhase(jet1.abs().data(), jet2.abs().data(), jet1.phase().data(), jet2.phase().data());
         double sim = 0.;
         const auto& a1 = jet1.abs(),& a2 = jet2.abs();
         const auto& p1 = jet1.phase(),& p2 = jet2.phase();
@@ -97,6 +242,19 @@ double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2)
     // compute disparity
     disparity(jet1, jet2);
 
+    if (m_default_family){
+      switch (m_type){
+        case DISPARITY:
+          return DefaultLength::phaseSimilarity(DEFAULT_FREQUENCIES, m_confidences.data(), m_phase_differences.data(), m_disparity);
+        case PHASE_DIFF:
+          return DefaultLength::phaseSimilarity(DEFAULT_FREQUENCIES, 0, m_phase_differences.data(), m_disparity) / DefaultLength::LENGTH;
+        case PHASE_DIFF_PLUS_CANBERRA:
+          return (DefaultLength::phaseSimilarity(DEFAULT_FREQUENCIES, 0, m_phase_differences.data(), m_disparity) + bob::ip::gabor::Simd::canberra(jet1.abs().data(), jet2.abs().data(), DefaultLength::LENGTH)) / (2. * DefaultLength::LENGTH);
+        default:
+          throw std::runtime_error("This should not have happened. Please check the implementation of the similarity() functions.");
+      }
+    }
+
     const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt->waveletFrequencies();
 
     switch (m_type){
@@ -121,13 +279,12 @@ double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2)
       case PHASE_DIFF_PLUS_CANBERRA:{
         // compute the similarity using the estimated disparity
         double sum = 0.;
-        const auto& a1 = jet1.abs(),& a2 = jet2.abs();
         for (int j = 0; j < m_phase_differences.extent(0); ++j){
           // add disparity term
           sum += cos(m_phase_differences(j) - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
-          // add Canberra term
-          sum += 1. - std::abs(a1(j) - a2(j)) / (a1(j) + a2(j));
         }
+        // add Canberra term
+        sum += bob::ip::gabor::Simd::canberra(jet1.abs().data(), jet2.abs().data(), jet1.length());
         return sum / (2. * jet1.length());
       }
 
@@ -139,6 +296,319 @@ double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Batched similarities  /////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The number of pairs of Gabor jets that are processed at once; for the default family, the block data fits into the L1 cache
+static const int BATCH_BLOCK_SIZE = 64;
+
+// Computes the similarity of pair p of a block from the coefficient-major confidences and phase differences, in the same order of operations as in similarity(), so that the results are identical
+static double block_similarity(bob::ip::gabor::Similarity::SimilarityType type, int length, int count, int p, const double* confidences, const double* phase_differences, double disparity_y, double disparity_x, const double* k, const double* abs1, const double* abs2){
+  double sum = 0.;
+  for (int j = 0; j < length; ++j){
+    const double c = cos(phase_differences[j * count + p] - disparity_y * k[2*j] - disparity_x * k[2*j+1]);
+    sum += type == bob::ip::gabor::Similarity::DISPARITY ? confidences[j * count + p] * c : c;
+  }
+  switch (type){
+    case bob::ip::gabor::Similarity::DISPARITY:
+      return sum;
+    case bob::ip::gabor::Similarity::PHASE_DIFF:
+      return sum / length;
+    case bob::ip::gabor::Similarity::PHASE_DIFF_PLUS_CANBERRA:
+      return (sum + bob::ip::gabor::Simd::canberra(abs1, abs2, length)) / (2. * length);
+    default:
+      throw std::runtime_error("This should not have happened. Please check the implementation of the batched similarity functions.");
+  }
+}
+
+void bob::ip::gabor::Similarity::similarities(const std::vector<boost::shared_ptr<Jet>>& jets1, const std::vector<boost::shared_ptr<Jet>>& jets2, blitz::Array<double,1>& similarities) const{
+  if (jets1.size() != jets2.size())
+    throw std::runtime_error((boost::format("The number of Gabor jets to compare (%d and %d) differ") % jets1.size() % jets2.size()).str());
+  bob::core::array::assertSameShape(similarities, blitz::shape(jets1.size()));
+
+  if (m_type < DISPARITY){
+    // there is nothing to share between the pairs
+    for (int p = 0; p < (int)jets1.size(); ++p){
+      similarities(p) = similarity(*jets1[p], *jets2[p]);
+    }
+    return;
+  }
+
+  BOB_IP_GABOR_STATS_TIME(SIMILARITY);
+  const int length = m_gwt->numberOfWavelets();
+  batch_disparities(jets1, jets2, [&](int first, int count, const double* confidences, const double* phase_differences, const double* disparity_y, const double* disparity_x, const double* k){
+    for (int p = 0; p < count; ++p){
+#ifdef BOB_IP_GABOR_STATS
+      bob::ip::gabor::Stats::increment(calls_counter(m_type));
+#endif
+      similarities(first + p) = block_similarity(m_type, length, count, p, confidences, phase_differences, disparity_y[p], disparity_x[p], k, jets1[first + p]->abs().data(), jets2[first + p]->abs().data());
+    }
+  });
+}
+
+void bob::ip::gabor::Similarity::disparities(const std::vector<boost::shared_ptr<Jet>>& jets1, const std::vector<boost::shared_ptr<Jet>>& jets2, blitz::Array<double,2>& disparities) const{
+  if (jets1.size() != jets2.size())
+    throw std::runtime_error((boost::format("The number of Gabor jets to compare (%d and %d) differ") % jets1.size() % jets2.size()).str());
+  bob::core::array::assertSameShape(disparities, blitz::shape(jets1.size(), 2));
+
+  batch_disparities(jets1, jets2, [&](int first, int count, const double*, const double*, const double* disparity_y, const double* disparity_x, const double*){
+    for (int p = 0; p < count; ++p){
+      disparities(first + p, 0) = disparity_y[p];
+      disparities(first + p, 1) = disparity_x[p];
+    }
+  });
+}
+
+void bob::ip::gabor::Similarity::batch_frequencies(std::vector<double>& frequencies) const{
+  // the default family uses the same table as the fixed-length implementation
+  const int length = m_gwt->numberOfWavelets();
+  frequencies.resize(2 * length);
+  if (m_default_family){
+    std::copy(&DEFAULT_FREQUENCIES[0][0], &DEFAULT_FREQUENCIES[0][0] + 2 * length, frequencies.begin());
+  } else {
+    const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt->waveletFrequencies();
+    for (int j = 0; j < length; ++j){
+      frequencies[2*j] = kernels[j][0];
+      frequencies[2*j+1] = kernels[j][1];
+    }
+  }
+}
+
+void bob::ip::gabor::Similarity::batch_disparities(const std::vector<boost::shared_ptr<Jet>>& jets1, const std::vector<boost::shared_ptr<Jet>>& jets2, const boost::function<void(int, int, const double*, const double*, const double*, const double*, const double*)>& block) const{
+  if (m_type < DISPARITY){
+    throw std::runtime_error("The disparity computation is not supported for similarity type " + type());
+  }
+  const int length = m_gwt->numberOfWavelets();
+  for (int p = 0; p < (int)jets1.size(); ++p){
+    bob::core::array::assertCZeroBaseContiguous(jets1[p]->jet());
+    bob::core::array::assertCZeroBaseContiguous(jets2[p]->jet());
+    if (jets1[p]->length() != length || jets2[p]->length() != length){
+      throw std::runtime_error((boost::format("The size of the Gabor jets of pair %d (%d and %d) and the number of wavelets in the Gabor wavelet transform (%d) differ!") % p % jets1[p]->length() % jets2[p]->length() % length).str());
+    }
+  }
+
+  std::vector<double> frequencies;
+  batch_frequencies(frequencies);
+
+  // the coefficient-major confidences and phase differences of one block of pairs
+  std::vector<double> confidences(length * BATCH_BLOCK_SIZE), phase_differences(length * BATCH_BLOCK_SIZE), disparity_y(BATCH_BLOCK_SIZE), disparity_x(BATCH_BLOCK_SIZE);
+  for (int first = 0; first < (int)jets1.size(); first += BATCH_BLOCK_SIZE){
+    const int count = std::min(BATCH_BLOCK_SIZE, (int)jets1.size() - first);
+    for (int p = 0; p < count; ++p){
+      const double* a1 = jets1[first + p]->abs().data(),* a2 = jets2[first + p]->abs().data(),* p1 = jets1[first + p]->phase().data(),* p2 = jets2[first + p]->phase().data();
+      for (int j = 0; j < length; ++j){
+        confidences[j * count + p] = a1[j] * a2[j];
+        phase_differences[j * count + p] = adjustPhase(p1[j] - p2[j]);
+      }
+    }
+    {
+      BOB_IP_GABOR_STATS_TIME(DISPARITY_ESTIMATION);
+      bob::ip::gabor::Simd::disparity(frequencies.data(), m_gwt->numberOfScales(), m_gwt->numberOfDirections(), confidences.data(), phase_differences.data(), count, disparity_y.data(), disparity_x.data());
+    }
+    block(first, count, confidences.data(), phase_differences.data(), disparity_y.data(), disparity_x.data(), frequencies.data());
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Dense disparity field  ////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Extracts the normalized Gabor jet from the given (strided) wavelet responses, see Jet::init and Jet::normalize;
+// the absolute values are followed by the phases
+static void extract_jet(const std::complex<double>* responses, int stride, double* jet, int length){
+  bob::ip::gabor::Simd::polar(responses, stride, jet, jet + length, length);
+  double norm = bob::ip::gabor::Simd::dot(jet, jet, length);
+  if (std::abs(norm - 1.) > 1e-8){
+    norm = sqrt(norm);
+    for (int j = 0; j < length; ++j) jet[j] /= norm;
+  }
+}
+
+void bob::ip::gabor::Similarity::disparityField(
+  const blitz::Array<std::complex<double>,3>& trafo_image1,
+  const blitz::Array<std::complex<double>,3>& trafo_image2,
+  blitz::Array<double,3>& disparities,
+  blitz::Array<double,2>& similarities,
+  const blitz::TinyVector<int,2>& step,
+  int number_of_threads
+) const{
+  if (m_type < DISPARITY){
+    throw std::runtime_error("The disparity computation is not supported for similarity type " + type());
+  }
+  bob::core::array::assertSameShape(trafo_image1, trafo_image2);
+  const int length = m_gwt->numberOfWavelets();
+  if (trafo_image1.extent(0) != length){
+    throw std::runtime_error((boost::format("The number of wavelet responses in the trafo images (%d) and the number of wavelets in the Gabor wavelet transform (%d) differ!") % trafo_image1.extent(0) % length).str());
+  }
+  if (step[0] <= 0 || step[1] <= 0){
+    throw std::runtime_error((boost::format("The step (%d, %d) of the disparity field must be positive") % step[0] % step[1]).str());
+  }
+  if (number_of_threads < 0){
+    throw std::runtime_error((boost::format("The number of threads (%d) must not be negative") % number_of_threads).str());
+  }
+  const int rows = (trafo_image1.extent(1) + step[0] - 1) / step[0], columns = (trafo_image1.extent(2) + step[1] - 1) / step[1];
+  bob::core::array::assertSameShape(disparities, blitz::shape(rows, columns, 2));
+  bob::core::array::assertSameShape(similarities, blitz::shape(rows, columns));
+  if (!rows || !columns) return;
+
+  std::vector<double> frequencies;
+  batch_frequencies(frequencies);
+
+  if (!number_of_threads) number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+  number_of_threads = std::min(number_of_threads, rows);
+
+  // the scratch memory of each thread is allocated beforehand; it holds the Gabor jets of both images for one block of points,
+  // and the coefficient-major confidences, phase differences and the disparities of that block
+  const int block_size = std::min(BATCH_BLOCK_SIZE, columns);
+  std::vector<std::vector<double>> scratch(number_of_threads, std::vector<double>(block_size * (6 * length + 2)));
+
+  auto estimate_rows = [&](int first, int last, double* memory){
+    double* jets1 = memory,* jets2 = jets1 + 2 * length * block_size;
+    double* confidences = jets2 + 2 * length * block_size,* phase_differences = confidences + length * block_size;
+    double* disparity_y = phase_differences + length * block_size,* disparity_x = disparity_y + block_size;
+    for (int r = first; r < last; ++r){
+      for (int c = 0; c < columns; c += block_size){
+        const int count = std::min(block_size, columns - c);
+        // extract the Gabor jets directly from the trafo images, without creating blitz slices
+        for (int p = 0; p < count; ++p){
+          double* jet1 = jets1 + 2 * length * p,* jet2 = jets2 + 2 * length * p;
+          extract_jet(trafo_image1.data() + r * step[0] * trafo_image1.stride(1) + (c + p) * step[1] * trafo_image1.stride(2), trafo_image1.stride(0), jet1, length);
+          extract_jet(trafo_image2.data() + r * step[0] * trafo_image2.stride(1) + (c + p) * step[1] * trafo_image2.stride(2), trafo_image2.stride(0), jet2, length);
+          for (int j = 0; j < length; ++j){
+            confidences[j * count + p] = jet1[j] * jet2[j];
+            phase_differences[j * count + p] = adjustPhase(jet1[length + j] - jet2[length + j]);
+          }
+        }
+        bob::ip::gabor::Simd::disparity(frequencies.data(), m_gwt->numberOfScales(), m_gwt->numberOfDirections(), confidences, phase_differences, count, disparity_y, disparity_x);
+        for (int p = 0; p < count; ++p){
+          disparities(r, c + p, 0) = disparity_y[p];
+          disparities(r, c + p, 1) = disparity_x[p];
+          similarities(r, c + p) = block_similarity(m_type, length, count, p, confidences, phase_differences, disparity_y[p], disparity_x[p], frequencies.data(), jets1 + 2 * length * p, jets2 + 2 * length * p);
+        }
+      }
+    }
+  };
+
+  BOB_IP_GABOR_STATS_TIME(DISPARITY_ESTIMATION);
+  if (number_of_threads == 1){
+    estimate_rows(0, rows, scratch[0].data());
+    return;
+  }
+
+  // each thread estimates a consecutive block of rows
+  std::vector<std::thread> threads;
+  try {
+    for (int t = 0; t < number_of_threads; ++t){
+      threads.push_back(std::thread(estimate_rows, t * rows / number_of_threads, (t+1) * rows / number_of_threads, scratch[t].data()));
+    }
+  } catch (...){
+    for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+    throw;
+  }
+  for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Top-k search  /////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The tolerance per node of the early termination, which covers rounding errors and the tolerance of Jet::normalize
+static const double SEARCH_TOLERANCE = 1e-8;
+
+void bob::ip::gabor::Similarity::search(
+  const blitz::Array<double,3>& probe,
+  const blitz::Array<double,4>& gallery,
+  blitz::Array<int,1>& indices,
+  blitz::Array<double,1>& scores,
+  bool normalized
+) const {
+  const int count = gallery.extent(0), nodes = gallery.extent(1), length = gallery.extent(3), k = indices.extent(0);
+  bob::core::array::assertSameShape(probe, blitz::shape(nodes, 2, length));
+  bob::core::array::assertSameShape(gallery, blitz::shape(count, nodes, 2, length));
+  bob::core::array::assertSameShape(scores, indices.shape());
+  if (!bob::core::array::isCZeroBaseContiguous(probe) || !bob::core::array::isCZeroBaseContiguous(gallery))
+    throw std::runtime_error("The probe and gallery graphs must be C-contiguous");
+  if (!nodes)
+    throw std::runtime_error("The probe and gallery graphs must have at least one node");
+  if (k > count)
+    throw std::runtime_error((boost::format("Cannot find the %d best out of %d gallery graphs") % k % count).str());
+  if (m_type >= DISPARITY && length != m_gwt->numberOfWavelets())
+    throw std::runtime_error((boost::format("The size of the Gabor jets (%d) and the number of wavelets in the Gabor wavelet transform (%d) differ!") % length % m_gwt->numberOfWavelets()).str());
+  if (!k) return;
+
+  // The similarity of a node is at most 1 for the Canberra and phase difference functions;
+  // for the product-based functions, it is bounded by the product of the norms of the absolute values of both Gabor jets
+  const bool norms = !normalized && (m_type == SCALAR_PRODUCT || m_type == ABS_PHASE || m_type == DISPARITY);
+  // remaining[n] is the bound of the sum of the similarities of the nodes n, ..., nodes-1
+  std::vector<double> probe_norms(nodes), remaining(nodes + 1, 0.);
+  for (int n = 0; n < nodes; ++n){
+    const double* abs = probe.data() + n * 2 * length;
+    probe_norms[n] = norms ? sqrt(bob::ip::gabor::Simd::dot(abs, abs, length)) : 1.;
+    remaining[n] = nodes - n;
+  }
+
+  // the Gabor jets that reference the probe and gallery memory, for the similarity functions that use the phases
+  bob::ip::gabor::Jet probe_jet, gallery_jet;
+  auto node_similarity = [&](const double* jet1, const double* jet2) -> double{
+    switch (m_type){
+      case SCALAR_PRODUCT:
+        return bob::ip::gabor::Simd::dot(jet1, jet2, length);
+      case CANBERRA:
+        return bob::ip::gabor::Simd::canberra(jet1, jet2, length) / length;
+      default:{
+        blitz::Array<double,2> view1(const_cast<double*>(jet1), blitz::shape(2, length), blitz::neverDeleteData), view2(const_cast<double*>(jet2), blitz::shape(2, length), blitz::neverDeleteData);
+        probe_jet.adopt(view1);
+        gallery_jet.adopt(view2);
+        return similarity(probe_jet, gallery_jet);
+      }
+    }
+  };
+
+  // a heap of the (sum, index) pairs of the k best candidates so far, with the worst on top; on equal sums, the lower index is better
+  auto better = [](const std::pair<double,int>& a, const std::pair<double,int>& b){return a.first > b.first || (a.first == b.first && a.second < b.second);};
+  std::vector<std::pair<double,int>> best;
+  best.reserve(k);
+
+  for (int i = 0; i < count; ++i){
+    const double* candidate = gallery.data() + i * nodes * 2 * length;
+    if (norms){
+      for (int n = nodes-1; n >= 0; --n){
+        const double* abs = candidate + n * 2 * length;
+        remaining[n] = remaining[n+1] + probe_norms[n] * sqrt(bob::ip::gabor::Simd::dot(abs, abs, length));
+      }
+    }
+    const bool full = (int)best.size() == k;
+    const double threshold = full ? best.front().first : -std::numeric_limits<double>::infinity();
+    double sum = 0.;
+    int n = 0;
+    for (; n < nodes; ++n){
+      // abandon the candidate, when it cannot get better than the current k-th best
+      if (full && sum + remaining[n] + SEARCH_TOLERANCE * nodes < threshold) break;
+      sum += node_similarity(probe.data() + n * 2 * length, candidate + n * 2 * length);
+    }
+    if (n < nodes) continue;
+
+    if (!full){
+      best.push_back(std::make_pair(sum, i));
+      std::push_heap(best.begin(), best.end(), better);
+    } else if (sum > threshold){
+      std::pop_heap(best.begin(), best.end(), better);
+      best.back() = std::make_pair(sum, i);
+      std::push_heap(best.begin(), best.end(), better);
+    }
+  }
+
+  std::sort_heap(best.begin(), best.end(), better);
+  for (int i = 0; i < k; ++i){
+    indices(i) = best[i].second;
+    scores(i) = best[i].first / nodes;
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////  Disparity estimation  /////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -159,10 +629,6 @@ blitz::TinyVector<double,2> bob::ip::gabor::Similarity::disparity(const Jet& jet
   return m_disparity;
 }
 
-static double adjustPhase(double phase){
-  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
-}
-
 void bob::ip::gabor::Similarity::shift_phase(const Jet& jet, const Jet& reference, Jet& shifted) const{
   bob::core::array::assertSameShape(jet.jet(),reference.jet());
   bob::core::array::assertSameShape(jet.jet(),shifted.jet());
@@ -189,6 +655,10 @@ void bob::ip::gabor::Similarity::compute_confidences(const Jet& jet1, const Jet&
     throw std::runtime_error((boost::format("The size of the Gabor jet (%d) and the number of wavelets in the Gabor wavelet transform (%d) differ!") % jet1.length() % m_confidences.extent(0)).str());
   }
   // first, fill confidence and phase difference vectors
+  if (m_default_family){
+    DefaultLength::confidences(jet1.abs().data(), jet2.abs().data(), jet1.phase().data(), jet2.phase().data(), m_confidences.data(), m_phase_differences.data());
+    return;
+  }
   const auto& a1 = jet1.abs(),& a2 = jet2.abs(),& p1 = jet1.phase(),& p2 = jet2.phase();
   for (int j = 0; j < m_confidences.extent(0); ++j){
     m_confidences(j) = a1(j) * a2(j);
@@ -197,6 +667,11 @@ void bob::ip::gabor::Similarity::compute_confidences(const Jet& jet1, const Jet&
 }
 
 void bob::ip::gabor::Similarity::compute_disparity() const{
+  BOB_IP_GABOR_STATS_TIME(DISPARITY_ESTIMATION);
+  if (m_default_family){
+    DefaultLength::disparity(DEFAULT_FREQUENCIES, m_confidences.data(), m_phase_differences.data(), m_disparity);
+    return;
+  }
   // approximate the disparity from the phase differences
   double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0.;
   // initialize the disparity with 0
@@ -252,6 +727,8 @@ void bob::ip::gabor::Similarity::load(bob::io::base::HDF5File& file){
   if (m_type >= DISPARITY){
     file.cd("Transform");
     m_gwt.reset(new Transform(file));
+    // all similarity functions of a model use the same wavelets
+    m_gwt->shareWavelets(true);
     file.cd("..");
 
     init();
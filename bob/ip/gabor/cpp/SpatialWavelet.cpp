@@ -0,0 +1,269 @@
+/**
+ * @brief C++ implementations of the truncated Gabor wavelet in spatial domain
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/SpatialWavelet.h>
+#include <bob.ip.gabor/Stats.h>
+#include <boost/format.hpp>
+
+static inline double sqr(double x){return x*x;}
+
+static inline int wrap(int i, int n){
+  i %= n;
+  return i < 0 ? i + n : i;
+}
+
+/**
+ * Folds the given kernel, which is defined for the offsets -r,...,r, periodically into a kernel of the given length n.
+ * Afterwards, the convolution can be computed as out[i] = sum_j ext[i+j] * taps[j] with ext[i] = in[(i - pad) mod n].
+ */
+static void fold(
+  const std::vector<std::complex<double>>& kernel,
+  int n,
+  std::vector<std::complex<double>>& taps,
+  int& pad
+){
+  int r = kernel.size() / 2;
+  if ((int)kernel.size() <= n){
+    // the kernel fits into the period; just reverse it
+    taps.assign(kernel.rbegin(), kernel.rend());
+    pad = r;
+  } else {
+    // the kernel wraps around (several times); sum up all kernel values falling onto the same offset
+    std::vector<std::complex<double>> folded(n, std::complex<double>(0.));
+    for (int d = -r; d <= r; ++d){
+      folded[wrap(d, n)] += kernel[d + r];
+    }
+    taps.assign(folded.rbegin(), folded.rend());
+    pad = n - 1;
+  }
+}
+
+/**
+ * Convolves all rows of the given (planar) image with the given folded taps.
+ * The loop order is chosen such that the innermost loop runs over the pixels, so that it can be vectorized.
+ */
+static void convolveRows(
+  const std::vector<double>& in_re, const std::vector<double>& in_im,
+  int height, int width,
+  const std::vector<std::complex<double>>& taps, int pad,
+  std::vector<double>& out_re, std::vector<double>& out_im
+){
+  int length = width + taps.size() - 1;
+  std::vector<double> ext_re(length), ext_im(length);
+  for (int y = 0; y < height; ++y){
+    const double* row_re = &in_re[y*width],* row_im = &in_im[y*width];
+    for (int i = 0; i < length; ++i){
+      int x = wrap(i - pad, width);
+      ext_re[i] = row_re[x];
+      ext_im[i] = row_im[x];
+    }
+    double* o_re = &out_re[y*width],* o_im = &out_im[y*width];
+    std::fill(o_re, o_re + width, 0.);
+    std::fill(o_im, o_im + width, 0.);
+    for (int j = 0; j < (int)taps.size(); ++j){
+      const double t_re = taps[j].real(), t_im = taps[j].imag();
+      const double* e_re = &ext_re[j],* e_im = &ext_im[j];
+      for (int x = 0; x < width; ++x){
+        o_re[x] += e_re[x] * t_re - e_im[x] * t_im;
+        o_im[x] += e_re[x] * t_im + e_im[x] * t_re;
+      }
+    }
+  }
+}
+
+/**
+ * Convolves all columns of the given (planar) image with the given folded taps.
+ * Complete rows are accumulated, so that the innermost loop can be vectorized.
+ */
+static void convolveColumns(
+  const std::vector<double>& in_re, const std::vector<double>& in_im,
+  int height, int width,
+  const std::vector<std::complex<double>>& taps, int pad,
+  std::vector<double>& out_re, std::vector<double>& out_im
+){
+  for (int y = 0; y < height; ++y){
+    double* o_re = &out_re[y*width],* o_im = &out_im[y*width];
+    std::fill(o_re, o_re + width, 0.);
+    std::fill(o_im, o_im + width, 0.);
+    for (int j = 0; j < (int)taps.size(); ++j){
+      const double t_re = taps[j].real(), t_im = taps[j].imag();
+      int src = wrap(y + j - pad, height);
+      const double* i_re = &in_re[src*width],* i_im = &in_im[src*width];
+      for (int x = 0; x < width; ++x){
+        o_re[x] += i_re[x] * t_re - i_im[x] * t_im;
+        o_im[x] += i_re[x] * t_im + i_im[x] * t_re;
+      }
+    }
+  }
+}
+
+
+/**
+ * Computes the radius of the truncated Gabor wavelet, i.e., the distance at which the Gaussian envelope falls below epsilon.
+ * @param k  The frequency vector of the wavelet
+ * @param sigma  The standard deviation of the wavelet
+ * @param epsilon  The relative value of the envelope at which the wavelet is truncated
+ */
+int bob::ip::gabor::SpatialWavelet::radius(
+  const blitz::TinyVector<double,2>& k,
+  const double sigma,
+  const double epsilon
+)
+{
+  double k_abs = sqrt(sqr(k[0]) + sqr(k[1]));
+  if (k_abs <= 0 || sigma <= 0 || epsilon <= 0 || epsilon >= 1){
+    throw std::runtime_error("The parametrization of the spatial Gabor wavelet does not make any sense.");
+  }
+  return (int)std::ceil(sigma / k_abs * sqrt(-2. * std::log(epsilon)));
+}
+
+/**
+ * Generates a truncated Gabor wavelet in spatial domain, which is:
+ * psi(x) = k^pow_of_k * k^2/(2 pi sigma^2) * exp(-k^2 x^2 / (2 sigma^2)) * (exp(i k x) - exp(-sigma^2/2))
+ * @param k  The frequency vector (i.e. the center of the Gaussian in frequency domain)
+ * @param sigma  The standard deviation (i.e. the width of the Gabor wavelet)
+ * @param pow_of_k  The power of \f$ k^x \f$ used as a prefactor of the Gabor wavelet
+ * @param dc_free   Make the Gabor wavelet DC-free?
+ * @param epsilon   The relative value of the Gaussian envelope below which the wavelet is truncated
+ */
+bob::ip::gabor::SpatialWavelet::SpatialWavelet(
+  const blitz::TinyVector<double,2>& k,
+  const double sigma,
+  const double pow_of_k,
+  const bool dc_free,
+  const double epsilon
+)
+: m_radius(radius(k, sigma, epsilon))
+{
+  double k_square = sqr(k[0]) + sqr(k[1]);
+  double sigma_square = sqr(sigma);
+  m_factor = std::pow(k_square, pow_of_k / 2.) * k_square / (2. * M_PI * sigma_square);
+  m_dc = dc_free ? exp(-sigma_square / 2.) : 0.;
+
+  m_gabor_y.resize(2*m_radius+1);
+  m_gabor_x.resize(2*m_radius+1);
+  m_gauss.resize(2*m_radius+1);
+  for (int d = -m_radius; d <= m_radius; ++d){
+    double gauss = exp(- k_square * sqr(d) / (2. * sigma_square));
+    m_gauss[d + m_radius] = gauss;
+    m_gabor_y[d + m_radius] = std::polar(gauss, k[0] * d);
+    m_gabor_x[d + m_radius] = std::polar(gauss, k[1] * d);
+  }
+}
+
+/**
+ * Generates and returns the image of the truncated wavelet in spatial domain.
+ * @return The wavelet image in spatial domain, where the center of the wavelet is at pixel (radius, radius)
+ */
+blitz::Array<std::complex<double>,2> bob::ip::gabor::SpatialWavelet::kernelImage() const{
+  blitz::Array<std::complex<double>,2> image(2*m_radius+1, 2*m_radius+1);
+  for (int y = 0; y <= 2*m_radius; ++y){
+    for (int x = 0; x <= 2*m_radius; ++x){
+      image(y,x) = m_factor * (m_gabor_y[y] * m_gabor_x[x] - m_dc * m_gauss[y] * m_gauss[x]);
+    }
+  }
+  return image;
+}
+
+/**
+ * Performs the convolution of the given image with this Gabor wavelet.
+ * The image is considered to be periodic, so that the result is comparable to the FFT based convolution.
+ * Both input and output images are in spatial domain.
+ * @param image  The image to convolve
+ * @param layer  The convolution result, must have the same shape as the image
+ */
+void bob::ip::gabor::SpatialWavelet::transform(
+  const blitz::Array<std::complex<double>,2>& image,
+  blitz::Array<std::complex<double>,2>& layer
+) const
+{
+  BOB_IP_GABOR_STATS_TIME(SPATIAL_CONVOLUTION);
+  bob::core::array::assertSameShape(image, layer);
+  const int height = image.extent(0), width = image.extent(1), size = height * width;
+
+  // fold the kernels to the current resolution
+  std::vector<std::complex<double>> gabor_x, gabor_y, gauss_x, gauss_y;
+  int pad_x, pad_y;
+  fold(m_gabor_x, width, gabor_x, pad_x);
+  fold(m_gabor_y, height, gabor_y, pad_y);
+  fold(m_gauss, width, gauss_x, pad_x);
+  fold(m_gauss, height, gauss_y, pad_y);
+
+  // copy image into planar memory
+  std::vector<double> in_re(size), in_im(size);
+  for (int y = 0, i = 0; y < height; ++y){
+    for (int x = 0; x < width; ++x, ++i){
+      in_re[i] = image(y,x).real();
+      in_im[i] = image(y,x).imag();
+    }
+  }
+
+  std::vector<double> temp_re(size), temp_im(size), out_re(size), out_im(size);
+  // the modulated part of the wavelet
+  convolveRows(in_re, in_im, height, width, gabor_x, pad_x, temp_re, temp_im);
+  convolveColumns(temp_re, temp_im, height, width, gabor_y, pad_y, out_re, out_im);
+
+  if (m_dc){
+    // the DC part of the wavelet
+    std::vector<double> dc_re(size), dc_im(size);
+    convolveRows(in_re, in_im, height, width, gauss_x, pad_x, temp_re, temp_im);
+    convolveColumns(temp_re, temp_im, height, width, gauss_y, pad_y, dc_re, dc_im);
+    for (int i = 0; i < size; ++i){
+      out_re[i] -= m_dc * dc_re[i];
+      out_im[i] -= m_dc * dc_im[i];
+    }
+  }
+
+  for (int y = 0, i = 0; y < height; ++y){
+    for (int x = 0; x < width; ++x, ++i){
+      layer(y,x) = std::complex<double>(m_factor * out_re[i], m_factor * out_im[i]);
+    }
+  }
+}
+
+/**
+ * Computes the convolution of the given image with this Gabor wavelet only at the given positions.
+ * @param image  The image in spatial domain
+ * @param positions  The positions (y,x) at which the responses should be computed
+ * @param responses  The responses of this wavelet at the given positions
+ */
+void bob::ip::gabor::SpatialWavelet::transform(
+  const blitz::Array<std::complex<double>,2>& image,
+  const std::vector<blitz::TinyVector<int,2>>& positions,
+  blitz::Array<std::complex<double>,1> responses
+) const
+{
+  BOB_IP_GABOR_STATS_TIME(SPATIAL_CONVOLUTION);
+  if (responses.extent(0) != (int)positions.size()){
+    throw std::runtime_error((boost::format("SpatialWavelet: the number of responses (%d) and positions (%d) differ") % responses.extent(0) % positions.size()).str());
+  }
+  const int height = image.extent(0), width = image.extent(1);
+
+  // fold the kernels to the current resolution
+  std::vector<std::complex<double>> gabor_x, gabor_y, gauss_x, gauss_y;
+  int pad_x, pad_y;
+  fold(m_gabor_x, width, gabor_x, pad_x);
+  fold(m_gabor_y, height, gabor_y, pad_y);
+  fold(m_gauss, width, gauss_x, pad_x);
+  fold(m_gauss, height, gauss_y, pad_y);
+
+  for (int p = 0; p < (int)positions.size(); ++p){
+    const int py = positions[p][0], px = positions[p][1];
+    std::complex<double> gabor(0.), gauss(0.);
+    for (int jy = 0; jy < (int)gabor_y.size(); ++jy){
+      int y = wrap(py + jy - pad_y, height);
+      std::complex<double> row_gabor(0.), row_gauss(0.);
+      for (int jx = 0; jx < (int)gabor_x.size(); ++jx){
+        const std::complex<double>& value = image(y, wrap(px + jx - pad_x, width));
+        row_gabor += value * gabor_x[jx];
+        row_gauss += value * gauss_x[jx];
+      }
+      gabor += row_gabor * gabor_y[jy];
+      gauss += row_gauss * gauss_y[jy];
+    }
+    responses(p) = m_factor * (gabor - m_dc * gauss);
+  }
+}
@@ -0,0 +1,84 @@
+/**
+ * @brief C++ implementations of the instrumentation of the stages of the Gabor wavelet transform and the similarity functions
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/Stats.h>
+
+#include <atomic>
+#include <map>
+
+static const std::map<bob::ip::gabor::Stats::Stage, std::string> stage_map = {
+  {bob::ip::gabor::Stats::WAVELET_GENERATION, "wavelet_generation"},
+  {bob::ip::gabor::Stats::FORWARD_FFT, "forward_fft"},
+  {bob::ip::gabor::Stats::WAVELET_MULTIPLY, "wavelet_multiply"},
+  {bob::ip::gabor::Stats::INVERSE_FFT, "inverse_fft"},
+  {bob::ip::gabor::Stats::SPATIAL_CONVOLUTION, "spatial_convolution"},
+  {bob::ip::gabor::Stats::RECURSIVE_FILTER, "recursive_filter"},
+  {bob::ip::gabor::Stats::SIMILARITY, "similarity"},
+  {bob::ip::gabor::Stats::DISPARITY_ESTIMATION, "disparity_estimation"}
+};
+
+static const std::map<bob::ip::gabor::Stats::Counter, std::string> counter_map = {
+  {bob::ip::gabor::Stats::WAVELET_RESETS, "wavelet_resets"},
+  {bob::ip::gabor::Stats::WAVELET_CACHE_HITS, "wavelet_cache_hits"},
+  {bob::ip::gabor::Stats::SCALAR_PRODUCT_CALLS, "ScalarProduct"},
+  {bob::ip::gabor::Stats::CANBERRA_CALLS, "Canberra"},
+  {bob::ip::gabor::Stats::ABS_PHASE_CALLS, "AbsPhase"},
+  {bob::ip::gabor::Stats::DISPARITY_CALLS, "Disparity"},
+  {bob::ip::gabor::Stats::PHASE_DIFF_CALLS, "PhaseDiff"},
+  {bob::ip::gabor::Stats::PHASE_DIFF_PLUS_CANBERRA_CALLS, "PhaseDiffPlusCanberra"}
+};
+
+// the statistics are updated with relaxed atomics, which is sufficient for accumulating
+static std::atomic<unsigned long long> stage_calls[bob::ip::gabor::Stats::NUMBER_OF_STAGES];
+static std::atomic<long long> stage_ticks[bob::ip::gabor::Stats::NUMBER_OF_STAGES];
+static std::atomic<unsigned long long> counters[bob::ip::gabor::Stats::NUMBER_OF_COUNTERS];
+
+const std::string& bob::ip::gabor::Stats::stage_to_name(bob::ip::gabor::Stats::Stage stage){
+  return stage_map.find(stage)->second;
+}
+
+const std::string& bob::ip::gabor::Stats::counter_to_name(bob::ip::gabor::Stats::Counter counter){
+  return counter_map.find(counter)->second;
+}
+
+bool bob::ip::gabor::Stats::enabled(){
+#ifdef BOB_IP_GABOR_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+unsigned long long bob::ip::gabor::Stats::calls(bob::ip::gabor::Stats::Stage stage){
+  return stage_calls[stage].load(std::memory_order_relaxed);
+}
+
+double bob::ip::gabor::Stats::seconds(bob::ip::gabor::Stats::Stage stage){
+  return std::chrono::duration<double>(std::chrono::steady_clock::duration(stage_ticks[stage].load(std::memory_order_relaxed))).count();
+}
+
+unsigned long long bob::ip::gabor::Stats::counter(bob::ip::gabor::Stats::Counter counter){
+  return counters[counter].load(std::memory_order_relaxed);
+}
+
+void bob::ip::gabor::Stats::reset(){
+  for (int i = 0; i < NUMBER_OF_STAGES; ++i){
+    stage_calls[i].store(0, std::memory_order_relaxed);
+    stage_ticks[i].store(0, std::memory_order_relaxed);
+  }
+  for (int i = 0; i < NUMBER_OF_COUNTERS; ++i){
+    counters[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void bob::ip::gabor::Stats::add(bob::ip::gabor::Stats::Stage stage, std::chrono::steady_clock::duration duration){
+  stage_calls[stage].fetch_add(1, std::memory_order_relaxed);
+  stage_ticks[stage].fetch_add(duration.count(), std::memory_order_relaxed);
+}
+
+void bob::ip::gabor::Stats::increment(bob::ip::gabor::Stats::Counter counter){
+  counters[counter].fetch_add(1, std::memory_order_relaxed);
+}
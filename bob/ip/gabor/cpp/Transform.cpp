@@ -8,6 +8,75 @@
  */
 
 #include <bob.ip.gabor/Transform.h>
+#include <bob.ip.gabor/Spectrum.h>
+#include <bob.ip.gabor/Stats.h>
+#include <boost/assign.hpp>
+#include <boost/format.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <mutex>
+#include <tuple>
+
+
+static const std::map<bob::ip::gabor::Transform::Engine, std::string> engine_map = boost::assign::map_list_of
+  (bob::ip::gabor::Transform::FREQUENCY_DOMAIN, "frequency")
+  (bob::ip::gabor::Transform::SPATIAL_DOMAIN, "spatial")
+  (bob::ip::gabor::Transform::AUTOMATIC, "automatic")
+  (bob::ip::gabor::Transform::RECURSIVE, "recursive")
+  ;
+
+const std::string& bob::ip::gabor::Transform::engine_to_name(bob::ip::gabor::Transform::Engine engine){
+  return engine_map.find(engine)->second;
+}
+
+bob::ip::gabor::Transform::Engine bob::ip::gabor::Transform::name_to_engine(const std::string& engine){
+  for (auto it = engine_map.begin(); it != engine_map.end(); ++it)
+    if (it->second == engine)
+      return it->first;
+  throw std::runtime_error("The given engine name '" + engine + "' does not name an appropriate Gabor wavelet transform engine.");
+}
+
+static const std::map<bob::ip::gabor::Transform::Padding, std::string> padding_map = boost::assign::map_list_of
+  (bob::ip::gabor::Transform::NO_PADDING, "none")
+  (bob::ip::gabor::Transform::ZERO_PADDING, "zero")
+  (bob::ip::gabor::Transform::REFLECT_PADDING, "reflect")
+  (bob::ip::gabor::Transform::SYMMETRIC_PADDING, "symmetric")
+  ;
+
+const std::string& bob::ip::gabor::Transform::padding_to_name(bob::ip::gabor::Transform::Padding padding){
+  return padding_map.find(padding)->second;
+}
+
+bob::ip::gabor::Transform::Padding bob::ip::gabor::Transform::name_to_padding(const std::string& padding){
+  for (auto it = padding_map.begin(); it != padding_map.end(); ++it)
+    if (it->second == padding)
+      return it->first;
+  throw std::runtime_error("The given padding name '" + padding + "' does not name an appropriate padding of the Gabor wavelet transform.");
+}
+
+/**
+ * Returns the smallest size that is not smaller than the given size and has only the prime factors 2, 3 and 5.
+ * For these sizes, the FFT is computed efficiently.
+ */
+int bob::ip::gabor::Transform::fftFriendlySize(int size){
+  for (int n = std::max(size, 1); ; ++n){
+    int m = n;
+    while (m % 2 == 0) m /= 2;
+    while (m % 3 == 0) m /= 3;
+    while (m % 5 == 0) m /= 5;
+    if (m == 1) return n;
+  }
+}
+
+// mirrors the index at the borders of the range [0, n[; the border elements are repeated when symmetric is set
+static inline int mirror(int i, int n, bool symmetric){
+  if (n == 1) return 0;
+  const int period = symmetric ? 2 * n : 2 * n - 2;
+  i %= period;
+  if (i < 0) i += period;
+  if (i < n) return i;
+  return symmetric ? period - 1 - i : period - i;
+}
 
 /**
  * Initializes a discrete family of Gabor wavelets
@@ -37,10 +106,14 @@ bob::ip::gabor::Transform::Transform(
   m_wavelets(),
   m_wavelet_frequencies(),
   m_fft(),
-  m_ifft(),
   m_number_of_scales(number_of_scales),
   m_number_of_directions(number_of_directions),
-  m_epsilon(epsilon)
+  m_epsilon(epsilon),
+  m_engine(FREQUENCY_DOMAIN),
+  m_spatial_epsilon(1e-4),
+  m_recursive_order(6),
+  m_padding(NO_PADDING),
+  m_share_wavelets(false)
 {
   computeWaveletFrequencies();
 }
@@ -56,11 +129,15 @@ bob::ip::gabor::Transform::Transform(
   m_dc_free(other.m_dc_free),
   m_wavelets(),
   m_wavelet_frequencies(),
-  m_fft(),
-  m_ifft(),
+  m_fft(other.m_fft.backend()),
   m_number_of_scales(other.m_number_of_scales),
   m_number_of_directions(other.m_number_of_directions),
-  m_epsilon(other.m_epsilon)
+  m_epsilon(other.m_epsilon),
+  m_engine(other.m_engine),
+  m_spatial_epsilon(other.m_spatial_epsilon),
+  m_recursive_order(other.m_recursive_order),
+  m_padding(other.m_padding),
+  m_share_wavelets(other.m_share_wavelets)
 {
   computeWaveletFrequencies();
 }
@@ -68,6 +145,11 @@ bob::ip::gabor::Transform::Transform(
 bob::ip::gabor::Transform::Transform(
   bob::io::base::HDF5File& file
 )
+: m_engine(FREQUENCY_DOMAIN),
+  m_spatial_epsilon(1e-4),
+  m_recursive_order(6),
+  m_padding(NO_PADDING),
+  m_share_wavelets(false)
 {
   load(file);
 }
@@ -84,11 +166,15 @@ bob::ip::gabor::Transform::operator =
   m_k_max = other.m_k_max;
   m_k_fac = other.m_k_fac;
   m_dc_free = other.m_dc_free;
-  m_fft = bob::sp::FFT2D();
-  m_ifft = bob::sp::IFFT2D();
+  m_fft = bob::ip::gabor::FFT(other.m_fft.backend());
   m_number_of_scales = other.m_number_of_scales;
   m_number_of_directions = other.m_number_of_directions;
   m_epsilon = other.m_epsilon;
+  m_engine = other.m_engine;
+  m_spatial_epsilon = other.m_spatial_epsilon;
+  m_recursive_order = other.m_recursive_order;
+  m_padding = other.m_padding;
+  m_share_wavelets = other.m_share_wavelets;
 
   computeWaveletFrequencies();
 
@@ -110,7 +196,8 @@ bob::ip::gabor::Transform::operator ==
          m_dc_free == other.m_dc_free &&
          m_number_of_scales == other.m_number_of_scales &&
          m_number_of_directions == other.m_number_of_directions &&
-         aeq(m_epsilon, other.m_epsilon);
+         aeq(m_epsilon, other.m_epsilon) &&
+         m_padding == other.m_padding;
 
 #undef aeq
 }
@@ -120,6 +207,9 @@ bob::ip::gabor::Transform::operator ==
  * Private function that computes the frequency vectors of the Gabor wavelets
  */
 void bob::ip::gabor::Transform::computeWaveletFrequencies(){
+  // the spatial and recursive wavelets depend on the frequencies
+  m_spatial_wavelets.clear();
+  m_recursive_wavelets.clear();
   // reserve enough space
   m_wavelet_frequencies.clear();
   m_wavelet_frequencies.reserve(m_number_of_scales * m_number_of_directions);
@@ -140,6 +230,40 @@ void bob::ip::gabor::Transform::computeWaveletFrequencies(){
     // move to the next frequency scale
     k_abs *= m_k_fac;
   } // for s
+
+  m_all_indices.resize(m_wavelet_frequencies.size());
+  for (int j = 0; j < (int)m_all_indices.size(); ++j) m_all_indices[j] = j;
+}
+
+/**
+ * Returns the indices of the Gabor wavelets with the given scales and directions.
+ * The indices are sorted by scale first, and by direction second, as are the wavelets.
+ * @param scales  The scale indices, in the range [0, numberOfScales()[
+ * @param directions  The direction indices, in the range [0, numberOfDirections()[
+ */
+std::vector<int> bob::ip::gabor::Transform::waveletIndices(
+  const std::vector<int>& scales,
+  const std::vector<int>& directions
+) const
+{
+  std::vector<bool> use_scale(m_number_of_scales, false), use_direction(m_number_of_directions, false);
+  for (auto it = scales.begin(); it != scales.end(); ++it){
+    if (*it < 0 || *it >= m_number_of_scales)
+      throw std::runtime_error((boost::format("The scale index %d is not in the range [0, %d[") % *it % m_number_of_scales).str());
+    use_scale[*it] = true;
+  }
+  for (auto it = directions.begin(); it != directions.end(); ++it){
+    if (*it < 0 || *it >= m_number_of_directions)
+      throw std::runtime_error((boost::format("The direction index %d is not in the range [0, %d[") % *it % m_number_of_directions).str());
+    use_direction[*it] = true;
+  }
+  std::vector<int> indices;
+  for (int s = 0; s < m_number_of_scales; ++s){
+    for (int d = 0; d < m_number_of_directions; ++d){
+      if (use_scale[s] && use_direction[d]) indices.push_back(s * m_number_of_directions + d);
+    }
+  }
+  return indices;
 }
 
 /**
@@ -152,52 +276,642 @@ void bob::ip::gabor::Transform::generateWavelets(
   int width
 )
 {
-  blitz::TinyVector<int,2> resolution(height, width);
-  if (height != (int)m_fft.getHeight() || width != (int)m_fft.getWidth() ){
-    // new kernels need to be generated
-    m_wavelets.resize(m_wavelet_frequencies.size());
+  prepareWavelets(height, width);
+  for (int j = 0; j < (int)m_wavelet_frequencies.size(); ++j){
+    if (!m_wavelets[j]) generateWavelet(j);
+  }
+}
 
-    for (int j = 0; j < (int)m_wavelet_frequencies.size(); ++j){
-      m_wavelets[j].reset(new bob::ip::gabor::Wavelet(resolution, m_wavelet_frequencies[j], m_sigma, m_pow_of_k, m_dc_free, m_epsilon));
+/**
+ * Sets the given Gabor wavelets, which need to be generated for the same resolution and with the parametrization of this class.
+ * @param wavelets  The wavelets to use; empty pointers are generated lazily
+ */
+void bob::ip::gabor::Transform::wavelets(
+  const std::vector<boost::shared_ptr<bob::ip::gabor::Wavelet>>& wavelets
+)
+{
+  if (wavelets.size() != m_wavelet_frequencies.size())
+    throw std::runtime_error((boost::format("Transform: %d wavelets are required, but %d are given") % m_wavelet_frequencies.size() % wavelets.size()).str());
+  int height = -1, width = -1;
+  for (int j = 0; j < (int)wavelets.size(); ++j){
+    const boost::shared_ptr<bob::ip::gabor::Wavelet>& wavelet = wavelets[j];
+    if (!wavelet) continue;
+    if (blitz::any(wavelet->frequency() != m_wavelet_frequencies[j]) || wavelet->sigma() != m_sigma || wavelet->powOfK() != m_pow_of_k || wavelet->dcFree() != m_dc_free || wavelet->epsilon() != m_epsilon){
+      throw std::runtime_error((boost::format("Transform: wavelet %d was generated with another parametrization than the one of this Gabor wavelet family") % j).str());
+    }
+    if (height < 0){
+      height = wavelet->m_y_resolution;
+      width = wavelet->m_x_resolution;
+    } else if (wavelet->m_y_resolution != height || wavelet->m_x_resolution != width){
+      throw std::runtime_error((boost::format("Transform: all wavelets need to have the same resolution, but (%d, %d) differs from (%d, %d)") % wavelet->m_y_resolution % wavelet->m_x_resolution % height % width).str());
     }
+  }
+  // nothing to set
+  if (height < 0) return;
+  prepareWavelets(height, width);
+  m_wavelets = wavelets;
+}
+
+/**
+ * Prepares the FFT for the given resolution.
+ * When the resolution changed, all wavelets are removed; they are generated when they are first used.
+ */
+void bob::ip::gabor::Transform::prepareWavelets(
+  int height,
+  int width
+)
+{
+  if (height != (int)m_fft.getHeight() || width != (int)m_fft.getWidth() || m_wavelets.size() != m_wavelet_frequencies.size()){
+    // new kernels need to be generated
+    BOB_IP_GABOR_STATS_COUNT(WAVELET_RESETS);
+    m_wavelets.assign(m_wavelet_frequencies.size(), boost::shared_ptr<bob::ip::gabor::Wavelet>());
 
     // reset fft sizes
     m_fft.setShape(height, width);
-    m_ifft.setShape(height, width);
     m_temp_array.resize(blitz::shape(height,width));
     m_temp_array2.resize(m_temp_array.shape());
     m_frequency_image.resize(m_temp_array.shape());
   }
 }
 
+// The wavelets that are shared between Transform objects, identified by all parameters of the Wavelet constructor.
+// Only weak pointers are stored, so that wavelets are released when no Transform uses them any more.
+typedef std::tuple<int, int, double, double, double, double, bool, double> WaveletKey;
+static std::mutex shared_wavelets_mutex;
+static std::map<WaveletKey, boost::weak_ptr<bob::ip::gabor::Wavelet>> shared_wavelets;
+
+/**
+ * Generates the wavelet with the given index for the current resolution.
+ * When wavelets are shared, an existing wavelet with the same parametrization is used instead.
+ * @param index  The index of the wavelet
+ */
+void bob::ip::gabor::Transform::generateWavelet(
+  int index
+)
+{
+  const int height = m_fft.getHeight(), width = m_fft.getWidth();
+  const blitz::TinyVector<double,2>& frequency = m_wavelet_frequencies[index];
+  if (!m_share_wavelets){
+    m_wavelets[index].reset(new bob::ip::gabor::Wavelet(blitz::TinyVector<int,2>(height, width), frequency, m_sigma, m_pow_of_k, m_dc_free, m_epsilon));
+    return;
+  }
+
+  const WaveletKey key(height, width, frequency[0], frequency[1], m_sigma, m_pow_of_k, m_dc_free, m_epsilon);
+  {
+    std::lock_guard<std::mutex> lock(shared_wavelets_mutex);
+    auto it = shared_wavelets.find(key);
+    if (it != shared_wavelets.end()){
+      m_wavelets[index] = it->second.lock();
+      if (m_wavelets[index]) return;
+    }
+  }
+
+  // generate the wavelet outside of the lock; when another thread was faster, its wavelet is used
+  boost::shared_ptr<bob::ip::gabor::Wavelet> wavelet(new bob::ip::gabor::Wavelet(blitz::TinyVector<int,2>(height, width), frequency, m_sigma, m_pow_of_k, m_dc_free, m_epsilon));
+  std::lock_guard<std::mutex> lock(shared_wavelets_mutex);
+  // remove the wavelets that are no longer used
+  for (auto it = shared_wavelets.begin(); it != shared_wavelets.end();){
+    if (it->second.expired()) it = shared_wavelets.erase(it);
+    else ++it;
+  }
+  boost::weak_ptr<bob::ip::gabor::Wavelet>& shared = shared_wavelets[key];
+  m_wavelets[index] = shared.lock();
+  if (!m_wavelets[index]){
+    m_wavelets[index] = wavelet;
+    shared = wavelet;
+  }
+}
+
+/**
+ * Generates the truncated Gabor wavelets in spatial domain, if they do not exist yet.
+ * Since the spatial wavelets are independent of the image resolution, they are generated only once.
+ */
+void bob::ip::gabor::Transform::generateSpatialWavelets(){
+  if (m_spatial_wavelets.size() != m_wavelet_frequencies.size()){
+    m_spatial_wavelets.resize(m_wavelet_frequencies.size());
+    for (int j = 0; j < (int)m_wavelet_frequencies.size(); ++j){
+      m_spatial_wavelets[j].reset(new bob::ip::gabor::SpatialWavelet(m_wavelet_frequencies[j], m_sigma, m_pow_of_k, m_dc_free, m_spatial_epsilon));
+    }
+  }
+}
+
+/**
+ * Generates the recursive Gabor wavelet filters, if they do not exist yet.
+ * As the spatial wavelets, they are independent of the image resolution.
+ */
+void bob::ip::gabor::Transform::generateRecursiveWavelets(){
+  if (m_recursive_wavelets.size() != m_wavelet_frequencies.size()){
+    m_recursive_wavelets.resize(m_wavelet_frequencies.size());
+    for (int j = 0; j < (int)m_wavelet_frequencies.size(); ++j){
+      m_recursive_wavelets[j].reset(new bob::ip::gabor::RecursiveWavelet(m_wavelet_frequencies[j], m_sigma, m_pow_of_k, m_dc_free, m_spatial_epsilon, m_recursive_order));
+    }
+  }
+}
+
+void bob::ip::gabor::Transform::spatialEpsilon(double epsilon){
+  if (epsilon <= 0. || epsilon >= 1.){
+    throw std::runtime_error((boost::format("The epsilon %g for the spatial domain Gabor wavelets must be in range ]0,1[") % epsilon).str());
+  }
+  m_spatial_epsilon = epsilon;
+  m_spatial_wavelets.clear();
+  m_recursive_wavelets.clear();
+}
+
+void bob::ip::gabor::Transform::recursiveOrder(int order){
+  if (order != 4 && order != 6 && order != 8){
+    throw std::runtime_error((boost::format("The order %d of the recursive Gabor wavelets must be 4, 6 or 8") % order).str());
+  }
+  m_recursive_order = order;
+  m_recursive_wavelets.clear();
+}
+
+/**
+ * Estimates the number of floating point operations of both engines and returns true if the spatial domain engine is cheaper.
+ * If the engine is not set to AUTOMATIC, the decision is taken by the engine.
+ * @param height  The height of the image to transform
+ * @param width   The width of the image to transform
+ * @param number_of_positions  The number of positions, at which the responses are required; use -1 for the whole image
+ */
+bool bob::ip::gabor::Transform::useSpatialDomain(
+  int height,
+  int width,
+  int number_of_positions
+) const
+{
+  switch (m_engine){
+    case FREQUENCY_DOMAIN:
+    case RECURSIVE: return false;
+    case SPATIAL_DOMAIN: return true;
+    default: break;
+  }
+
+  const double pixels = (double)height * width;
+  const double wavelets = m_wavelet_frequencies.size();
+  // one forward and one inverse FFT per wavelet with roughly 5 N log2(N) operations each, plus the multiplication with the wavelets
+  double frequency_costs = (wavelets + 1.) * 5. * pixels * std::log2(pixels) + wavelets * 6. * pixels;
+
+  // one complex multiply-add per kernel tap, and another real-valued one for the DC term
+  const double tap_costs = m_dc_free ? 12. : 8.;
+  double spatial_costs = 0.;
+  for (auto it = m_wavelet_frequencies.begin(); it != m_wavelet_frequencies.end(); ++it){
+    int taps = 2 * bob::ip::gabor::SpatialWavelet::radius(*it, m_sigma, m_spatial_epsilon) + 1;
+    double taps_y = std::min(taps, height), taps_x = std::min(taps, width);
+    if (number_of_positions < 0){
+      // separable convolution of the whole image
+      spatial_costs += pixels * (taps_y + taps_x) * tap_costs;
+    } else {
+      // full kernel at each requested position
+      spatial_costs += number_of_positions * taps_y * taps_x * tap_costs;
+    }
+  }
+  return spatial_costs < frequency_costs;
+}
+
+/**
+ * Returns the shape of the image that is actually transformed, i.e., including the padding
+ */
+blitz::TinyVector<int,2> bob::ip::gabor::Transform::paddedShape(int height, int width) const{
+  if (m_padding == NO_PADDING)
+    return blitz::TinyVector<int,2>(height, width);
+  return blitz::TinyVector<int,2>(fftFriendlySize(height), fftFriendlySize(width));
+}
+
+/**
+ * Pads the given image centrally into the padded image, using the current padding mode
+ */
+void bob::ip::gabor::Transform::pad(
+  const blitz::Array<std::complex<double>,2>& image,
+  blitz::Array<std::complex<double>,2>& padded
+) const
+{
+  const int height = image.extent(0), width = image.extent(1);
+  const int top = (padded.extent(0) - height) / 2, left = (padded.extent(1) - width) / 2;
+  if (m_padding == ZERO_PADDING){
+    padded = 0.;
+    padded(blitz::Range(top, top + height - 1), blitz::Range(left, left + width - 1)) = image;
+  } else {
+    const bool symmetric = m_padding == SYMMETRIC_PADDING;
+    for (int y = 0; y < padded.extent(0); ++y){
+      const int iy = mirror(y - top, height, symmetric);
+      for (int x = 0; x < padded.extent(1); ++x){
+        padded(y,x) = image(iy, mirror(x - left, width, symmetric));
+      }
+    }
+  }
+}
+
 /**
  * Computes the Gabor wavelet transformation for the given image (in spatial domain)
+ * If padding is enabled, the image is padded to an FFT friendly size, and the trafo image is cropped afterwards.
  * @param gray_image  The source image in spatial domain
  * @param trafo_image The convolution result, in spatial domain
  */
 void bob::ip::gabor::Transform::transform_inner(
   const blitz::Array<std::complex<double>,2>& gray_image,
+  const std::vector<int>& indices,
   blitz::Array<std::complex<double>,3>& trafo_image
 )
 {
-  // check that the shape is correct
-  bob::core::array::assertSameShape(trafo_image, blitz::shape(m_wavelet_frequencies.size(), gray_image.extent(0), gray_image.extent(1)));
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  // check that the shape and the indices are correct
+  bob::core::array::assertSameShape(trafo_image, blitz::shape(indices.size(), height, width));
+  checkIndices(indices);
+
+  blitz::TinyVector<int,2> shape = paddedShape(height, width);
+  if (shape[0] == height && shape[1] == width){
+    transform_engine(gray_image, indices, trafo_image);
+    return;
+  }
+
+  // pad the image, transform it and crop the result
+  m_padded_image.resize(shape);
+  pad(gray_image, m_padded_image);
+  m_trafo_image.resize(indices.size(), shape[0], shape[1]);
+  transform_engine(m_padded_image, indices, m_trafo_image);
+  const int top = (shape[0] - height) / 2, left = (shape[1] - width) / 2;
+  trafo_image = m_trafo_image(blitz::Range::all(), blitz::Range(top, top + height - 1), blitz::Range(left, left + width - 1));
+}
+
+/**
+ * Computes the Gabor wavelet transformation of the given image with the given wavelets and the current engine, without any padding
+ * @param gray_image  The source image in spatial domain
+ * @param indices  The indices of the wavelets to apply; the i-th layer of the trafo image is computed with wavelet indices[i]
+ * @param trafo_image The convolution result, in spatial domain
+ */
+void bob::ip::gabor::Transform::transform_engine(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const std::vector<int>& indices,
+  blitz::Array<std::complex<double>,3>& trafo_image
+)
+{
+  if (m_engine == RECURSIVE){
+    // filter the image with the recursive wavelets
+    generateRecursiveWavelets();
+    m_smoothed_image.resize(gray_image.shape());
+    int smoothed_scale = -1;
+    for (int i = 0; i < (int)indices.size(); ++i){
+      const int j = indices[i];
+      // the DC part only depends on the scale, so it is shared between all directions
+      if (m_dc_free && j / m_number_of_directions != smoothed_scale){
+        smoothed_scale = j / m_number_of_directions;
+        m_recursive_wavelets[j]->smooth(gray_image, m_smoothed_image);
+      }
+      blitz::Array<std::complex<double>,2> layer(trafo_image(i, blitz::Range::all(), blitz::Range::all()));
+      m_recursive_wavelets[j]->transform(gray_image, m_smoothed_image, layer);
+    }
+    return;
+  }
+
+  if (useSpatialDomain(gray_image.extent(0), gray_image.extent(1))){
+    // convolve the image with the truncated wavelets
+    generateSpatialWavelets();
+    for (int i = 0; i < (int)indices.size(); ++i){
+      blitz::Array<std::complex<double>,2> layer(trafo_image(i, blitz::Range::all(), blitz::Range::all()));
+      m_spatial_wavelets[indices[i]]->transform(gray_image, layer);
+    }
+    return;
+  }
 
   // first, check if we need to reset the kernels
-  generateWavelets(gray_image.extent(0), gray_image.extent(1));
+  prepareWavelets(gray_image.extent(0), gray_image.extent(1));
 
   // perform Fourier transformation to image
-  m_fft(gray_image, m_frequency_image);
+  m_fft.forward(gray_image, m_frequency_image);
+
+  transform_frequency(m_frequency_image, indices, trafo_image);
+}
+
+/**
+ * Applies the given Gabor wavelets to the given image in frequency domain, and transforms the results back to spatial domain.
+ * Wavelets that were not used before for this resolution are generated.
+ * @param frequency_image  The FFT of the (padded) image
+ * @param indices  The indices of the wavelets to apply
+ * @param trafo_image  The convolution results in spatial domain, with the same resolution as the frequency image
+ */
+void bob::ip::gabor::Transform::transform_frequency(
+  const blitz::Array<std::complex<double>,2>& frequency_image,
+  const std::vector<int>& indices,
+  blitz::Array<std::complex<double>,3>& trafo_image
+)
+{
+  const int height = frequency_image.extent(0), width = frequency_image.extent(1);
+  prepareWavelets(height, width);
 
   // now, let each kernel compute the transformation result
-  for (int j = 0; j < (int)m_wavelets.size(); ++j){
+  for (int i = 0; i < (int)indices.size(); ++i){
+    const int j = indices[i];
+    if (!m_wavelets[j]){
+      generateWavelet(j);
+    } else {
+      BOB_IP_GABOR_STATS_COUNT(WAVELET_CACHE_HITS);
+    }
     // compute Gabor wavelet transform in frequency domain
-    m_wavelets[j]->transform(m_frequency_image, m_temp_array);
+    m_wavelets[j]->transform(frequency_image, m_temp_array);
     // get a reference to the current layer of the trafo image
-    blitz::Array<std::complex<double>,2> layer(trafo_image(j, blitz::Range::all(), blitz::Range::all()));
+    blitz::Array<std::complex<double>,2> layer(trafo_image(i, blitz::Range::all(), blitz::Range::all()));
     // perform ifft on the trafo image layer
-    m_ifft(m_temp_array, layer);
-  } // for j
+    m_fft.inverse(m_temp_array, layer);
+  } // for i
+}
+
+/**
+ * Computes the FFT of the given image, which is padded according to the current padding
+ * @param gray_image  The image in spatial domain
+ * @param spectrum  The spectrum that will contain the FFT of the padded image
+ */
+void bob::ip::gabor::Transform::spectrum_inner(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  bob::ip::gabor::Spectrum& spectrum
+)
+{
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  blitz::TinyVector<int,2> shape = paddedShape(height, width);
+  spectrum.m_height = height;
+  spectrum.m_width = width;
+  spectrum.m_padding = m_padding;
+  spectrum.m_frequency_image.resize(shape);
+
+  // prepare the FFT for the padded resolution
+  prepareWavelets(shape[0], shape[1]);
+  if (shape[0] == height && shape[1] == width){
+    m_fft.forward(gray_image, spectrum.m_frequency_image);
+  } else {
+    m_padded_image.resize(shape);
+    pad(gray_image, m_padded_image);
+    m_fft.forward(m_padded_image, spectrum.m_frequency_image);
+  }
+}
+
+/**
+ * Computes the Gabor wavelet transformation of the image, whose spectrum is given.
+ * The spectrum must have been computed with the same padding as used by this class.
+ * @param spectrum  The spectrum of the image, see spectrum()
+ * @param indices  The indices of the wavelets to apply
+ * @param trafo_image The convolution result, in spatial domain
+ */
+void bob::ip::gabor::Transform::transform(
+  const bob::ip::gabor::Spectrum& spectrum,
+  const std::vector<int>& indices,
+  blitz::Array<std::complex<double>,3>& trafo_image
+)
+{
+  if (spectrum.padding() != m_padding)
+    throw std::runtime_error("The spectrum was computed with padding '" + padding_to_name(spectrum.padding()) + "', but this transform uses padding '" + padding_to_name(m_padding) + "'");
+  const int height = spectrum.height(), width = spectrum.width();
+  bob::core::array::assertSameShape(trafo_image, blitz::shape(indices.size(), height, width));
+  checkIndices(indices);
+
+  const blitz::Array<std::complex<double>,2>& frequency_image = spectrum.frequencyImage();
+  if (frequency_image.extent(0) == height && frequency_image.extent(1) == width){
+    transform_frequency(frequency_image, indices, trafo_image);
+    return;
+  }
+
+  m_trafo_image.resize(indices.size(), frequency_image.extent(0), frequency_image.extent(1));
+  transform_frequency(frequency_image, indices, m_trafo_image);
+  const int top = (frequency_image.extent(0) - height) / 2, left = (frequency_image.extent(1) - width) / 2;
+  trafo_image = m_trafo_image(blitz::Range::all(), blitz::Range(top, top + height - 1), blitz::Range(left, left + width - 1));
+}
+
+/**
+ * Computes the Gabor wavelet responses for the given image only at the given positions
+ * @param gray_image  The source image in spatial domain
+ * @param positions   The positions (y,x) inside the image, where the responses are computed
+ * @param responses   The responses of all wavelets, of shape (positions.size(), numberOfWavelets())
+ */
+void bob::ip::gabor::Transform::transform_inner(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const std::vector<blitz::TinyVector<int,2>>& positions,
+  blitz::Array<std::complex<double>,2>& responses
+)
+{
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  checkPositions(positions, height, width, responses);
+
+  blitz::TinyVector<int,2> shape = paddedShape(height, width);
+  if (shape[0] == height && shape[1] == width){
+    transform_engine(gray_image, positions, responses);
+    return;
+  }
+
+  // pad the image and shift the positions accordingly
+  m_padded_image.resize(shape);
+  pad(gray_image, m_padded_image);
+  const blitz::TinyVector<int,2> offset((shape[0] - height) / 2, (shape[1] - width) / 2);
+  std::vector<blitz::TinyVector<int,2>> shifted(positions.size());
+  for (int p = 0; p < (int)positions.size(); ++p){
+    shifted[p] = positions[p] + offset;
+  }
+  transform_engine(m_padded_image, shifted, responses);
+}
+
+/**
+ * Computes the Gabor wavelet responses at the given positions with the current engine, without any padding
+ */
+void bob::ip::gabor::Transform::transform_engine(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const std::vector<blitz::TinyVector<int,2>>& positions,
+  blitz::Array<std::complex<double>,2>& responses
+)
+{
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  if (useSpatialDomain(height, width, positions.size())){
+    // compute only the requested responses
+    generateSpatialWavelets();
+    for (int j = 0; j < (int)m_spatial_wavelets.size(); ++j){
+      m_spatial_wavelets[j]->transform(gray_image, positions, responses(blitz::Range::all(), j));
+    }
+  } else {
+    // compute the full trafo image and pick the responses
+    m_trafo_image.resize(m_wavelet_frequencies.size(), height, width);
+    transform_engine(gray_image, m_all_indices, m_trafo_image);
+    for (int p = 0; p < (int)positions.size(); ++p){
+      responses(p, blitz::Range::all()) = m_trafo_image(blitz::Range::all(), positions[p][0], positions[p][1]);
+    }
+  }
+}
+
+/**
+ * Computes the Gabor wavelet transform of the given image only inside the region of interest.
+ * The complete image is filtered, so that the result is identical to the corresponding part of the full transform.
+ * @param gray_image  The source image in spatial domain
+ * @param offset  The upper left position (y,x) of the region of interest
+ * @param trafo_roi  The convolution result inside the region of interest, of shape (numberOfWavelets(), roi_height, roi_width)
+ */
+void bob::ip::gabor::Transform::transform_inner(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const blitz::TinyVector<int,2>& offset,
+  blitz::Array<std::complex<double>,3>& trafo_roi
+)
+{
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  if (trafo_roi.extent(0) != (int)m_wavelet_frequencies.size())
+    throw std::runtime_error((boost::format("The trafo image of the region of interest needs %d layers, but has %d") % m_wavelet_frequencies.size() % trafo_roi.extent(0)).str());
+  if (offset[0] < 0 || offset[1] < 0 || offset[0] + trafo_roi.extent(1) > height || offset[1] + trafo_roi.extent(2) > width)
+    throw std::runtime_error((boost::format("The region of interest of size %i x %i at (%i,%i) is out of the image boundaries %i x %i") % trafo_roi.extent(1) % trafo_roi.extent(2) % offset[0] % offset[1] % height % width).str());
+
+  blitz::TinyVector<int,2> shape = paddedShape(height, width);
+  if (shape[0] == height && shape[1] == width){
+    transform_engine(gray_image, offset, trafo_roi);
+    return;
+  }
+
+  // pad the image and shift the region of interest accordingly
+  m_padded_image.resize(shape);
+  pad(gray_image, m_padded_image);
+  transform_engine(m_padded_image, offset + blitz::TinyVector<int,2>((shape[0] - height) / 2, (shape[1] - width) / 2), trafo_roi);
+}
+
+/**
+ * Computes the Gabor wavelet transform inside the region of interest with the current engine, without any padding
+ */
+void bob::ip::gabor::Transform::transform_engine(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const blitz::TinyVector<int,2>& offset,
+  blitz::Array<std::complex<double>,3>& trafo_roi
+)
+{
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  const blitz::Range all = blitz::Range::all(), rows(offset[0], offset[0] + trafo_roi.extent(1) - 1), columns(offset[1], offset[1] + trafo_roi.extent(2) - 1);
+  if (m_engine == RECURSIVE){
+    // the recursive filters cannot be restricted, so the full image is filtered
+    m_trafo_image.resize(m_wavelet_frequencies.size(), height, width);
+    transform_engine(gray_image, m_all_indices, m_trafo_image);
+    trafo_roi = m_trafo_image(all, rows, columns);
+    return;
+  }
+
+  if (useSpatialDomain(height, width, trafo_roi.extent(1) * trafo_roi.extent(2))){
+    // compute the responses only at the positions inside the region of interest
+    std::vector<blitz::TinyVector<int,2>> positions;
+    positions.reserve(trafo_roi.extent(1) * trafo_roi.extent(2));
+    for (int y = rows.first(); y <= rows.last(); ++y){
+      for (int x = columns.first(); x <= columns.last(); ++x){
+        positions.push_back(blitz::TinyVector<int,2>(y, x));
+      }
+    }
+    generateSpatialWavelets();
+    m_responses.resize(positions.size());
+    for (int j = 0; j < (int)m_spatial_wavelets.size(); ++j){
+      m_spatial_wavelets[j]->transform(gray_image, positions, m_responses);
+      int p = 0;
+      for (int y = 0; y < trafo_roi.extent(1); ++y){
+        for (int x = 0; x < trafo_roi.extent(2); ++x, ++p){
+          trafo_roi(j, y, x) = m_responses(p);
+        }
+      }
+    }
+    return;
+  }
+
+  // filter the full spectrum, but transform back only the region of interest
+  prepareWavelets(height, width);
+  m_fft.forward(gray_image, m_frequency_image);
+  for (int j = 0; j < (int)m_wavelet_frequencies.size(); ++j){
+    if (!m_wavelets[j]){
+      generateWavelet(j);
+    } else {
+      BOB_IP_GABOR_STATS_COUNT(WAVELET_CACHE_HITS);
+    }
+    m_wavelets[j]->transform(m_frequency_image, m_temp_array);
+    blitz::Array<std::complex<double>,2> layer(trafo_roi(j, all, all));
+    m_fft.inverse(m_temp_array, offset, layer);
+  }
+}
+
+
+void bob::ip::gabor::Transform::checkIndices(const std::vector<int>& indices) const{
+  for (auto it = indices.begin(); it != indices.end(); ++it){
+    if (*it < 0 || *it >= (int)m_wavelet_frequencies.size())
+      throw std::runtime_error((boost::format("The wavelet index %d is not in the range [0, %d[") % *it % m_wavelet_frequencies.size()).str());
+  }
+}
+
+void bob::ip::gabor::Transform::checkPositions(
+  const std::vector<blitz::TinyVector<int,2>>& positions,
+  int height,
+  int width,
+  const blitz::Array<std::complex<double>,2>& responses
+) const
+{
+  bob::core::array::assertSameShape(responses, blitz::shape(positions.size(), m_wavelet_frequencies.size()));
+  for (auto it = positions.begin(); it != positions.end(); ++it){
+    if ((*it)[0] < 0 || (*it)[0] >= height || (*it)[1] < 0 || (*it)[1] >= width)
+      throw std::runtime_error((boost::format("The position (%i,%i) is out of the image boundaries %i x %i") % (*it)[0] % (*it)[1] % height % width).str());
+  }
+}
+
+
+/**
+ * Returns the margin of the tiles, which is the largest radius of the truncated wavelets.
+ * Beyond this radius, the wavelets are below spatialEpsilon(), so that the tiles do not influence each other.
+ */
+int bob::ip::gabor::Transform::tileMargin() const{
+  int margin = 0;
+  for (auto it = m_wavelet_frequencies.begin(); it != m_wavelet_frequencies.end(); ++it){
+    margin = std::max(margin, bob::ip::gabor::SpatialWavelet::radius(*it, m_sigma, m_spatial_epsilon));
+  }
+  return margin;
+}
+
+/**
+ * Adapts the given tile size, so that the tiles including their margins have FFT friendly sizes.
+ */
+blitz::TinyVector<int,2> bob::ip::gabor::Transform::tileShape(const blitz::TinyVector<int,2>& tile_size) const{
+  if (tile_size[0] <= 0 || tile_size[1] <= 0)
+    throw std::runtime_error((boost::format("The tile size %i x %i is invalid") % tile_size[0] % tile_size[1]).str());
+  const int margin = tileMargin();
+  return blitz::TinyVector<int,2>(fftFriendlySize(tile_size[0] + 2 * margin) - 2 * margin, fftFriendlySize(tile_size[1] + 2 * margin) - 2 * margin);
+}
+
+/**
+ * Computes the indices of the image pixels that are copied to the extended tile.
+ * Pixels outside the image are mirrored or wrapped, depending on the padding; for zero padding, -1 is returned.
+ */
+void bob::ip::gabor::Transform::tileIndices(int start, int length, int size, std::vector<int>& indices) const{
+  indices.resize(length);
+  for (int i = 0; i < length; ++i){
+    int index = start + i;
+    if (index < 0 || index >= size){
+      switch (m_padding){
+        case NO_PADDING: index = ((index % size) + size) % size; break;
+        case ZERO_PADDING: index = -1; break;
+        case REFLECT_PADDING: index = mirror(index, size, false); break;
+        case SYMMETRIC_PADDING: index = mirror(index, size, true); break;
+      }
+    }
+    indices[i] = index;
+  }
+}
+
+/**
+ * Transforms the current extended tile and passes the valid part to the sink.
+ */
+void bob::ip::gabor::Transform::transformTile(
+  const blitz::TinyVector<int,2>& offset,
+  const blitz::TinyVector<int,2>& size,
+  const TileSink& sink
+)
+{
+  const int margin = tileMargin();
+  m_tile_trafo.resize(m_wavelet_frequencies.size(), m_tile_image.extent(0), m_tile_image.extent(1));
+  transform_engine(m_tile_image, m_all_indices, m_tile_trafo);
+  sink(offset, m_tile_trafo(blitz::Range::all(), blitz::Range(margin, margin + size[0] - 1), blitz::Range(margin, margin + size[1] - 1)));
+}
+
+void bob::ip::gabor::Transform::collectResponses(
+  const blitz::TinyVector<int,2>& offset,
+  const blitz::Array<std::complex<double>,3>& trafo_tile,
+  const std::vector<blitz::TinyVector<int,2>>& positions,
+  blitz::Array<std::complex<double>,2>& responses
+)
+{
+  for (int p = 0; p < (int)positions.size(); ++p){
+    const int y = positions[p][0] - offset[0], x = positions[p][1] - offset[1];
+    if (y >= 0 && y < trafo_tile.extent(1) && x >= 0 && x < trafo_tile.extent(2)){
+      responses(p, blitz::Range::all()) = trafo_tile(blitz::Range::all(), y, x);
+    }
+  }
 }
 
 
@@ -210,6 +924,9 @@ void bob::ip::gabor::Transform::save(bob::io::base::HDF5File& file) const{
   file.set("NumberOfScales", m_number_of_scales);
   file.set("NumberOfDirections", m_number_of_directions);
   file.set("Epsilon", m_epsilon);
+  // only write the padding when it is used, so that older versions can still read the file
+  if (m_padding != NO_PADDING)
+    file.set("Padding", padding_to_name(m_padding));
 }
 
 void bob::ip::gabor::Transform::load(bob::io::base::HDF5File& file){
@@ -221,7 +938,10 @@ void bob::ip::gabor::Transform::load(bob::io::base::HDF5File& file){
   m_number_of_scales = file.read<int>("NumberOfScales");
   m_number_of_directions = file.read<int>("NumberOfDirections");
   m_epsilon = file.read<double>("Epsilon");
+  m_padding = file.contains("Padding") ? name_to_padding(file.read<std::string>("Padding")) : NO_PADDING;
 
+  // the wavelets need to be regenerated with the new parametrization
+  m_fft = bob::ip::gabor::FFT(m_fft.backend());
   computeWaveletFrequencies();
 }
 
@@ -0,0 +1,268 @@
+/**
+ * @brief C++ implementations of the asynchronous Gabor wavelet transform of streams of images
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/TransformStream.h>
+#include <boost/format.hpp>
+
+/**
+ * Creates a stream that computes the Gabor wavelet transform of the pushed frames
+ * @param transform  The Gabor wavelet transform; each thread uses its own copy
+ * @param number_of_threads  The number of worker threads that compute the inverse FFTs; if 0, the number of cores is used
+ * @param capacity  The number of frames that can be pushed without being popped; if 0, twice the number of threads is used
+ */
+bob::ip::gabor::TransformStream::TransformStream(
+  const bob::ip::gabor::Transform& transform,
+  int number_of_threads,
+  int capacity
+)
+{
+  start(transform, number_of_threads, capacity);
+}
+
+/**
+ * Creates a stream that extracts the Gabor jets at the nodes of the given graph from the pushed frames
+ * @param transform  The Gabor wavelet transform; each thread uses its own copy
+ * @param graph  The graph defining the positions of the Gabor jets
+ * @param number_of_threads  The number of worker threads that compute the inverse FFTs; if 0, the number of cores is used
+ * @param capacity  The number of frames that can be pushed without being popped; if 0, twice the number of threads is used
+ */
+bob::ip::gabor::TransformStream::TransformStream(
+  const bob::ip::gabor::Transform& transform,
+  const bob::ip::gabor::Graph& graph,
+  int number_of_threads,
+  int capacity
+)
+: m_graph(new bob::ip::gabor::Graph(graph))
+{
+  start(transform, number_of_threads, capacity);
+}
+
+bob::ip::gabor::TransformStream::~TransformStream(){
+  close();
+  m_spectrum_thread.join();
+  for (auto it = m_threads.begin(); it != m_threads.end(); ++it){
+    it->join();
+  }
+}
+
+void bob::ip::gabor::TransformStream::start(const bob::ip::gabor::Transform& transform, int number_of_threads, int capacity){
+  if (number_of_threads < 0 || capacity < 0)
+    throw std::runtime_error((boost::format("TransformStream: the number of threads (%d) and the capacity (%d) must not be negative") % number_of_threads % capacity).str());
+  if (!number_of_threads) number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+  m_capacity = capacity ? capacity : 2 * number_of_threads;
+  m_pushed = m_popped = 0;
+  m_processing = 0;
+  m_closed = m_prepared = false;
+
+  // split the wavelets into one contiguous chunk per worker
+  const int wavelets = transform.numberOfWavelets(), chunks = std::min(number_of_threads, wavelets);
+  m_chunks.resize(chunks);
+  for (int j = 0; j < wavelets; ++j){
+    m_chunks[j * chunks / wavelets].push_back(j);
+  }
+
+  // each thread has its own copy of the transform (and, hence, its own FFT memory), but all of them share the generated wavelets
+  for (int i = 0; i <= number_of_threads; ++i){
+    m_transforms.push_back(boost::shared_ptr<bob::ip::gabor::Transform>(new bob::ip::gabor::Transform(transform)));
+    m_transforms.back()->shareWavelets(true);
+  }
+  for (int i = 1; i <= number_of_threads; ++i){
+    m_threads.push_back(std::thread(&bob::ip::gabor::TransformStream::work, this, std::ref(*m_transforms[i])));
+  }
+  m_spectrum_thread = std::thread(&bob::ip::gabor::TransformStream::prepare, this, std::ref(*m_transforms[0]));
+}
+
+int bob::ip::gabor::TransformStream::pending() const{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pushed - m_popped;
+}
+
+void bob::ip::gabor::TransformStream::pushFrame(const blitz::Array<std::complex<double>,2>& frame){
+  boost::shared_ptr<Frame> f(new Frame);
+  f->image.reference(frame);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_space_available.wait(lock, [this](){return m_closed || m_pushed - m_popped < (uint64_t)m_capacity;});
+  if (m_closed)
+    throw std::runtime_error("TransformStream: cannot push frames after the stream was closed");
+  m_input.push_back(std::make_pair(m_pushed++, f));
+  m_input_available.notify_one();
+}
+
+void bob::ip::gabor::TransformStream::close(){
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_closed = true;
+  m_input_available.notify_all();
+  m_output_available.notify_all();
+  m_space_available.notify_all();
+}
+
+/**
+ * Computes the spectra of the frames of the input queue and passes one task per chunk of wavelets to the worker threads, until the stream is closed.
+ * At most two frames are processed by the workers at the same time, so that the spectrum of the next frame is computed while the current frame is transformed.
+ * Frames that are not transformed in frequency domain are passed to one worker as a whole; then, all workers can process a frame at the same time.
+ */
+void bob::ip::gabor::TransformStream::prepare(bob::ip::gabor::Transform& transform){
+  while (true){
+    std::pair<uint64_t, boost::shared_ptr<Frame>> next;
+    bool staged;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_input_available.wait(lock, [this](){return m_closed || !m_input.empty();});
+      if (m_input.empty()){
+        // no more frames will be pushed
+        m_prepared = true;
+        m_tasks_available.notify_all();
+        return;
+      }
+      const blitz::Array<std::complex<double>,2>& image = m_input.front().second->image;
+      const blitz::TinyVector<int,2> shape = transform.paddedShape(image.extent(0), image.extent(1));
+      staged = transform.engine() != bob::ip::gabor::Transform::RECURSIVE && !transform.useSpatialDomain(shape[0], shape[1], m_graph ? (int)m_graph->nodes().size() : -1);
+      const int limit = staged ? 2 : m_threads.size() + 1;
+      m_processing_finished.wait(lock, [this, limit](){return m_processing < limit;});
+      next = m_input.front();
+      m_input.pop_front();
+      ++m_processing;
+    }
+
+    Frame& frame = *next.second;
+    const int height = frame.image.extent(0), width = frame.image.extent(1);
+    int tasks = 1;
+    try {
+      if (m_graph) frame.responses.resize(m_graph->nodes().size(), transform.numberOfWavelets());
+      else frame.trafo_image.resize(transform.numberOfWavelets(), height, width);
+      if (staged){
+        frame.spectrum.reset(new bob::ip::gabor::Spectrum());
+        transform.spectrum(frame.image, *frame.spectrum);
+        // the image is not needed any more
+        frame.image.free();
+        tasks = m_chunks.size();
+      }
+    } catch (...){
+      frame.error = std::current_exception();
+      finish(next.first, next.second);
+      continue;
+    }
+
+    frame.remaining = tasks;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int c = 0; c < tasks; ++c){
+      m_tasks.push_back(Task{next.first, next.second, staged ? c : -1});
+    }
+    m_tasks_available.notify_all();
+  }
+}
+
+/**
+ * Processes the tasks passed by the first stage, until all frames are processed.
+ * Errors are stored with the frame, and they are re-thrown when the frame is popped.
+ */
+void bob::ip::gabor::TransformStream::work(bob::ip::gabor::Transform& transform){
+  blitz::Array<std::complex<double>,3> layers;
+  while (true){
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_tasks_available.wait(lock, [this](){return m_prepared || !m_tasks.empty();});
+      if (m_tasks.empty()) return;
+      task = m_tasks.front();
+      m_tasks.pop_front();
+    }
+
+    std::exception_ptr error;
+    try {
+      process(transform, task, layers);
+    } catch (...){
+      error = std::current_exception();
+    }
+
+    bool finished;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (error && !task.frame->error) task.frame->error = error;
+      finished = --task.frame->remaining == 0;
+    }
+    if (finished) finish(task.index, task.frame);
+  }
+}
+
+void bob::ip::gabor::TransformStream::process(bob::ip::gabor::Transform& transform, const Task& task, blitz::Array<std::complex<double>,3>& layers){
+  Frame& frame = *task.frame;
+  if (task.chunk < 0){
+    // transform the whole frame with the engine of the transform
+    if (m_graph){
+      // compute only the responses at the nodes, which is cheaper with the spatial domain engine
+      transform.transform(frame.image, m_graph->nodes(), frame.responses);
+    } else {
+      transform.transform(frame.image, frame.trafo_image);
+    }
+    return;
+  }
+
+  // apply the wavelets of the chunk to the spectrum; the other workers write other layers or responses
+  const std::vector<int>& indices = m_chunks[task.chunk];
+  const blitz::Range all = blitz::Range::all();
+  if (m_graph){
+    layers.resize(indices.size(), frame.spectrum->height(), frame.spectrum->width());
+    transform.transform(*frame.spectrum, indices, layers);
+    const std::vector<blitz::TinyVector<int,2>>& nodes = m_graph->nodes();
+    for (int i = 0; i < (int)nodes.size(); ++i){
+      for (int l = 0; l < (int)indices.size(); ++l){
+        frame.responses(i, indices[l]) = layers(l, nodes[i][0], nodes[i][1]);
+      }
+    }
+  } else {
+    blitz::Array<std::complex<double>,3> part(frame.trafo_image(blitz::Range(indices.front(), indices.back()), all, all));
+    transform.transform(*frame.spectrum, indices, part);
+  }
+}
+
+void bob::ip::gabor::TransformStream::finish(uint64_t index, const boost::shared_ptr<Frame>& frame){
+  if (m_graph && !frame->error){
+    frame->jets.resize(frame->responses.extent(0));
+    for (int i = 0; i < frame->responses.extent(0); ++i){
+      frame->jets[i].reset(new bob::ip::gabor::Jet(frame->responses(i, blitz::Range::all())));
+    }
+  }
+  // the image, the spectrum and the responses are not needed any more
+  frame->image.free();
+  frame->spectrum.reset();
+  frame->responses.free();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_output[index] = frame;
+  --m_processing;
+  m_processing_finished.notify_one();
+  m_output_available.notify_all();
+}
+
+boost::shared_ptr<bob::ip::gabor::TransformStream::Frame> bob::ip::gabor::TransformStream::next(){
+  boost::shared_ptr<Frame> frame;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_output_available.wait(lock, [this](){return m_popped == m_pushed || m_output.count(m_popped);});
+    if (m_popped == m_pushed)
+      throw std::runtime_error("TransformStream: there is no frame to pop");
+    auto it = m_output.find(m_popped++);
+    frame = it->second;
+    m_output.erase(it);
+    m_space_available.notify_one();
+  }
+  if (frame->error) std::rethrow_exception(frame->error);
+  return frame;
+}
+
+void bob::ip::gabor::TransformStream::pop(blitz::Array<std::complex<double>,3>& trafo_image){
+  if (m_graph)
+    throw std::runtime_error("TransformStream: this stream extracts Gabor jets; please pop a list of jets instead");
+  trafo_image.reference(next()->trafo_image);
+}
+
+void bob::ip::gabor::TransformStream::pop(std::vector<boost::shared_ptr<bob::ip::gabor::Jet>>& jets){
+  if (!m_graph)
+    throw std::runtime_error("TransformStream: this stream computes trafo images; please pop a trafo image instead");
+  jets = next()->jets;
+}
@@ -8,6 +8,11 @@
  */
 
 #include <bob.ip.gabor/Wavelet.h>
+#include <bob.ip.gabor/Simd.h>
+#include <bob.ip.gabor/Stats.h>
+#include <bob.core/check.h>
+
+#include <boost/format.hpp>
 
 static inline double sqr(double x){return x*x;}
 
@@ -28,9 +33,15 @@ bob::ip::gabor::Wavelet::Wavelet(
   const bool dc_free,
   const double epsilon
 )
-: m_y_resolution(resolution[0]),
+: m_frequency(k),
+  m_sigma(sigma),
+  m_pow_of_k(pow_of_k),
+  m_epsilon(epsilon),
+  m_dc_free(dc_free),
+  m_y_resolution(resolution[0]),
   m_x_resolution(resolution[1])
 {
+  BOB_IP_GABOR_STATS_TIME(WAVELET_GENERATION);
   // check that the parametrization makes sense
   if (m_y_resolution <= 0 || m_y_resolution <= 0 || sigma <= 0){
     throw std::runtime_error("The parametrization of the Gabor wavelet does not make any sense.");
@@ -72,23 +83,74 @@ bob::ip::gabor::Wavelet::Wavelet(
       wavelet_value *= std::pow(k_square, pow_of_k / 2.);
 
       if (std::abs(wavelet_value) > epsilon){
-        m_wavelet_pixel.push_back(std::make_pair(
-          blitz::TinyVector<int,2>((y + m_y_resolution) % m_y_resolution, (x + m_x_resolution) % m_x_resolution),
-          wavelet_value
-        ));
+        int py = (y + m_y_resolution) % m_y_resolution, px = (x + m_x_resolution) % m_x_resolution;
+        // extend the current run, or start a new one
+        if (!m_runs.empty() && m_runs.back()[0] == py && m_runs.back()[1] + m_runs.back()[2] == px)
+          ++m_runs.back()[2];
+        else
+          m_runs.push_back(blitz::TinyVector<int,3>(py, px, 1));
+        m_values.push_back(wavelet_value);
       }
     } // for x
   } // for y
 }
 
+/**
+ * Restores a Gabor wavelet from its sparse representation.
+ * The parametrization is not checked against the values; it is only stored.
+ * @param resolution  The resolution of the image that the wavelet is applied on
+ * @param k, sigma, pow_of_k, dc_free, epsilon  The parametrization that the wavelet was generated with
+ * @param runs  The runs (y, x, length) of consecutive non-zero pixels, as returned by runs()
+ * @param values  The values of all non-zero pixels, as returned by values()
+ */
+bob::ip::gabor::Wavelet::Wavelet(
+  const blitz::TinyVector<int,2>& resolution,
+  const blitz::TinyVector<double,2>& k,
+  const double sigma,
+  const double pow_of_k,
+  const bool dc_free,
+  const double epsilon,
+  const blitz::Array<int,2>& runs,
+  const blitz::Array<double,1>& values
+)
+: m_frequency(k),
+  m_sigma(sigma),
+  m_pow_of_k(pow_of_k),
+  m_epsilon(epsilon),
+  m_dc_free(dc_free),
+  m_y_resolution(resolution[0]),
+  m_x_resolution(resolution[1])
+{
+  if (m_y_resolution <= 0 || m_x_resolution <= 0)
+    throw std::runtime_error((boost::format("The resolution (%d, %d) of the Gabor wavelet must be positive") % m_y_resolution % m_x_resolution).str());
+  if (runs.extent(1) != 3)
+    throw std::runtime_error((boost::format("The runs of the Gabor wavelet must have shape (N, 3), not (%d, %d)") % runs.extent(0) % runs.extent(1)).str());
+  m_runs.resize(runs.extent(0));
+  int count = 0;
+  for (int r = 0; r < runs.extent(0); ++r){
+    m_runs[r] = blitz::TinyVector<int,3>(runs(r,0), runs(r,1), runs(r,2));
+    if (runs(r,0) < 0 || runs(r,0) >= m_y_resolution || runs(r,1) < 0 || runs(r,2) <= 0 || runs(r,1) + runs(r,2) > m_x_resolution)
+      throw std::runtime_error((boost::format("The run (%d, %d, %d) of the Gabor wavelet is outside of the resolution (%d, %d)") % runs(r,0) % runs(r,1) % runs(r,2) % m_y_resolution % m_x_resolution).str());
+    count += runs(r,2);
+  }
+  if (count != values.extent(0))
+    throw std::runtime_error((boost::format("The runs of the Gabor wavelet cover %d pixels, but %d values are given") % count % values.extent(0)).str());
+  m_values.assign(values.begin(), values.end());
+}
+
 bob::ip::gabor::Wavelet::Wavelet(
   const bob::ip::gabor::Wavelet& other
 )
-: m_wavelet_pixel(other.m_wavelet_pixel.size()),
+: m_runs(other.m_runs),
+  m_values(other.m_values),
+  m_frequency(other.m_frequency),
+  m_sigma(other.m_sigma),
+  m_pow_of_k(other.m_pow_of_k),
+  m_epsilon(other.m_epsilon),
+  m_dc_free(other.m_dc_free),
   m_y_resolution(other.m_y_resolution),
   m_x_resolution(other.m_x_resolution)
 {
-  std::copy(other.m_wavelet_pixel.begin(), other.m_wavelet_pixel.end(), m_wavelet_pixel.begin());
 }
 
 bob::ip::gabor::Wavelet&
@@ -99,8 +161,13 @@ bob::ip::gabor::Wavelet::operator =
 {
   const_cast<int&>(m_y_resolution) = other.m_y_resolution;
   const_cast<int&>(m_x_resolution) = other.m_x_resolution;
-  m_wavelet_pixel.resize(other.m_wavelet_pixel.size());
-  std::copy(other.m_wavelet_pixel.begin(), other.m_wavelet_pixel.end(), m_wavelet_pixel.begin());
+  m_runs = other.m_runs;
+  m_values = other.m_values;
+  m_frequency = other.m_frequency;
+  m_sigma = other.m_sigma;
+  m_pow_of_k = other.m_pow_of_k;
+  m_epsilon = other.m_epsilon;
+  m_dc_free = other.m_dc_free;
   return *this;
 }
 
@@ -112,12 +179,14 @@ bob::ip::gabor::Wavelet::operator ==
 {
   if (m_x_resolution != other.m_x_resolution || m_y_resolution != other.m_y_resolution)
     return false;
-  if (m_wavelet_pixel.size() != other.m_wavelet_pixel.size())
+  if (m_runs.size() != other.m_runs.size() || m_values.size() != other.m_values.size())
     return false;
 
-  auto it1 = m_wavelet_pixel.begin(), it2 = other.m_wavelet_pixel.begin(), it1end = m_wavelet_pixel.end();
-  for (; it1 != it1end; ++it1, ++it2)
-    if (it1->first[0] != it2->first[0] || it1->first[1] != it2->first[1] || std::abs(it1->second - it2->second) > 1e-8)
+  for (int r = 0; r < (int)m_runs.size(); ++r)
+    if (blitz::any(m_runs[r] != other.m_runs[r]))
+      return false;
+  for (int i = 0; i < (int)m_values.size(); ++i)
+    if (std::abs(m_values[i] - other.m_values[i]) > 1e-8)
       return false;
 
   // identical.
@@ -135,17 +204,42 @@ void bob::ip::gabor::Wavelet::transform(
   blitz::Array<std::complex<double>,2>& transformed_frequency_domain_image
 ) const
 {
+  BOB_IP_GABOR_STATS_TIME(WAVELET_MULTIPLY);
   // assert same size
   bob::core::array::assertSameShape(frequency_domain_image, transformed_frequency_domain_image);
   // clear resulting image first
   transformed_frequency_domain_image = std::complex<double>(0);
-  // iterate through the wavelet pixels and do the multiplication
-  auto it = m_wavelet_pixel.begin(), it_end = m_wavelet_pixel.end();
-  for (; it < it_end; ++it){
-    transformed_frequency_domain_image(it->first) = frequency_domain_image(it->first) * it->second;
+  // iterate through the runs of wavelet pixels and do the multiplication
+  const double* values = m_values.data();
+  if (bob::core::array::isCZeroBaseContiguous(frequency_domain_image) && bob::core::array::isCZeroBaseContiguous(transformed_frequency_domain_image)){
+    // use the vectorized kernel on the consecutive pixels
+    for (auto it = m_runs.begin(); it != m_runs.end(); values += (*it)[2], ++it){
+      const int offset = (*it)[0] * m_x_resolution + (*it)[1];
+      bob::ip::gabor::Simd::multiply(frequency_domain_image.data() + offset, values, transformed_frequency_domain_image.data() + offset, (*it)[2]);
+    }
+  } else {
+    for (auto it = m_runs.begin(); it != m_runs.end(); values += (*it)[2], ++it){
+      for (int i = 0; i < (*it)[2]; ++i){
+        transformed_frequency_domain_image((*it)[0], (*it)[1] + i) = frequency_domain_image((*it)[0], (*it)[1] + i) * values[i];
+      }
+    }
   }
 }
 
+blitz::Array<int,2> bob::ip::gabor::Wavelet::runs() const{
+  blitz::Array<int,2> runs(m_runs.size(), 3);
+  for (int r = 0; r < (int)m_runs.size(); ++r){
+    runs(r, blitz::Range::all()) = m_runs[r];
+  }
+  return runs;
+}
+
+blitz::Array<double,1> bob::ip::gabor::Wavelet::values() const{
+  blitz::Array<double,1> values(m_values.size());
+  std::copy(m_values.begin(), m_values.end(), values.begin());
+  return values;
+}
+
 /**
  * Generates and returns the image for the current wavelet.
  * @return The wavelet image in frequency domain.
@@ -153,10 +247,12 @@ void bob::ip::gabor::Wavelet::transform(
 blitz::Array<double,2> bob::ip::gabor::Wavelet::waveletImage() const{
   blitz::Array<double,2> image(m_y_resolution, m_x_resolution);
   image = 0;
-  // iterate through the wavelet pixels
-  auto it = m_wavelet_pixel.begin(), it_end = m_wavelet_pixel.end();
-  for (; it < it_end; ++it){
-    image(it->first) = it->second;
+  // iterate through the runs of wavelet pixels
+  const double* values = m_values.data();
+  for (auto it = m_runs.begin(); it != m_runs.end(); values += (*it)[2], ++it){
+    for (int i = 0; i < (*it)[2]; ++i){
+      image((*it)[0], (*it)[1] + i) = values[i];
+    }
   }
   return image;
 }
@@ -0,0 +1,260 @@
+/**
+ * @brief Bindings for the extraction of block-pooled Gabor magnitude and phase features
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto FeatureExtractor_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".FeatureExtractor",
+  "Extracts block-pooled Gabor magnitude (and phase histogram) features from images",
+  "The image is split into non-overlapping blocks of :py:attr:`block_size`; pixels at the bottom and the right border, which do not fill a complete block, are ignored. "
+  "For each Gabor wavelet and each block, the average magnitude of the responses is computed, as well as a normalized histogram of the phases, if :py:attr:`phase_bins` is positive. "
+  "The responses of each wavelet are pooled directly after its inverse FFT, so that only one complex layer is kept in memory, instead of the complete trafo image.\n\n"
+  "The :py:attr:`Transform.padding` is taken into account, but the wavelets are always applied in frequency domain, regardless of the :py:attr:`Transform.engine`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a feature extractor for the given Gabor wavelet transform",
+    "The given ``transform`` is shared with this object, i.e., later changes of the ``transform`` affect the features.",
+    true
+  )
+  .add_prototype("transform, block_size, [phase_bins]", "")
+  .add_parameter("transform", ":py:class:`bob.ip.gabor.Transform`", "The Gabor wavelet transform that should be used")
+  .add_parameter("block_size", "(int, int)", "The size (height, width) of the blocks, in which the responses are pooled")
+  .add_parameter("phase_bins", "int", "[default: 0] The number of bins of the phase histograms; if 0, only the magnitudes are pooled")
+);
+
+static int PyBobIpGaborFeatureExtractor_init(PyBobIpGaborFeatureExtractorObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = FeatureExtractor_doc.kwlist();
+
+  PyBobIpGaborTransformObject* transform;
+  blitz::TinyVector<int,2> block_size;
+  int phase_bins = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!(ii)|i", kwlist, &PyBobIpGaborTransform_Type, &transform, &block_size[0], &block_size[1], &phase_bins)) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::FeatureExtractor(transform->cxx, block_size, phase_bins));
+  return 0;
+BOB_CATCH_MEMBER("cannot create FeatureExtractor", -1)
+}
+
+static void PyBobIpGaborFeatureExtractor_delete(PyBobIpGaborFeatureExtractorObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborFeatureExtractor_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborFeatureExtractor_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto transform_doc = bob::extension::VariableDoc(
+  "transform",
+  ":py:class:`bob.ip.gabor.Transform`",
+  "The Gabor wavelet transform that is used to extract the features"
+);
+PyObject* PyBobIpGaborFeatureExtractor_transform(PyBobIpGaborFeatureExtractorObject* self, void*){
+BOB_TRY
+  PyBobIpGaborTransformObject* transform = reinterpret_cast<PyBobIpGaborTransformObject*>(PyBobIpGaborTransform_Type.tp_alloc(&PyBobIpGaborTransform_Type, 0));
+  transform->cxx = self->cxx->transform();
+  return Py_BuildValue("N", transform);
+BOB_CATCH_MEMBER("transform", 0)
+}
+
+static auto blockSize_doc = bob::extension::VariableDoc(
+  "block_size",
+  "(int, int)",
+  "The size (height, width) of the blocks, in which the responses are pooled"
+);
+PyObject* PyBobIpGaborFeatureExtractor_blockSize(PyBobIpGaborFeatureExtractorObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("(ii)", self->cxx->blockSize()[0], self->cxx->blockSize()[1]);
+BOB_CATCH_MEMBER("block_size", 0)
+}
+
+static auto phaseBins_doc = bob::extension::VariableDoc(
+  "phase_bins",
+  "int",
+  "The number of bins of the phase histograms; 0 if no phase histograms are computed"
+);
+PyObject* PyBobIpGaborFeatureExtractor_phaseBins(PyBobIpGaborFeatureExtractorObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->phaseBins());
+BOB_CATCH_MEMBER("phase_bins", 0)
+}
+
+static PyGetSetDef PyBobIpGaborFeatureExtractor_getseters[] = {
+  {
+    transform_doc.name(),
+    (getter)PyBobIpGaborFeatureExtractor_transform,
+    0,
+    transform_doc.doc(),
+    0
+  },
+  {
+    blockSize_doc.name(),
+    (getter)PyBobIpGaborFeatureExtractor_blockSize,
+    0,
+    blockSize_doc.doc(),
+    0
+  },
+  {
+    phaseBins_doc.name(),
+    (getter)PyBobIpGaborFeatureExtractor_phaseBins,
+    0,
+    phaseBins_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto extract_doc = bob::extension::FunctionDoc(
+  "extract",
+  "Extracts the pooled Gabor features from the given image",
+  "The input image must be of two dimensions and might be of any supported type: ``uint8``, ``float`` or ``complex``. "
+  "The magnitudes have shape (:py:attr:`Transform.number_of_wavelets`, input.shape[0] // block_size[0], input.shape[1] // block_size[1]), and the phase histograms have an additional last dimension of size :py:attr:`phase_bins`. "
+  "Each phase histogram covers the range :math:`[-\\pi, \\pi]` and sums up to 1.\n\n"
+  ".. note::\n\n  The function `__call__` is a synonym for this function.",
+  true
+)
+.add_prototype("input, [magnitudes], [phase_histograms]", "magnitudes")
+.add_prototype("input, [magnitudes], [phase_histograms]", "magnitudes, phase_histograms")
+.add_parameter("input", "array_like (2D)", "The image in spatial domain, from which the features should be extracted")
+.add_parameter("magnitudes", "array_like (float, 3D)", "If given, the pooled magnitudes are written to this array")
+.add_parameter("phase_histograms", "array_like (float, 4D)", "If given, the phase histograms are written to this array; only allowed when :py:attr:`phase_bins` is positive")
+.add_return("magnitudes", "array_like (float, 3D)", "The average magnitudes per wavelet and block; identical to the ``magnitudes`` parameter, if given")
+.add_return("phase_histograms", "array_like (float, 4D)", "The phase histograms per wavelet and block; only returned when :py:attr:`phase_bins` is positive")
+;
+
+static PyObject* PyBobIpGaborFeatureExtractor_extract(PyBobIpGaborFeatureExtractorObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = extract_doc.kwlist();
+
+  PyBlitzArrayObject* input = 0,* magnitudes = 0,* phase_histograms = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&O&", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &magnitudes, &PyBlitzArray_OutputConverter, &phase_histograms)) return 0;
+
+  auto input_ = make_safe(input);
+  auto magnitudes_ = make_xsafe(magnitudes);
+  auto phase_histograms_ = make_xsafe(phase_histograms);
+
+  if (input->ndim != 2) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, input->ndim);
+    return 0;
+  }
+  if ((magnitudes && (magnitudes->ndim != 3 || magnitudes->type_num != NPY_FLOAT64)) || (phase_histograms && (phase_histograms->ndim != 4 || phase_histograms->type_num != NPY_FLOAT64))) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the magnitudes and phase histograms to be 3D and 4D arrays of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  const int bins = self->cxx->phaseBins();
+  if (phase_histograms && !bins) {
+    PyErr_Format(PyExc_RuntimeError, "`%s' computes phase histograms only when phase_bins is positive", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  /** if the outputs were not pre-allocated, do it now **/
+  blitz::TinyVector<int,3> shape = self->cxx->magnitudeShape(input->shape[0], input->shape[1]);
+  if (!magnitudes) {
+    Py_ssize_t osize[3] = {shape[0], shape[1], shape[2]};
+    magnitudes = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, osize);
+    magnitudes_ = make_safe(magnitudes);
+  }
+  if (bins && !phase_histograms) {
+    Py_ssize_t osize[4] = {shape[0], shape[1], shape[2], bins};
+    phase_histograms = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 4, osize);
+    phase_histograms_ = make_safe(phase_histograms);
+  }
+
+  blitz::Array<double,3> mags = *PyBlitzArrayCxx_AsBlitz<double,3>(magnitudes);
+  switch (input->type_num){
+    case NPY_UINT8:
+      if (bins) self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(input), mags, *PyBlitzArrayCxx_AsBlitz<double,4>(phase_histograms));
+      else self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(input), mags);
+      break;
+    case NPY_FLOAT64:
+      if (bins) self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<double,2>(input), mags, *PyBlitzArrayCxx_AsBlitz<double,4>(phase_histograms));
+      else self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<double,2>(input), mags);
+      break;
+    case NPY_COMPLEX128:
+      if (bins) self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(input), mags, *PyBlitzArrayCxx_AsBlitz<double,4>(phase_histograms));
+      else self->cxx->extract(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(input), mags);
+      break;
+    default:
+      PyErr_Format(PyExc_RuntimeError, "`%s' only supports arrays of type uint8, float and complex for array `input'", Py_TYPE(self)->tp_name);
+      return 0;
+  }
+
+  if (bins)
+    return Py_BuildValue("(NN)", PyBlitzArray_AsNumpyArray(magnitudes, 0), PyBlitzArray_AsNumpyArray(phase_histograms, 0));
+  return PyBlitzArray_AsNumpyArray(magnitudes, 0);
+BOB_CATCH_MEMBER("extract", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborFeatureExtractor_methods[] = {
+  {
+    extract_doc.name(),
+    (PyCFunction)PyBobIpGaborFeatureExtractor_extract,
+    METH_VARARGS|METH_KEYWORDS,
+    extract_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the FeatureExtractor type struct; will be initialized later
+PyTypeObject PyBobIpGaborFeatureExtractor_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpGaborFeatureExtractor(PyObject* module)
+{
+
+  // initialize the FeatureExtractor type struct
+  PyBobIpGaborFeatureExtractor_Type.tp_name = FeatureExtractor_doc.name();
+  PyBobIpGaborFeatureExtractor_Type.tp_basicsize = sizeof(PyBobIpGaborFeatureExtractorObject);
+  PyBobIpGaborFeatureExtractor_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborFeatureExtractor_Type.tp_doc = FeatureExtractor_doc.doc();
+
+  // set the functions
+  PyBobIpGaborFeatureExtractor_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborFeatureExtractor_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborFeatureExtractor_init);
+  PyBobIpGaborFeatureExtractor_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborFeatureExtractor_delete);
+  PyBobIpGaborFeatureExtractor_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpGaborFeatureExtractor_extract);
+  PyBobIpGaborFeatureExtractor_Type.tp_methods = PyBobIpGaborFeatureExtractor_methods;
+  PyBobIpGaborFeatureExtractor_Type.tp_getset = PyBobIpGaborFeatureExtractor_getseters;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborFeatureExtractor_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborFeatureExtractor_Type);
+  return PyModule_AddObject(module, "FeatureExtractor", (PyObject*)&PyBobIpGaborFeatureExtractor_Type) >= 0;
+}
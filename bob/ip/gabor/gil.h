@@ -0,0 +1,24 @@
+/**
+ * @brief Helper for the bindings to release the global interpreter lock
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_GIL_H
+#define BOB_IP_GABOR_GIL_H
+
+#include <Python.h>
+
+// releases the GIL for the lifetime of the object; re-acquires it also when an exception is thrown.
+// Only use it while no Python object is accessed, and copy all state of the bound object that another thread could modify.
+class ReleaseGIL {
+  public:
+    ReleaseGIL() : m_state(PyEval_SaveThread()) {}
+    ~ReleaseGIL() {PyEval_RestoreThread(m_state);}
+  private:
+    ReleaseGIL(const ReleaseGIL&);
+    ReleaseGIL& operator=(const ReleaseGIL&);
+    PyThreadState* m_state;
+};
+
+#endif // BOB_IP_GABOR_GIL_H
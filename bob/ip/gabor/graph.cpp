@@ -15,6 +15,8 @@
 #include <bob.io.base/api.h>
 #include <bob.extension/documentation.h>
 
+#include "gil.h"
+
 
 static inline char* c(const char* o){return const_cast<char*>(o);}
 
@@ -292,6 +294,75 @@ BOB_CATCH_MEMBER("extract", 0)
 }
 
 
+static auto extractBatch_doc = bob::extension::FunctionDoc(
+  "extract_batch",
+  "This function extracts the Gabor jets at all nodes of the graph from a stack of trafo images into one array",
+  "In opposition to :py:func:`extract`, no :py:class:`bob.ip.gabor.Jet` objects are created, but the absolute values and phases of all Gabor jets are written into a 4D array, "
+  "where ``jets[i,n]`` contains the Gabor jet of node ``n`` in image ``i``, in the same layout as :py:attr:`bob.ip.gabor.Jet.jet`. "
+  "The nodes are checked only once for the whole stack, and the images can be distributed over several threads, during which the GIL is released.\n\n"
+  "When ``nodes`` are given, they define individual node positions for each image, and the nodes of this graph are not used.",
+  true
+)
+.add_prototype("trafo_images, [jets], [normalize], [nodes], [number_of_threads]", "jets")
+.add_parameter("trafo_images", "array_like (complex, 4D)", "The stack of Gabor wavelet transformed images, of shape ``(N, number_of_wavelets, height, width)``")
+.add_parameter("jets", "array_like (float, 4D)", "If given, the C-contiguous array of shape ``(N, nodes, 2, number_of_wavelets)`` that will be filled with the Gabor jets")
+.add_parameter("normalize", "bool", "[default: ``True``] Should the absolute values of the Gabor jets be normalized to unit Euclidean length?")
+.add_parameter("nodes", "array_like (int32, 3D)", "If given, the individual node positions ``(y, x)`` of shape ``(N, nodes, 2)`` for each image")
+.add_parameter("number_of_threads", "int", "[default: 1] The number of threads, among which the images are distributed; 0 uses one thread per core")
+.add_return("jets", "array_like (float, 4D)", "The Gabor jets extracted from all images; identical to the ``jets`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborGraph_extractBatch(PyBobIpGaborGraphObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = extractBatch_doc.kwlist();
+
+  PyBlitzArrayObject* trafo_images = 0,* jets = 0,* nodes = 0;
+  PyObject* normalize = 0;
+  int number_of_threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&O!O&i", kwlist, &PyBlitzArray_Converter, &trafo_images, &PyBlitzArray_OutputConverter, &jets, &PyBool_Type, &normalize, &PyBlitzArray_Converter, &nodes, &number_of_threads)) return 0;
+
+  auto trafo_images_ = make_safe(trafo_images);
+  auto jets_ = make_xsafe(jets);
+  auto nodes_ = make_xsafe(nodes);
+
+  if (trafo_images->ndim != 4 || trafo_images->type_num != NPY_COMPLEX128) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 4-dimensional arrays of complex type for `trafo_images`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (jets && (jets->ndim != 4 || jets->type_num != NPY_FLOAT64)) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires `jets` to be a 4-dimensional array of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (nodes && (nodes->ndim != 3 || nodes->type_num != NPY_INT32)) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires `nodes` to be a 3-dimensional array of type int32", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  // if the output was not pre-allocated, do it now
+  if (!jets){
+    Py_ssize_t osize[4] = {trafo_images->shape[0], nodes ? nodes->shape[1] : self->cxx->numberOfNodes(), 2, trafo_images->shape[1]};
+    jets = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 4, osize);
+    jets_ = make_safe(jets);
+  }
+
+  blitz::Array<std::complex<double>,4> input = *PyBlitzArrayCxx_AsBlitz<std::complex<double>,4>(trafo_images);
+  blitz::Array<double,4> output = *PyBlitzArrayCxx_AsBlitz<double,4>(jets);
+  bool norm = !normalize || PyObject_IsTrue(normalize);
+  if (nodes){
+    ReleaseGIL gil;
+    bob::ip::gabor::Graph::extract(input, *PyBlitzArrayCxx_AsBlitz<int32_t,3>(nodes), output, norm, number_of_threads);
+  } else {
+    // copy the nodes, which might be modified by another thread while the GIL is released
+    bob::ip::gabor::Graph graph(*self->cxx);
+    ReleaseGIL gil;
+    graph.extract(input, output, norm, number_of_threads);
+  }
+  return PyBlitzArray_AsNumpyArray(jets, 0);
+BOB_CATCH_MEMBER("extract_batch", 0)
+}
+
+
 static auto load_doc = bob::extension::FunctionDoc(
   "load",
   "Loads the list of node positions of the Gabor graph from the given HDF5 file",
@@ -347,6 +418,12 @@ static PyMethodDef PyBobIpGaborGraph_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     extract_doc.doc()
   },
+  {
+    extractBatch_doc.name(),
+    (PyCFunction)PyBobIpGaborGraph_extractBatch,
+    METH_VARARGS|METH_KEYWORDS,
+    extractBatch_doc.doc()
+  },
   {
     load_doc.name(),
     (PyCFunction)PyBobIpGaborGraph_load,
@@ -0,0 +1,78 @@
+/**
+ * @brief Header file for the benchmark of the Gabor wavelet transform, the Gabor jet extraction, the similarities and the jet statistics
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_BENCHMARK_H
+#define BOB_IP_GABOR_BENCHMARK_H
+
+#include <blitz/array.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class measures the run time of the main operations of this library on synthetic data.
+      //! It times Transform::transform for all combinations of image sizes and wavelet families,
+      //! Graph::extract, Similarity::similarity for all similarity types, PhaseCode::encode and PhaseCode::similarity, Similarity::disparity and JetStatistics::logLikelihood,
+      //! as well as the exhaustive Similarity::search and the approximate Index::search (including its recall) in a synthetic gallery.
+      //! The results, including latency percentiles, throughput and allocations, are written as JSON.
+      class Benchmark {
+
+        public:
+
+          //! The timings of one benchmarked operation
+          struct Measurement {
+            //! The name of the operation, e.g., "transform" or "similarity"
+            std::string name;
+            //! The variant of the operation, e.g., the engine or the similarity type
+            std::string variant;
+            //! The parameters of the measurement, e.g., the image size
+            std::map<std::string, int> parameters;
+            //! The number of items (images, Gabor jets or pairs of Gabor jets) that are processed in each repetition
+            int items;
+            //! The latency of each repetition, in seconds
+            std::vector<double> seconds;
+            //! The average number of heap allocations per repetition; negative if allocations are not counted
+            double allocations;
+          };
+
+          //! Creates a benchmark for the given image sizes (height, width) and wavelet families (scales, directions);
+          //! each operation is run once to warm up, and then timed the given number of times
+          Benchmark(
+            const std::vector<blitz::TinyVector<int,2>>& image_sizes = std::vector<blitz::TinyVector<int,2>>(1, blitz::TinyVector<int,2>(128, 128)),
+            const std::vector<blitz::TinyVector<int,2>>& wavelets = std::vector<blitz::TinyVector<int,2>>(1, blitz::TinyVector<int,2>(5, 8)),
+            int repetitions = 20
+          );
+
+          //! Runs all benchmarks and returns the measurements
+          std::vector<Measurement> run() const;
+
+          //! Writes the given measurements as a JSON document
+          static std::string json(const std::vector<Measurement>& measurements);
+
+          //! \brief Sets the function that returns the number of heap allocations performed so far.
+          //! Allocations can only be counted by executables that replace the global operator new (see benchmark/bob_ip_gabor_benchmark.cpp);
+          //! when no counter is set, allocations are reported as null
+          static void allocationCounter(unsigned long (*counter)());
+
+        private:
+
+          std::vector<blitz::TinyVector<int,2>> m_image_sizes;
+          std::vector<blitz::TinyVector<int,2>> m_wavelets;
+          int m_repetitions;
+
+      }; // class Benchmark
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_BENCHMARK_H
@@ -0,0 +1,115 @@
+/**
+ * @brief Header file for the FFT backends used by the Gabor wavelet transform
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_FFT_H
+#define BOB_IP_GABOR_FFT_H
+
+#include <bob.sp/FFT1D.h>
+#include <bob.sp/FFT2D.h>
+#include <string>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class computes the two-dimensional forward and inverse complex FFT of a fixed shape.
+      //! The inverse FFT is normalized, i.e., inverse(forward(x)) == x.
+      //! By default, bob::sp::FFT2D and bob::sp::IFFT2D are used.
+      //! When compiled with FFTW3 (HAVE_FFTW3), measured FFTW plans can be used instead;
+      //! these plans are computed only once per resolution and shared between all FFT objects and threads.
+      class FFT {
+
+        public:
+
+          //! The available FFT implementations
+          typedef enum {
+            BOB_SP = 0,
+            FFTW = 1
+          } Backend;
+
+          static const std::string& backend_to_name(Backend backend);
+
+          static Backend name_to_backend(const std::string& backend);
+
+          //! Returns true if the given backend was compiled into this library
+          static bool available(Backend backend);
+
+          //! Creates an FFT object with the given backend; the shape needs to be set using setShape()
+          FFT(Backend backend = BOB_SP);
+
+          //! Copy constructor; the temporary memory is not shared with the other object
+          FFT(const FFT& other);
+
+          //! Assignment operator; the temporary memory is not shared with the other object
+          FFT& operator =(const FFT& other);
+
+          //! The backend used by this object
+          Backend backend() const {return m_backend;}
+
+          //! Changes the backend, keeping the current shape
+          void backend(Backend backend);
+
+          //! Sets the shape of the images to transform
+          void setShape(int height, int width);
+
+          int getHeight() const {return m_height;}
+          int getWidth() const {return m_width;}
+
+          //! Computes the forward FFT of the given image; input and output must not be identical
+          void forward(const blitz::Array<std::complex<double>,2>& input, blitz::Array<std::complex<double>,2>& output);
+
+          //! Computes the normalized inverse FFT of the given spectrum; input and output must not be identical
+          void inverse(const blitz::Array<std::complex<double>,2>& input, blitz::Array<std::complex<double>,2>& output);
+
+          //! \brief Computes the normalized inverse FFT only inside the window of the shape of output, starting at the given offset.
+          //! The inverse FFT is pruned: the 1D transforms of the second pass are only computed for the lines that cross the window
+          void inverse(const blitz::Array<std::complex<double>,2>& input, const blitz::TinyVector<int,2>& offset, blitz::Array<std::complex<double>,2>& output);
+
+          //! Loads the FFTW wisdom from the given file, so that the planning of known resolutions is fast
+          static void loadWisdom(const std::string& filename);
+
+          //! Saves the FFTW wisdom of all resolutions planned so far to the given file
+          static void saveWisdom(const std::string& filename);
+
+        private:
+
+          void setup();
+
+          // computes the inverse 1D FFT of the given line along the x (or y) axis and copies the part starting at start to output
+          void inverseLine(bool along_x, const blitz::Array<std::complex<double>,1>& input, int start, blitz::Array<std::complex<double>,1> output);
+
+          Backend m_backend;
+          int m_height;
+          int m_width;
+
+          // the bob.sp implementation
+          bob::sp::FFT2D m_fft;
+          bob::sp::IFFT2D m_ifft;
+
+          // the shared FFTW plans, stored as opaque pointers to avoid exposing the FFTW header
+          void* m_forward_plan;
+          void* m_inverse_plan;
+
+          // the 1D transforms for the pruned inverse FFT, which are set up on first use
+          bob::sp::IFFT1D m_ifft_x;
+          bob::sp::IFFT1D m_ifft_y;
+          void* m_inverse_plan_x;
+          void* m_inverse_plan_y;
+          blitz::Array<std::complex<double>,2> m_pruned;
+          blitz::Array<std::complex<double>,1> m_line_input, m_line_output;
+
+          // temporary memory in case the given arrays are not contiguous
+          blitz::Array<std::complex<double>,2> m_input, m_output;
+
+      }; // class FFT
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_FFT_H
@@ -0,0 +1,94 @@
+/**
+ * @brief Header file for the extraction of block-pooled Gabor magnitude and phase features
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_FEATURE_EXTRACTOR_H
+#define BOB_IP_GABOR_FEATURE_EXTRACTOR_H
+
+#include <bob.ip.gabor/Transform.h>
+#include <bob.ip.gabor/Spectrum.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class extracts texture features from the Gabor wavelet transform of an image.
+      //! The image is split into non-overlapping blocks, and for each wavelet the average magnitude
+      //! (and, optionally, a histogram of phases) of the responses is computed in each block.
+      //! The responses are pooled directly after the inverse FFT of each wavelet,
+      //! so that only one complex layer is kept in memory, instead of the complete trafo image.
+      class FeatureExtractor {
+
+        public:
+
+          //! Creates a feature extractor using the given Gabor wavelet transform, block size, and number of phase histogram bins (0 for none)
+          FeatureExtractor(
+            boost::shared_ptr<Transform> transform,
+            const blitz::TinyVector<int,2>& block_size,
+            int phase_bins = 0
+          );
+
+          //! The Gabor wavelet transform used to compute the features
+          boost::shared_ptr<Transform> transform() const {return m_transform;}
+
+          //! The size of the blocks (height, width), in which the responses are pooled
+          const blitz::TinyVector<int,2>& blockSize() const {return m_block_size;}
+
+          //! The number of bins of the phase histograms; 0 if no phase histograms are computed
+          int phaseBins() const {return m_phase_bins;}
+
+          //! Returns the shape (numberOfWavelets, blocks_y, blocks_x) of the pooled magnitudes for the given image resolution;
+          //! pixels at the bottom and the right of the image, which do not fill a complete block, are ignored
+          blitz::TinyVector<int,3> magnitudeShape(int height, int width) const;
+
+          //! Computes the average Gabor magnitudes in each block of the given image
+          template <typename T> void extract(
+            const blitz::Array<T,2>& gray_image,
+            blitz::Array<double,3>& magnitudes
+          ){
+            if (m_phase_bins)
+              throw std::runtime_error("FeatureExtractor: please provide an array for the phase histograms");
+            extract_inner(bob::core::array::cast<std::complex<double> >(gray_image), magnitudes, 0);
+          }
+
+          //! Computes the average Gabor magnitudes and the normalized phase histograms of shape (numberOfWavelets, blocks_y, blocks_x, phaseBins) in each block of the given image
+          template <typename T> void extract(
+            const blitz::Array<T,2>& gray_image,
+            blitz::Array<double,3>& magnitudes,
+            blitz::Array<double,4>& phase_histograms
+          ){
+            extract_inner(bob::core::array::cast<std::complex<double> >(gray_image), magnitudes, &phase_histograms);
+          }
+
+        private:
+
+          // computes the features; phase_histograms might be NULL
+          void extract_inner(
+            const blitz::Array<std::complex<double>,2>& gray_image,
+            blitz::Array<double,3>& magnitudes,
+            blitz::Array<double,4>* phase_histograms
+          );
+
+          boost::shared_ptr<Transform> m_transform;
+          blitz::TinyVector<int,2> m_block_size;
+          int m_phase_bins;
+
+          // the spectrum of the current image, and the one layer of the trafo image
+          Spectrum m_spectrum;
+          blitz::Array<std::complex<double>,3> m_layer;
+          blitz::Array<double,1> m_abs, m_phase;
+          std::vector<int> m_index;
+
+      }; // class FeatureExtractor
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_FEATURE_EXTRACTOR_H
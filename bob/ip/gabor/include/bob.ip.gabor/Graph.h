@@ -82,6 +82,26 @@ namespace bob {
             bool normalize = true
           ) const;
 
+          //! \brief extracts the Gabor jets of the graph from all trafo images of the given stack of shape (N, wavelets, height, width)
+          //! into the jets array of shape (N, numberOfNodes(), 2, wavelets), which needs to be C-contiguous.
+          //! The nodes are checked only once; the images are distributed over the given number of threads (0 for one thread per core)
+          void extract(
+            const blitz::Array<std::complex<double>,4>& trafo_images,
+            blitz::Array<double,4>& jets,
+            bool normalize = true,
+            int number_of_threads = 1
+          ) const;
+
+          //! \brief extracts the Gabor jets at individual node positions for each trafo image of the given stack of shape (N, wavelets, height, width).
+          //! The nodes are of shape (N, nodes, 2), and the jets array of shape (N, nodes, 2, wavelets) needs to be C-contiguous
+          static void extract(
+            const blitz::Array<std::complex<double>,4>& trafo_images,
+            const blitz::Array<int,3>& nodes,
+            blitz::Array<double,4>& jets,
+            bool normalize = true,
+            int number_of_threads = 1
+          );
+
           //! saves this graph to file
           void save(bob::io::base::HDF5File& file) const;
 
@@ -0,0 +1,125 @@
+/**
+ * @brief Header file for the approximate nearest neighbor index of Gabor graphs
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_INDEX_H
+#define BOB_IP_GABOR_INDEX_H
+
+#include <bob.io.base/HDF5File.h>
+
+#include <bob.ip.gabor/Similarity.h>
+
+#include <boost/function.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class implements an approximate nearest neighbor index of Gabor graphs, i.e., an inverted file with product quantized residuals (IVF-PQ).
+      //! The feature vector of a graph is the concatenation of the absolute values of its Gabor jets, see features();
+      //! for normalized Gabor jets, the Euclidean distance between feature vectors is equivalent to the ScalarProduct similarity of the graphs.
+      //! The feature vectors are assigned to the closest of numberOfLists() coarse centroids, and their residuals are split into numberOfSubquantizers() parts,
+      //! each of which is quantized with numberOfCentroids() centroids, so that each graph is stored with numberOfSubquantizers() bytes.
+      //! A search visits only the given number of closest lists; optionally, the shortlisted graphs are re-ranked with an exact Similarity.
+      //! Several threads can search the same index at the same time, but it must not be trained or extended meanwhile.
+      class Index {
+
+        public:
+
+          //! The function that writes the graph with the given identifier into the given array of shape (nodes, 2, length), e.g., by reading it from disk
+          typedef boost::function<void (int id, blitz::Array<double,3>& graph)> GraphLoader;
+
+          //! Creates an untrained index for feature vectors of the given dimension;
+          //! the dimension must be divisible by the number of sub-quantizers, and the number of centroids per sub-quantizer must be in [1, 256]
+          Index(
+            int dimension,
+            int number_of_lists,
+            int number_of_subquantizers,
+            int number_of_centroids = 256
+          );
+
+          //! Reads the index, including the stored graphs, from the given HDF5 file
+          Index(bob::io::base::HDF5File& file);
+
+          //! Computes the feature vector of the given graph of shape (nodes, 2, length), see Graph::extract
+          static void features(const blitz::Array<double,3>& graph, blitz::Array<double,1>& features);
+
+          //! Computes the feature vectors of the given graphs of shape (N, nodes, 2, length), see Graph::extract
+          static void features(const blitz::Array<double,4>& graphs, blitz::Array<double,2>& features);
+
+          //! Trains the coarse centroids and the product quantizers on the given feature vectors using k-means with the given number of iterations;
+          //! all graphs stored in the index are removed
+          void train(const blitz::Array<double,2>& features, int iterations = 20, unsigned seed = 0);
+
+          //! Adds the given feature vectors to the trained index; the identifiers of the new graphs continue from size()
+          void add(const blitz::Array<double,2>& features);
+
+          //! \brief Finds the ids.extent(0) graphs with the smallest approximate Euclidean distances to the given feature vector, visiting the given number of closest lists.
+          //! The ids are ordered by ascending distance; if less graphs are found, the remaining ids are -1 and the distances are infinite
+          void search(const blitz::Array<double,1>& query, int probes, blitz::Array<int,1>& ids, blitz::Array<double,1>& distances) const;
+
+          //! \brief Finds the shortlist graphs closest to the probe graph, see search(), and re-ranks them with the exact Similarity::search;
+          //! only the shortlisted graphs are requested from the given loader, so that the gallery does not need to be kept in memory.
+          //! If less than ids.extent(0) graphs are shortlisted, the remaining ids are -1 and the scores are NaN.
+          //! The similarity is not thread-safe for all types, so it must not be used by other threads meanwhile
+          void search(const Similarity& similarity, const blitz::Array<double,3>& probe, const GraphLoader& loader, int probes, int shortlist, blitz::Array<int,1>& ids, blitz::Array<double,1>& scores) const;
+
+          //! Re-ranks the shortlisted graphs as above, taking them from the gallery of shape (size(), nodes, 2, length), which contains the graphs in the order of their identifiers
+          void search(const Similarity& similarity, const blitz::Array<double,3>& probe, const blitz::Array<double,4>& gallery, int probes, int shortlist, blitz::Array<int,1>& ids, blitz::Array<double,1>& scores) const;
+
+          //! The dimension of the feature vectors
+          int dimension() const {return m_dimension;}
+
+          //! The number of coarse centroids, i.e., of inverted lists
+          int numberOfLists() const {return m_coarse_centroids.extent(0);}
+
+          //! The number of parts, into which the residuals are split
+          int numberOfSubquantizers() const {return m_codebooks.extent(0);}
+
+          //! The number of centroids of each sub-quantizer
+          int numberOfCentroids() const {return m_codebooks.extent(1);}
+
+          //! The number of graphs stored in the index
+          int size() const {return m_size;}
+
+          //! Has the index been trained?
+          bool isTrained() const {return m_trained;}
+
+          //! Saves the index, including the stored graphs, to the given HDF5 file
+          void save(bob::io::base::HDF5File& file) const;
+
+          //! Loads the index, including the stored graphs, from the given HDF5 file
+          void load(bob::io::base::HDF5File& file);
+
+        private:
+
+          // returns the index of the coarse centroid closest to the given feature vector
+          int assign(const double* feature) const;
+
+          int m_dimension;
+          bool m_trained;
+          int m_size;
+
+          // the coarse centroids (lists, dimension)
+          blitz::Array<double,2> m_coarse_centroids;
+          // the centroids of the sub-quantizers (subquantizers, centroids, dimension / subquantizers)
+          blitz::Array<double,3> m_codebooks;
+
+          // for each list, the identifiers and the codes (subquantizers bytes per graph)
+          std::vector<std::vector<int>> m_ids;
+          std::vector<std::vector<uint8_t>> m_codes;
+
+      }; // class Index
+
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_INDEX_H
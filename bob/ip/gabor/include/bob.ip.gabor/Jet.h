@@ -103,6 +103,11 @@ namespace bob {
 
           void setJet(const blitz::Array<double,2>& jets);
 
+          //! \brief Uses the memory of the given array of shape (2, length) as storage of this Gabor jet, without copying.
+          //! The array must be C-contiguous, and its memory must stay valid as long as this Gabor jet refers to it;
+          //! extracting or initializing a Gabor jet of the same length writes directly into the adopted memory
+          void adopt(blitz::Array<double,2>& jet);
+
           //! The vector of complex values
           const blitz::Array<std::complex<double>,1> complex() const;
 
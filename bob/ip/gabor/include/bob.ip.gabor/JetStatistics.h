@@ -31,8 +31,8 @@ class JetStatistics {
     const blitz::Array<double,1>& varPhase() const {return m_varPhase;}
     // gets the utilized Transform class
     boost::shared_ptr<bob::ip::gabor::Transform> gwt() {return m_gwt;}
-    // sets the utilized Transform class
-    void gwt(boost::shared_ptr<bob::ip::gabor::Transform> gwt) {m_gwt = gwt;}
+    // sets the utilized Transform class; the wavelet frequencies are cached, so set it again after modifying the transform
+    void gwt(boost::shared_ptr<bob::ip::gabor::Transform> gwt);
 
     // helper function to get the phase shifted between -pi and pi
     static double adjust_phase(const double phase){
@@ -43,10 +43,13 @@ class JetStatistics {
     void save(bob::io::base::HDF5File& hdf5, bool saveTransform = true) const;
 
     // computes the estimated disparity of the given jet towards the mean and variance given in these statistics
-    blitz::TinyVector<double, 2> disparity(const boost::shared_ptr<bob::ip::gabor::Jet> jet) const;
+    // the scoring functions do not modify these statistics, so that they can be called from several threads at the same time
+    blitz::TinyVector<double, 2> disparity(const bob::ip::gabor::Jet& jet) const;
+    blitz::TinyVector<double, 2> disparity(const boost::shared_ptr<bob::ip::gabor::Jet> jet) const {return disparity(*jet);}
 
     // computes the log likelihood that the given jet fits to these statistics; always negative
-    double logLikelihood(const boost::shared_ptr<bob::ip::gabor::Jet> jet, bool estimate_phase = true, const blitz::TinyVector<double,2>& offset=blitz::TinyVector<double,2>(0.,0.)) const;
+    double logLikelihood(const bob::ip::gabor::Jet& jet, bool estimate_phase = true, const blitz::TinyVector<double,2>& offset=blitz::TinyVector<double,2>(0.,0.)) const;
+    double logLikelihood(const boost::shared_ptr<bob::ip::gabor::Jet> jet, bool estimate_phase = true, const blitz::TinyVector<double,2>& offset=blitz::TinyVector<double,2>(0.,0.)) const {return logLikelihood(*jet, estimate_phase, offset);}
 
   protected:
     // means and variances of absolute and phase values of the jets
@@ -55,8 +58,13 @@ class JetStatistics {
     boost::shared_ptr<bob::ip::gabor::Transform> m_gwt;
 
   private:
-    // cached sotrage to speed up computation
-    mutable blitz::Array<double,1> m_confidences, m_phaseDifferences;
+    // precomputes the inverse variances and the products of the wavelet frequencies with the inverse phase variances
+    void prepare();
+
+    // the inverse variances of the absolute values, and the inverse products of phase variances and mean absolute values
+    blitz::Array<double,1> m_invVarAbs, m_phaseWeights;
+    // for each wavelet j with frequency (ky, kx) and phase variance v: ky, kx, ky*ky/v, ky*kx/v, kx*kx/v, ky/v, kx/v
+    blitz::Array<double,2> m_kernels;
 };
 
 } } } // namespaces
@@ -0,0 +1,98 @@
+/**
+ * @brief Header file for the binary phase codes of Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_PHASE_CODE_H
+#define BOB_IP_GABOR_PHASE_CODE_H
+
+#include <bob.core/assert.h>
+
+#include <bob.ip.gabor/Jet.h>
+#include <bob.ip.gabor/Graph.h>
+
+#include <cstdint>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class encodes Gabor jets into compact binary codes and compares them with the masked Hamming distance.
+      //! For each wavelet, two bits store the quadrant of the phase, i.e., whether the real and the imaginary parts of the response are non-negative.
+      //! The bits of wavelets, whose magnitudes are below magnitudeThreshold() times the mean magnitude of the Gabor jet, are masked out.
+      //! The codes and the masks of a Gabor jet with L wavelets are stored in words(L) 64 bit integers each;
+      //! for a graph, the codes of all nodes are stored one after the other.
+      class PhaseCode {
+
+        public:
+
+          //! Creates a phase code that masks out the wavelets with magnitudes below the given fraction of the mean magnitude of the Gabor jet
+          PhaseCode(double magnitude_threshold = 0.);
+
+          //! The fraction of the mean magnitude of the Gabor jet, below which the bits of a wavelet are masked out
+          double magnitudeThreshold() const {return m_magnitude_threshold;}
+
+          //! Sets the fraction of the mean magnitude of the Gabor jet, below which the bits of a wavelet are masked out
+          void magnitudeThreshold(double magnitude_threshold);
+
+          //! The number of 64 bit words of the code (and the mask) of a Gabor jet with the given number of wavelets
+          static int words(int length) {return (2 * length + 63) / 64;}
+
+          //! Encodes the given Gabor jet into the code and the mask of shape (words(length))
+          void encode(const bob::ip::gabor::Jet& jet, blitz::Array<uint64_t,1>& code, blitz::Array<uint64_t,1>& mask) const;
+
+          //! Encodes the Gabor jets of a graph of shape (nodes, 2, length) into the codes and the masks of shape (nodes, words(length))
+          void encode(const blitz::Array<double,3>& jets, blitz::Array<uint64_t,2>& codes, blitz::Array<uint64_t,2>& masks) const;
+
+          //! Encodes the Gabor jets of shape (N, nodes, 2, length), see Graph::extract, into the codes and the masks of shape (N, nodes, words(length))
+          void encode(const blitz::Array<double,4>& jets, blitz::Array<uint64_t,3>& codes, blitz::Array<uint64_t,3>& masks) const;
+
+          //! \brief Encodes the responses of the given trafo image at the nodes of the given graph into the codes and the masks of shape (nodes, words(wavelets)).
+          //! The phases are not computed, so that this is much faster than extracting the Gabor jets first
+          void encode(const bob::ip::gabor::Graph& graph, const blitz::Array<std::complex<double>,3>& trafo_image, blitz::Array<uint64_t,2>& codes, blitz::Array<uint64_t,2>& masks) const;
+
+          //! \brief Returns the similarity 1 - d / v of the given codes of the given number of words, where v is the number of bits that are valid in both masks,
+          //! and d is the number of valid bits that differ between the codes; the similarity is 0 if no bit is valid
+          static double similarity(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words);
+
+          //! Returns the similarity of the given codes of Gabor jets (1D) or graphs (2D) of the same shape, which need to be C-contiguous
+          template <int N>
+          static double similarity(const blitz::Array<uint64_t,N>& code1, const blitz::Array<uint64_t,N>& mask1, const blitz::Array<uint64_t,N>& code2, const blitz::Array<uint64_t,N>& mask2){
+            check(code1, mask1, code2, mask2);
+            return similarity(code1.data(), mask1.data(), code2.data(), mask2.data(), code1.numElements());
+          }
+
+          //! Computes the similarities of the code of the probe graph of shape (nodes, words) to the codes of all gallery graphs of shape (N, nodes, words), which need to be C-contiguous
+          static void similarities(const blitz::Array<uint64_t,2>& code, const blitz::Array<uint64_t,2>& mask, const blitz::Array<uint64_t,3>& codes, const blitz::Array<uint64_t,3>& masks, blitz::Array<double,1>& similarities);
+
+        private:
+
+          // checks that the codes and the masks have the same shape and are C-contiguous
+          template <int N>
+          static void check(const blitz::Array<uint64_t,N>& code1, const blitz::Array<uint64_t,N>& mask1, const blitz::Array<uint64_t,N>& code2, const blitz::Array<uint64_t,N>& mask2){
+            bob::core::array::assertSameShape(mask1, code1);
+            bob::core::array::assertSameShape(code2, code1);
+            bob::core::array::assertSameShape(mask2, code1);
+            if (!bob::core::array::isCZeroBaseContiguous(code1) || !bob::core::array::isCZeroBaseContiguous(mask1) || !bob::core::array::isCZeroBaseContiguous(code2) || !bob::core::array::isCZeroBaseContiguous(mask2))
+              throw std::runtime_error("PhaseCode: the codes and the masks must be C-contiguous");
+          }
+
+          // encodes the given absolute values and phases, which are stored with the given stride
+          void encode(const double* abs, const double* phase, int stride, int length, uint64_t* code, uint64_t* mask) const;
+
+          // encodes the given complex responses, which are stored with the given stride
+          void encode(const std::complex<double>* responses, int stride, int length, uint64_t* code, uint64_t* mask) const;
+
+          double m_magnitude_threshold;
+
+      }; // class PhaseCode
+
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_PHASE_CODE_H
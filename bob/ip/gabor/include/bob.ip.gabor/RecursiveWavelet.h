@@ -0,0 +1,110 @@
+/**
+ * @brief Header file for the C++ implementations of the recursive (IIR) Gabor wavelet filter
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_RECURSIVE_WAVELET_H
+#define BOB_IP_GABOR_RECURSIVE_WAVELET_H
+
+#include <bob.core/assert.h>
+#include <vector>
+#include <complex>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class approximates the convolution with a single Gabor wavelet by recursive filtering.
+      //! The image is demodulated with the wavelet frequency, smoothed with a recursive Gaussian filter
+      //! (a sum of causal and anti-causal IIR filters) and modulated back.
+      //! Hence, the costs per pixel do not depend on the size of the wavelet, but they grow linearly with the order of the filter.
+      //! The order selects the accuracy: the maximum deviation of the fitted Gaussian is 5e-4 for order 4, 8e-6 for order 6 and 1e-7 for order 8.
+      class RecursiveWavelet {
+
+        public:
+
+          //! Generate a recursive Gabor wavelet filter; the epsilon defines the length of the periodic warm-up margin, the order (4, 6 or 8) the accuracy
+          RecursiveWavelet(
+            const blitz::TinyVector<double,2>& wavelet_frequency,
+            const double sigma = 2. * M_PI,
+            const double pow_of_k = 0.,
+            const bool dc_free = true,
+            const double epsilon = 1e-4,
+            const int order = 6
+          );
+
+          //! The standard deviation sigma/k (in pixels) of the Gaussian envelope of this wavelet
+          double scale() const {return m_scale;}
+
+          //! The number of pixels that are filtered before and after each line to warm up the recursions
+          int margin() const {return m_margin;}
+
+          //! The order of the recursive Gaussian filter
+          int order() const {return 2 * m_sections;}
+
+          //! Smoothes the given image with the Gaussian envelope of this wavelet, using periodic boundary conditions
+          void smooth(
+            const blitz::Array<std::complex<double>,2>& image,
+            blitz::Array<std::complex<double>,2>& smoothed
+          ) const;
+
+          //! Filters the given image with this wavelet using periodic boundary conditions (i.e., as the FFT does)
+          void transform(
+            const blitz::Array<std::complex<double>,2>& image,
+            blitz::Array<std::complex<double>,2>& layer
+          ) const;
+
+          //! Filters the given image with this wavelet, where the DC part is taken from the given result of smooth()
+          void transform(
+            const blitz::Array<std::complex<double>,2>& image,
+            const blitz::Array<std::complex<double>,2>& smoothed,
+            blitz::Array<std::complex<double>,2>& layer
+          ) const;
+
+        private:
+
+          // filters count lines of the given length, each modulated with the given frequency
+          void filter(
+            const std::complex<double>* input,
+            std::complex<double>* output,
+            int length,
+            int count,
+            int line_stride,
+            int element_stride,
+            double frequency
+          ) const;
+
+          // filters the image with the modulated Gaussian in both directions
+          void filter(
+            const blitz::Array<std::complex<double>,2>& image,
+            blitz::Array<std::complex<double>,2>& result,
+            const blitz::TinyVector<double,2>& frequency
+          ) const;
+
+          // the wavelet frequency
+          blitz::TinyVector<double,2> m_k;
+          // the standard deviation of the Gaussian envelope
+          double m_scale;
+          // the warm-up margin of the recursions
+          int m_margin;
+          // the prefactor k^pow_of_k of the wavelet
+          double m_factor;
+          // the DC term exp(-sigma^2/2), or 0 if the wavelet is not DC-free
+          double m_dc;
+          // the number of parallel second-order sections, i.e., half of the order
+          int m_sections;
+          // the numerator coefficients of the causal and the anti-causal filter of each section
+          double m_causal[4][2], m_anticausal[4][2];
+          // the common denominator coefficients of both filters of each section
+          double m_denominator[4][2];
+
+      }; // class RecursiveWavelet
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_RECURSIVE_WAVELET_H
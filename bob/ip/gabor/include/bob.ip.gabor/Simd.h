@@ -0,0 +1,94 @@
+/**
+ * @brief Header file for the vectorized kernels, which are selected at runtime according to the CPU features
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_SIMD_H
+#define BOB_IP_GABOR_SIMD_H
+
+#include <complex>
+#include <cstdint>
+#include <string>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class provides the inner loops of the Gabor wavelet transform, the Gabor jets and their similarities.
+      //! Each kernel is implemented for several instruction sets (compiled with the according target attributes),
+      //! and the best implementation supported by the current CPU is selected when the library is loaded.
+      //! Hence, one binary runs with the fastest kernels on all x86 machines; on other architectures, only the scalar kernels exist.
+      class Simd {
+
+        public:
+
+          //! The available instruction sets, in increasing order
+          typedef enum {
+            SCALAR = 0,
+            SSE2 = 1,
+            AVX2 = 2,
+            AVX512 = 3
+          } Level;
+
+          static const std::string& level_to_name(Level level);
+
+          static Level name_to_level(const std::string& level);
+
+          //! Returns true if the given level is compiled into this library and supported by the current CPU
+          static bool available(Level level);
+
+          //! The best level that is available on the current CPU
+          static Level best();
+
+          //! The level of the kernels that are currently in use
+          static Level level();
+
+          //! Selects the kernels of the given level, e.g., for testing; throws if the level is not available.
+          //! This function is not thread-safe, i.e., no kernels must run while the level is changed
+          static void level(Level level);
+
+          //! Returns the scalar product of the given vectors
+          static double dot(const double* a, const double* b, int size);
+
+          //! Returns the sum of the Canberra similarities 1 - |a-b| / (a+b) of the elements of the given vectors
+          static double canberra(const double* a, const double* b, int size);
+
+          //! Computes the absolute values of the given complex numbers, which are stored with the given stride (in elements)
+          static void abs(const std::complex<double>* input, int stride, double* output, int size);
+
+          //! Computes the absolute values and the phases of the given complex numbers, which are stored with the given stride (in elements).
+          //! The phases are computed with std::atan2, or with a vectorized approximation if approximatePhase() is enabled
+          static void polar(const std::complex<double>* input, int stride, double* abs, double* phase, int size);
+
+          //! Returns whether polar() approximates the phases
+          static bool approximatePhase();
+
+          //! Enables or disables the approximation of phases in polar(), which is disabled by default.
+          //! The absolute values are not affected. This function is not thread-safe
+          static void approximatePhase(bool approximate);
+
+          //! The maximum absolute error (in radians) of the approximated phases
+          static const double approximatePhaseError;
+
+          //! Multiplies the given complex numbers element-wise with the given real-valued weights
+          static void multiply(const std::complex<double>* input, const double* weights, std::complex<double>* output, int size);
+
+          //! \brief Estimates the disparities of count pairs of Gabor jets at once, with one pair per SIMD lane, see Similarity::disparity.
+          //! The frequencies (ky, kx) of the scales * directions wavelets are shared by all pairs.
+          //! The confidences and the (adjusted) phase differences are stored coefficient-major, i.e., the value of wavelet j for pair p is at index j * count + p.
+          //! The disparities (dy, dx) of pair p are written to disparity_y[p] and disparity_x[p]
+          static void disparity(const double* frequencies, int scales, int directions, const double* confidences, const double* phase_differences, int count, double* disparity_y, double* disparity_x);
+
+          //! Counts the bits that are set in both masks, and how many of these bits differ between the codes, see PhaseCode
+          static void hamming(const uint64_t* code1, const uint64_t* mask1, const uint64_t* code2, const uint64_t* mask2, int words, int* differences, int* valid);
+
+      }; // class Simd
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_SIMD_H
@@ -17,6 +17,8 @@
 
 #include <bob.ip.gabor/Jet.h>
 
+#include <boost/function.hpp>
+
 namespace bob {
   namespace ip {
     namespace gabor{
@@ -52,6 +54,26 @@ namespace bob {
           //! returns the disparity vector estimated from the given jets
           blitz::TinyVector<double,2> disparity(const Jet& jet1, const Jet& jet2) const;
 
+          //! \brief computes the similarities between the pairs of Gabor jets jets1[p] and jets2[p] and stores them in similarities[p];
+          //! for the disparity types, the disparities of several pairs are estimated simultaneously in SIMD lanes, see Simd::disparity
+          void similarities(const std::vector<boost::shared_ptr<Jet>>& jets1, const std::vector<boost::shared_ptr<Jet>>& jets2, blitz::Array<double,1>& similarities) const;
+
+          //! \brief estimates the disparity vectors between the pairs of Gabor jets jets1[p] and jets2[p] and stores them in the rows of the (jets1.size(), 2) array disparities;
+          //! only valid for disparity types. The disparities are estimated simultaneously in SIMD lanes, and they are identical to the ones returned by disparity(jet1, jet2)
+          void disparities(const std::vector<boost::shared_ptr<Jet>>& jets1, const std::vector<boost::shared_ptr<Jet>>& jets2, blitz::Array<double,2>& disparities) const;
+
+          //! \brief estimates the dense disparity field between two trafo images of the same Transform, see Transform::transform;
+          //! for each point (r*step[0], c*step[1]), the disparity vector and the similarity between the normalized Gabor jets of both images are stored in disparities(r,c,:) and similarities(r,c).
+          //! Only valid for disparity types; the rows are distributed over the given number of threads (0 for one thread per core)
+          void disparityField(const blitz::Array<std::complex<double>,3>& trafo_image1, const blitz::Array<std::complex<double>,3>& trafo_image2, blitz::Array<double,3>& disparities, blitz::Array<double,2>& similarities, const blitz::TinyVector<int,2>& step = blitz::TinyVector<int,2>(1,1), int number_of_threads = 1) const;
+
+          //! \brief finds the indices and scores of the indices.extent(0) gallery graphs that are most similar to the probe graph, in descending order of the score.
+          //! The score of a gallery graph is the average similarity of its Gabor jets to the Gabor jets of the probe graph at the same nodes.
+          //! The probe of shape (nodes, 2, length) and the gallery of shape (N, nodes, 2, length) must be C-contiguous, see Graph::extract.
+          //! Candidates are abandoned as soon as an upper bound of their score cannot reach the current k-th best score, so the results are exact.
+          //! When normalized is true, the absolute values of all Gabor jets must have unit length, which tightens the bounds of the product-based similarity functions
+          void search(const blitz::Array<double,3>& probe, const blitz::Array<double,4>& gallery, blitz::Array<int,1>& indices, blitz::Array<double,1>& scores, bool normalized = true) const;
+
           //! returns the disparity vector estimated during the last call of similarity; only valid for disparity types
           blitz::TinyVector<double,2> disparity() const {return m_disparity;}
 
@@ -75,6 +97,8 @@ namespace bob {
 
           // members required by disparity functions
           boost::shared_ptr<Transform> m_gwt;
+          // is m_gwt the default Gabor wavelet family Transform(5, 8), for which fixed-length implementations are used?
+          bool m_default_family;
 
           // initializes the internal memory to be used for disparity-like Gabor jet similarities
           void init();
@@ -83,6 +107,12 @@ namespace bob {
           // computes the disparity using the m_confidences and m_phase_differences values
           void compute_disparity() const;
 
+          // fills the wavelet frequencies (ky, kx) shared by all pairs of Gabor jets, see Simd::disparity
+          void batch_frequencies(std::vector<double>& frequencies) const;
+          // estimates the disparities of the pairs of Gabor jets in blocks of pairs; the given function is called for each block with
+          // the coefficient-major confidences and phase differences, the disparities and the wavelet frequencies of that block
+          void batch_disparities(const std::vector<boost::shared_ptr<Jet>>& jets1, const std::vector<boost::shared_ptr<Jet>>& jets2, const boost::function<void(int first, int count, const double* confidences, const double* phase_differences, const double* disparity_y, const double* disparity_x, const double* frequencies)>& block) const;
+
           mutable blitz::TinyVector<double,2> m_disparity;
 
           mutable blitz::Array<double,1> m_confidences;
@@ -0,0 +1,77 @@
+/**
+ * @brief Header file for the C++ implementations of the truncated Gabor wavelet in spatial domain
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_SPATIAL_WAVELET_H
+#define BOB_IP_GABOR_SPATIAL_WAVELET_H
+
+#include <bob.core/assert.h>
+#include <vector>
+#include <complex>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class represents a single Gabor wavelet in spatial domain.
+      //! The wavelet is the analytic inverse Fourier transform of the frequency domain Wavelet,
+      //! truncated where the Gaussian envelope falls below epsilon.
+      //! Since the envelope is separable, the wavelet is stored as two pairs of one-dimensional kernels.
+      class SpatialWavelet {
+
+        public:
+
+          //! Generate a truncated Gabor wavelet in spatial domain
+          SpatialWavelet(
+            const blitz::TinyVector<double,2>& wavelet_frequency,
+            const double sigma = 2. * M_PI,
+            const double pow_of_k = 0.,
+            const bool dc_free = true,
+            const double epsilon = 1e-4
+          );
+
+          //! Returns the radius (in pixels) of the truncated wavelet for the given parametrization
+          static int radius(const blitz::TinyVector<double,2>& wavelet_frequency, const double sigma, const double epsilon);
+
+          //! The radius of this truncated wavelet; the kernel has (2*radius+1) x (2*radius+1) pixels
+          int radius() const {return m_radius;}
+
+          //! Get the image representation of the truncated Gabor wavelet in spatial domain, centered at (radius, radius)
+          blitz::Array<std::complex<double>,2> kernelImage() const;
+
+          //! Convolves the given image with this wavelet using periodic boundary conditions (i.e., as the FFT does)
+          void transform(
+            const blitz::Array<std::complex<double>,2>& image,
+            blitz::Array<std::complex<double>,2>& layer
+          ) const;
+
+          //! Computes the responses of this wavelet only at the given positions of the image
+          void transform(
+            const blitz::Array<std::complex<double>,2>& image,
+            const std::vector<blitz::TinyVector<int,2>>& positions,
+            blitz::Array<std::complex<double>,1> responses
+          ) const;
+
+        private:
+          // the radius of the kernels
+          int m_radius;
+          // the prefactor k^pow_of_k * k^2 / (2 pi sigma^2) of the wavelet
+          double m_factor;
+          // the DC term exp(-sigma^2/2), or 0 if the wavelet is not DC-free
+          double m_dc;
+          // the modulated Gaussian kernels in vertical and horizontal direction, indexed from -radius to radius
+          std::vector<std::complex<double>> m_gabor_y, m_gabor_x;
+          // the plain Gaussian kernel, which is identical in both directions
+          std::vector<std::complex<double>> m_gauss;
+
+      }; // class SpatialWavelet
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_SPATIAL_WAVELET_H
@@ -0,0 +1,55 @@
+/**
+ * @brief Header file for the spectrum of an image that can be shared between several Gabor wavelet families
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_SPECTRUM_H
+#define BOB_IP_GABOR_SPECTRUM_H
+
+#include <bob.ip.gabor/Transform.h>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief The Spectrum class stores the FFT of an image, as computed by Transform::spectrum().
+      //! It can be transformed by any number of Gabor wavelet families (see Transform::transform(const Spectrum&, ...)),
+      //! which use the same padding, so that the forward FFT of the image is computed only once.
+      class Spectrum {
+
+        public:
+
+          //! Creates an empty spectrum; use Transform::spectrum() to compute it
+          Spectrum() : m_height(0), m_width(0), m_padding(Transform::NO_PADDING) {}
+
+          //! The height of the original image
+          int height() const {return m_height;}
+
+          //! The width of the original image
+          int width() const {return m_width;}
+
+          //! The padding that was applied to the image before computing the FFT
+          Transform::Padding padding() const {return m_padding;}
+
+          //! The FFT of the (padded) image
+          const blitz::Array<std::complex<double>,2>& frequencyImage() const {return m_frequency_image;}
+
+        private:
+
+          friend class Transform;
+
+          int m_height;
+          int m_width;
+          Transform::Padding m_padding;
+          blitz::Array<std::complex<double>,2> m_frequency_image;
+
+      }; // class Spectrum
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_SPECTRUM_H
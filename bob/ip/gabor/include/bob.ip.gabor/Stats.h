@@ -0,0 +1,107 @@
+/**
+ * @brief Header file for the instrumentation of the stages of the Gabor wavelet transform and the similarity functions
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_STATS_H
+#define BOB_IP_GABOR_STATS_H
+
+#include <boost/preprocessor/cat.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class accumulates the wall time and the number of calls of the stages of the Gabor wavelet transform and the similarity functions,
+      //! as well as some event counters. The statistics are global for the process and thread-safe.
+      //! Instrumentation is only compiled into the library when BOB_IP_GABOR_STATS is defined (see the macros below);
+      //! otherwise, all statistics stay 0 and the instrumented code has no overhead.
+      class Stats {
+
+        public:
+
+          //! The timed stages; note that stages might be nested, e.g., DISPARITY_ESTIMATION is part of SIMILARITY for the disparity-based similarity functions
+          typedef enum {
+            WAVELET_GENERATION = 0,
+            FORWARD_FFT,
+            WAVELET_MULTIPLY,
+            INVERSE_FFT,
+            SPATIAL_CONVOLUTION,
+            RECURSIVE_FILTER,
+            SIMILARITY,
+            DISPARITY_ESTIMATION,
+            NUMBER_OF_STAGES
+          } Stage;
+
+          //! The event counters
+          typedef enum {
+            WAVELET_RESETS = 0,
+            WAVELET_CACHE_HITS,
+            SCALAR_PRODUCT_CALLS,
+            CANBERRA_CALLS,
+            ABS_PHASE_CALLS,
+            DISPARITY_CALLS,
+            PHASE_DIFF_CALLS,
+            PHASE_DIFF_PLUS_CANBERRA_CALLS,
+            NUMBER_OF_COUNTERS
+          } Counter;
+
+          static const std::string& stage_to_name(Stage stage);
+
+          static const std::string& counter_to_name(Counter counter);
+
+          //! Returns true if the instrumentation was compiled into this library
+          static bool enabled();
+
+          //! Returns the number of times the given stage was executed
+          static unsigned long long calls(Stage stage);
+
+          //! Returns the accumulated wall time of the given stage, in seconds
+          static double seconds(Stage stage);
+
+          //! Returns the value of the given counter
+          static unsigned long long counter(Counter counter);
+
+          //! Sets all statistics to 0
+          static void reset();
+
+          //! Adds one call with the given duration to the given stage
+          static void add(Stage stage, std::chrono::steady_clock::duration duration);
+
+          //! Increments the given counter
+          static void increment(Counter counter);
+
+          //! Measures the wall time from its construction to its destruction and adds it to the given stage
+          class Timer {
+            public:
+              Timer(Stage stage) : m_stage(stage), m_start(std::chrono::steady_clock::now()) {}
+              ~Timer() {add(m_stage, std::chrono::steady_clock::now() - m_start);}
+            private:
+              Stage m_stage;
+              std::chrono::steady_clock::time_point m_start;
+          };
+
+      }; // class Stats
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+//! BOB_IP_GABOR_STATS_TIME(stage) times the remainder of the current scope;
+//! BOB_IP_GABOR_STATS_COUNT(counter) increments the given counter.
+//! Both expand to nothing, unless BOB_IP_GABOR_STATS is defined.
+#ifdef BOB_IP_GABOR_STATS
+#define BOB_IP_GABOR_STATS_TIME(stage) bob::ip::gabor::Stats::Timer BOOST_PP_CAT(bob_ip_gabor_stats_timer_, __LINE__)(bob::ip::gabor::Stats::stage)
+#define BOB_IP_GABOR_STATS_COUNT(counter) bob::ip::gabor::Stats::increment(bob::ip::gabor::Stats::counter)
+#else
+#define BOB_IP_GABOR_STATS_TIME(stage)
+#define BOB_IP_GABOR_STATS_COUNT(counter)
+#endif
+
+#endif // BOB_IP_GABOR_STATS_H
@@ -12,10 +12,13 @@
 #define BOB_IP_GABOR_TRANSFORM_H
 
 #include <bob.io.base/HDF5File.h>
-#include <bob.sp/FFT2D.h>
 #include <bob.core/cast.h>
+#include <boost/function.hpp>
 
+#include <bob.ip.gabor/FFT.h>
 #include <bob.ip.gabor/Wavelet.h>
+#include <bob.ip.gabor/SpatialWavelet.h>
+#include <bob.ip.gabor/RecursiveWavelet.h>
 
 
 namespace bob {
@@ -24,6 +27,7 @@ namespace bob {
 
     namespace gabor{
 
+      class Spectrum;
 
       //! \brief The Transform class computes a Gabor wavelet transform of the given image.
       //! It computes either the complete Gabor wavelet transformed image (short: trafo image) with
@@ -33,6 +37,40 @@ namespace bob {
 
         public:
 
+          //! This enum defines how the Gabor wavelet transform is computed.
+          //! FREQUENCY_DOMAIN multiplies the image spectrum with the Gabor wavelets and performs one FFT per wavelet,
+          //! SPATIAL_DOMAIN convolves the image with truncated SpatialWavelet's,
+          //! while AUTOMATIC selects the cheaper of both based on the image resolution and the number of requested positions.
+          //! RECURSIVE approximates the transform with RecursiveWavelet's in linear time; it is never selected automatically
+          typedef enum {
+            FREQUENCY_DOMAIN = 0,
+            SPATIAL_DOMAIN = 1,
+            AUTOMATIC = 2,
+            RECURSIVE = 3
+          } Engine;
+
+          static const std::string& engine_to_name(Engine engine);
+
+          static Engine name_to_engine(const std::string& engine);
+
+          //! This enum defines how the image is padded before the transform.
+          //! When padding is enabled, the image is padded (centrally) to the next size that has only the prime factors 2, 3 and 5,
+          //! and the trafo image is cropped back to the image resolution.
+          //! ZERO_PADDING fills the border with zeros, REFLECT_PADDING mirrors the image without and SYMMETRIC_PADDING with repeating the border pixels
+          typedef enum {
+            NO_PADDING = 0,
+            ZERO_PADDING = 1,
+            REFLECT_PADDING = 2,
+            SYMMETRIC_PADDING = 3
+          } Padding;
+
+          static const std::string& padding_to_name(Padding padding);
+
+          static Padding name_to_padding(const std::string& padding);
+
+          //! Returns the smallest size not below the given size that has only the prime factors 2, 3 and 5
+          static int fftFriendlySize(int size);
+
           //! \brief Constructs a Gabor wavelet transform object.
           //! This class will generate number_of_scales * number_of_orientations Gabor wavelets
           //! using the given sigma, k_max and k_fac values
@@ -62,9 +100,25 @@ namespace bob {
           //! generate the wavelets for the new resolution
           void generateWavelets(int y_resoultion, int x_resolution);
 
+          //! generate the truncated wavelets for the spatial domain engine; these are independent of the resolution
+          void generateSpatialWavelets();
+
+          //! generate the recursive wavelet filters for the recursive engine; these are independent of the resolution
+          void generateRecursiveWavelets();
+
           //! Returns the Gabor wavelet for the given index
           const std::vector<boost::shared_ptr<bob::ip::gabor::Wavelet>>& wavelets() const {return m_wavelets;}
 
+          //! \brief Sets already generated Gabor wavelets, e.g., the wavelets() of another Transform with the same parametrization.
+          //! All given wavelets need to be generated with the parametrization of this class and for the same resolution; missing wavelets (empty pointers) are generated when they are first used
+          void wavelets(const std::vector<boost::shared_ptr<bob::ip::gabor::Wavelet>>& wavelets);
+
+          //! Returns the truncated Gabor wavelets used by the spatial domain engine
+          const std::vector<boost::shared_ptr<bob::ip::gabor::SpatialWavelet>>& spatialWavelets() const {return m_spatial_wavelets;}
+
+          //! Returns the recursive Gabor wavelet filters used by the recursive engine
+          const std::vector<boost::shared_ptr<bob::ip::gabor::RecursiveWavelet>>& recursiveWavelets() const {return m_recursive_wavelets;}
+
           //! get the number of wavelets (usually, 40) used by this GWT class
           int numberOfWavelets() const{return m_wavelet_frequencies.size();}
           int numberOfDirections() const{return m_number_of_directions;}
@@ -78,12 +132,171 @@ namespace bob {
           double k_fac() const {return m_k_fac;}
           double pow_of_k() const {return m_pow_of_k;}
           bool dc_free() const {return m_dc_free;}
+          double epsilon() const {return m_epsilon;}
+
+          //! The engine that is used to compute the Gabor wavelet transform
+          Engine engine() const {return m_engine;}
+          void engine(Engine engine) {m_engine = engine;}
+
+          //! The relative value of the Gaussian envelope, at which the spatial domain wavelets are truncated;
+          //! it also defines the warm-up margin of the recursive wavelets
+          double spatialEpsilon() const {return m_spatial_epsilon;}
+          void spatialEpsilon(double epsilon);
+
+          //! The order (4, 6 or 8) of the recursive Gaussian filters of the recursive engine, which selects their accuracy
+          int recursiveOrder() const {return m_recursive_order;}
+          void recursiveOrder(int order);
+
+          //! The FFT implementation used by the frequency domain engine
+          FFT::Backend fftBackend() const {return m_fft.backend();}
+          void fftBackend(FFT::Backend backend) {m_fft.backend(backend);}
+
+          //! The padding that is applied to the images before the transform
+          Padding padding() const {return m_padding;}
+          void padding(Padding padding) {m_padding = padding;}
+
+          //! \brief Shall the generated wavelets be shared with other Transform objects that have the same parametrization and share their wavelets, too?
+          //! Wavelets are never modified, so only the memory and the time to generate them is saved
+          bool shareWavelets() const {return m_share_wavelets;}
+          void shareWavelets(bool share) {m_share_wavelets = share;}
+
+          //! Returns the shape of the image that is transformed internally, i.e., after padding
+          blitz::TinyVector<int,2> paddedShape(int height, int width) const;
+
+          //! \brief Decides whether the spatial domain engine should be used for the given image resolution.
+          //! When number_of_positions is negative, the complete image is transformed, otherwise only the given number of positions
+          bool useSpatialDomain(int height, int width, int number_of_positions = -1) const;
 
           template <typename T> void transform(
             const blitz::Array<T,2>& gray_image,
             blitz::Array<std::complex<double>,3>& trafo_image
           ){
-            transform_inner(bob::core::array::cast<std::complex<double> >(gray_image), trafo_image);
+            transform_inner(bob::core::array::cast<std::complex<double> >(gray_image), m_all_indices, trafo_image);
+          }
+
+          //! \brief computes the Gabor wavelet transform only for the wavelets with the given indices (see waveletIndices()).
+          //! The trafo_image has shape (indices.size(), height, width); only the required wavelets are generated
+          template <typename T> void transform(
+            const blitz::Array<T,2>& gray_image,
+            const std::vector<int>& indices,
+            blitz::Array<std::complex<double>,3>& trafo_image
+          ){
+            transform_inner(bob::core::array::cast<std::complex<double> >(gray_image), indices, trafo_image);
+          }
+
+          //! Returns the indices of the wavelets of the given scales and directions, in the order of the wavelets
+          std::vector<int> waveletIndices(const std::vector<int>& scales, const std::vector<int>& directions) const;
+
+          //! computes the Gabor wavelet responses only at the given positions; responses are of shape (positions, numberOfWavelets())
+          template <typename T> void transform(
+            const blitz::Array<T,2>& gray_image,
+            const std::vector<blitz::TinyVector<int,2>>& positions,
+            blitz::Array<std::complex<double>,2>& responses
+          ){
+            transform_inner(bob::core::array::cast<std::complex<double> >(gray_image), positions, responses);
+          }
+
+          //! \brief computes the Gabor wavelet transform only inside the region of interest, which starts at the given offset and has the size of the trafo image.
+          //! The full image is used for filtering, but only the region of interest is transformed back to spatial domain
+          template <typename T> void transform(
+            const blitz::Array<T,2>& gray_image,
+            const blitz::TinyVector<int,2>& offset,
+            blitz::Array<std::complex<double>,3>& trafo_roi
+          ){
+            transform_inner(bob::core::array::cast<std::complex<double> >(gray_image), offset, trafo_roi);
+          }
+
+          //! \brief Computes the FFT of the given image, including the current padding.
+          //! The spectrum can be transformed by all Transform objects with the same padding
+          template <typename T> void spectrum(
+            const blitz::Array<T,2>& gray_image,
+            Spectrum& spectrum
+          ){
+            spectrum_inner(bob::core::array::cast<std::complex<double> >(gray_image), spectrum);
+          }
+
+          //! \brief Computes the Gabor wavelet transform of the image, whose spectrum is given.
+          //! The wavelets are always applied in frequency domain, independent of the current engine()
+          void transform(
+            const Spectrum& spectrum,
+            blitz::Array<std::complex<double>,3>& trafo_image
+          ){
+            transform(spectrum, m_all_indices, trafo_image);
+          }
+
+          //! Computes the Gabor wavelet transform of the image, whose spectrum is given, only for the wavelets with the given indices
+          void transform(
+            const Spectrum& spectrum,
+            const std::vector<int>& indices,
+            blitz::Array<std::complex<double>,3>& trafo_image
+          );
+
+          //! The function that receives the tiles computed by transformTiled():
+          //! the position of the upper left pixel of the tile in the image, and the trafo image of the tile
+          typedef boost::function<void (const blitz::TinyVector<int,2>& offset, const blitz::Array<std::complex<double>,3>& trafo_tile)> TileSink;
+
+          //! The margin (in pixels) added around each tile in transformTiled(), i.e., the largest radius of the truncated spatial wavelets
+          int tileMargin() const;
+
+          //! The shape of the tiles used by transformTiled(); the requested tile size is adapted such that the tiles including the margins have FFT friendly sizes
+          blitz::TinyVector<int,2> tileShape(const blitz::TinyVector<int,2>& tile_size) const;
+
+          //! \brief Computes the Gabor wavelet transform tile by tile and passes the trafo image of each tile to the given sink.
+          //! Each tile is extended by tileMargin() pixels, which are taken from the neighboring tiles.
+          //! Outside of the image, they are filled according to the padding, or periodically without padding.
+          //! Hence, the memory is bounded by the tile size, and without padding the result deviates from transform() by at most the spatial epsilon.
+          //! With padding, the result corresponds to transforming the image padded by tileMargin() pixels on each side, while transform() pads only up to an FFT friendly size
+          //! and wraps around periodically beyond; the results differ within tileMargin() pixels of the image borders
+          template <typename T> void transformTiled(
+            const blitz::Array<T,2>& gray_image,
+            const blitz::TinyVector<int,2>& tile_size,
+            const TileSink& sink
+          ){
+            const int height = gray_image.extent(0), width = gray_image.extent(1), margin = tileMargin();
+            const blitz::TinyVector<int,2> tile = tileShape(blitz::TinyVector<int,2>(std::min(tile_size[0], height), std::min(tile_size[1], width)));
+            m_tile_image.resize(tile[0] + 2 * margin, tile[1] + 2 * margin);
+            std::vector<int> ys, xs;
+            for (int y = 0; y < height; y += tile[0]){
+              tileIndices(y - margin, m_tile_image.extent(0), height, ys);
+              for (int x = 0; x < width; x += tile[1]){
+                tileIndices(x - margin, m_tile_image.extent(1), width, xs);
+                for (int i = 0; i < m_tile_image.extent(0); ++i){
+                  for (int j = 0; j < m_tile_image.extent(1); ++j){
+                    m_tile_image(i,j) = ys[i] < 0 || xs[j] < 0 ? std::complex<double>(0.) : std::complex<double>(gray_image(ys[i], xs[j]));
+                  }
+                }
+                transformTile(blitz::TinyVector<int,2>(y, x), blitz::TinyVector<int,2>(std::min(tile[0], height - y), std::min(tile[1], width - x)), sink);
+              }
+            }
+          }
+
+          //! Computes the Gabor wavelet transform tile by tile and writes the result to the given trafo image, which might be a memory-mapped array
+          template <typename T> void transformTiled(
+            const blitz::Array<T,2>& gray_image,
+            const blitz::TinyVector<int,2>& tile_size,
+            blitz::Array<std::complex<double>,3>& trafo_image
+          ){
+            bob::core::array::assertSameShape(trafo_image, blitz::shape(m_wavelet_frequencies.size(), gray_image.extent(0), gray_image.extent(1)));
+            transformTiled(gray_image, tile_size, TileSink(
+              [&trafo_image](const blitz::TinyVector<int,2>& offset, const blitz::Array<std::complex<double>,3>& trafo_tile){
+                trafo_image(blitz::Range::all(), blitz::Range(offset[0], offset[0] + trafo_tile.extent(1) - 1), blitz::Range(offset[1], offset[1] + trafo_tile.extent(2) - 1)) = trafo_tile;
+              }
+            ));
+          }
+
+          //! Computes the Gabor wavelet transform tile by tile and collects the responses at the given positions, e.g., the nodes of a Graph
+          template <typename T> void transformTiled(
+            const blitz::Array<T,2>& gray_image,
+            const blitz::TinyVector<int,2>& tile_size,
+            const std::vector<blitz::TinyVector<int,2>>& positions,
+            blitz::Array<std::complex<double>,2>& responses
+          ){
+            checkPositions(positions, gray_image.extent(0), gray_image.extent(1), responses);
+            transformTiled(gray_image, tile_size, TileSink(
+              [&positions, &responses](const blitz::TinyVector<int,2>& offset, const blitz::Array<std::complex<double>,3>& trafo_tile){
+                collectResponses(offset, trafo_tile, positions, responses);
+              }
+            ));
           }
 
           //! \brief saves the parameters of this Gabor wavelet family to file
@@ -94,12 +307,102 @@ namespace bob {
 
         private:
 
-          //! performs Gabor wavelet transform and returns vector of complex images
+          //! performs Gabor wavelet transform for the given wavelets and returns vector of complex images
+          void transform_inner(
+            const blitz::Array<std::complex<double>,2>& gray_image,
+            const std::vector<int>& indices,
+            blitz::Array<std::complex<double>,3>& trafo_image
+          );
+
+          //! computes the Gabor wavelet responses at the given positions
+          void transform_inner(
+            const blitz::Array<std::complex<double>,2>& gray_image,
+            const std::vector<blitz::TinyVector<int,2>>& positions,
+            blitz::Array<std::complex<double>,2>& responses
+          );
+
+          //! computes the Gabor wavelet transform inside the region of interest
           void transform_inner(
             const blitz::Array<std::complex<double>,2>& gray_image,
+            const blitz::TinyVector<int,2>& offset,
+            blitz::Array<std::complex<double>,3>& trafo_roi
+          );
+
+          //! computes the Gabor wavelet transform of the already padded image inside the region of interest with the current engine
+          void transform_engine(
+            const blitz::Array<std::complex<double>,2>& gray_image,
+            const blitz::TinyVector<int,2>& offset,
+            blitz::Array<std::complex<double>,3>& trafo_roi
+          );
+
+          //! checks that the wavelet indices are valid
+          void checkIndices(const std::vector<int>& indices) const;
+
+          //! computes the spectrum of the given image
+          void spectrum_inner(
+            const blitz::Array<std::complex<double>,2>& gray_image,
+            Spectrum& spectrum
+          );
+
+          //! applies the given wavelets to the given spectrum of the already padded image
+          void transform_frequency(
+            const blitz::Array<std::complex<double>,2>& frequency_image,
+            const std::vector<int>& indices,
+            blitz::Array<std::complex<double>,3>& trafo_image
+          );
+
+          //! computes the Gabor wavelet transform of the already padded image with the given wavelets and the current engine
+          void transform_engine(
+            const blitz::Array<std::complex<double>,2>& gray_image,
+            const std::vector<int>& indices,
             blitz::Array<std::complex<double>,3>& trafo_image
           );
 
+          //! prepares the FFT for the given resolution; the wavelets are generated lazily
+          void prepareWavelets(int height, int width);
+
+          //! generates the wavelet with the given index for the current resolution, or takes a shared one
+          void generateWavelet(int index);
+
+          //! computes the Gabor wavelet responses of the already padded image with the current engine
+          void transform_engine(
+            const blitz::Array<std::complex<double>,2>& gray_image,
+            const std::vector<blitz::TinyVector<int,2>>& positions,
+            blitz::Array<std::complex<double>,2>& responses
+          );
+
+          //! checks that all positions are inside the image and that the responses have the correct shape
+          void checkPositions(
+            const std::vector<blitz::TinyVector<int,2>>& positions,
+            int height,
+            int width,
+            const blitz::Array<std::complex<double>,2>& responses
+          ) const;
+
+          //! computes the image indices of the extended tile starting at the given index, or -1 for zero padding
+          void tileIndices(int start, int length, int size, std::vector<int>& indices) const;
+
+          //! transforms m_tile_image and passes the valid part of the given size to the sink
+          void transformTile(
+            const blitz::TinyVector<int,2>& offset,
+            const blitz::TinyVector<int,2>& size,
+            const TileSink& sink
+          );
+
+          //! copies the responses at all positions that lie inside the given tile
+          static void collectResponses(
+            const blitz::TinyVector<int,2>& offset,
+            const blitz::Array<std::complex<double>,3>& trafo_tile,
+            const std::vector<blitz::TinyVector<int,2>>& positions,
+            blitz::Array<std::complex<double>,2>& responses
+          );
+
+          //! pads the image with the current padding mode
+          void pad(
+            const blitz::Array<std::complex<double>,2>& image,
+            blitz::Array<std::complex<double>,2>& padded
+          ) const;
+
           void computeWaveletFrequencies();
 
           double m_sigma;
@@ -109,12 +412,18 @@ namespace bob {
           bool m_dc_free;
 
           std::vector<boost::shared_ptr<bob::ip::gabor::Wavelet>> m_wavelets;
+          std::vector<boost::shared_ptr<bob::ip::gabor::SpatialWavelet>> m_spatial_wavelets;
+          std::vector<boost::shared_ptr<bob::ip::gabor::RecursiveWavelet>> m_recursive_wavelets;
           std::vector<blitz::TinyVector<double,2> > m_wavelet_frequencies;
+          // the indices of all wavelets, used when the complete trafo image is computed
+          std::vector<int> m_all_indices;
 
-          bob::sp::FFT2D m_fft;
-          bob::sp::IFFT2D m_ifft;
+          bob::ip::gabor::FFT m_fft;
 
-          blitz::Array<std::complex<double>,2> m_temp_array, m_temp_array2, m_frequency_image;
+          blitz::Array<std::complex<double>,2> m_temp_array, m_temp_array2, m_frequency_image, m_smoothed_image, m_padded_image;
+          blitz::Array<std::complex<double>,3> m_trafo_image, m_tile_trafo;
+          blitz::Array<std::complex<double>,2> m_tile_image;
+          blitz::Array<std::complex<double>,1> m_responses;
 
           //! The number of scales (levels, frequencies) of this family
           int m_number_of_scales;
@@ -122,6 +431,17 @@ namespace bob {
           int m_number_of_directions;
           //! The lowest absolute value in the wavelet that should be considered as non-zero
           double m_epsilon;
+
+          //! The engine used to compute the transform
+          Engine m_engine;
+          //! The relative value of the Gaussian envelope, where the spatial wavelets are truncated
+          double m_spatial_epsilon;
+          //! The order of the recursive wavelets
+          int m_recursive_order;
+          //! The padding of the images
+          Padding m_padding;
+          //! Are the generated wavelets shared with other Transform objects?
+          bool m_share_wavelets;
       }; // class Transform
 
     } // namepsace gabor
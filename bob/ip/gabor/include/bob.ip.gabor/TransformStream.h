@@ -0,0 +1,159 @@
+/**
+ * @brief Header file for the asynchronous Gabor wavelet transform of streams of images
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_TRANSFORM_STREAM_H
+#define BOB_IP_GABOR_TRANSFORM_STREAM_H
+
+#include <bob.ip.gabor/Transform.h>
+#include <bob.ip.gabor/Spectrum.h>
+#include <bob.ip.gabor/Graph.h>
+#include <bob.ip.gabor/Jet.h>
+
+#include <boost/shared_ptr.hpp>
+#include <condition_variable>
+#include <exception>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief This class computes the Gabor wavelet transform of a stream of images (e.g., video frames) asynchronously in a two-stage pipeline.
+      //! A dedicated thread computes the Spectrum of each pushed frame, and the inverse FFTs of the wavelets of one frame are spread over several worker threads.
+      //! The pipeline is double-buffered: the spectrum of the next frame is computed while the inverse FFTs of the current frame are still running.
+      //! Frames that are transformed in spatial domain or with recursive filters (see Transform::engine()) are passed to a single worker as a whole.
+      //! The results are popped in the order, in which the frames were pushed.
+      //! When the given capacity of frames is reached, push() blocks until the oldest result is popped (back-pressure).
+      class TransformStream {
+
+        public:
+
+          //! Creates a stream that computes full trafo images with the given Gabor wavelet transform;
+          //! by default, one worker thread per core is used (in addition to the thread computing the spectra), and the capacity is twice the number of worker threads
+          TransformStream(
+            const Transform& transform,
+            int number_of_threads = 0,
+            int capacity = 0
+          );
+
+          //! Creates a stream that extracts the Gabor jets at the nodes of the given graph
+          TransformStream(
+            const Transform& transform,
+            const Graph& graph,
+            int number_of_threads = 0,
+            int capacity = 0
+          );
+
+          //! Closes the stream and waits for the worker threads; results that were not popped are discarded
+          ~TransformStream();
+
+          //! The number of worker threads that compute the inverse FFTs
+          int numberOfThreads() const {return m_threads.size();}
+
+          //! The maximum number of frames that are pushed, but not yet popped
+          int capacity() const {return m_capacity;}
+
+          //! Are Gabor jets extracted instead of trafo images?
+          bool extractsJets() const {return (bool)m_graph;}
+
+          //! The number of frames that were pushed, but not yet popped
+          int pending() const;
+
+          //! Pushes the given frame to the stream; blocks while the capacity is reached
+          template <typename T> void push(const blitz::Array<T,2>& frame){
+            pushFrame(bob::core::array::cast<std::complex<double> >(frame));
+          }
+
+          //! Pushes the given frame, which must not be modified afterwards; blocks while the capacity is reached
+          void pushFrame(const blitz::Array<std::complex<double>,2>& frame);
+
+          //! Waits for the trafo image of the oldest frame, which is returned as a new array; only available without graph
+          void pop(blitz::Array<std::complex<double>,3>& trafo_image);
+
+          //! Waits for the Gabor jets of the oldest frame; only available with graph
+          void pop(std::vector<boost::shared_ptr<Jet>>& jets);
+
+          //! Signals that no more frames will be pushed; the remaining frames can still be popped
+          void close();
+
+        private:
+
+          // a frame and its results
+          struct Frame {
+            blitz::Array<std::complex<double>,2> image;
+            boost::shared_ptr<Spectrum> spectrum;
+            blitz::Array<std::complex<double>,3> trafo_image;
+            blitz::Array<std::complex<double>,2> responses;
+            std::vector<boost::shared_ptr<Jet>> jets;
+            std::exception_ptr error;
+            // the number of tasks of this frame that are not finished yet
+            int remaining;
+          };
+
+          // the work of a worker thread: a chunk of the wavelets of a frame, whose spectrum is computed, or a whole frame if the chunk is negative
+          struct Task {
+            uint64_t index;
+            boost::shared_ptr<Frame> frame;
+            int chunk;
+          };
+
+          void start(const Transform& transform, int number_of_threads, int capacity);
+
+          // the main loop of the thread that computes the spectra (first stage)
+          void prepare(Transform& transform);
+
+          // the main loop of the worker threads (second stage)
+          void work(Transform& transform);
+
+          // computes the given task; layers is a buffer for the trafo image of a chunk
+          void process(Transform& transform, const Task& task, blitz::Array<std::complex<double>,3>& layers);
+
+          // extracts the Gabor jets and passes the frame, whose tasks are finished, to the output
+          void finish(uint64_t index, const boost::shared_ptr<Frame>& frame);
+
+          // waits for the oldest frame and removes it from the stream
+          boost::shared_ptr<Frame> next();
+
+          // the transform of the first stage, followed by those of the worker threads
+          std::vector<boost::shared_ptr<Transform>> m_transforms;
+          boost::shared_ptr<Graph> m_graph;
+          // the indices of the wavelets, split into one chunk per worker thread
+          std::vector<std::vector<int>> m_chunks;
+          std::thread m_spectrum_thread;
+          std::vector<std::thread> m_threads;
+          int m_capacity;
+
+          // the frames to be transformed, the tasks of the worker threads, and the transformed frames indexed by their number
+          std::deque<std::pair<uint64_t, boost::shared_ptr<Frame>>> m_input;
+          std::deque<Task> m_tasks;
+          std::map<uint64_t, boost::shared_ptr<Frame>> m_output;
+          uint64_t m_pushed;
+          uint64_t m_popped;
+          // the number of frames that were passed to the worker threads, but are not finished yet
+          int m_processing;
+          bool m_closed;
+          // has the first stage passed all frames to the worker threads?
+          bool m_prepared;
+
+          mutable std::mutex m_mutex;
+          std::condition_variable m_input_available;
+          std::condition_variable m_tasks_available;
+          std::condition_variable m_processing_finished;
+          std::condition_variable m_output_available;
+          std::condition_variable m_space_available;
+
+      }; // class TransformStream
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_TRANSFORM_STREAM_H
@@ -35,6 +35,19 @@ namespace bob {
             const double epsilon = 1e-10
           );
 
+          //! \brief Restores a Gabor wavelet of the given parametrization from its runs (y, x, length) of non-zero pixels and the values of all pixels, see runs() and values().
+          //! This is used to transfer already generated Gabor wavelets, e.g., between processes
+          Wavelet(
+            const blitz::TinyVector<int,2>& resolution,
+            const blitz::TinyVector<double,2>& wavelet_frequency,
+            const double sigma,
+            const double pow_of_k,
+            const bool dc_free,
+            const double epsilon,
+            const blitz::Array<int,2>& runs,
+            const blitz::Array<double,1>& values
+          );
+
           //! Copy constructor
           Wavelet(const Wavelet& other);
 
@@ -46,6 +59,19 @@ namespace bob {
           //! Get the image represenation of the Gabor wavelet in frequency domain
           blitz::Array<double,2> waveletImage() const;
 
+          //! Returns the runs (y, x, length) of consecutive non-zero pixels of the Gabor wavelet
+          blitz::Array<int,2> runs() const;
+
+          //! Returns the values of the non-zero pixels of the Gabor wavelet, in the order of the runs
+          blitz::Array<double,1> values() const;
+
+          //! The parametrization that this Gabor wavelet was generated with
+          const blitz::TinyVector<double,2>& frequency() const {return m_frequency;}
+          double sigma() const {return m_sigma;}
+          double powOfK() const {return m_pow_of_k;}
+          bool dcFree() const {return m_dc_free;}
+          double epsilon() const {return m_epsilon;}
+
           //! Gabor transforms the given image
           void transform(
             const blitz::Array<std::complex<double>,2>& frequency_domain_image,
@@ -53,8 +79,14 @@ namespace bob {
           ) const;
 
         private:
-          // the Gabor wavelet, stored as pairs of indices and values
-          std::vector<std::pair<blitz::TinyVector<int,2>, double> > m_wavelet_pixel;
+          // the Gabor wavelet, stored as runs (y, x, length) of consecutive non-zero pixels in one row, and the values of all pixels
+          std::vector<blitz::TinyVector<int,3> > m_runs;
+          std::vector<double> m_values;
+
+          // the parametrization of the Gabor wavelet
+          blitz::TinyVector<double,2> m_frequency;
+          double m_sigma, m_pow_of_k, m_epsilon;
+          bool m_dc_free;
 
         public:
           // the resolution of the current Gabor wavelet
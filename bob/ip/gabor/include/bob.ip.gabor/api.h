@@ -22,6 +22,11 @@
 #include <bob.ip.gabor/Similarity.h>
 #include <bob.ip.gabor/Graph.h>
 #include <bob.ip.gabor/JetStatistics.h>
+#include <bob.ip.gabor/TransformStream.h>
+#include <bob.ip.gabor/Spectrum.h>
+#include <bob.ip.gabor/FeatureExtractor.h>
+#include <bob.ip.gabor/Index.h>
+#include <bob.ip.gabor/PhaseCode.h>
 
 #include <boost/shared_ptr.hpp>
 
@@ -50,6 +55,21 @@ enum _PyBobIpGabor_ENUM{
   // Bindings for bob.ip.gabor.JetStatistics
   PyBobIpGaborJetStatistics_Type_NUM,
   PyBobIpGaborJetStatistics_Check_NUM,
+  // Bindings for bob.ip.gabor.TransformStream
+  PyBobIpGaborTransformStream_Type_NUM,
+  PyBobIpGaborTransformStream_Check_NUM,
+  // Bindings for bob.ip.gabor.Spectrum
+  PyBobIpGaborSpectrum_Type_NUM,
+  PyBobIpGaborSpectrum_Check_NUM,
+  // Bindings for bob.ip.gabor.FeatureExtractor
+  PyBobIpGaborFeatureExtractor_Type_NUM,
+  PyBobIpGaborFeatureExtractor_Check_NUM,
+  // Bindings for bob.ip.gabor.Index
+  PyBobIpGaborIndex_Type_NUM,
+  PyBobIpGaborIndex_Check_NUM,
+  // Bindings for bob.ip.gabor.PhaseCode
+  PyBobIpGaborPhaseCode_Type_NUM,
+  PyBobIpGaborPhaseCode_Check_NUM,
   // Total number of C API pointers
   PyBobIpGabor_API_pointers
 };
@@ -66,6 +86,8 @@ typedef struct {
 typedef struct {
   PyObject_HEAD
   boost::shared_ptr<bob::ip::gabor::Transform> cxx;
+  // shall the generated wavelets be pickled, see bob/ip/gabor/pickling.py
+  bool pickle_wavelets;
 } PyBobIpGaborTransformObject;
 
 // Gabor jet
@@ -94,6 +116,36 @@ typedef struct {
   boost::shared_ptr<bob::ip::gabor::JetStatistics> cxx;
 } PyBobIpGaborJetStatisticsObject;
 
+// Asynchronous Gabor wavelet transform of streams
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::TransformStream> cxx;
+} PyBobIpGaborTransformStreamObject;
+
+// Spectrum of an image
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::Spectrum> cxx;
+} PyBobIpGaborSpectrumObject;
+
+// Pooled Gabor feature extractor
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::FeatureExtractor> cxx;
+} PyBobIpGaborFeatureExtractorObject;
+
+// Approximate nearest neighbor index of Gabor graphs
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::Index> cxx;
+} PyBobIpGaborIndexObject;
+
+// Binary phase codes of Gabor jets
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::PhaseCode> cxx;
+} PyBobIpGaborPhaseCodeObject;
+
 
 #ifdef BOB_IP_GABOR_MODULE
 
@@ -115,6 +167,11 @@ typedef struct {
   extern PyTypeObject PyBobIpGaborSimilarity_Type;
   extern PyTypeObject PyBobIpGaborGraph_Type;
   extern PyTypeObject PyBobIpGaborJetStatistics_Type;
+  extern PyTypeObject PyBobIpGaborTransformStream_Type;
+  extern PyTypeObject PyBobIpGaborSpectrum_Type;
+  extern PyTypeObject PyBobIpGaborFeatureExtractor_Type;
+  extern PyTypeObject PyBobIpGaborIndex_Type;
+  extern PyTypeObject PyBobIpGaborPhaseCode_Type;
 
   /*******************
    * Check functions *
@@ -126,6 +183,11 @@ typedef struct {
   int PyBobIpGaborSimilarity_Check(PyObject* o);
   int PyBobIpGaborGraph_Check(PyObject* o);
   int PyBobIpGaborJetStatistics_Check(PyObject* o);
+  int PyBobIpGaborTransformStream_Check(PyObject* o);
+  int PyBobIpGaborSpectrum_Check(PyObject* o);
+  int PyBobIpGaborFeatureExtractor_Check(PyObject* o);
+  int PyBobIpGaborIndex_Check(PyObject* o);
+  int PyBobIpGaborPhaseCode_Check(PyObject* o);
 
 #else
 
@@ -158,6 +220,11 @@ typedef struct {
 #define PyBobIpGaborSimilarity_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborSimilarity_Type_NUM])
 #define PyBobIpGaborTransform_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborTransform_Type_NUM])
 #define PyBobIpGaborJetStatistics_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborJetStatistics_Type_NUM])
+#define PyBobIpGaborTransformStream_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborTransformStream_Type_NUM])
+#define PyBobIpGaborSpectrum_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborSpectrum_Type_NUM])
+#define PyBobIpGaborFeatureExtractor_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborFeatureExtractor_Type_NUM])
+#define PyBobIpGaborIndex_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborIndex_Type_NUM])
+#define PyBobIpGaborPhaseCode_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborPhaseCode_Type_NUM])
 
 
   /*******************
@@ -169,6 +236,11 @@ typedef struct {
 #define PyBobIpGaPyBobIpGaborSimilarity_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborSimilarity_Check_NUM])
 #define PyBobIpGaborGraph_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborGraph_Check_NUM])
 #define PyBobIpGaborJetStatistics_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborJetStatistics_Check_NUM])
+#define PyBobIpGaborTransformStream_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborTransformStream_Check_NUM])
+#define PyBobIpGaborSpectrum_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborSpectrum_Check_NUM])
+#define PyBobIpGaborFeatureExtractor_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborFeatureExtractor_Check_NUM])
+#define PyBobIpGaborIndex_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborIndex_Check_NUM])
+#define PyBobIpGaborPhaseCode_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborPhaseCode_Check_NUM])
 
 
 # if !defined(NO_IMPORT_ARRAY)
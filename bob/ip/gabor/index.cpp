@@ -0,0 +1,575 @@
+/**
+ * @brief Bindings for the approximate nearest neighbor index of Gabor graphs
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.io.base/api.h>
+#include <bob.extension/documentation.h>
+
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto Index_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".Index",
+  "An approximate nearest neighbor index of Gabor graphs",
+  "The index stores the feature vectors of Gabor graphs, see :py:meth:`features`, in an inverted file with product quantized residuals. "
+  "Each feature vector is assigned to the closest of :py:attr:`number_of_lists` coarse centroids, and its residual is split into :py:attr:`number_of_subquantizers` parts, "
+  "each of which is quantized with :py:attr:`number_of_centroids` centroids, so that each graph is stored with :py:attr:`number_of_subquantizers` bytes. "
+  "Before graphs can be added, the index needs to be trained with :py:meth:`train`.\n\n"
+  "A :py:meth:`search` visits only the ``probes`` closest lists; the more lists are visited, the higher is the recall and the longer takes the search. "
+  "With :py:meth:`rerank`, the shortlisted graphs are re-ranked with the exact :py:meth:`bob.ip.gabor.Similarity.search`.\n\n"
+  ".. note::\n\n  For Gabor jets normalized to unit length, the Euclidean distance between feature vectors is equivalent to the ``'ScalarProduct'`` similarity of the graphs."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an untrained index, or reads an index from file",
+    0,
+    true
+  )
+  .add_prototype("dimension, number_of_lists, number_of_subquantizers, [number_of_centroids]", "")
+  .add_prototype("hdf5", "")
+  .add_parameter("dimension", "int", "The dimension of the feature vectors, i.e., the number of nodes times the number of wavelets")
+  .add_parameter("number_of_lists", "int", "The number of coarse centroids, i.e., of inverted lists")
+  .add_parameter("number_of_subquantizers", "int", "The number of parts, into which the residuals are split; ``dimension`` must be divisible by it")
+  .add_parameter("number_of_centroids", "int", "[default: 256] The number of centroids of each sub-quantizer; must be in [1, 256]")
+  .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading to load the index, including the stored graphs, from")
+);
+
+static int PyBobIpGaborIndex_init(PyBobIpGaborIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist1 = Index_doc.kwlist(1);
+  char** kwlist2 = Index_doc.kwlist(0);
+
+  // two ways to call
+  PyObject* k = Py_BuildValue("s", kwlist1[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) == 1 && PyBobIoHDF5File_Check(PyTuple_GetItem(args, 0)))
+  ){
+    PyBobIoHDF5FileObject* hdf5;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist1, &PyBobIoHDF5File_Converter, &hdf5)) return -1;
+
+    auto hdf5_ = make_safe(hdf5);
+    self->cxx.reset(new bob::ip::gabor::Index(*hdf5->f));
+  } else {
+    int dimension, lists, subquantizers, centroids = 256;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iii|i", kwlist2, &dimension, &lists, &subquantizers, &centroids)) return -1;
+    self->cxx.reset(new bob::ip::gabor::Index(dimension, lists, subquantizers, centroids));
+  }
+  return 0;
+BOB_CATCH_MEMBER("Index constructor", -1)
+}
+
+static void PyBobIpGaborIndex_delete(PyBobIpGaborIndexObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborIndex_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborIndex_Type));
+}
+
+Py_ssize_t PyBobIpGaborIndex_len(PyObject* self){
+  return reinterpret_cast<PyBobIpGaborIndexObject*>(self)->cxx->size();
+}
+
+static PySequenceMethods PyBobIpGaborIndex_sequence_methods = {
+  PyBobIpGaborIndex_len,                /* sq_length */
+  0                                     /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto dimension_doc = bob::extension::VariableDoc(
+  "dimension",
+  "int",
+  "The dimension of the feature vectors"
+);
+PyObject* PyBobIpGaborIndex_dimension(PyBobIpGaborIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->dimension());
+BOB_CATCH_MEMBER("dimension", 0)
+}
+
+static auto numberOfLists_doc = bob::extension::VariableDoc(
+  "number_of_lists",
+  "int",
+  "The number of coarse centroids, i.e., of inverted lists"
+);
+PyObject* PyBobIpGaborIndex_numberOfLists(PyBobIpGaborIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfLists());
+BOB_CATCH_MEMBER("number_of_lists", 0)
+}
+
+static auto numberOfSubquantizers_doc = bob::extension::VariableDoc(
+  "number_of_subquantizers",
+  "int",
+  "The number of parts, into which the residuals are split, i.e., the number of bytes stored per graph"
+);
+PyObject* PyBobIpGaborIndex_numberOfSubquantizers(PyBobIpGaborIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfSubquantizers());
+BOB_CATCH_MEMBER("number_of_subquantizers", 0)
+}
+
+static auto numberOfCentroids_doc = bob::extension::VariableDoc(
+  "number_of_centroids",
+  "int",
+  "The number of centroids of each sub-quantizer"
+);
+PyObject* PyBobIpGaborIndex_numberOfCentroids(PyBobIpGaborIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfCentroids());
+BOB_CATCH_MEMBER("number_of_centroids", 0)
+}
+
+static auto isTrained_doc = bob::extension::VariableDoc(
+  "is_trained",
+  "bool",
+  "Has the index been trained?"
+);
+PyObject* PyBobIpGaborIndex_isTrained(PyBobIpGaborIndexObject* self, void*){
+BOB_TRY
+  if (self->cxx->isTrained()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+BOB_CATCH_MEMBER("is_trained", 0)
+}
+
+static PyGetSetDef PyBobIpGaborIndex_getseters[] = {
+  {
+    dimension_doc.name(),
+    (getter)PyBobIpGaborIndex_dimension,
+    0,
+    dimension_doc.doc(),
+    0
+  },
+  {
+    numberOfLists_doc.name(),
+    (getter)PyBobIpGaborIndex_numberOfLists,
+    0,
+    numberOfLists_doc.doc(),
+    0
+  },
+  {
+    numberOfSubquantizers_doc.name(),
+    (getter)PyBobIpGaborIndex_numberOfSubquantizers,
+    0,
+    numberOfSubquantizers_doc.doc(),
+    0
+  },
+  {
+    numberOfCentroids_doc.name(),
+    (getter)PyBobIpGaborIndex_numberOfCentroids,
+    0,
+    numberOfCentroids_doc.doc(),
+    0
+  },
+  {
+    isTrained_doc.name(),
+    (getter)PyBobIpGaborIndex_isTrained,
+    0,
+    isTrained_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto features_doc = bob::extension::FunctionDoc(
+  "features",
+  "Computes the feature vectors of the given graphs",
+  "The feature vector of a graph is the concatenation of the absolute values of its Gabor jets. "
+  "The graphs are stored in arrays as returned by :py:meth:`bob.ip.gabor.Graph.extract_batch`.",
+  true
+)
+.add_prototype("graphs", "features")
+.add_parameter("graphs", "array_like (float, 3D or 4D)", "The Gabor jets of one graph, of shape ``(nodes, 2, number_of_wavelets)``, or of several graphs, of shape ``(N, nodes, 2, number_of_wavelets)``")
+.add_return("features", "array_like (float, 1D or 2D)", "The feature vector of the graph, of shape ``(nodes * number_of_wavelets,)``, or of the graphs, of shape ``(N, nodes * number_of_wavelets)``")
+;
+
+static PyObject* PyBobIpGaborIndex_features(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = features_doc.kwlist();
+
+  PyBlitzArrayObject* graphs;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBlitzArray_Converter, &graphs)) return 0;
+  auto graphs_ = make_safe(graphs);
+
+  if ((graphs->ndim != 3 && graphs->ndim != 4) || graphs->type_num != NPY_FLOAT64) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 3- or 4-dimensional arrays of type float for `graphs`", Index_doc.name());
+    return 0;
+  }
+
+  PyBlitzArrayObject* features;
+  if (graphs->ndim == 3){
+    Py_ssize_t size[] = {graphs->shape[0] * graphs->shape[2]};
+    features = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, size);
+  } else {
+    Py_ssize_t size[] = {graphs->shape[0], graphs->shape[1] * graphs->shape[3]};
+    features = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, size);
+  }
+  auto features_ = make_safe(features);
+
+  if (graphs->ndim == 3)
+    bob::ip::gabor::Index::features(*PyBlitzArrayCxx_AsBlitz<double,3>(graphs), *PyBlitzArrayCxx_AsBlitz<double,1>(features));
+  else
+    bob::ip::gabor::Index::features(*PyBlitzArrayCxx_AsBlitz<double,4>(graphs), *PyBlitzArrayCxx_AsBlitz<double,2>(features));
+  return PyBlitzArray_AsNumpyArray(features, 0);
+BOB_CATCH_FUNCTION("features", 0)
+}
+
+
+// converts the given features to a 2D float array
+static PyBlitzArrayObject* feature_array(PyObject* self, PyObject* object){
+  PyBlitzArrayObject* features = 0;
+  if (!PyBlitzArray_Converter(object, &features)) return 0;
+  if (features->ndim != 2 || features->type_num != NPY_FLOAT64) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays of type float for `features`", Py_TYPE(self)->tp_name);
+    Py_DECREF(features);
+    return 0;
+  }
+  return features;
+}
+
+static auto train_doc = bob::extension::FunctionDoc(
+  "train",
+  "Trains the coarse centroids and the sub-quantizers with k-means",
+  "All graphs stored in the index are removed. "
+  "At least :py:attr:`number_of_lists` and :py:attr:`number_of_centroids` training feature vectors are required.",
+  true
+)
+.add_prototype("features, [iterations], [seed]")
+.add_parameter("features", "array_like (float, 2D)", "The training feature vectors, see :py:meth:`features`")
+.add_parameter("iterations", "int", "[default: 20] The maximum number of k-means iterations")
+.add_parameter("seed", "int", "[default: 0] The seed of the random initialization of the k-means clustering")
+;
+
+static PyObject* PyBobIpGaborIndex_train(PyBobIpGaborIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = train_doc.kwlist();
+
+  PyObject* object;
+  int iterations = 20;
+  unsigned int seed = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|iI", kwlist, &object, &iterations, &seed)) return 0;
+
+  PyBlitzArrayObject* features = feature_array((PyObject*)self, object);
+  if (!features) return 0;
+  auto features_ = make_safe(features);
+
+  // the GIL is kept, so that the index is not searched by other threads meanwhile
+  self->cxx->train(*PyBlitzArrayCxx_AsBlitz<double,2>(features), iterations, seed);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("train", 0)
+}
+
+
+static auto add_doc = bob::extension::FunctionDoc(
+  "add",
+  "Adds the given feature vectors to the trained index",
+  "The identifiers of the new graphs continue from ``len(index)``.",
+  true
+)
+.add_prototype("features")
+.add_parameter("features", "array_like (float, 2D)", "The feature vectors of the graphs, see :py:meth:`features`")
+;
+
+static PyObject* PyBobIpGaborIndex_add(PyBobIpGaborIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = add_doc.kwlist();
+
+  PyObject* object;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &object)) return 0;
+
+  PyBlitzArrayObject* features = feature_array((PyObject*)self, object);
+  if (!features) return 0;
+  auto features_ = make_safe(features);
+
+  // the GIL is kept, so that the index is not searched by other threads meanwhile
+  self->cxx->add(*PyBlitzArrayCxx_AsBlitz<double,2>(features));
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("add", 0)
+}
+
+
+static auto search_doc = bob::extension::FunctionDoc(
+  "search",
+  "Finds the ``k`` graphs with the smallest approximate Euclidean distances to the given feature vector",
+  "Only the graphs in the ``probes`` lists with the closest coarse centroids are considered. "
+  "If less than ``k`` graphs are found, the remaining ``ids`` are -1 and the ``distances`` are infinite.",
+  true
+)
+.add_prototype("query, k, [probes]", "ids, distances")
+.add_parameter("query", "array_like (float, 1D)", "The feature vector of the query graph, see :py:meth:`features`")
+.add_parameter("k", "int", "The number of graphs to return")
+.add_parameter("probes", "int", "[default: 1] The number of lists that are visited")
+.add_return("ids", "array_like (int32, 1D)", "The identifiers of the closest graphs, ordered by ascending distance")
+.add_return("distances", "array_like (float, 1D)", "The approximate squared Euclidean distances of the closest graphs")
+;
+
+static PyObject* PyBobIpGaborIndex_search(PyBobIpGaborIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = search_doc.kwlist();
+
+  PyBlitzArrayObject* query;
+  int k, probes = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&i|i", kwlist, &PyBlitzArray_Converter, &query, &k, &probes)) return 0;
+  auto query_ = make_safe(query);
+
+  if (query->ndim != 1 || query->type_num != NPY_FLOAT64) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 1-dimensional arrays of type float for `query`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (k < 0) {
+    PyErr_Format(PyExc_ValueError, "`%s' requires a non-negative `k`, but got %d", Py_TYPE(self)->tp_name, k);
+    return 0;
+  }
+
+  Py_ssize_t osize[] = {k};
+  PyBlitzArrayObject* ids = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_INT32, 1, osize);
+  auto ids_ = make_safe(ids);
+  PyBlitzArrayObject* distances = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+  auto distances_ = make_safe(distances);
+
+  self->cxx->search(*PyBlitzArrayCxx_AsBlitz<double,1>(query), probes, *PyBlitzArrayCxx_AsBlitz<int32_t,1>(ids), *PyBlitzArrayCxx_AsBlitz<double,1>(distances));
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(ids, 0), PyBlitzArray_AsNumpyArray(distances, 0));
+BOB_CATCH_MEMBER("search", 0)
+}
+
+
+static auto rerank_doc = bob::extension::FunctionDoc(
+  "rerank",
+  "Finds the ``k`` graphs that are most similar to the given probe graph",
+  "First, the ``shortlist`` graphs closest to the probe graph are found with :py:meth:`search`. "
+  "Afterward, these graphs are re-ranked with :py:meth:`bob.ip.gabor.Similarity.search`, which expects the Gabor jets to be normalized to unit length. "
+  "If less than ``k`` graphs are shortlisted, the remaining ``ids`` are -1 and the ``scores`` are NaN.\n\n"
+  "Only the shortlisted graphs are required, so the ``gallery`` can also be a function that loads the graph with the given identifier, e.g., from disk. "
+  "When all lists are visited and all graphs are shortlisted, the results are identical to :py:meth:`bob.ip.gabor.Similarity.search`.",
+  true
+)
+.add_prototype("similarity, probe, gallery, k, [probes], [shortlist]", "ids, scores")
+.add_parameter("similarity", ":py:class:`bob.ip.gabor.Similarity`", "The similarity function used to re-rank the shortlisted graphs")
+.add_parameter("probe", "array_like (float, 3D)", "The Gabor jets of the probe graph, of shape ``(nodes, 2, number_of_wavelets)``")
+.add_parameter("gallery", "array_like (float, 4D) or callable", "The Gabor jets of all graphs stored in the index, in the order of their identifiers, of shape ``(len(index), nodes, 2, number_of_wavelets)``; or a function ``gallery(id)`` that returns the Gabor jets of the graph with the given identifier, of the shape of ``probe``")
+.add_parameter("k", "int", "The number of graphs to return")
+.add_parameter("probes", "int", "[default: 1] The number of lists that are visited")
+.add_parameter("shortlist", "int", "[default: ``10 * k``] The number of graphs that are re-ranked; must not be smaller than ``k``")
+.add_return("ids", "array_like (int32, 1D)", "The identifiers of the most similar graphs, ordered by descending score")
+.add_return("scores", "array_like (float, 1D)", "The scores of the most similar graphs")
+;
+
+// thrown by the gallery loader when a Python exception has been set
+struct PythonError {};
+
+static PyObject* PyBobIpGaborIndex_rerank(PyBobIpGaborIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = rerank_doc.kwlist();
+
+  PyBobIpGaborSimilarityObject* similarity;
+  PyBlitzArrayObject* probe;
+  PyObject* gallery;
+  int k, probes = 1, shortlist = -1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&Oi|ii", kwlist, &PyBobIpGaborSimilarity_Type, &similarity, &PyBlitzArray_Converter, &probe, &gallery, &k, &probes, &shortlist)) return 0;
+  auto probe_ = make_safe(probe);
+
+  if (probe->ndim != 3 || probe->type_num != NPY_FLOAT64) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 3-dimensional arrays of type float for `probe`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (k < 0) {
+    PyErr_Format(PyExc_ValueError, "`%s' requires a non-negative `k`, but got %d", Py_TYPE(self)->tp_name, k);
+    return 0;
+  }
+  if (shortlist < 0) shortlist = 10 * k;
+
+  Py_ssize_t osize[] = {k};
+  PyBlitzArrayObject* ids = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_INT32, 1, osize);
+  auto ids_ = make_safe(ids);
+  PyBlitzArrayObject* scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+  auto scores_ = make_safe(scores);
+
+  // the GIL is kept during the search, since the similarity function uses internal buffers for some similarity types
+  const blitz::Array<double,3>& probe_graph = *PyBlitzArrayCxx_AsBlitz<double,3>(probe);
+  if (PyCallable_Check(gallery)){
+    const char* name = Py_TYPE(self)->tp_name;
+    try {
+      self->cxx->search(*similarity->cxx, probe_graph, bob::ip::gabor::Index::GraphLoader(
+        [gallery, name](int id, blitz::Array<double,3>& graph){
+          PyObject* result = PyObject_CallFunction(gallery, "i", id);
+          if (!result) throw PythonError();
+          auto result_ = make_safe(result);
+          PyBlitzArrayObject* array;
+          if (!PyBlitzArray_Converter(result, &array)) throw PythonError();
+          auto array_ = make_safe(array);
+          if (array->ndim != 3 || array->type_num != NPY_FLOAT64 || array->shape[0] != graph.extent(0) || array->shape[1] != graph.extent(1) || array->shape[2] != graph.extent(2)) {
+            PyErr_Format(PyExc_RuntimeError, "`%s' requires the `gallery` function to return arrays of type float of shape (%d, %d, %d)", name, graph.extent(0), graph.extent(1), graph.extent(2));
+            throw PythonError();
+          }
+          graph = *PyBlitzArrayCxx_AsBlitz<double,3>(array);
+        }
+      ), probes, shortlist, *PyBlitzArrayCxx_AsBlitz<int32_t,1>(ids), *PyBlitzArrayCxx_AsBlitz<double,1>(scores));
+    } catch (PythonError&){
+      // the error was already set by the gallery function
+      return 0;
+    }
+  } else {
+    PyBlitzArrayObject* graphs;
+    if (!PyBlitzArray_Converter(gallery, &graphs)) return 0;
+    auto graphs_ = make_safe(graphs);
+    if (graphs->ndim != 4 || graphs->type_num != NPY_FLOAT64) {
+      PyErr_Format(PyExc_TypeError, "`%s' only accepts 4-dimensional arrays of type float or callables for `gallery`", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    self->cxx->search(*similarity->cxx, probe_graph, *PyBlitzArrayCxx_AsBlitz<double,4>(graphs), probes, shortlist, *PyBlitzArrayCxx_AsBlitz<int32_t,1>(ids), *PyBlitzArrayCxx_AsBlitz<double,1>(scores));
+  }
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(ids, 0), PyBlitzArray_AsNumpyArray(scores, 0));
+BOB_CATCH_MEMBER("rerank", 0)
+}
+
+
+static auto load_doc = bob::extension::FunctionDoc(
+  "load",
+  "Loads the index, including the stored graphs, from the given HDF5 file",
+  0,
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file opened for reading")
+;
+
+static PyObject* PyBobIpGaborIndex_load(PyBobIpGaborIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  // get list of arguments
+  char** kwlist = load_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->load(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("load", 0)
+}
+
+
+static auto save_doc = bob::extension::FunctionDoc(
+  "save",
+  "Saves the index, including the stored graphs, to the given HDF5 file",
+  0,
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing")
+;
+
+static PyObject* PyBobIpGaborIndex_save(PyBobIpGaborIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  // get list of arguments
+  char** kwlist = save_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->save(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("save", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborIndex_methods[] = {
+  {
+    features_doc.name(),
+    (PyCFunction)PyBobIpGaborIndex_features,
+    METH_VARARGS|METH_KEYWORDS|METH_STATIC,
+    features_doc.doc()
+  },
+  {
+    train_doc.name(),
+    (PyCFunction)PyBobIpGaborIndex_train,
+    METH_VARARGS|METH_KEYWORDS,
+    train_doc.doc()
+  },
+  {
+    add_doc.name(),
+    (PyCFunction)PyBobIpGaborIndex_add,
+    METH_VARARGS|METH_KEYWORDS,
+    add_doc.doc()
+  },
+  {
+    search_doc.name(),
+    (PyCFunction)PyBobIpGaborIndex_search,
+    METH_VARARGS|METH_KEYWORDS,
+    search_doc.doc()
+  },
+  {
+    rerank_doc.name(),
+    (PyCFunction)PyBobIpGaborIndex_rerank,
+    METH_VARARGS|METH_KEYWORDS,
+    rerank_doc.doc()
+  },
+  {
+    load_doc.name(),
+    (PyCFunction)PyBobIpGaborIndex_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load_doc.doc()
+  },
+  {
+    save_doc.name(),
+    (PyCFunction)PyBobIpGaborIndex_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the Index type struct; will be initialized later
+PyTypeObject PyBobIpGaborIndex_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpGaborIndex(PyObject* module)
+{
+
+  // initialize the Index type struct
+  PyBobIpGaborIndex_Type.tp_name = Index_doc.name();
+  PyBobIpGaborIndex_Type.tp_basicsize = sizeof(PyBobIpGaborIndexObject);
+  PyBobIpGaborIndex_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborIndex_Type.tp_doc = Index_doc.doc();
+
+  // set the functions
+  PyBobIpGaborIndex_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborIndex_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborIndex_init);
+  PyBobIpGaborIndex_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborIndex_delete);
+  PyBobIpGaborIndex_Type.tp_as_sequence = &PyBobIpGaborIndex_sequence_methods;
+  PyBobIpGaborIndex_Type.tp_methods = PyBobIpGaborIndex_methods;
+  PyBobIpGaborIndex_Type.tp_getset = PyBobIpGaborIndex_getseters;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborIndex_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborIndex_Type);
+  return PyModule_AddObject(module, "Index", (PyObject*)&PyBobIpGaborIndex_Type) >= 0;
+}
@@ -13,6 +13,7 @@
 #include <bob.blitz/cppapi.h>
 #include <bob.blitz/cleanup.h>
 #include <bob.io.base/api.h>
+#include <bob.core/check.h>
 #include <bob.extension/documentation.h>
 
 
@@ -31,7 +32,9 @@ static auto Jet_doc = bob::extension::ClassDoc(
   "A Gabor jet contains the responses of all Gabor wavelets of the Gabor wavelet family at a certain position in the image",
   "The Gabor jet represents the local texture at a certain offset point of an image that it was extracted from. "
   "Commonly, the complex-valued Gabor jet is stored as a vector of absolute values and a vector of phase values. "
-  "Also, usually the Gabor jet is normalized to unit Euclidean length."
+  "Also, usually the Gabor jet is normalized to unit Euclidean length.\n\n"
+  "The Gabor jet exports its storage of shape ``(2, length)`` through the buffer protocol, i.e., ``numpy.asarray(jet)`` returns a writable view without copying the data. "
+  "Use :py:meth:`adopt` to create a Gabor jet that uses the memory of an existing array."
 ).add_constructor(
   bob::extension::FunctionDoc(
     "__init__",
@@ -393,6 +396,51 @@ static PySequenceMethods PyBobIpGaborJet_sequence_methods = {
   0                                     /* Sentinel */
 };
 
+// The exported buffer keeps a reference to the memory of the Gabor jet,
+// so that the memory stays valid even when the Gabor jet is re-allocated or deleted
+struct JetBuffer {
+  blitz::Array<double,2> jet;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+};
+
+static int PyBobIpGaborJet_getbuffer(PyBobIpGaborJetObject* self, Py_buffer* view, int flags){
+BOB_TRY
+  const blitz::Array<double,2>& jet = self->cxx->jet();
+  if (!bob::core::array::isCZeroBaseContiguous(jet)){
+    view->obj = 0;
+    PyErr_Format(PyExc_BufferError, "`%s' cannot export a non-contiguous Gabor jet", Py_TYPE(self)->tp_name);
+    return -1;
+  }
+  JetBuffer* buffer = new JetBuffer;
+  buffer->jet.reference(jet);
+  buffer->shape[0] = jet.extent(0);
+  buffer->shape[1] = jet.extent(1);
+  buffer->strides[0] = jet.extent(1) * sizeof(double);
+  buffer->strides[1] = sizeof(double);
+
+  view->buf = buffer->jet.data();
+  view->obj = reinterpret_cast<PyObject*>(self);
+  Py_INCREF(self);
+  view->len = jet.size() * sizeof(double);
+  view->readonly = 0;
+  view->itemsize = sizeof(double);
+  view->format = (flags & PyBUF_FORMAT) ? c("d") : 0;
+  view->ndim = 2;
+  view->shape = buffer->shape;
+  view->strides = buffer->strides;
+  view->suboffsets = 0;
+  view->internal = buffer;
+  return 0;
+BOB_CATCH_MEMBER("buffer", -1)
+}
+
+static void PyBobIpGaborJet_releasebuffer(PyBobIpGaborJetObject*, Py_buffer* view){
+  delete reinterpret_cast<JetBuffer*>(view->internal);
+}
+
+static PyBufferProcs PyBobIpGaborJet_buffer_procs;
+
 
 /******************************************************************/
 /************ Functions Section ***********************************/
@@ -525,7 +573,65 @@ BOB_CATCH_MEMBER("save", 0)
 }
 
 
+static auto adopt_doc = bob::extension::FunctionDoc(
+  "adopt",
+  "Creates a Gabor jet that uses the memory of the given array, without copying it",
+  "The array must be a C-contiguous and writable ``numpy.ndarray`` of 64-bit floats and shape ``(2, length)``, with the absolute values in the first and the phases in the second row. "
+  "The Gabor jet keeps a reference to the array, and all modifications of the array are visible in the Gabor jet, and vice versa; "
+  "particularly, :py:meth:`extract` and :py:meth:`init` with the same length write their results directly into the array.\n\n"
+  "Together with the buffer protocol, e.g., ``numpy.asarray(jet)``, which provides a writable view of the Gabor jet without copying, this allows to process many Gabor jets stored in one large array.",
+  true
+)
+.add_prototype("array", "jet")
+.add_parameter("array", "array_like (float, 2D)", "The array with shape ``(2, length)`` that should be used as storage")
+.add_return("jet", ":py:class:`bob.ip.gabor.Jet`", "The Gabor jet that refers to the given ``array``")
+;
+
+// deletes the Gabor jet and releases the reference to the array whose memory it adopted
+struct ReleaseArray {
+  PyObject* array;
+  void operator()(bob::ip::gabor::Jet* jet){
+    delete jet;
+    PyGILState_STATE state = PyGILState_Ensure();
+    Py_DECREF(array);
+    PyGILState_Release(state);
+  }
+};
+
+static PyObject* PyBobIpGaborJet_adopt(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = adopt_doc.kwlist();
+  PyObject* array;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyArray_Type, &array)) return 0;
+
+  PyArrayObject* a = reinterpret_cast<PyArrayObject*>(array);
+  if (PyArray_TYPE(a) != NPY_FLOAT64 || PyArray_NDIM(a) != 2 || PyArray_DIM(a, 0) != 2){
+    PyErr_Format(PyExc_TypeError, "`%s' can only adopt 64-bit float arrays of shape (2, length)", type->tp_name);
+    return 0;
+  }
+  if (!PyArray_IS_C_CONTIGUOUS(a) || !PyArray_ISALIGNED(a) || !PyArray_ISWRITEABLE(a)){
+    PyErr_Format(PyExc_ValueError, "`%s' can only adopt C-contiguous, aligned and writable arrays", type->tp_name);
+    return 0;
+  }
+
+  blitz::Array<double,2> data(static_cast<double*>(PyArray_DATA(a)), blitz::shape(2, PyArray_DIM(a, 1)), blitz::neverDeleteData);
+  PyBobIpGaborJetObject* jet = reinterpret_cast<PyBobIpGaborJetObject*>(type->tp_alloc(type, 0));
+  if (!jet) return 0;
+  auto jet_ = make_safe(jet);
+  Py_INCREF(array);
+  jet->cxx.reset(new bob::ip::gabor::Jet(0), ReleaseArray{array});
+  jet->cxx->adopt(data);
+  return Py_BuildValue("O", jet);
+BOB_CATCH_FUNCTION("adopt", 0)
+}
+
 static PyMethodDef PyBobIpGaborJet_methods[] = {
+  {
+    adopt_doc.name(),
+    (PyCFunction)PyBobIpGaborJet_adopt,
+    METH_VARARGS|METH_KEYWORDS|METH_CLASS,
+    adopt_doc.doc()
+  },
   {
     normalize_doc.name(),
     (PyCFunction)PyBobIpGaborJet_normalize,
@@ -587,6 +693,14 @@ bool init_BobIpGaborJet(PyObject* module)
   PyBobIpGaborJet_Type.tp_getset = PyBobIpGaborJet_getseters;
   PyBobIpGaborJet_Type.tp_as_sequence = &PyBobIpGaborJet_sequence_methods;
 
+  // export the storage of the Gabor jet through the buffer protocol
+  PyBobIpGaborJet_buffer_procs.bf_getbuffer = reinterpret_cast<getbufferproc>(PyBobIpGaborJet_getbuffer);
+  PyBobIpGaborJet_buffer_procs.bf_releasebuffer = reinterpret_cast<releasebufferproc>(PyBobIpGaborJet_releasebuffer);
+  PyBobIpGaborJet_Type.tp_as_buffer = &PyBobIpGaborJet_buffer_procs;
+#if PY_VERSION_HEX < 0x03000000
+  PyBobIpGaborJet_Type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+
   // check that everyting is fine
   if (PyType_Ready(&PyBobIpGaborJet_Type) < 0) return false;
 
@@ -15,6 +15,8 @@
 #include <bob.io.base/api.h>
 #include <bob.extension/documentation.h>
 
+#include "gil.h"
+
 static inline char* c(const char* o){return const_cast<char*>(o);}
 
 #if PY_VERSION_HEX >= 0x03000000
@@ -36,6 +38,7 @@ static auto JetStatistics_doc = bob::extension::ClassDoc(
   "The mean and variance of the absolute values is computed assuming univariate Gaussian distribution of :py:attr:`Jet.abs` from all given Gabor jets. "
   "The mean phase is computed differently, i.e., by computing the average jet (using the according :py:class:`Jet` constructor, while the phase variance is computed by computing the variances of :py:attr:`Jet.phase` to the mean phase. "
   "Finally, the Statistics of a given :py:class:`Jet` can be computed using the :py:meth:`log_likelihood` function. "
+  "The GIL is released in :py:meth:`disparity` and :py:meth:`log_likelihood`, so that several threads can score Gabor jets with the same ``JetStatistics`` at the same time. "
   "More details about the Gabor jet statistics can be found in section 3.3.3 of [Guenther2011]_."
 ).add_constructor(
   bob::extension::FunctionDoc(
@@ -158,12 +161,19 @@ BOB_TRY
 BOB_CATCH_MEMBER("gwt", 0)
 }
 
+// other threads might score with the statistics while the GIL is released, so they are replaced by a copy instead of being modified
+static boost::shared_ptr<bob::ip::gabor::JetStatistics> replaceGwt(const boost::shared_ptr<bob::ip::gabor::JetStatistics>& statistics, boost::shared_ptr<bob::ip::gabor::Transform> gwt){
+  boost::shared_ptr<bob::ip::gabor::JetStatistics> copy(new bob::ip::gabor::JetStatistics(*statistics));
+  copy->gwt(gwt);
+  return copy;
+}
+
 int PyBobIpGaborJetStatistics_setGwt(PyBobIpGaborJetStatisticsObject* self, PyObject* value, void*){
 BOB_TRY
   // check fore None
   if (value == Py_None){
     // reset gwt
-    self->cxx->gwt(boost::shared_ptr<bob::ip::gabor::Transform>());
+    self->cxx = replaceGwt(self->cxx, boost::shared_ptr<bob::ip::gabor::Transform>());
     return 0;
   }
   // check for transform type
@@ -173,7 +183,7 @@ BOB_TRY
   }
   // set transform
   PyBobIpGaborTransformObject* transform = (PyBobIpGaborTransformObject*)value;
-  self->cxx->gwt(transform->cxx);
+  self->cxx = replaceGwt(self->cxx, transform->cxx);
   return 0;
 BOB_CATCH_MEMBER("gwt", -1)
 }
@@ -288,7 +298,14 @@ BOB_TRY
   PyBobIpGaborJetObject* jet;
   if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobIpGaborJet_Type, &jet)) return 0;
 
-  auto disp = self->cxx->disparity(jet->cxx);
+  // the jet is copied, since another thread might modify it while the GIL is released
+  auto statistics = self->cxx;
+  bob::ip::gabor::Jet copy(*jet->cxx);
+  blitz::TinyVector<double,2> disp;
+  {
+    ReleaseGIL gil;
+    disp = statistics->disparity(copy);
+  }
   return Py_BuildValue("dd", disp[0], disp[1]);
 BOB_CATCH_MEMBER("disparity", 0)
 }
@@ -322,7 +339,14 @@ BOB_TRY
 
   if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O(dd)", kwlist, &PyBobIpGaborJet_Type, &jet, &phase, &offset[0], &offset[1])) return 0;
 
-  double score = self->cxx->logLikelihood(jet->cxx, !phase || PyObject_IsTrue(phase), offset);
+  const bool estimate_phase = !phase || PyObject_IsTrue(phase);
+  auto statistics = self->cxx;
+  bob::ip::gabor::Jet copy(*jet->cxx);
+  double score;
+  {
+    ReleaseGIL gil;
+    score = statistics->logLikelihood(copy, estimate_phase, offset);
+  }
   return Py_BuildValue("d", score);
 BOB_CATCH_MEMBER("log_likelihood", 0)
 }
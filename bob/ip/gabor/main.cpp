@@ -16,6 +16,331 @@
 #include <bob.core/api.h>
 #include <bob.io.base/api.h>
 #include <bob.sp/api.h>
+#include <bob.extension/documentation.h>
+
+#include <bob.ip.gabor/FFT.h>
+#include <bob.ip.gabor/Simd.h>
+#include <bob.ip.gabor/Benchmark.h>
+#include <bob.ip.gabor/Stats.h>
+
+
+static auto fftBackends_doc = bob::extension::FunctionDoc(
+  "fft_backends",
+  "Returns the list of FFT backends that are available in this installation",
+  "The backend ``'bob.sp'`` is always available, while ``'fftw'`` is only available when bob.ip.gabor was compiled with FFTW3 support. "
+  "The backend can be selected for each :py:class:`Transform` using :py:attr:`Transform.fft_backend`."
+)
+.add_prototype("", "backends")
+.add_return("backends", "[str]", "The names of the available FFT backends")
+;
+static PyObject* PyBobIpGabor_fftBackends(PyObject*, PyObject*){
+BOB_TRY
+  bob::ip::gabor::FFT::Backend backends[] = {bob::ip::gabor::FFT::BOB_SP, bob::ip::gabor::FFT::FFTW};
+  PyObject* list = PyList_New(0);
+  auto list_ = make_safe(list);
+  for (auto backend : backends){
+    if (bob::ip::gabor::FFT::available(backend)){
+      PyObject* name = Py_BuildValue("s", bob::ip::gabor::FFT::backend_to_name(backend).c_str());
+      auto name_ = make_safe(name);
+      if (PyList_Append(list, name) < 0) return 0;
+    }
+  }
+  return Py_BuildValue("O", list);
+BOB_CATCH_FUNCTION("fft_backends", 0)
+}
+
+static auto loadFFTWisdom_doc = bob::extension::FunctionDoc(
+  "load_fft_wisdom",
+  "Loads the FFTW wisdom from the given file",
+  "The wisdom contains the optimized FFTW plans for all resolutions that were planned when the wisdom was saved using :py:func:`save_fft_wisdom`. "
+  "Loading the wisdom at startup avoids the expensive measurement of the plans. "
+  "Plans are computed only once per resolution and shared between all :py:class:`Transform` objects (and threads) that use the ``'fftw'`` :py:attr:`Transform.fft_backend`."
+)
+.add_prototype("filename")
+.add_parameter("filename", "str", "The name of the wisdom file to read")
+;
+static PyObject* PyBobIpGabor_loadFFTWisdom(PyObject*, PyObject* args, PyObject* kwargs){
+BOB_TRY
+  char** kwlist = loadFFTWisdom_doc.kwlist();
+  const char* filename = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &filename)) return 0;
+  bob::ip::gabor::FFT::loadWisdom(filename);
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("load_fft_wisdom", 0)
+}
+
+static auto saveFFTWisdom_doc = bob::extension::FunctionDoc(
+  "save_fft_wisdom",
+  "Saves the FFTW wisdom of all resolutions that have been planned so far to the given file",
+  "The wisdom can be loaded again using :py:func:`load_fft_wisdom`."
+)
+.add_prototype("filename")
+.add_parameter("filename", "str", "The name of the wisdom file to write")
+;
+static PyObject* PyBobIpGabor_saveFFTWisdom(PyObject*, PyObject* args, PyObject* kwargs){
+BOB_TRY
+  char** kwlist = saveFFTWisdom_doc.kwlist();
+  const char* filename = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &filename)) return 0;
+  bob::ip::gabor::FFT::saveWisdom(filename);
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("save_fft_wisdom", 0)
+}
+
+static auto simdLevels_doc = bob::extension::FunctionDoc(
+  "simd_levels",
+  "Returns the list of SIMD levels that are supported by the current CPU",
+  "The levels are ``'scalar'``, ``'sse2'``, ``'avx2'`` and ``'avx512'``, in increasing order; vectorized kernels are only compiled on x86 machines."
+)
+.add_prototype("", "levels")
+.add_return("levels", "[str]", "The names of the available SIMD levels")
+;
+static PyObject* PyBobIpGabor_simdLevels(PyObject*, PyObject*){
+BOB_TRY
+  bob::ip::gabor::Simd::Level levels[] = {bob::ip::gabor::Simd::SCALAR, bob::ip::gabor::Simd::SSE2, bob::ip::gabor::Simd::AVX2, bob::ip::gabor::Simd::AVX512};
+  PyObject* list = PyList_New(0);
+  auto list_ = make_safe(list);
+  for (auto level : levels){
+    if (bob::ip::gabor::Simd::available(level)){
+      PyObject* name = Py_BuildValue("s", bob::ip::gabor::Simd::level_to_name(level).c_str());
+      auto name_ = make_safe(name);
+      if (PyList_Append(list, name) < 0) return 0;
+    }
+  }
+  return Py_BuildValue("O", list);
+BOB_CATCH_FUNCTION("simd_levels", 0)
+}
+
+static auto simdLevel_doc = bob::extension::FunctionDoc(
+  "simd_level",
+  "Returns the SIMD level of the vectorized kernels that are currently in use",
+  "The kernels are used in :py:meth:`Transform.transform` (frequency domain engine), for the absolute values of :py:class:`Jet`'s, in :py:meth:`Jet.normalize` and in the ``'ScalarProduct'`` and ``'Canberra'`` :py:class:`Similarity` functions. "
+  "When the library is loaded, the best level supported by the CPU is selected, see :py:func:`simd_levels`."
+)
+.add_prototype("", "level")
+.add_return("level", "str", "The name of the current SIMD level")
+;
+static PyObject* PyBobIpGabor_simdLevel(PyObject*, PyObject*){
+BOB_TRY
+  return Py_BuildValue("s", bob::ip::gabor::Simd::level_to_name(bob::ip::gabor::Simd::level()).c_str());
+BOB_CATCH_FUNCTION("simd_level", 0)
+}
+
+static auto setSimdLevel_doc = bob::extension::FunctionDoc(
+  "set_simd_level",
+  "Selects the vectorized kernels of the given SIMD level",
+  "This function is mainly meant for testing and benchmarking; it must not be called while other threads compute Gabor wavelet transforms or similarities. "
+  "If ``level`` is ``None``, the best level supported by the CPU is selected."
+)
+.add_prototype("[level]")
+.add_parameter("level", "str or ``None``", "One of the levels returned by :py:func:`simd_levels`")
+;
+static PyObject* PyBobIpGabor_setSimdLevel(PyObject*, PyObject* args, PyObject* kwargs){
+BOB_TRY
+  char** kwlist = setSimdLevel_doc.kwlist();
+  const char* level = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|z", kwlist, &level)) return 0;
+  bob::ip::gabor::Simd::level(level ? bob::ip::gabor::Simd::name_to_level(level) : bob::ip::gabor::Simd::best());
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("set_simd_level", 0)
+}
+
+static auto approximatePhase_doc = bob::extension::FunctionDoc(
+  "approximate_phase",
+  "Returns whether the phases of :py:class:`Jet`'s are computed with the fast approximation of ``atan2``",
+  "See :py:func:`set_approximate_phase` for details."
+)
+.add_prototype("", "enabled")
+.add_return("enabled", "bool", "``True`` if the phases are approximated")
+;
+static PyObject* PyBobIpGabor_approximatePhase(PyObject*, PyObject*){
+BOB_TRY
+  if (bob::ip::gabor::Simd::approximatePhase()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+BOB_CATCH_FUNCTION("approximate_phase", 0)
+}
+
+static auto setApproximatePhase_doc = bob::extension::FunctionDoc(
+  "set_approximate_phase",
+  "Enables or disables the fast approximation of ``atan2`` for the phases of :py:class:`Jet`'s",
+  "By default, the phases of the Gabor jets (extracted with :py:class:`Jet`, :py:meth:`Graph.extract` or the graph sink of :py:meth:`Transform.transform_tiled`) and the phase histograms of the :py:class:`FeatureExtractor` are computed with the exact ``atan2`` function. "
+  "When enabled, a vectorized polynomial approximation is used instead, which is about an order of magnitude faster, and which has a maximum absolute phase error of :math:`2\\cdot10^{-6}` rad. "
+  "The absolute values are not affected. "
+  "This function must not be called while other threads extract Gabor jets."
+)
+.add_prototype("[enable]")
+.add_parameter("enable", "bool", "[Default: ``True``] Enable or disable the approximation")
+;
+static PyObject* PyBobIpGabor_setApproximatePhase(PyObject*, PyObject* args, PyObject* kwargs){
+BOB_TRY
+  char** kwlist = setApproximatePhase_doc.kwlist();
+  PyObject* enable = Py_True;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O!", kwlist, &PyBool_Type, &enable)) return 0;
+  bob::ip::gabor::Simd::approximatePhase(PyObject_IsTrue(enable));
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("set_approximate_phase", 0)
+}
+
+static auto runBenchmark_doc = bob::extension::FunctionDoc(
+  "run_benchmark",
+  "Measures the run time of the Gabor wavelet transform, the Gabor jet extraction, the similarities and the jet statistics on synthetic data",
+  ":py:meth:`Transform.transform` is timed for all combinations of ``sizes`` and ``wavelets``. "
+  ":py:meth:`Graph.extract`, :py:meth:`Similarity.similarity` for all similarity types, :py:meth:`Similarity.disparity` and :py:meth:`JetStatistics.log_likelihood` are timed on the Gabor jets of a regular grid graph, which is placed in an image of the first size. "
+  "Each operation is run once to warm up, before it is timed ``repetitions`` times.\n\n"
+  "The result is a JSON document that contains, for each operation, its parameters, the latency percentiles (in seconds), the throughput (items per second) and the number of heap allocations per repetition. "
+  "Allocations can only be counted in the standalone ``bob_ip_gabor_benchmark`` executable, here they are always ``null``. "
+  "The :py:func:`simd_level` and the :py:func:`approximate_phase` mode are recorded, too."
+)
+.add_prototype("[sizes], [wavelets], [repetitions]", "json")
+.add_parameter("sizes", "[(int, int)]", "[Default: ``[(128, 128)]``] The image resolutions (height, width), each at least ``(32, 32)``")
+.add_parameter("wavelets", "[(int, int)]", "[Default: ``[(5, 8)]``] The wavelet families (number of scales, number of directions)")
+.add_parameter("repetitions", "int", "[Default: ``20``] The number of timed runs of each operation")
+.add_return("json", "str", "The measurements as a JSON document")
+;
+static bool convert_pairs(PyObject* o, std::vector<blitz::TinyVector<int,2>>& pairs){
+  PyObject* seq = PySequence_Fast(o, "expected a sequence of pairs of integers");
+  if (!seq) return false;
+  auto seq_ = make_safe(seq);
+  Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+  pairs.resize(size);
+  for (Py_ssize_t i = 0; i < size; ++i){
+    if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "ii", &pairs[i][0], &pairs[i][1])) return false;
+  }
+  return true;
+}
+static PyObject* PyBobIpGabor_runBenchmark(PyObject*, PyObject* args, PyObject* kwargs){
+BOB_TRY
+  char** kwlist = runBenchmark_doc.kwlist();
+  PyObject* sizes_object = 0,* wavelets_object = 0;
+  int repetitions = 20;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOi", kwlist, &sizes_object, &wavelets_object, &repetitions)) return 0;
+  std::vector<blitz::TinyVector<int,2>> sizes(1, blitz::TinyVector<int,2>(128, 128)), wavelets(1, blitz::TinyVector<int,2>(5, 8));
+  if (sizes_object && !convert_pairs(sizes_object, sizes)) return 0;
+  if (wavelets_object && !convert_pairs(wavelets_object, wavelets)) return 0;
+
+  bob::ip::gabor::Benchmark benchmark(sizes, wavelets, repetitions);
+  return Py_BuildValue("s", bob::ip::gabor::Benchmark::json(benchmark.run()).c_str());
+BOB_CATCH_FUNCTION("run_benchmark", 0)
+}
+
+static auto stats_doc = bob::extension::FunctionDoc(
+  "stats",
+  "Returns the accumulated statistics of the stages of the Gabor wavelet transform and the similarity functions",
+  "The statistics are only collected when bob.ip.gabor was compiled with the environment variable ``BOB_IP_GABOR_STATS=1``; otherwise, ``enabled`` is ``False`` and all values stay 0. "
+  "The statistics are accumulated over all threads since the module was loaded, or since the last call to :py:func:`reset_stats`.\n\n"
+  "The ``stages`` are ``'wavelet_generation'`` (one call per generated frequency domain wavelet), ``'forward_fft'``, ``'wavelet_multiply'``, ``'inverse_fft'``, ``'spatial_convolution'``, ``'recursive_filter'``, ``'similarity'`` and ``'disparity_estimation'``; each contains the number of ``calls`` and the accumulated wall time in ``seconds``. "
+  "Note that stages might be nested, e.g., the ``'disparity_estimation'`` is part of the ``'similarity'`` for disparity-based similarity functions. "
+  "The ``counters`` contain the number of ``'wavelet_resets'`` (all wavelets are discarded due to a new resolution), ``'wavelet_cache_hits'`` (an existing wavelet is reused), and the number of calls of each :py:class:`Similarity` type, e.g., ``'Disparity'``."
+)
+.add_prototype("", "stats")
+.add_return("stats", "dict", "A dictionary with the keys ``'enabled'``, ``'stages'`` and ``'counters'``")
+;
+static PyObject* PyBobIpGabor_stats(PyObject*, PyObject*){
+BOB_TRY
+  PyObject* stages = PyDict_New();
+  auto stages_ = make_safe(stages);
+  for (int i = 0; i < bob::ip::gabor::Stats::NUMBER_OF_STAGES; ++i){
+    auto stage = static_cast<bob::ip::gabor::Stats::Stage>(i);
+    PyObject* value = Py_BuildValue("{sKsd}", "calls", bob::ip::gabor::Stats::calls(stage), "seconds", bob::ip::gabor::Stats::seconds(stage));
+    if (!value) return 0;
+    auto value_ = make_safe(value);
+    if (PyDict_SetItemString(stages, bob::ip::gabor::Stats::stage_to_name(stage).c_str(), value) < 0) return 0;
+  }
+  PyObject* counters = PyDict_New();
+  auto counters_ = make_safe(counters);
+  for (int i = 0; i < bob::ip::gabor::Stats::NUMBER_OF_COUNTERS; ++i){
+    auto counter = static_cast<bob::ip::gabor::Stats::Counter>(i);
+    PyObject* value = Py_BuildValue("K", bob::ip::gabor::Stats::counter(counter));
+    if (!value) return 0;
+    auto value_ = make_safe(value);
+    if (PyDict_SetItemString(counters, bob::ip::gabor::Stats::counter_to_name(counter).c_str(), value) < 0) return 0;
+  }
+  return Py_BuildValue("{sOsOsO}", "enabled", bob::ip::gabor::Stats::enabled() ? Py_True : Py_False, "stages", stages, "counters", counters);
+BOB_CATCH_FUNCTION("stats", 0)
+}
+
+static auto resetStats_doc = bob::extension::FunctionDoc(
+  "reset_stats",
+  "Sets all statistics returned by :py:func:`stats` to 0"
+)
+.add_prototype("")
+;
+static PyObject* PyBobIpGabor_resetStats(PyObject*, PyObject*){
+BOB_TRY
+  bob::ip::gabor::Stats::reset();
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("reset_stats", 0)
+}
+
+static PyMethodDef module_methods[] = {
+  {
+    fftBackends_doc.name(),
+    (PyCFunction)PyBobIpGabor_fftBackends,
+    METH_NOARGS,
+    fftBackends_doc.doc()
+  },
+  {
+    simdLevels_doc.name(),
+    (PyCFunction)PyBobIpGabor_simdLevels,
+    METH_NOARGS,
+    simdLevels_doc.doc()
+  },
+  {
+    simdLevel_doc.name(),
+    (PyCFunction)PyBobIpGabor_simdLevel,
+    METH_NOARGS,
+    simdLevel_doc.doc()
+  },
+  {
+    setSimdLevel_doc.name(),
+    (PyCFunction)PyBobIpGabor_setSimdLevel,
+    METH_VARARGS|METH_KEYWORDS,
+    setSimdLevel_doc.doc()
+  },
+  {
+    approximatePhase_doc.name(),
+    (PyCFunction)PyBobIpGabor_approximatePhase,
+    METH_NOARGS,
+    approximatePhase_doc.doc()
+  },
+  {
+    setApproximatePhase_doc.name(),
+    (PyCFunction)PyBobIpGabor_setApproximatePhase,
+    METH_VARARGS|METH_KEYWORDS,
+    setApproximatePhase_doc.doc()
+  },
+  {
+    runBenchmark_doc.name(),
+    (PyCFunction)PyBobIpGabor_runBenchmark,
+    METH_VARARGS|METH_KEYWORDS,
+    runBenchmark_doc.doc()
+  },
+  {
+    stats_doc.name(),
+    (PyCFunction)PyBobIpGabor_stats,
+    METH_NOARGS,
+    stats_doc.doc()
+  },
+  {
+    resetStats_doc.name(),
+    (PyCFunction)PyBobIpGabor_resetStats,
+    METH_NOARGS,
+    resetStats_doc.doc()
+  },
+  {
+    loadFFTWisdom_doc.name(),
+    (PyCFunction)PyBobIpGabor_loadFFTWisdom,
+    METH_VARARGS|METH_KEYWORDS,
+    loadFFTWisdom_doc.doc()
+  },
+  {
+    saveFFTWisdom_doc.name(),
+    (PyCFunction)PyBobIpGabor_saveFFTWisdom,
+    METH_VARARGS|METH_KEYWORDS,
+    saveFFTWisdom_doc.doc()
+  },
+  {0}  /* Sentinel */
+};
 
 
 PyDoc_STRVAR(module_docstr, "Bob's Gabor wavelet support and utilities.");
@@ -26,8 +351,8 @@ static PyModuleDef module_definition = {
   BOB_EXT_MODULE_NAME,
   module_docstr,
   -1,
-  0,
-  0
+  module_methods,
+  0, 0, 0, 0
 };
 #endif
 
@@ -37,6 +362,11 @@ extern bool init_BobIpGaborJet(PyObject* module);
 extern bool init_BobIpGaborSimilarity(PyObject* module);
 extern bool init_BobIpGaborGraph(PyObject* module);
 extern bool init_BobIpGaborJetStatistics(PyObject* module);
+extern bool init_BobIpGaborTransformStream(PyObject* module);
+extern bool init_BobIpGaborSpectrum(PyObject* module);
+extern bool init_BobIpGaborFeatureExtractor(PyObject* module);
+extern bool init_BobIpGaborIndex(PyObject* module);
+extern bool init_BobIpGaborPhaseCode(PyObject* module);
 
 int PyBobIpGabor_APIVersion = BOB_IP_GABOR_API_VERSION;
 
@@ -47,7 +377,7 @@ static PyObject* create_module (void) {
   auto module_ = make_xsafe(module);
   const char* ret = "O";
 # else
-  PyObject* module = Py_InitModule3(BOB_EXT_MODULE_NAME, 0, module_docstr);
+  PyObject* module = Py_InitModule3(BOB_EXT_MODULE_NAME, module_methods, module_docstr);
   const char* ret = "N";
 # endif
   if (!module) return 0;
@@ -58,6 +388,11 @@ static PyObject* create_module (void) {
   if (!init_BobIpGaborSimilarity(module)) return NULL;
   if (!init_BobIpGaborGraph(module)) return NULL;
   if (!init_BobIpGaborJetStatistics(module)) return NULL;
+  if (!init_BobIpGaborTransformStream(module)) return NULL;
+  if (!init_BobIpGaborSpectrum(module)) return NULL;
+  if (!init_BobIpGaborFeatureExtractor(module)) return NULL;
+  if (!init_BobIpGaborIndex(module)) return NULL;
+  if (!init_BobIpGaborPhaseCode(module)) return NULL;
 
   // C-API bindings
 
@@ -79,6 +414,11 @@ static PyObject* create_module (void) {
   PyBobIpGabor_API[PyBobIpGaborSimilarity_Type_NUM] = (void *)&PyBobIpGaborSimilarity_Type;
   PyBobIpGabor_API[PyBobIpGaborTransform_Type_NUM] = (void *)&PyBobIpGaborTransform_Type;
   PyBobIpGabor_API[PyBobIpGaborJetStatistics_Type_NUM] = (void *)&PyBobIpGaborJetStatistics_Type;
+  PyBobIpGabor_API[PyBobIpGaborTransformStream_Type_NUM] = (void *)&PyBobIpGaborTransformStream_Type;
+  PyBobIpGabor_API[PyBobIpGaborSpectrum_Type_NUM] = (void *)&PyBobIpGaborSpectrum_Type;
+  PyBobIpGabor_API[PyBobIpGaborFeatureExtractor_Type_NUM] = (void *)&PyBobIpGaborFeatureExtractor_Type;
+  PyBobIpGabor_API[PyBobIpGaborIndex_Type_NUM] = (void *)&PyBobIpGaborIndex_Type;
+  PyBobIpGabor_API[PyBobIpGaborPhaseCode_Type_NUM] = (void *)&PyBobIpGaborPhaseCode_Type;
 
   /*******************
    * Check functions *
@@ -90,6 +430,11 @@ static PyObject* create_module (void) {
   PyBobIpGabor_API[PyBobIpGaborSimilarity_Check_NUM] = (void *)&PyBobIpGaborSimilarity_Check;
   PyBobIpGabor_API[PyBobIpGaborTransform_Check_NUM] = (void *)&PyBobIpGaborTransform_Check;
   PyBobIpGabor_API[PyBobIpGaborJetStatistics_Check_NUM] = (void *)&PyBobIpGaborJetStatistics_Check;
+  PyBobIpGabor_API[PyBobIpGaborTransformStream_Check_NUM] = (void *)&PyBobIpGaborTransformStream_Check;
+  PyBobIpGabor_API[PyBobIpGaborSpectrum_Check_NUM] = (void *)&PyBobIpGaborSpectrum_Check;
+  PyBobIpGabor_API[PyBobIpGaborFeatureExtractor_Check_NUM] = (void *)&PyBobIpGaborFeatureExtractor_Check;
+  PyBobIpGabor_API[PyBobIpGaborIndex_Check_NUM] = (void *)&PyBobIpGaborIndex_Check;
+  PyBobIpGabor_API[PyBobIpGaborPhaseCode_Check_NUM] = (void *)&PyBobIpGaborPhaseCode_Check;
 
 #if PY_VERSION_HEX >= 0x02070000
 
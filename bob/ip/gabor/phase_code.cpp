@@ -0,0 +1,353 @@
+/**
+ * @brief Bindings for the binary phase codes of Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto PhaseCode_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".PhaseCode",
+  "Encodes Gabor jets into compact binary codes, which are compared with the masked Hamming distance",
+  "For each wavelet, two bits store the quadrant of the phase, i.e., whether the real and the imaginary parts of the response are non-negative. "
+  "The bits of wavelets, whose magnitudes are below :py:attr:`magnitude_threshold` times the mean magnitude of the Gabor jet, are masked out. "
+  "The codes and the masks of a Gabor jet with ``L`` wavelets are stored in :py:meth:`words` (``L``) 64 bit unsigned integers each, e.g., in 80 bits for the default 40 wavelets.\n\n"
+  "The similarity of two codes is the fraction of the bits that are valid in both masks and that are equal in both codes. "
+  "It is computed with vectorized bit counts, so that :py:meth:`similarities` can be used to pre-filter large galleries, before re-scoring the best candidates with :py:class:`bob.ip.gabor.Similarity`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a phase code with the given magnitude threshold",
+    0,
+    true
+  )
+  .add_prototype("[magnitude_threshold]", "")
+  .add_parameter("magnitude_threshold", "float", "[default: 0] The fraction of the mean magnitude of the Gabor jet, below which the bits of a wavelet are masked out; with 0, no bits are masked out")
+);
+
+static int PyBobIpGaborPhaseCode_init(PyBobIpGaborPhaseCodeObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = PhaseCode_doc.kwlist();
+
+  double magnitude_threshold = 0.;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|d", kwlist, &magnitude_threshold)) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::PhaseCode(magnitude_threshold));
+  return 0;
+BOB_CATCH_MEMBER("cannot create PhaseCode", -1)
+}
+
+static void PyBobIpGaborPhaseCode_delete(PyBobIpGaborPhaseCodeObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborPhaseCode_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborPhaseCode_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto magnitudeThreshold_doc = bob::extension::VariableDoc(
+  "magnitude_threshold",
+  "float",
+  "The fraction of the mean magnitude of the Gabor jet, below which the bits of a wavelet are masked out"
+);
+PyObject* PyBobIpGaborPhaseCode_magnitudeThreshold(PyBobIpGaborPhaseCodeObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->magnitudeThreshold());
+BOB_CATCH_MEMBER("magnitude_threshold", 0)
+}
+
+int PyBobIpGaborPhaseCode_setMagnitudeThreshold(PyBobIpGaborPhaseCodeObject* self, PyObject* value, void*){
+BOB_TRY
+  double threshold = PyFloat_AsDouble(value);
+  if (PyErr_Occurred()) return -1;
+  self->cxx->magnitudeThreshold(threshold);
+  return 0;
+BOB_CATCH_MEMBER("magnitude_threshold", -1)
+}
+
+static PyGetSetDef PyBobIpGaborPhaseCode_getseters[] = {
+  {
+    magnitudeThreshold_doc.name(),
+    (getter)PyBobIpGaborPhaseCode_magnitudeThreshold,
+    (setter)PyBobIpGaborPhaseCode_setMagnitudeThreshold,
+    magnitudeThreshold_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto words_doc = bob::extension::FunctionDoc(
+  "words",
+  "Returns the number of 64 bit words of the code (and the mask) of a Gabor jet with the given number of wavelets",
+  0,
+  true
+)
+.add_prototype("length", "words")
+.add_parameter("length", "int", "The number of wavelets, i.e., the length of the Gabor jet")
+.add_return("words", "int", "The number of 64 bit words of the code")
+;
+
+static PyObject* PyBobIpGaborPhaseCode_words(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = words_doc.kwlist();
+
+  int length;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &length)) return 0;
+  return Py_BuildValue("i", bob::ip::gabor::PhaseCode::words(length));
+BOB_CATCH_FUNCTION("words", 0)
+}
+
+
+static auto encode_doc = bob::extension::FunctionDoc(
+  "encode",
+  "Encodes the given Gabor jet(s) into binary codes and masks",
+  "Gabor jets can be given as :py:class:`bob.ip.gabor.Jet` or as arrays, as returned by :py:meth:`bob.ip.gabor.Graph.extract_batch`. "
+  "When a ``graph`` and a ``trafo_image`` are given, the responses at the nodes of the graph are encoded directly, without computing the phases of the Gabor jets.",
+  true
+)
+.add_prototype("jet", "code, mask")
+.add_prototype("jets", "codes, masks")
+.add_prototype("graph, trafo_image", "codes, masks")
+.add_parameter("jet", ":py:class:`bob.ip.gabor.Jet`", "The Gabor jet to encode")
+.add_parameter("jets", "array_like (float, 3D or 4D)", "The Gabor jets of a graph, of shape ``(nodes, 2, length)``, or of several graphs, of shape ``(N, nodes, 2, length)``")
+.add_parameter("graph", ":py:class:`bob.ip.gabor.Graph`", "The graph, at the nodes of which the responses are encoded")
+.add_parameter("trafo_image", "array_like (complex, 3D)", "The result of the Gabor wavelet transform, of shape ``(length, height, width)``")
+.add_return("code, mask", "array_like (uint64, 1D)", "The code and the mask of the Gabor jet, of shape ``(words(length),)``")
+.add_return("codes, masks", "array_like (uint64, 2D or 3D)", "The codes and the masks of the Gabor jets, of shape ``(nodes, words(length))`` or ``(N, nodes, words(length))``")
+;
+
+static PyObject* PyBobIpGaborPhaseCode_encode(PyBobIpGaborPhaseCodeObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist1 = encode_doc.kwlist(0);
+  char** kwlist2 = encode_doc.kwlist(1);
+  char** kwlist3 = encode_doc.kwlist(2);
+
+  Py_ssize_t nargs = (args ? PyTuple_Size(args) : 0) + (kwargs ? PyDict_Size(kwargs) : 0);
+
+  PyBlitzArrayObject* codes,* masks;
+  if (nargs == 2){
+    // encode the responses at the graph nodes
+    PyBobIpGaborGraphObject* graph;
+    PyBlitzArrayObject* trafo_image;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O&", kwlist3, &PyBobIpGaborGraph_Type, &graph, &PyBlitzArray_Converter, &trafo_image)) return 0;
+    auto trafo_image_ = make_safe(trafo_image);
+    if (trafo_image->ndim != 3 || trafo_image->type_num != NPY_COMPLEX128) {
+      PyErr_Format(PyExc_TypeError, "`%s' only accepts 3-dimensional arrays of type complex for `trafo_image`", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    Py_ssize_t shape[] = {graph->cxx->numberOfNodes(), bob::ip::gabor::PhaseCode::words(trafo_image->shape[0])};
+    codes = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, 2, shape);
+    auto codes_ = make_safe(codes);
+    masks = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, 2, shape);
+    auto masks_ = make_safe(masks);
+    self->cxx->encode(*graph->cxx, *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(trafo_image), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(codes), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(masks));
+    return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(codes, 0), PyBlitzArray_AsNumpyArray(masks, 0));
+  }
+
+  PyObject* k = Py_BuildValue("s", kwlist1[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) == 1 && PyBobIpGaborJet_Check(PyTuple_GetItem(args, 0)))
+  ){
+    // encode a single Gabor jet
+    PyBobIpGaborJetObject* jet;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist1, &PyBobIpGaborJet_Type, &jet)) return 0;
+    Py_ssize_t shape[] = {bob::ip::gabor::PhaseCode::words(jet->cxx->length())};
+    codes = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, 1, shape);
+    auto codes_ = make_safe(codes);
+    masks = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, 1, shape);
+    auto masks_ = make_safe(masks);
+    self->cxx->encode(*jet->cxx, *PyBlitzArrayCxx_AsBlitz<uint64_t,1>(codes), *PyBlitzArrayCxx_AsBlitz<uint64_t,1>(masks));
+    return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(codes, 0), PyBlitzArray_AsNumpyArray(masks, 0));
+  }
+
+  // encode the Gabor jets of one or several graphs
+  PyBlitzArrayObject* jets;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist2, &PyBlitzArray_Converter, &jets)) return 0;
+  auto jets_ = make_safe(jets);
+  if ((jets->ndim != 3 && jets->ndim != 4) || jets->type_num != NPY_FLOAT64) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 3- or 4-dimensional arrays of type float for `jets`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  const int ndim = jets->ndim - 1;
+  Py_ssize_t shape[] = {jets->shape[0], jets->shape[1], bob::ip::gabor::PhaseCode::words(jets->shape[jets->ndim-1])};
+  if (ndim == 2) shape[1] = shape[2];
+  codes = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, ndim, shape);
+  auto codes_ = make_safe(codes);
+  masks = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_UINT64, ndim, shape);
+  auto masks_ = make_safe(masks);
+  if (ndim == 2)
+    self->cxx->encode(*PyBlitzArrayCxx_AsBlitz<double,3>(jets), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(codes), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(masks));
+  else
+    self->cxx->encode(*PyBlitzArrayCxx_AsBlitz<double,4>(jets), *PyBlitzArrayCxx_AsBlitz<uint64_t,3>(codes), *PyBlitzArrayCxx_AsBlitz<uint64_t,3>(masks));
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(codes, 0), PyBlitzArray_AsNumpyArray(masks, 0));
+BOB_CATCH_MEMBER("encode", 0)
+}
+
+
+static auto similarity_doc = bob::extension::FunctionDoc(
+  "similarity",
+  "Computes the similarity of the given codes",
+  "The similarity is ``1 - d / v``, where ``v`` is the number of bits that are valid in both masks, and ``d`` is the number of valid bits that differ between the codes. "
+  "For the codes of graphs, the bits of all nodes are pooled. "
+  "If no bit is valid, the similarity is 0.",
+  true
+)
+.add_prototype("code1, mask1, code2, mask2", "similarity")
+.add_parameter("code1, mask1", "array_like (uint64, 1D or 2D)", "The code and the mask of the first Gabor jet or graph")
+.add_parameter("code2, mask2", "array_like (uint64, 1D or 2D)", "The code and the mask of the second Gabor jet or graph, of the same shape")
+.add_return("similarity", "float", "The similarity of the codes, in the range [0, 1]")
+;
+
+static PyObject* PyBobIpGaborPhaseCode_similarity(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarity_doc.kwlist();
+
+  PyBlitzArrayObject* arrays[4];
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&", kwlist, &PyBlitzArray_Converter, &arrays[0], &PyBlitzArray_Converter, &arrays[1], &PyBlitzArray_Converter, &arrays[2], &PyBlitzArray_Converter, &arrays[3])) return 0;
+  auto code1_ = make_safe(arrays[0]);
+  auto mask1_ = make_safe(arrays[1]);
+  auto code2_ = make_safe(arrays[2]);
+  auto mask2_ = make_safe(arrays[3]);
+
+  const int ndim = arrays[0]->ndim;
+  for (int i = 0; i < 4; ++i){
+    if ((ndim != 1 && ndim != 2) || arrays[i]->ndim != ndim || arrays[i]->type_num != NPY_UINT64) {
+      PyErr_Format(PyExc_TypeError, "`%s' only accepts 1- or 2-dimensional arrays of type uint64 with the same number of dimensions", PhaseCode_doc.name());
+      return 0;
+    }
+  }
+
+  double similarity;
+  if (ndim == 1)
+    similarity = bob::ip::gabor::PhaseCode::similarity(*PyBlitzArrayCxx_AsBlitz<uint64_t,1>(arrays[0]), *PyBlitzArrayCxx_AsBlitz<uint64_t,1>(arrays[1]), *PyBlitzArrayCxx_AsBlitz<uint64_t,1>(arrays[2]), *PyBlitzArrayCxx_AsBlitz<uint64_t,1>(arrays[3]));
+  else
+    similarity = bob::ip::gabor::PhaseCode::similarity(*PyBlitzArrayCxx_AsBlitz<uint64_t,2>(arrays[0]), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(arrays[1]), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(arrays[2]), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(arrays[3]));
+  return Py_BuildValue("d", similarity);
+BOB_CATCH_FUNCTION("similarity", 0)
+}
+
+
+static auto similarities_doc = bob::extension::FunctionDoc(
+  "similarities",
+  "Computes the similarities of the codes of a probe graph to the codes of all gallery graphs",
+  "This function can be used to pre-filter large galleries; see :py:meth:`similarity` for the definition of the similarity.",
+  true
+)
+.add_prototype("code, mask, codes, masks", "similarities")
+.add_parameter("code, mask", "array_like (uint64, 2D)", "The code and the mask of the probe graph, of shape ``(nodes, words)``")
+.add_parameter("codes, masks", "array_like (uint64, 3D)", "The codes and the masks of the gallery graphs, of shape ``(N, nodes, words)``")
+.add_return("similarities", "array_like (float, 1D)", "The similarities of the probe graph to all ``N`` gallery graphs")
+;
+
+static PyObject* PyBobIpGaborPhaseCode_similarities(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarities_doc.kwlist();
+
+  PyBlitzArrayObject* arrays[4];
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&O&O&", kwlist, &PyBlitzArray_Converter, &arrays[0], &PyBlitzArray_Converter, &arrays[1], &PyBlitzArray_Converter, &arrays[2], &PyBlitzArray_Converter, &arrays[3])) return 0;
+  auto code_ = make_safe(arrays[0]);
+  auto mask_ = make_safe(arrays[1]);
+  auto codes_ = make_safe(arrays[2]);
+  auto masks_ = make_safe(arrays[3]);
+
+  for (int i = 0; i < 4; ++i){
+    if (arrays[i]->ndim != (i < 2 ? 2 : 3) || arrays[i]->type_num != NPY_UINT64) {
+      PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays of type uint64 for `code` and `mask`, and 3-dimensional arrays of type uint64 for `codes` and `masks`", PhaseCode_doc.name());
+      return 0;
+    }
+  }
+
+  Py_ssize_t shape[] = {arrays[2]->shape[0]};
+  PyBlitzArrayObject* similarities = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, shape);
+  auto similarities_ = make_safe(similarities);
+  bob::ip::gabor::PhaseCode::similarities(*PyBlitzArrayCxx_AsBlitz<uint64_t,2>(arrays[0]), *PyBlitzArrayCxx_AsBlitz<uint64_t,2>(arrays[1]), *PyBlitzArrayCxx_AsBlitz<uint64_t,3>(arrays[2]), *PyBlitzArrayCxx_AsBlitz<uint64_t,3>(arrays[3]), *PyBlitzArrayCxx_AsBlitz<double,1>(similarities));
+  return PyBlitzArray_AsNumpyArray(similarities, 0);
+BOB_CATCH_FUNCTION("similarities", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborPhaseCode_methods[] = {
+  {
+    words_doc.name(),
+    (PyCFunction)PyBobIpGaborPhaseCode_words,
+    METH_VARARGS|METH_KEYWORDS|METH_STATIC,
+    words_doc.doc()
+  },
+  {
+    encode_doc.name(),
+    (PyCFunction)PyBobIpGaborPhaseCode_encode,
+    METH_VARARGS|METH_KEYWORDS,
+    encode_doc.doc()
+  },
+  {
+    similarity_doc.name(),
+    (PyCFunction)PyBobIpGaborPhaseCode_similarity,
+    METH_VARARGS|METH_KEYWORDS|METH_STATIC,
+    similarity_doc.doc()
+  },
+  {
+    similarities_doc.name(),
+    (PyCFunction)PyBobIpGaborPhaseCode_similarities,
+    METH_VARARGS|METH_KEYWORDS|METH_STATIC,
+    similarities_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the PhaseCode type struct; will be initialized later
+PyTypeObject PyBobIpGaborPhaseCode_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpGaborPhaseCode(PyObject* module)
+{
+
+  // initialize the PhaseCode type struct
+  PyBobIpGaborPhaseCode_Type.tp_name = PhaseCode_doc.name();
+  PyBobIpGaborPhaseCode_Type.tp_basicsize = sizeof(PyBobIpGaborPhaseCodeObject);
+  PyBobIpGaborPhaseCode_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborPhaseCode_Type.tp_doc = PhaseCode_doc.doc();
+
+  // set the functions
+  PyBobIpGaborPhaseCode_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborPhaseCode_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborPhaseCode_init);
+  PyBobIpGaborPhaseCode_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborPhaseCode_delete);
+  PyBobIpGaborPhaseCode_Type.tp_methods = PyBobIpGaborPhaseCode_methods;
+  PyBobIpGaborPhaseCode_Type.tp_getset = PyBobIpGaborPhaseCode_getseters;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborPhaseCode_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborPhaseCode_Type);
+  return PyModule_AddObject(module, "PhaseCode", (PyObject*)&PyBobIpGaborPhaseCode_Type) >= 0;
+}
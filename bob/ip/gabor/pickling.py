@@ -0,0 +1,79 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+
+"""Pickling support for Gabor jets, graphs, wavelets and Gabor wavelet transforms.
+
+Gabor jets are pickled through a view of their data, so that pickle protocol 5 can transfer them as out-of-band buffers without copying.
+The generated wavelets of a Gabor wavelet transform are only pickled when enabled with its :py:attr:`bob.ip.gabor.Transform.pickle_wavelets`.
+"""
+
+try:
+  import copyreg
+except ImportError:
+  import copy_reg as copyreg
+
+import numpy
+
+from . import _library
+
+def _restore_jet(data, state):
+  # the data is used without copying, if possible; out-of-band buffers might be read-only
+  if not (data.flags.c_contiguous and data.flags.aligned and data.flags.writeable):
+    data = numpy.array(data, dtype = numpy.float64)
+  from . import Jet
+  jet = Jet.adopt(data)
+  if state:
+    jet.__dict__.update(state)
+  return jet
+
+def _reduce_jet(jet):
+  # the view of the Gabor jet is pickled by numpy, which uses out-of-band buffers for pickle protocol 5
+  return _restore_jet, (numpy.asarray(jet), getattr(jet, '__dict__', None) or None)
+
+
+def _reduce_graph(graph):
+  return _library.Graph, (graph.nodes,)
+
+
+def _reduce_wavelet(wavelet):
+  return _library.Wavelet, (wavelet.resolution, wavelet.frequency, wavelet.sigma, wavelet.power_of_k, wavelet.dc_free, wavelet.epsilon, wavelet.runs, wavelet.values)
+
+
+def _restore_transform(parameters, state):
+  transform = _library.Transform(**parameters)
+  for name in ('engine', 'spatial_epsilon', 'padding'):
+    setattr(transform, name, state[name])
+  transform.recursive_order = state.get('recursive_order', 6)
+  # the FFT backend is a property of the host, which might not provide the backend of the pickling host
+  if state.get('fft_backend') in _library.fft_backends():
+    transform.fft_backend = state['fft_backend']
+  transform.share_wavelets = state.get('share_wavelets', False)
+  transform.pickle_wavelets = state.get('pickle_wavelets', False)
+  if state.get('wavelets') is not None:
+    transform.wavelets = state['wavelets']
+  return transform
+
+def _reduce_transform(transform):
+  parameters = {
+    'number_of_scales' : transform.number_of_scales,
+    'number_of_directions' : transform.number_of_directions,
+    'sigma' : transform.sigma,
+    'k_max' : transform.k_max,
+    'k_fac' : transform.k_fac,
+    'power_of_k' : transform.power_of_k,
+    'dc_free' : transform.dc_free,
+    'epsilon' : transform.epsilon
+  }
+  state = dict((name, getattr(transform, name)) for name in ('engine', 'spatial_epsilon', 'recursive_order', 'padding', 'fft_backend', 'share_wavelets', 'pickle_wavelets'))
+  if transform.pickle_wavelets and any(w is not None for w in transform.wavelets):
+    state['wavelets'] = transform.wavelets
+  return _restore_transform, (parameters, state)
+
+
+def register(jet_class):
+  """Registers the reducers for the C++ classes and the given Python :py:class:`bob.ip.gabor.Jet` class."""
+  for cls in (_library.Jet, jet_class):
+    copyreg.pickle(cls, _reduce_jet)
+  copyreg.pickle(_library.Graph, _reduce_graph)
+  copyreg.pickle(_library.Wavelet, _reduce_wavelet)
+  copyreg.pickle(_library.Transform, _reduce_transform)
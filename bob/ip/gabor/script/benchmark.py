@@ -0,0 +1,53 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+
+"""Measures the run time of the Gabor wavelet transform, the Gabor jet extraction, the similarities and the jet statistics, and writes the results as JSON."""
+
+import argparse
+import json
+import sys
+
+import bob.ip.gabor
+
+
+def _pairs(text):
+  try:
+    return [tuple(int(v) for v in pair.split('x')) for pair in text.split(',')]
+  except ValueError:
+    raise argparse.ArgumentTypeError("expected a comma-separated list of pairs like 128x128, got '%s'" % text)
+
+
+def command_line_arguments(command_line_parameters):
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+  parser.add_argument('-s', '--sizes', type=_pairs, default=[(128, 128), (256, 256)], help="The image sizes HEIGHTxWIDTH, comma-separated")
+  parser.add_argument('-w', '--wavelets', type=_pairs, default=[(5, 8)], help="The wavelet families SCALESxDIRECTIONS, comma-separated")
+  parser.add_argument('-r', '--repetitions', type=int, default=20, help="The number of timed runs of each operation")
+  parser.add_argument('-l', '--simd-level', choices=bob.ip.gabor.simd_levels(), help="Use the given SIMD level instead of the best one")
+  parser.add_argument('-a', '--approximate-phase', action='store_true', help="Compute the phases of the Gabor jets with the fast atan2 approximation")
+  parser.add_argument('-o', '--output', help="Write the JSON document into the given file instead of the console")
+  return parser.parse_args(command_line_parameters)
+
+
+def main(command_line_parameters = None):
+  args = command_line_arguments(command_line_parameters)
+
+  bob.ip.gabor.set_simd_level(args.simd_level)
+  bob.ip.gabor.set_approximate_phase(args.approximate_phase)
+  try:
+    result = bob.ip.gabor.run_benchmark(args.sizes, args.wavelets, args.repetitions)
+  finally:
+    bob.ip.gabor.set_simd_level()
+    bob.ip.gabor.set_approximate_phase(False)
+
+  # validate the document, before it is written
+  json.loads(result)
+  if args.output:
+    with open(args.output, 'w') as f:
+      f.write(result)
+  else:
+    sys.stdout.write(result)
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -15,6 +15,8 @@
 #include <bob.io.base/api.h>
 #include <bob.extension/documentation.h>
 
+#include "gil.h"
+
 
 static inline char* c(const char* o){return const_cast<char*>(o);}
 
@@ -221,6 +223,208 @@ BOB_CATCH_MEMBER("disparity", 0)
 }
 
 
+// converts the given iterable of bob.ip.gabor.Jet objects; returns false and sets an exception on error
+static bool jet_list(PyObject* self, PyObject* jets, const char* name, std::vector<boost::shared_ptr<bob::ip::gabor::Jet>>& data){
+  PyObject* iterator = PyObject_GetIter(jets);
+  if (!iterator) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `%s' parameter to be an iterable of bob.ip.gabor.Jet objects", Py_TYPE(self)->tp_name, name);
+    return false;
+  }
+  auto iterator_ = make_safe(iterator);
+  int i = 0;
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `%s' parameter to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, name, i);
+      return false;
+    }
+    data.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+    ++i;
+  }
+  return !PyErr_Occurred();
+}
+
+
+static auto similarities_doc = bob::extension::FunctionDoc(
+  "similarities",
+  "This function computes the similarities between many pairs of Gabor jets at once",
+  "The similarity ``sims[p]`` between ``jets1[p]`` and ``jets2[p]`` is identical to ``similarity(jets1[p], jets2[p])``. "
+  "For the disparity-based similarity functions, the disparities of several pairs are estimated simultaneously in the SIMD lanes of the processor (see :py:func:`bob.ip.gabor.simd_level`), which is considerably faster than calling :py:func:`similarity` for each pair. "
+  "In opposition to :py:func:`similarity`, :py:attr:`last_disparity` is not updated.",
+  true
+)
+.add_prototype("jets1, jets2", "sims")
+.add_parameter("jets1, jets2", "[:py:class:`bob.ip.gabor.Jet`]", "Two lists of Gabor jets of the same length, which should be compared pairwise")
+.add_return("sims", "array_like (1D, float)", "The similarities between the pairs of Gabor jets")
+;
+
+static PyObject* PyBobIpGaborSimilarity_similarities(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarities_doc.kwlist();
+
+  PyObject* jets1,* jets2;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO", kwlist, &jets1, &jets2)) return 0;
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> data1, data2;
+  if (!jet_list(reinterpret_cast<PyObject*>(self), jets1, "jets1", data1) || !jet_list(reinterpret_cast<PyObject*>(self), jets2, "jets2", data2)) return 0;
+
+  Py_ssize_t osize[] = {(Py_ssize_t)data1.size()};
+  PyBlitzArrayObject* sims = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+  auto sims_ = make_safe(sims);
+  self->cxx->similarities(data1, data2, *PyBlitzArrayCxx_AsBlitz<double,1>(sims));
+  return PyBlitzArray_AsNumpyArray(sims, 0);
+BOB_CATCH_MEMBER("similarities", 0)
+}
+
+
+static auto disparities_doc = bob::extension::FunctionDoc(
+  "disparities",
+  "This function computes the disparity vectors between many pairs of Gabor jets at once",
+  "The disparity ``disps[p]`` between ``jets1[p]`` and ``jets2[p]`` is identical to ``disparity(jets1[p], jets2[p])``, but the disparities of several pairs are estimated simultaneously in the SIMD lanes of the processor. "
+  "This function is only available for the disparity-based similarity functions.",
+  true
+)
+.add_prototype("jets1, jets2", "disps")
+.add_parameter("jets1, jets2", "[:py:class:`bob.ip.gabor.Jet`]", "Two lists of Gabor jets of the same length, between which the disparities should be computed")
+.add_return("disps", "array_like (2D, float)", "The disparity vectors ``(dy, dx)`` estimated from the pairs of Gabor jets, one per row")
+;
+
+static PyObject* PyBobIpGaborSimilarity_disparities(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = disparities_doc.kwlist();
+
+  PyObject* jets1,* jets2;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO", kwlist, &jets1, &jets2)) return 0;
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> data1, data2;
+  if (!jet_list(reinterpret_cast<PyObject*>(self), jets1, "jets1", data1) || !jet_list(reinterpret_cast<PyObject*>(self), jets2, "jets2", data2)) return 0;
+
+  Py_ssize_t osize[] = {(Py_ssize_t)data1.size(), 2};
+  PyBlitzArrayObject* disps = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, osize);
+  auto disps_ = make_safe(disps);
+  self->cxx->disparities(data1, data2, *PyBlitzArrayCxx_AsBlitz<double,2>(disps));
+  return PyBlitzArray_AsNumpyArray(disps, 0);
+BOB_CATCH_MEMBER("disparities", 0)
+}
+
+
+static auto disparityField_doc = bob::extension::FunctionDoc(
+  "disparity_field",
+  "This function estimates the dense disparity field between two Gabor wavelet transformed images",
+  "Both trafo images must be generated by the same :py:class:`bob.ip.gabor.Transform`, i.e., the :py:attr:`transform` of this object. "
+  "For each point ``(r * step[0], c * step[1])``, the Gabor jets of both images are extracted and normalized, and the disparity vector and the similarity between them are estimated. "
+  "The results are identical to calling :py:func:`disparity` and :py:func:`similarity` with the :py:class:`bob.ip.gabor.Jet`\\s of both images at each point, but several points are processed simultaneously in SIMD lanes, and the rows can be distributed over several threads, during which the GIL is released.\n\n"
+  "The similarity values can be used as confidences of the disparity vectors. "
+  "This function is only available for the disparity-based similarity functions.",
+  true
+)
+.add_prototype("trafo_image1, trafo_image2, [step], [number_of_threads]", "disparities, similarities")
+.add_parameter("trafo_image1, trafo_image2", "array_like (complex, 3D)", "The Gabor wavelet transformed images of the same shape, see :py:func:`bob.ip.gabor.Transform.transform`")
+.add_parameter("step", "(int, int)", "[default: ``(1, 1)``] The distance between two points of the field in y and x direction")
+.add_parameter("number_of_threads", "int", "[default: 1] The number of threads, among which the rows of the field are distributed; 0 uses one thread per core")
+.add_return("disparities", "array_like (float, 3D)", "The disparity vectors ``(dy, dx)`` from the first to the second image, of shape ``(rows, columns, 2)``")
+.add_return("similarities", "array_like (float, 2D)", "The similarities between the Gabor jets of both images, of shape ``(rows, columns)``")
+;
+
+static PyObject* PyBobIpGaborSimilarity_disparityField(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = disparityField_doc.kwlist();
+
+  PyBlitzArrayObject* trafo_image1,* trafo_image2;
+  blitz::TinyVector<int,2> step(1, 1);
+  int number_of_threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|(ii)i", kwlist, &PyBlitzArray_Converter, &trafo_image1, &PyBlitzArray_Converter, &trafo_image2, &step[0], &step[1], &number_of_threads)) return 0;
+
+  auto trafo_image1_ = make_safe(trafo_image1);
+  auto trafo_image2_ = make_safe(trafo_image2);
+
+  if (trafo_image1->ndim != 3 || trafo_image1->type_num != NPY_COMPLEX128 || trafo_image2->ndim != 3 || trafo_image2->type_num != NPY_COMPLEX128) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 3-dimensional arrays of complex type for `trafo_image1` and `trafo_image2`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (step[0] <= 0 || step[1] <= 0) {
+    PyErr_Format(PyExc_ValueError, "`%s' requires a positive `step`, but got (%d, %d)", Py_TYPE(self)->tp_name, step[0], step[1]);
+    return 0;
+  }
+
+  Py_ssize_t dsize[] = {(trafo_image1->shape[1] + step[0] - 1) / step[0], (trafo_image1->shape[2] + step[1] - 1) / step[1], 2};
+  PyBlitzArrayObject* disparities = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, dsize);
+  auto disparities_ = make_safe(disparities);
+  PyBlitzArrayObject* similarities = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, dsize);
+  auto similarities_ = make_safe(similarities);
+
+  blitz::Array<std::complex<double>,3> input1 = *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(trafo_image1);
+  blitz::Array<std::complex<double>,3> input2 = *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(trafo_image2);
+  blitz::Array<double,3> output1 = *PyBlitzArrayCxx_AsBlitz<double,3>(disparities);
+  blitz::Array<double,2> output2 = *PyBlitzArrayCxx_AsBlitz<double,2>(similarities);
+  {
+    ReleaseGIL gil;
+    self->cxx->disparityField(input1, input2, output1, output2, step, number_of_threads);
+  }
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(disparities, 0), PyBlitzArray_AsNumpyArray(similarities, 0));
+BOB_CATCH_MEMBER("disparity_field", 0)
+}
+
+
+static auto search_doc = bob::extension::FunctionDoc(
+  "search",
+  "This function finds the ``k`` gallery graphs that are most similar to the given probe graph",
+  "The score of a gallery graph is the average similarity of its Gabor jets to the Gabor jets of the probe at the same nodes, which are computed with :py:func:`similarity`. "
+  "The probe and the gallery are stored in contiguous arrays, as returned by :py:func:`bob.ip.gabor.Graph.extract_batch`. "
+  "Candidates are abandoned as soon as an upper bound of their score cannot reach the current ``k``-th best score, so that the results are identical to computing and sorting all scores. "
+  "On equal scores, the gallery graph with the lower index is preferred.\n\n"
+  ".. note::\n\n  The bounds of the ``'ScalarProduct'``, ``'AbsPhase'`` and ``'Disparity'`` similarity functions are tighter, when all Gabor jets are normalized to unit length. "
+  "If this is not the case, set ``normalized = False``.",
+  true
+)
+.add_prototype("probe, gallery, k, [normalized]", "indices, scores")
+.add_parameter("probe", "array_like (float, 3D)", "The Gabor jets of the probe graph, of shape ``(nodes, 2, number_of_wavelets)``")
+.add_parameter("gallery", "array_like (float, 4D)", "The Gabor jets of the gallery graphs, of shape ``(N, nodes, 2, number_of_wavelets)``")
+.add_parameter("k", "int", "The number of gallery graphs to return; must not be larger than ``N``")
+.add_parameter("normalized", "bool", "[default: ``True``] Are the absolute values of all Gabor jets normalized to unit Euclidean length?")
+.add_return("indices", "array_like (int32, 1D)", "The indices of the ``k`` best gallery graphs, ordered by descending score")
+.add_return("scores", "array_like (float, 1D)", "The scores of the ``k`` best gallery graphs")
+;
+
+static PyObject* PyBobIpGaborSimilarity_search(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = search_doc.kwlist();
+
+  PyBlitzArrayObject* probe,* gallery;
+  int k;
+  PyObject* normalized = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&i|O!", kwlist, &PyBlitzArray_Converter, &probe, &PyBlitzArray_Converter, &gallery, &k, &PyBool_Type, &normalized)) return 0;
+
+  auto probe_ = make_safe(probe);
+  auto gallery_ = make_safe(gallery);
+
+  if (probe->ndim != 3 || probe->type_num != NPY_FLOAT64) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 3-dimensional arrays of type float for `probe`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (gallery->ndim != 4 || gallery->type_num != NPY_FLOAT64) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 4-dimensional arrays of type float for `gallery`", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (k < 0) {
+    PyErr_Format(PyExc_ValueError, "`%s' requires a non-negative `k`, but got %d", Py_TYPE(self)->tp_name, k);
+    return 0;
+  }
+
+  Py_ssize_t osize[] = {k};
+  PyBlitzArrayObject* indices = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_INT32, 1, osize);
+  auto indices_ = make_safe(indices);
+  PyBlitzArrayObject* scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+  auto scores_ = make_safe(scores);
+
+  self->cxx->search(*PyBlitzArrayCxx_AsBlitz<double,3>(probe), *PyBlitzArrayCxx_AsBlitz<double,4>(gallery), *PyBlitzArrayCxx_AsBlitz<int32_t,1>(indices), *PyBlitzArrayCxx_AsBlitz<double,1>(scores), !normalized || PyObject_IsTrue(normalized));
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(indices, 0), PyBlitzArray_AsNumpyArray(scores, 0));
+BOB_CATCH_MEMBER("search", 0)
+}
+
+
 static auto shift_phase_doc = bob::extension::FunctionDoc(
   "shift_phase",
   "This function returns a copy of the Gabor jet, for which the Gabor phases are shifted towards the reference Gabor jet",
@@ -316,6 +520,30 @@ static PyMethodDef PyBobIpGaborSimilarity_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     disparity_doc.doc()
   },
+  {
+    similarities_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_similarities,
+    METH_VARARGS|METH_KEYWORDS,
+    similarities_doc.doc()
+  },
+  {
+    disparities_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_disparities,
+    METH_VARARGS|METH_KEYWORDS,
+    disparities_doc.doc()
+  },
+  {
+    disparityField_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_disparityField,
+    METH_VARARGS|METH_KEYWORDS,
+    disparityField_doc.doc()
+  },
+  {
+    search_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_search,
+    METH_VARARGS|METH_KEYWORDS,
+    search_doc.doc()
+  },
   {
     shift_phase_doc.name(),
     (PyCFunction)PyBobIpGaborSimilarity_shift_phase,
@@ -0,0 +1,148 @@
+/**
+ * @brief Bindings for the spectrum of an image
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto Spectrum_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".Spectrum",
+  "The spectrum (i.e., the FFT) of an image, which can be shared between several Gabor wavelet families",
+  "A spectrum is computed by :py:meth:`Transform.spectrum`, including the :py:attr:`Transform.padding` of the image. "
+  "It can be passed to :py:meth:`Transform.transform` of any :py:class:`Transform` with the same padding, e.g., with different :py:attr:`Transform.sigma` or :py:attr:`Transform.k_max`, "
+  "so that the forward FFT of the image is computed only once."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an empty spectrum",
+    "Use :py:meth:`Transform.spectrum` to fill the spectrum.",
+    true
+  )
+  .add_prototype("", "")
+);
+
+static int PyBobIpGaborSpectrum_init(PyBobIpGaborSpectrumObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = Spectrum_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return -1;
+  self->cxx.reset(new bob::ip::gabor::Spectrum());
+  return 0;
+BOB_CATCH_MEMBER("cannot create Spectrum", -1)
+}
+
+static void PyBobIpGaborSpectrum_delete(PyBobIpGaborSpectrumObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborSpectrum_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborSpectrum_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto shape_doc = bob::extension::VariableDoc(
+  "shape",
+  "(int, int)",
+  "The shape (height, width) of the original image, i.e., without padding"
+);
+PyObject* PyBobIpGaborSpectrum_shape(PyBobIpGaborSpectrumObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("(ii)", self->cxx->height(), self->cxx->width());
+BOB_CATCH_MEMBER("shape", 0)
+}
+
+static auto padding_doc = bob::extension::VariableDoc(
+  "padding",
+  "str",
+  "The padding that was applied to the image before computing its FFT, see :py:attr:`Transform.padding`"
+);
+PyObject* PyBobIpGaborSpectrum_padding(PyBobIpGaborSpectrumObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", bob::ip::gabor::Transform::padding_to_name(self->cxx->padding()).c_str());
+BOB_CATCH_MEMBER("padding", 0)
+}
+
+static auto frequencyImage_doc = bob::extension::VariableDoc(
+  "frequency_image",
+  "array_like (complex, 2D)",
+  "The FFT of the (padded) image; read access only"
+);
+PyObject* PyBobIpGaborSpectrum_frequencyImage(PyBobIpGaborSpectrumObject* self, void*){
+BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->frequencyImage());
+BOB_CATCH_MEMBER("frequency_image", 0)
+}
+
+static PyGetSetDef PyBobIpGaborSpectrum_getseters[] = {
+  {
+    shape_doc.name(),
+    (getter)PyBobIpGaborSpectrum_shape,
+    0,
+    shape_doc.doc(),
+    0
+  },
+  {
+    padding_doc.name(),
+    (getter)PyBobIpGaborSpectrum_padding,
+    0,
+    padding_doc.doc(),
+    0
+  },
+  {
+    frequencyImage_doc.name(),
+    (getter)PyBobIpGaborSpectrum_frequencyImage,
+    0,
+    frequencyImage_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the Spectrum type struct; will be initialized later
+PyTypeObject PyBobIpGaborSpectrum_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpGaborSpectrum(PyObject* module)
+{
+
+  // initialize the Spectrum type struct
+  PyBobIpGaborSpectrum_Type.tp_name = Spectrum_doc.name();
+  PyBobIpGaborSpectrum_Type.tp_basicsize = sizeof(PyBobIpGaborSpectrumObject);
+  PyBobIpGaborSpectrum_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborSpectrum_Type.tp_doc = Spectrum_doc.doc();
+
+  // set the functions
+  PyBobIpGaborSpectrum_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborSpectrum_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborSpectrum_init);
+  PyBobIpGaborSpectrum_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborSpectrum_delete);
+  PyBobIpGaborSpectrum_Type.tp_getset = PyBobIpGaborSpectrum_getseters;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborSpectrum_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborSpectrum_Type);
+  return PyModule_AddObject(module, "Spectrum", (PyObject*)&PyBobIpGaborSpectrum_Type) >= 0;
+}
@@ -14,3 +14,82 @@ def test_jet():
     assert numpy.allclose(jet.abs, jet_after_pickle.abs, 10e-3)
     assert numpy.allclose(jet.complex, jet_after_pickle.complex, 10e-3)
     assert numpy.allclose(jet.jet, jet_after_pickle.jet, 10e-3)    
+
+
+def test_jet_out_of_band():
+    if not hasattr(pickle, "PickleBuffer"):
+        return
+    jet = bob.ip.gabor.Jet(5)
+    jet.jet = numpy.arange(10).reshape(2,5).astype("float")
+    jet.label = "test"
+
+    # the data of the Gabor jet is transferred as an out-of-band buffer
+    buffers = []
+    data = pickle.dumps(jet, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) == 1
+    jet_after_pickle = pickle.loads(data, buffers=buffers)
+    assert isinstance(jet_after_pickle, bob.ip.gabor.Jet)
+    assert numpy.allclose(jet.jet, jet_after_pickle.jet)
+    assert jet_after_pickle.label == "test"
+    # ... and it is not copied
+    assert numpy.shares_memory(numpy.asarray(jet), numpy.asarray(jet_after_pickle))
+
+    # lists of Gabor jets, e.g., extracted by a graph, use one buffer per jet
+    graph = bob.ip.gabor.Graph((10,10), (20,20), (5,5))
+    trafo_image = bob.ip.gabor.Transform().transform(numpy.random.random((32,32)))
+    jets = graph.extract(trafo_image)
+    buffers = []
+    jets_after_pickle = pickle.loads(pickle.dumps(jets, protocol=5, buffer_callback=buffers.append), buffers=buffers)
+    assert len(buffers) == len(jets)
+    for a, b in zip(jets, jets_after_pickle):
+        assert numpy.allclose(a.jet, b.jet)
+
+
+def test_graph():
+    graph = bob.ip.gabor.Graph((10,10), (30,40), (10,10))
+    graph_after_pickle = pickle.loads(pickle.dumps(graph))
+    assert graph.nodes == graph_after_pickle.nodes
+
+
+def test_transform():
+    transform = bob.ip.gabor.Transform(number_of_scales=3, number_of_directions=4, sigma=numpy.pi, epsilon=1e-8)
+    transform.padding = "reflect"
+    transform.share_wavelets = True
+    image = numpy.random.random((24,32))
+    trafo_image = transform(image)
+
+    # by default, only the parametrization is pickled
+    transform_after_pickle = pickle.loads(pickle.dumps(transform))
+    assert transform_after_pickle == transform
+    assert transform_after_pickle.padding == "reflect"
+    assert transform_after_pickle.epsilon == 1e-8
+    assert transform_after_pickle.share_wavelets
+    assert all(w is None for w in transform_after_pickle.wavelets)
+
+    # the generated wavelets can be pickled as well, which is enabled for each transform
+    transform.pickle_wavelets = True
+    transform_after_pickle = pickle.loads(pickle.dumps(transform))
+    assert transform_after_pickle.pickle_wavelets
+    assert all(w is not None for w in transform_after_pickle.wavelets)
+    for a, b in zip(transform.wavelets, transform_after_pickle.wavelets):
+        assert a.resolution == b.resolution
+        assert a.frequency == b.frequency and a.sigma == b.sigma and a.epsilon == b.epsilon
+        assert numpy.all(a.runs == b.runs)
+        assert numpy.allclose(a.values, b.values)
+    assert numpy.allclose(transform_after_pickle(image), trafo_image)
+
+    # ... which does not influence other transforms
+    other = bob.ip.gabor.Transform(number_of_scales=3, number_of_directions=4)
+    other(image)
+    assert not other.pickle_wavelets
+    assert all(w is None for w in pickle.loads(pickle.dumps(other)).wavelets)
+
+def test_transform_fft_backend():
+    # a Transform pickled on a host with an FFT backend that is not available falls back to the default backend
+    from bob.ip.gabor import pickling
+    transform = bob.ip.gabor.Transform()
+    function, (parameters, state) = pickling._reduce_transform(transform)
+    state['fft_backend'] = 'unavailable'
+    transform_after_pickle = function(parameters, state)
+    assert transform_after_pickle == transform
+    assert transform_after_pickle.fft_backend == 'bob.sp'
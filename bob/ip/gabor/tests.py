@@ -12,6 +12,7 @@ import numpy
 import nose.tools
 import math, cmath
 import os
+import threading
 
 import bob.io.base
 import bob.sp
@@ -123,6 +124,16 @@ def test_transform():
     # create wavelet
     w = bob.ip.gabor.Wavelet((size, size), k, sigma, 0., True, 1e-10)
     assert numpy.allclose(w.wavelet, wavelets[i].wavelet)
+    assert wavelets[i].frequency == tuple(k) and wavelets[i].sigma == sigma and wavelets[i].epsilon == 1e-10
+
+  # generated wavelets can be assigned only to transforms with the same parametrization
+  same = bob.ip.gabor.Transform(number_of_directions=d, number_of_scales=s, sigma=sigma, k_max=k_max, k_fac=k_fac)
+  same.wavelets = wavelets
+  assert all(a is not None and numpy.array_equal(a.values, b.values) for a, b in zip(same.wavelets, wavelets))
+  for other in (bob.ip.gabor.Transform(number_of_directions=d, number_of_scales=s, sigma=sigma/2., k_max=k_max, k_fac=k_fac), bob.ip.gabor.Transform(number_of_directions=d, number_of_scales=s, sigma=sigma, k_max=k_max/2., k_fac=k_fac)):
+    nose.tools.assert_raises(RuntimeError, setattr, other, 'wavelets', wavelets)
+  restored = [bob.ip.gabor.Wavelet(w.resolution, w.frequency, w.sigma, w.power_of_k, not w.dc_free, w.epsilon, w.runs, w.values) for w in wavelets]
+  nose.tools.assert_raises(RuntimeError, setattr, same, 'wavelets', restored)
 
   # load test image
   image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
@@ -144,6 +155,771 @@ def test_transform():
 
 
 
+def test_spatial_engine():
+  # check that the spatial domain engine is comparable to the frequency domain engine
+  gwt = bob.ip.gabor.Transform()
+  assert gwt.engine == 'frequency'
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:32,:32].astype(numpy.float64)
+  reference = gwt(image)
+
+  gwt.engine = 'spatial'
+  assert gwt.engine == 'spatial'
+  gwt.spatial_epsilon = 1e-5
+  trafo_image = gwt(image)
+  assert trafo_image.shape == reference.shape
+  # the documented error bound of the truncated wavelets
+  bound = gwt.spatial_epsilon * (1. + math.exp(-gwt.sigma**2/2.)) * numpy.max(numpy.abs(image))
+  assert numpy.allclose(trafo_image, reference, rtol=0., atol=bound)
+
+  # the responses at selected positions are identical to the full transform
+  positions = [(0,0), (5,17), (31,31), (16,8)]
+  for engine in ('frequency', 'spatial', 'automatic'):
+    gwt.engine = engine
+    responses = gwt.transform_at(image, positions)
+    assert responses.shape == (len(positions), gwt.number_of_wavelets)
+    for i, (y,x) in enumerate(positions):
+      assert numpy.allclose(responses[i], reference[:,y,x], rtol=0., atol=bound)
+
+  nose.tools.assert_raises(RuntimeError, gwt.transform_at, image, [(32,0)])
+  nose.tools.assert_raises(RuntimeError, setattr, gwt, 'engine', 'unknown')
+
+
+def test_recursive_engine():
+  # check that the recursive engine approximates the frequency domain engine
+  gwt = bob.ip.gabor.Transform()
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:48,:56].astype(numpy.float64)
+  reference = gwt(image)
+
+  gwt.engine = 'recursive'
+  assert gwt.engine == 'recursive'
+  assert gwt.recursive_order == 6
+  # the documented bounds of the relative error per layer for each order
+  for order, epsilon, bound in ((4, 1e-4, 3e-2), (6, 1e-4, 1e-3), (8, 1e-6, 3e-5)):
+    gwt.recursive_order = order
+    gwt.spatial_epsilon = epsilon
+    trafo_image = gwt(image)
+    assert trafo_image.shape == reference.shape
+    for j in range(gwt.number_of_wavelets):
+      error = numpy.sqrt(numpy.mean(numpy.abs(trafo_image[j] - reference[j])**2))
+      assert error < bound * numpy.sqrt(numpy.mean(numpy.abs(reference[j])**2))
+  nose.tools.assert_raises(RuntimeError, setattr, gwt, 'recursive_order', 5)
+  gwt.recursive_order = 6
+  gwt.spatial_epsilon = 1e-4
+
+  # the report compares all engines with the frequency domain engine
+  report = bob.ip.gabor.engine_report(image, gwt, repetitions=1)
+  assert [r['engine'] for r in report] == ['frequency', 'spatial', 'recursive']
+  assert report[0]['max_error'] == 0.
+  assert report[2]['relative_error'] < 1e-2
+  assert gwt.engine == 'recursive'
+
+
+def test_padding():
+  # check that the padding is identical to transforming a padded image
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:31,:37].astype(numpy.float64)
+  gwt = bob.ip.gabor.Transform()
+  assert gwt.padding == 'none'
+  # 31 -> 32 and 37 -> 40
+  pad_width = ((0,1), (1,2))
+  for padding, mode in (('zero', 'constant'), ('reflect', 'reflect'), ('symmetric', 'symmetric')):
+    gwt.padding = padding
+    assert gwt.padding == padding
+    trafo_image = gwt(image)
+    assert trafo_image.shape == (gwt.number_of_wavelets, 31, 37)
+
+    reference_gwt = bob.ip.gabor.Transform()
+    reference = reference_gwt(numpy.pad(image, pad_width, mode))[:, 0:31, 1:38]
+    assert numpy.allclose(trafo_image, reference)
+
+    # the responses at positions are padded identically
+    positions = [(0,0), (30,36)]
+    responses = gwt.transform_at(image, positions)
+    assert numpy.allclose(responses[1], trafo_image[:,30,36])
+
+  # the padding is stored in and loaded from file
+  filename = bob.io.base.test_utils.temporary_filename(suffix=".hdf5")
+  try:
+    gwt.save(bob.io.base.HDF5File(filename, 'w'))
+    loaded = bob.ip.gabor.Transform(bob.io.base.HDF5File(filename))
+    assert loaded.padding == 'symmetric'
+    assert loaded == gwt
+    assert loaded != bob.ip.gabor.Transform()
+  finally:
+    os.remove(filename)
+
+  nose.tools.assert_raises(RuntimeError, setattr, gwt, 'padding', 'unknown')
+
+
+def test_fft_backend():
+  # check that all FFT backends compute the same transform
+  assert 'bob.sp' in bob.ip.gabor.fft_backends()
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  assert gwt.fft_backend == 'bob.sp'
+  reference = gwt(image)
+
+  filename = bob.io.base.test_utils.temporary_filename(suffix=".wisdom")
+  try:
+    if 'fftw' in bob.ip.gabor.fft_backends():
+      gwt.fft_backend = 'fftw'
+      assert gwt.fft_backend == 'fftw'
+      assert numpy.allclose(gwt(image), reference)
+      # a second transform shares the plans
+      other = bob.ip.gabor.Transform()
+      other.fft_backend = 'fftw'
+      assert numpy.allclose(other(image), reference)
+      # wisdom can be written and read
+      bob.ip.gabor.save_fft_wisdom(filename)
+      bob.ip.gabor.load_fft_wisdom(filename)
+    else:
+      nose.tools.assert_raises(RuntimeError, setattr, gwt, 'fft_backend', 'fftw')
+      nose.tools.assert_raises(RuntimeError, bob.ip.gabor.save_fft_wisdom, filename)
+  finally:
+    if os.path.exists(filename):
+      os.remove(filename)
+
+
+def test_tiled_transform():
+  # check that the tiled transform is comparable to the full transform
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:48,:56].astype(numpy.float64)
+  gwt = bob.ip.gabor.Transform()
+  reference = gwt(image)
+  bound = 2. * gwt.spatial_epsilon * (1. + math.exp(-gwt.sigma**2/2.)) * numpy.max(numpy.abs(image))
+
+  # write into an output array
+  output = numpy.zeros(reference.shape, numpy.complex128)
+  trafo_image = gwt.transform_tiled(image, output, (16,16))
+  assert trafo_image.shape == reference.shape
+  assert numpy.allclose(output, reference, rtol=0., atol=bound)
+
+  # collect the tiles with a callback
+  tiles = []
+  assert gwt.transform_tiled(image, lambda offset, tile: tiles.append((offset, tile)), (16,16)) is None
+  assert len(tiles) > 1
+  collected = numpy.zeros(reference.shape, numpy.complex128)
+  for (y,x), tile in tiles:
+    collected[:, y:y+tile.shape[1], x:x+tile.shape[2]] = tile
+  assert numpy.allclose(collected, reference, rtol=0., atol=bound)
+
+  # extract Gabor jets at the nodes of a graph
+  graph = bob.ip.gabor.Graph((2,3), (45,50), (7,11))
+  jets = gwt.transform_tiled(image, graph, (16,16))
+  reference_jets = graph.extract(reference)
+  assert len(jets) == len(reference_jets)
+  for jet, reference_jet in zip(jets, reference_jets):
+    assert numpy.allclose(jet.complex, reference_jet.complex, rtol=0., atol=1e-3)
+  # a graph without nodes gives no jets
+  assert gwt.transform_tiled(image, bob.ip.gabor.Graph([]), (16,16)) == []
+
+  # exceptions of the callback are passed on
+  def failing(offset, tile):
+    raise ValueError("stop")
+  nose.tools.assert_raises(ValueError, gwt.transform_tiled, image, failing)
+
+  # with padding, the tiles are filled as if the image was padded on all sides by (at least) the margin
+  size = 128
+  for padding, mode in (('zero', 'constant'), ('reflect', 'reflect'), ('symmetric', 'symmetric')):
+    gwt.padding = padding
+    output = gwt.transform_tiled(image, numpy.zeros(reference.shape, numpy.complex128), (16,16))
+    padded = bob.ip.gabor.Transform()(numpy.pad(image, size, mode))[:, size:-size, size:-size]
+    assert numpy.allclose(output, padded, rtol=0., atol=bound), padding
+
+
+def test_transform_stream():
+  # check that the stream returns the same results as the transform, in the correct order
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:32,:40]
+  frames = [numpy.roll(image, i, axis=1) for i in range(5)]
+  gwt = bob.ip.gabor.Transform()
+
+  stream = bob.ip.gabor.TransformStream(gwt, number_of_threads=2, capacity=3)
+  assert stream.number_of_threads == 2
+  assert stream.capacity == 3
+  for frame in frames[:3]:
+    stream.push(frame)
+  assert stream.pending == 3
+  for i, frame in enumerate(frames):
+    if i+3 < len(frames):
+      stream.push(frames[i+3])
+    assert numpy.allclose(stream.pop(), gwt(frame))
+  assert stream.pending == 0
+  stream.close()
+  nose.tools.assert_raises(RuntimeError, stream.pop)
+  nose.tools.assert_raises(RuntimeError, stream.push, image)
+
+  # extract Gabor jets at the nodes of a graph
+  graph = bob.ip.gabor.Graph((2,3), (30,37), (7,11))
+  stream = bob.ip.gabor.TransformStream(gwt, graph, 2)
+  for frame in frames:
+    stream.push(frame)
+  for frame in frames:
+    jets = stream.pop()
+    reference = graph.extract(gwt(frame))
+    assert len(jets) == len(reference)
+    for jet, ref in zip(jets, reference):
+      assert numpy.allclose(jet.jet, ref.jet)
+
+  # the pipeline works with a single worker and with padding, and frames transformed in spatial domain are passed as a whole
+  for engine, padding in (('frequency', 'symmetric'), ('spatial', 'none')):
+    gwt = bob.ip.gabor.Transform()
+    gwt.engine = engine
+    gwt.padding = padding
+    for threads in (1, 3):
+      stream = bob.ip.gabor.TransformStream(gwt, number_of_threads=threads)
+      assert stream.number_of_threads == threads
+      for frame in frames:
+        stream.push(frame)
+      for frame in frames:
+        assert numpy.allclose(stream.pop(), gwt(frame))
+      stream = bob.ip.gabor.TransformStream(gwt, graph, threads)
+      for frame in frames:
+        stream.push(frame)
+      for frame in frames:
+        jets = stream.pop()
+        for jet, ref in zip(jets, graph.extract(gwt(frame))):
+          assert numpy.allclose(jet.jet, ref.jet)
+
+
+def test_spectrum():
+  # check that a spectrum can be shared between several Gabor wavelet families
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:31,:37]
+  gwt1 = bob.ip.gabor.Transform()
+  gwt2 = bob.ip.gabor.Transform(number_of_scales=3, sigma=math.pi, k_max=math.pi/4.)
+  for padding in ('none', 'symmetric'):
+    gwt1.padding = padding
+    gwt2.padding = padding
+    spectrum = gwt1.spectrum(image)
+    assert spectrum.shape == image.shape
+    assert spectrum.padding == padding
+    assert spectrum.frequency_image.shape == ((31,37) if padding == 'none' else (32,40))
+    assert numpy.allclose(gwt1(spectrum), gwt1(image))
+    assert numpy.allclose(gwt2(spectrum), gwt2(image))
+
+  # the spectrum can be re-used, and it needs the same padding
+  spectrum = bob.ip.gabor.Spectrum()
+  assert gwt2.spectrum(image[:20,:24], spectrum) is spectrum
+  assert spectrum.shape == (20,24)
+  output = numpy.zeros((gwt2.number_of_wavelets, 20, 24), numpy.complex128)
+  gwt2.transform(spectrum, output)
+  assert numpy.allclose(output, gwt2.transform(spectrum))
+  nose.tools.assert_raises(RuntimeError, gwt2.transform, spectrum, output[0])
+  nose.tools.assert_raises(RuntimeError, gwt2.transform, spectrum, output[:,:10])
+  gwt1.padding = 'zero'
+  nose.tools.assert_raises(RuntimeError, gwt1.transform, spectrum)
+
+
+def test_wavelet_subset():
+  # check that a subset of the wavelets can be computed
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:31,:37]
+  gwt = bob.ip.gabor.Transform()
+  indices = gwt.wavelet_indices(scales=range(3), directions=[0,2,4])
+  assert indices == [s * 8 + d for s in range(3) for d in (0,2,4)]
+  assert gwt.wavelet_indices() == list(range(gwt.number_of_wavelets))
+
+  # only the selected wavelets are generated
+  subset = gwt.transform(image, indices=indices)
+  assert subset.shape == (len(indices), 31, 37)
+  assert sum(w is not None for w in gwt.wavelets) == len(indices)
+
+  full = gwt.transform(image)
+  assert numpy.allclose(subset, full[indices])
+  assert numpy.allclose(gwt.transform(gwt.spectrum(image), indices=indices), full[indices])
+  gwt.engine = 'spatial'
+  assert numpy.allclose(gwt.transform(image, indices=indices), gwt.transform(image)[indices])
+
+  nose.tools.assert_raises(RuntimeError, gwt.transform, image, indices=[gwt.number_of_wavelets])
+  nose.tools.assert_raises(RuntimeError, gwt.wavelet_indices, scales=[5])
+
+
+def test_feature_extractor():
+  # check that the pooled features are identical to pooling the trafo image
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:31,:37]
+  gwt = bob.ip.gabor.Transform()
+  extractor = bob.ip.gabor.FeatureExtractor(gwt, (8,6), phase_bins=4)
+  assert extractor.block_size == (8,6)
+  assert extractor.phase_bins == 4
+
+  magnitudes, histograms = extractor.extract(image)
+  assert magnitudes.shape == (40,3,6)
+  assert histograms.shape == (40,3,6,4)
+
+  trafo_image = gwt(image)[:,:24,:36].reshape(40,3,8,6,6)
+  assert numpy.allclose(magnitudes, numpy.abs(trafo_image).mean(axis=(2,4)))
+  assert numpy.allclose(histograms.sum(axis=3), 1.)
+  phases = numpy.angle(trafo_image[0,0,:,0,:])
+  assert numpy.allclose(histograms[0,0,0], numpy.histogram(phases, bins=4, range=(-math.pi, math.pi))[0] / 48.)
+
+  # without phase bins, only the magnitudes are returned
+  extractor = bob.ip.gabor.FeatureExtractor(gwt, (8,6))
+  assert numpy.allclose(extractor(image), magnitudes)
+  nose.tools.assert_raises(RuntimeError, extractor.extract, image[:5,:5])
+
+
+def test_transform_roi():
+  # check that the region of interest is identical to the corresponding part of the full transform
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:31,:37]
+  gwt = bob.ip.gabor.Transform()
+  for engine, padding in (('frequency', 'none'), ('frequency', 'symmetric'), ('spatial', 'none')):
+    gwt.engine = engine
+    gwt.padding = padding
+    full = gwt(image)
+    for roi in ((5,7,10,12), (0,0,31,3), (20,30,11,7)):
+      y, x, h, w = roi
+      assert numpy.allclose(gwt.transform_roi(image, roi), full[:, y:y+h, x:x+w])
+
+  nose.tools.assert_raises(RuntimeError, gwt.transform_roi, image, (25,30,10,10))
+
+
+def test_simd():
+  # check that all vectorized kernels give the same results as the scalar ones
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))[:31,:37]
+  levels = bob.ip.gabor.simd_levels()
+  assert levels[0] == 'scalar'
+  assert bob.ip.gabor.simd_level() == levels[-1]
+
+  def compute():
+    gwt = bob.ip.gabor.Transform()
+    trafo_image = gwt(image)
+    jet1 = bob.ip.gabor.Jet(trafo_image=trafo_image, position=(10,10))
+    jet2 = bob.ip.gabor.Jet(trafo_image=trafo_image, position=(12,15))
+    similarities = [bob.ip.gabor.Similarity(type=name, transform=gwt)(jet1, jet2) for name in ('ScalarProduct', 'Canberra', 'PhaseDiffPlusCanberra')]
+    return trafo_image, jet1.jet, similarities
+
+  try:
+    bob.ip.gabor.set_simd_level('scalar')
+    assert bob.ip.gabor.simd_level() == 'scalar'
+    reference = compute()
+    for level in levels[1:]:
+      bob.ip.gabor.set_simd_level(level)
+      result = compute()
+      for r, e in zip(result, reference):
+        assert numpy.allclose(r, e)
+  finally:
+    bob.ip.gabor.set_simd_level()
+  assert bob.ip.gabor.simd_level() == levels[-1]
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.set_simd_level, 'neon')
+
+
+def test_approximate_phase():
+  # the approximated phases of the Gabor jets must be close to the exact ones, for all SIMD levels
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  trafo_image = gwt(image)
+  positions = [(y, x) for y in range(0, image.shape[0], 7) for x in range(0, image.shape[1], 5)]
+  assert not bob.ip.gabor.approximate_phase()
+  reference = [bob.ip.gabor.Jet(trafo_image=trafo_image, position=p, normalize=False).jet for p in positions]
+  try:
+    bob.ip.gabor.set_approximate_phase()
+    assert bob.ip.gabor.approximate_phase()
+    for level in bob.ip.gabor.simd_levels():
+      bob.ip.gabor.set_simd_level(level)
+      for p, r in zip(positions, reference):
+        jet = bob.ip.gabor.Jet(trafo_image=trafo_image, position=p, normalize=False).jet
+        assert numpy.allclose(jet[0], r[0])
+        diff = numpy.angle(numpy.exp(1j * (jet[1] - r[1])))
+        assert numpy.max(numpy.abs(diff)) < 2e-6
+  finally:
+    bob.ip.gabor.set_approximate_phase(False)
+    bob.ip.gabor.set_simd_level()
+  assert not bob.ip.gabor.approximate_phase()
+
+
+def test_benchmark():
+  # run a tiny benchmark through the script and check the JSON document
+  import json
+  import tempfile
+  from .script import benchmark
+  with tempfile.NamedTemporaryFile(suffix='.json') as f:
+    assert benchmark.main(['--sizes', '32x32,40x48', '--wavelets', '2x2', '--repetitions', '3', '--output', f.name]) == 0
+    result = json.load(open(f.name))
+  assert result['simd_level'] == bob.ip.gabor.simd_level()
+  names = [m['name'] for m in result['measurements']]
+  assert names.count('transform') == 2
+  assert names.count('similarity') == 6
+  for name in ('graph_extract', 'disparity', 'log_likelihood'):
+    assert name in names
+  for m in result['measurements']:
+    assert m['repetitions'] == 3
+    assert 0 <= m['latency']['min'] <= m['latency']['p50'] <= m['latency']['p99'] <= m['latency']['max']
+    assert m['throughput'] > 0
+    # allocations are only counted by the standalone executable
+    assert m['allocations'] is None
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.run_benchmark, [(16, 16)])
+
+
+def test_stats():
+  # the statistics are only collected when the instrumentation is compiled in
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform(number_of_scales=2, number_of_directions=3)
+  bob.ip.gabor.reset_stats()
+  stats = bob.ip.gabor.stats()
+  assert set(stats['stages']) == set(('wavelet_generation', 'forward_fft', 'wavelet_multiply', 'inverse_fft', 'spatial_convolution', 'recursive_filter', 'similarity', 'disparity_estimation'))
+  assert all(s['calls'] == 0 and s['seconds'] == 0 for s in stats['stages'].values())
+  assert all(c == 0 for c in stats['counters'].values())
+
+  trafo_image = gwt(image)
+  gwt(image)
+  jet = bob.ip.gabor.Jet(trafo_image=trafo_image, position=(10,10))
+  bob.ip.gabor.Similarity(type='Disparity', transform=gwt)(jet, jet)
+  stats = bob.ip.gabor.stats()
+  if stats['enabled']:
+    assert stats['stages']['forward_fft']['calls'] == 2
+    assert stats['stages']['inverse_fft']['calls'] == 12
+    assert stats['stages']['wavelet_generation']['calls'] == 6
+    assert stats['stages']['wavelet_multiply']['calls'] == 12
+    assert stats['stages']['disparity_estimation']['calls'] == 1
+    assert stats['counters']['wavelet_resets'] == 1
+    assert stats['counters']['wavelet_cache_hits'] == 6
+    assert stats['counters']['Disparity'] == 1
+    assert stats['stages']['forward_fft']['seconds'] > 0
+  else:
+    assert all(s['calls'] == 0 for s in stats['stages'].values())
+  bob.ip.gabor.reset_stats()
+  assert all(c == 0 for c in bob.ip.gabor.stats()['counters'].values())
+
+
+def test_jet_buffer():
+  # the buffer protocol and adopted arrays share the memory with the Gabor jet
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  trafo_image = gwt(image)
+  jet = bob.ip.gabor.Jet(trafo_image=trafo_image, position=(10,10))
+
+  view = numpy.asarray(jet)
+  assert view.shape == (2, 40)
+  assert view.dtype == numpy.float64
+  assert numpy.allclose(view, jet.jet)
+  view[1,0] = 42.
+  assert jet.jet[1,0] == 42.
+  # the view stays valid when the Gabor jet is re-initialized with another length
+  jet.init(numpy.ones(10, numpy.complex128))
+  assert view.shape == (2, 40)
+  assert numpy.asarray(jet).shape == (2, 10)
+
+  # adopt a block of memory for several Gabor jets, and extract the jets into it
+  storage = numpy.zeros((3, 2, 40))
+  jets = [bob.ip.gabor.Jet.adopt(storage[i]) for i in range(3)]
+  assert isinstance(jets[0], bob.ip.gabor.Jet)
+  for i, jet in enumerate(jets):
+    jet.extract(trafo_image, (10 + i, 20))
+    reference = bob.ip.gabor.Jet(trafo_image=trafo_image, position=(10 + i, 20))
+    assert numpy.allclose(storage[i], reference.jet)
+  storage[2,0] = 1.
+  assert numpy.all(jets[2].abs == 1.)
+  similarity = bob.ip.gabor.Similarity(type='ScalarProduct')
+  assert abs(similarity(jets[0], jets[0]) - 1.) < 1e-8
+  # the Gabor jet keeps the adopted memory alive
+  del storage
+  assert numpy.all(jets[2].abs == 1.)
+
+  nose.tools.assert_raises(ValueError, bob.ip.gabor.Jet.adopt, numpy.zeros((2, 80))[:, ::2])
+  nose.tools.assert_raises(TypeError, bob.ip.gabor.Jet.adopt, numpy.zeros((2, 40), numpy.float32))
+  nose.tools.assert_raises(TypeError, bob.ip.gabor.Jet.adopt, numpy.zeros((3, 40)))
+
+
+def test_graph_batch():
+  # the batched extraction is identical to the extraction of each image
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  images = [image, image[::-1], image[:,::-1]]
+  trafo_images = numpy.array([gwt(i) for i in images])
+  graph = bob.ip.gabor.Graph(first=(10,10), last=(60,60), step=(25,25))
+
+  for number_of_threads in (1, 2, 0):
+    jets = graph.extract_batch(trafo_images, number_of_threads=number_of_threads)
+    assert jets.shape == (3, graph.number_of_nodes, 2, gwt.number_of_wavelets)
+    for i in range(3):
+      for n, jet in enumerate(graph.extract(trafo_images[i])):
+        assert numpy.allclose(jets[i,n], jet.jet)
+
+  # unnormalized jets are written into the given array
+  jets = numpy.ndarray((3, graph.number_of_nodes, 2, gwt.number_of_wavelets))
+  assert graph.extract_batch(trafo_images, jets, normalize=False) is jets
+  assert numpy.allclose(jets[1,0], bob.ip.gabor.Jet(trafo_image=trafo_images[1], position=graph.nodes[0], normalize=False).jet)
+
+  # individual nodes for each image
+  nodes = numpy.array([[(10,10), (20,30)], [(5,7), (40,2)], [(0,0), (70,70)]], numpy.int32)
+  jets = graph.extract_batch(trafo_images, nodes=nodes, number_of_threads=3)
+  assert jets.shape == (3, 2, 2, gwt.number_of_wavelets)
+  for i in range(3):
+    for n in range(2):
+      assert numpy.allclose(jets[i,n], bob.ip.gabor.Jet(trafo_image=trafo_images[i], position=tuple(nodes[i,n])).jet)
+
+  # nodes outside of the images are rejected
+  nodes[2,1] = (200, 0)
+  nose.tools.assert_raises(RuntimeError, graph.extract_batch, trafo_images, nodes=nodes)
+  nose.tools.assert_raises(TypeError, graph.extract_batch, trafo_images[0])
+
+
+def test_similarity_fixed_length():
+  # the fixed-length implementation for the default Gabor wavelet family gives the same results as the generic one
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  default = bob.ip.gabor.Transform()
+  # this family is not recognized as the default one, but it is numerically identical
+  generic = bob.ip.gabor.Transform(k_max = math.pi / 2. * (1. + 1e-10))
+  trafo_image = default(image)
+  jets = [bob.ip.gabor.Jet(trafo_image=trafo_image, position=(y, x)) for y in (20, 25, 40) for x in (20, 33)]
+
+  for name in ('AbsPhase', 'Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra'):
+    fixed = bob.ip.gabor.Similarity(type=name, transform=default)
+    reference = bob.ip.gabor.Similarity(type=name, transform=generic)
+    for jet1 in jets:
+      for jet2 in jets:
+        assert abs(fixed(jet1, jet2) - reference(jet1, jet2)) < 1e-6
+        if name != 'AbsPhase':
+          assert numpy.allclose(fixed.disparity(jet1, jet2), reference.disparity(jet1, jet2), atol=1e-6)
+
+
+def test_similarity_batch():
+  # the batched similarities and disparities are identical to the ones of the single pairs, for all SIMD levels
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  default = bob.ip.gabor.Transform()
+  trafo_image = default(image)
+  jets = [bob.ip.gabor.Jet(trafo_image=trafo_image, position=(y, x)) for y in range(20, 41, 5) for x in range(20, 41, 4)]
+  jets1 = [jets[i] for i in range(len(jets)) for j in range(len(jets))]
+  jets2 = [jets[j] for i in range(len(jets)) for j in range(len(jets))]
+
+  level = bob.ip.gabor.simd_level()
+  try:
+    for transform in (default, bob.ip.gabor.Transform(number_of_scales=3, number_of_directions=6)):
+      if transform is not default:
+        trafo_image = transform(image)
+        jets1 = [bob.ip.gabor.Jet(trafo_image=trafo_image, position=(20 + i % 7, 30 + i % 3)) for i in range(37)]
+        jets2 = [bob.ip.gabor.Jet(trafo_image=trafo_image, position=(22 + i % 5, 27 + i % 4)) for i in range(37)]
+      for name in ('ScalarProduct', 'AbsPhase', 'Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra'):
+        similarity = bob.ip.gabor.Similarity(type=name, transform=transform)
+        reference = numpy.array([similarity(jet1, jet2) for jet1, jet2 in zip(jets1, jets2)])
+        disparities = numpy.array([similarity.disparity(jet1, jet2) for jet1, jet2 in zip(jets1, jets2)]) if name not in ('ScalarProduct', 'AbsPhase') else None
+        for simd in bob.ip.gabor.simd_levels():
+          bob.ip.gabor.set_simd_level(simd)
+          sims = similarity.similarities(jets1, jets2)
+          assert sims.shape == (len(jets1),)
+          assert numpy.allclose(sims, reference, atol=1e-12)
+          if disparities is not None:
+            assert numpy.allclose(similarity.disparities(jets1, jets2), disparities, atol=1e-12)
+          else:
+            nose.tools.assert_raises(RuntimeError, similarity.disparities, jets1, jets2)
+
+    # jets without responses in the lowest frequency scale give 0/0 there, and the NaN is propagated by all SIMD levels
+    degenerate = [bob.ip.gabor.Jet(jet) for jet in jets]
+    for jet in degenerate[::3]:
+      numpy.asarray(jet)[0, -default.number_of_directions:] = 0.
+    similarity = bob.ip.gabor.Similarity(type='Disparity', transform=default)
+    disparities = numpy.array([similarity.disparity(jet1, jet2) for jet1, jet2 in zip(degenerate, jets)])
+    assert numpy.isnan(disparities[::3]).all()
+    for simd in bob.ip.gabor.simd_levels():
+      bob.ip.gabor.set_simd_level(simd)
+      assert numpy.allclose(similarity.disparities(degenerate, jets), disparities, atol=1e-12, equal_nan=True)
+  finally:
+    bob.ip.gabor.set_simd_level(level)
+
+  similarity = bob.ip.gabor.Similarity(type='Disparity', transform=default)
+  assert similarity.similarities([], []).shape == (0,)
+  nose.tools.assert_raises(RuntimeError, similarity.similarities, jets[:2], jets[:3])
+  nose.tools.assert_raises(TypeError, similarity.disparities, jets[:2], [1, 2])
+
+
+def test_disparity_field():
+  # the dense disparity field is identical to the disparities and similarities of the single Gabor jets
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  trafo_image1 = gwt(image)
+  trafo_image2 = gwt(numpy.roll(numpy.roll(image, 2, axis=0), -1, axis=1))
+
+  for name in ('Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra'):
+    similarity = bob.ip.gabor.Similarity(type=name, transform=gwt)
+    disparities, similarities = similarity.disparity_field(trafo_image1, trafo_image2, step=(7, 5))
+    assert disparities.shape == ((image.shape[0] + 6) // 7, (image.shape[1] + 4) // 5, 2)
+    assert similarities.shape == disparities.shape[:2]
+    for r in range(disparities.shape[0]):
+      for c in range(disparities.shape[1]):
+        jet1 = bob.ip.gabor.Jet(trafo_image=trafo_image1, position=(r * 7, c * 5))
+        jet2 = bob.ip.gabor.Jet(trafo_image=trafo_image2, position=(r * 7, c * 5))
+        assert numpy.allclose(disparities[r,c], similarity.disparity(jet1, jet2), atol=1e-12)
+        assert abs(similarities[r,c] - similarity(jet1, jet2)) < 1e-12
+
+    # the result does not depend on the number of threads
+    threaded = similarity.disparity_field(trafo_image1, trafo_image2, step=(7, 5), number_of_threads=3)
+    assert numpy.array_equal(threaded[0], disparities)
+    assert numpy.array_equal(threaded[1], similarities)
+
+  # the disparity field is estimated at all pixels by default
+  disparities, similarities = similarity.disparity_field(trafo_image1, trafo_image2)
+  assert disparities.shape == image.shape + (2,)
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.Similarity(type='Canberra').disparity_field, trafo_image1, trafo_image2)
+  nose.tools.assert_raises(RuntimeError, similarity.disparity_field, trafo_image1, trafo_image2[:,:-1])
+  nose.tools.assert_raises(ValueError, similarity.disparity_field, trafo_image1, trafo_image2, step=(0, 1))
+
+
+def test_search():
+  # the top-k search with early termination gives the same results as sorting all scores
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  trafo_image = gwt(image)
+  graph = bob.ip.gabor.Graph(first=(10,10), last=(20,20), step=(10,10))
+  # gallery graphs at shifted positions, with the probe graph in between
+  nodes = numpy.array([numpy.array(graph.nodes) + (dy, dx) for dy in range(0, 21, 5) for dx in range(0, 21, 4)], dtype=numpy.int32)
+  gallery = graph.extract_batch(trafo_image[numpy.newaxis].repeat(len(nodes), axis=0), nodes=nodes)
+  probe = gallery[17].copy()
+
+  for name in ('ScalarProduct', 'Canberra', 'AbsPhase', 'Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra'):
+    similarity = bob.ip.gabor.Similarity(type=name, transform=gwt)
+    jets = lambda graph: [bob.ip.gabor.Jet.adopt(graph[n].copy()) for n in range(len(graph))]
+    reference = numpy.array([numpy.mean([similarity(p, g) for p, g in zip(jets(probe), jets(candidate))]) for candidate in gallery])
+    order = sorted(range(len(gallery)), key=lambda i: (-reference[i], i))
+    for k in (1, 5, len(gallery)):
+      for normalized in (True, False):
+        indices, scores = similarity.search(probe, gallery, k, normalized=normalized)
+        assert indices.dtype == numpy.int32 and len(indices) == k
+        assert list(indices) == order[:k]
+        assert numpy.allclose(scores, reference[order[:k]], atol=1e-10)
+    assert similarity.search(probe, gallery, 1)[0][0] == 17
+
+  assert len(similarity.search(probe, gallery, 0)[0]) == 0
+  nose.tools.assert_raises(RuntimeError, similarity.search, probe, gallery, len(gallery) + 1)
+  nose.tools.assert_raises(RuntimeError, similarity.search, probe[:-1], gallery, 1)
+  nose.tools.assert_raises(TypeError, similarity.search, probe[0], gallery, 1)
+
+
+def test_index():
+  # the approximate index gives the exact search results when all lists are visited and all graphs are re-ranked
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  trafo_image = gwt(image)
+  graph = bob.ip.gabor.Graph(first=(10,10), last=(20,20), step=(10,10))
+  nodes = numpy.array([numpy.array(graph.nodes) + (dy, dx) for dy in range(0, 21, 5) for dx in range(0, 21, 4)], dtype=numpy.int32)
+  gallery = graph.extract_batch(trafo_image[numpy.newaxis].repeat(len(nodes), axis=0), nodes=nodes)
+  probe = gallery[17].copy()
+
+  features = bob.ip.gabor.Index.features(gallery)
+  assert features.shape == (len(gallery), 4 * gwt.number_of_wavelets)
+  assert numpy.allclose(features[3], gallery[3,:,0].flatten())
+  assert numpy.allclose(bob.ip.gabor.Index.features(probe), features[17])
+
+  index = bob.ip.gabor.Index(features.shape[1], 4, 8, 16)
+  assert not index.is_trained and len(index) == 0
+  nose.tools.assert_raises(RuntimeError, index.add, features)
+  nose.tools.assert_raises(RuntimeError, index.train, features[:10])
+  index.train(features)
+  assert index.is_trained
+
+  # graphs are added incrementally
+  index.add(features[:20])
+  index.add(features[20:])
+  assert len(index) == len(gallery)
+
+  ids, distances = index.search(features[17], len(gallery), probes=index.number_of_lists)
+  assert sorted(ids) == list(range(len(gallery)))
+  assert numpy.all(numpy.diff(distances) >= 0)
+  ids, distances = index.search(features[17], len(gallery) + 2, probes=index.number_of_lists)
+  assert list(ids[-2:]) == [-1, -1] and numpy.all(numpy.isinf(distances[-2:]))
+
+  similarity = bob.ip.gabor.Similarity('ScalarProduct')
+  for k in (1, 5, 10):
+    ids, scores = index.rerank(similarity, probe, gallery, k, probes=index.number_of_lists, shortlist=len(gallery))
+    indices, reference = similarity.search(probe, gallery, k)
+    assert ids.dtype == numpy.int32
+    assert list(ids) == list(indices)
+    assert numpy.allclose(scores, reference)
+  assert index.rerank(similarity, probe, gallery, 1, probes=index.number_of_lists)[0][0] == 17
+  nose.tools.assert_raises(RuntimeError, index.rerank, similarity, probe, gallery[:-1], 1)
+  nose.tools.assert_raises(RuntimeError, index.rerank, similarity, probe, gallery, 5, shortlist=4)
+
+  # only the shortlisted graphs are loaded, when the gallery is a function
+  loaded = []
+  def load(id):
+    loaded.append(id)
+    return gallery[id]
+  ids, scores = index.rerank(similarity, probe, load, 2, probes=index.number_of_lists, shortlist=5)
+  assert len(loaded) == 5
+  assert numpy.all(ids == index.rerank(similarity, probe, gallery, 2, probes=index.number_of_lists, shortlist=5)[0])
+  nose.tools.assert_raises(RuntimeError, index.rerank, similarity, probe, lambda id : gallery[id,:-1], 1)
+  def failing(id):
+    raise ValueError("stop")
+  nose.tools.assert_raises(ValueError, index.rerank, similarity, probe, failing, 1)
+
+  # the index, including the stored graphs, is written to and read from file
+  filename = bob.io.base.test_utils.temporary_filename(suffix=".hdf5")
+  try:
+    index.save(bob.io.base.HDF5File(filename, 'w'))
+    loaded = bob.ip.gabor.Index(bob.io.base.HDF5File(filename))
+    assert len(loaded) == len(index) and loaded.number_of_subquantizers == 8 and loaded.number_of_centroids == 16
+    for probes in (1, 2):
+      assert all(numpy.array_equal(a, b) for a, b in zip(loaded.search(features[5], 10, probes), index.search(features[5], 10, probes)))
+  finally:
+    os.remove(filename)
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.Index, 10, 4, 3)
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.Index, 10, 4, 5, 257)
+
+
+def test_phase_code():
+  # binary phase codes store the signs of the real and imaginary parts of the responses
+  image = bob.io.base.load(bob.io.base.test_utils.datafile("testimage.hdf5", 'bob.ip.gabor'))
+  gwt = bob.ip.gabor.Transform()
+  trafo_image = gwt(image)
+  graph = bob.ip.gabor.Graph(first=(10,10), last=(40,40), step=(10,10))
+  jets = graph.extract_batch(trafo_image[numpy.newaxis])
+  assert bob.ip.gabor.PhaseCode.words(gwt.number_of_wavelets) == 2
+
+  for threshold in (0., 0.5):
+    phase_code = bob.ip.gabor.PhaseCode(threshold)
+    assert phase_code.magnitude_threshold == threshold
+    codes, masks = phase_code.encode(jets)
+    assert codes.dtype == numpy.uint64 and codes.shape == (1, graph.number_of_nodes, 2)
+    # encoding the responses at the graph nodes gives the same codes
+    graph_codes, graph_masks = phase_code.encode(graph, trafo_image)
+    assert numpy.array_equal(graph_codes, codes[0]) and numpy.array_equal(graph_masks, masks[0])
+    graph_codes, graph_masks = phase_code.encode(jets[0])
+    assert numpy.array_equal(graph_codes, codes[0]) and numpy.array_equal(graph_masks, masks[0])
+
+    for n, jet in enumerate(graph.extract(trafo_image)):
+      code, mask = phase_code.encode(jet)
+      assert numpy.array_equal(code, codes[0,n]) and numpy.array_equal(mask, masks[0,n])
+      # check the bits of all wavelets
+      bits = lambda words, j: int(words[2*j // 64] >> numpy.uint64(2*j % 64)) & 3
+      responses = trafo_image[:, graph.nodes[n][0], graph.nodes[n][1]]
+      for j, response in enumerate(responses):
+        assert bits(code, j) == (response.real >= 0) + 2 * (response.imag >= 0)
+        assert bits(mask, j) == (3 if abs(response) >= threshold * numpy.mean(numpy.abs(responses)) else 0)
+      assert bob.ip.gabor.PhaseCode.similarity(code, mask, code, mask) == 1.
+      assert bob.ip.gabor.PhaseCode.similarity(code, mask, ~code, mask) == 0.
+
+  # with a zero threshold, all 80 bits are valid
+  assert list(masks[0,0]) == [2**64-1, 2**16-1]
+  assert bob.ip.gabor.PhaseCode.similarity(codes[0,0], masks[0,0], codes[0,0], numpy.zeros(2, numpy.uint64)) == 0.
+
+  # the similarities of graphs pool the bits of all nodes
+  gallery = graph.extract_batch(numpy.array([trafo_image, gwt(image[::-1,:].copy()), gwt(image[:,::-1].copy())]))
+  gallery_codes, gallery_masks = phase_code.encode(gallery)
+  similarities = bob.ip.gabor.PhaseCode.similarities(codes[0], masks[0], gallery_codes, gallery_masks)
+  assert similarities.shape == (3,) and similarities[0] == 1.
+  assert similarities[1] < 1. and similarities[2] < 1.
+
+  # the bits are counted identically on all SIMD levels, also in the remaining words of codes longer than the registers
+  random = numpy.random.RandomState(42)
+  code1, mask1, code2, mask2 = random.randint(0, 2**64, size=(4, 7), dtype=numpy.uint64)
+  bit_count = lambda words: numpy.unpackbits(words.view(numpy.uint8)).sum()
+  expected = [1. - float(bit_count((code1[:w] ^ code2[:w]) & mask1[:w] & mask2[:w])) / bit_count(mask1[:w] & mask2[:w]) for w in range(1, 8)]
+  level = bob.ip.gabor.simd_level()
+  try:
+    for simd in bob.ip.gabor.simd_levels():
+      bob.ip.gabor.set_simd_level(simd)
+      for w in range(1, 8):
+        assert bob.ip.gabor.PhaseCode.similarity(code1[:w], mask1[:w], code2[:w], mask2[:w]) == expected[w-1]
+      assert numpy.array_equal(bob.ip.gabor.PhaseCode.similarities(codes[0], masks[0], gallery_codes, gallery_masks), similarities)
+      for i in range(3):
+        assert similarities[i] == bob.ip.gabor.PhaseCode.similarity(codes[0], masks[0], gallery_codes[i], gallery_masks[i])
+  finally:
+    bob.ip.gabor.set_simd_level(level)
+
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.PhaseCode, -1.)
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.PhaseCode.similarity, codes[0,0], masks[0,0], codes[0,0,:1], masks[0,0,:1])
+  nose.tools.assert_raises(TypeError, bob.ip.gabor.PhaseCode.similarity, codes[0,0], masks[0,0], codes[0], masks[0])
+  nose.tools.assert_raises(TypeError, bob.ip.gabor.PhaseCode.similarity, codes[0,0], masks[0,0], codes[0,0], masks[0,0].astype(numpy.int64))
+
+
 def test_jet():
   gwt = bob.ip.gabor.Transform()
 
@@ -348,6 +1124,27 @@ def test_statistics():
   abs_sim = stats(jets[0], False)
   phase_sim = stats(jets[0], True)
   assert numpy.allclose((abs_sim, phase_sim), (-1.097344, -0.792773)), str((abs_sim, phase_sim))
+  # scoring other jets does not influence the results
+  stats.disparity(jets[1]); stats(jets[2], True)
+  assert numpy.allclose(stats.disparity(jets[0]), disparity)
+  assert stats(jets[0], True) == phase_sim
+
+  # the scoring releases the GIL; concurrent scores are identical to the sequential ones, also while the transform is set again
+  expected = [(stats.disparity(jet), stats(jet, True), stats(jet, False)) for jet in jets]
+  results = [None] * 4
+  def score(t):
+    results[t] = [(stats.disparity(jet), stats(jet, True), stats(jet, False)) for i in range(10) for jet in jets]
+  def set_gwt():
+    for i in range(100):
+      stats.gwt = gwt
+  threads = [threading.Thread(target=score, args=(t,)) for t in range(4)] + [threading.Thread(target=set_gwt)]
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+  for result in results:
+    assert result == expected * 10
+  nose.tools.assert_raises(RuntimeError, stats.log_likelihood, bob.ip.gabor.Jet(bob.ip.gabor.Transform().number_of_wavelets), False)
 
   stats.gwt = None
   assert stats.gwt is None
@@ -368,6 +1165,34 @@ def test_statistics():
     assert numpy.allclose(stats.var_phase, new_stats.var_phase)
     assert stats.gwt == new_stats.gwt
 
+    hdf5.close()
+
+    # statistics loaded with the same transform share the generated wavelets, but nothing else
+    stats.gwt = gwt
+    hdf5 = bob.io.base.HDF5File(temp_file, 'w')
+    stats.save(hdf5)
+    hdf5.close()
+
+    hdf5 = bob.io.base.HDF5File(temp_file)
+    first_stats, second_stats = bob.ip.gabor.JetStatistics(hdf5), bob.ip.gabor.JetStatistics(hdf5)
+    assert first_stats.gwt == gwt
+    assert first_stats.gwt.share_wavelets and second_stats.gwt.share_wavelets
+    assert not gwt.share_wavelets
+    first_stats.gwt.engine = 'spatial'
+    assert second_stats.gwt.engine == 'frequency'
+    first_stats.gwt.engine = 'frequency'
+
+    image = numpy.random.random((32,32))
+    bob.ip.gabor.reset_stats()
+    first_trafo = first_stats.gwt(image)
+    second_trafo = second_stats.gwt(image)
+    assert numpy.allclose(first_trafo, second_trafo)
+    if bob.ip.gabor.stats()['enabled']:
+      # only the first transform generated the wavelets
+      assert bob.ip.gabor.stats()['stages']['wavelet_generation']['calls'] == gwt.number_of_wavelets
+    assert gwt.engine == 'frequency'
+    hdf5.close()
+
   finally:
     if os.path.exists(temp_file):
       os.remove(temp_file)
@@ -201,6 +201,17 @@ BOB_TRY
 BOB_CATCH_MEMBER("dc_free", 0)
 }
 
+static auto epsilon_doc = bob::extension::VariableDoc(
+  "epsilon",
+  "float",
+  "The absolute value below which the Gabor wavelet pixels in frequency domain are considered as 0"
+);
+PyObject* PyBobIpGaborTransform_epsilon(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->epsilon());
+BOB_CATCH_MEMBER("epsilon", 0)
+}
+
 static auto waveletFrequencies_doc = bob::extension::VariableDoc(
   "wavelet_frequencies",
   "[(float, float), ...]",
@@ -225,7 +236,10 @@ static auto wavelets_doc = bob::extension::VariableDoc(
   "The list of Gabor wavelets used in this transform",
   ".. note::\n\n  "
   "The wavelets will be generated either by a call to :py:func:`generate_wavelets` or by a call to :py:func:`transform`. "
-  "Before one of these functions is called, no wavelet will be generated."
+  "Before one of these functions is called, no wavelet will be generated. "
+  "When only some wavelets were used by :py:func:`transform` (see its ``indices`` parameter), the remaining wavelets are ``None``.\n\n"
+  "Already generated wavelets of a Gabor wavelet transform with the same parametrization can be assigned, e.g., to avoid generating them again after unpickling, see :py:attr:`pickle_wavelets`; "
+  "all assigned wavelets need to have the same :py:attr:`Wavelet.resolution`, and each wavelet needs to be generated with the parametrization of this transform, i.e., with its :py:attr:`Wavelet.frequency` in :py:attr:`wavelet_frequencies` and with the same :py:attr:`sigma`, :py:attr:`power_of_k`, :py:attr:`dc_free` and :py:attr:`epsilon`."
 );
 PyObject* PyBobIpGaborTransform_wavelets(PyBobIpGaborTransformObject* self, void*){
 BOB_TRY
@@ -234,6 +248,11 @@ BOB_TRY
   // populate a list
   PyObject* list = PyList_New(wavelets.size());
   for (Py_ssize_t i = 0; i < (Py_ssize_t)wavelets.size(); ++i){
+    if (!wavelets[i]){
+      Py_INCREF(Py_None);
+      PyList_SET_ITEM(list, i, Py_None);
+      continue;
+    }
     PyBobIpGaborWaveletObject* wavelet = (PyBobIpGaborWaveletObject*)PyBobIpGaborWavelet_Type.tp_alloc(&PyBobIpGaborWavelet_Type, 0);
     wavelet->cxx = wavelets[i];
     PyList_SET_ITEM(list, i, Py_BuildValue("N", wavelet));
@@ -242,6 +261,199 @@ BOB_TRY
 BOB_CATCH_MEMBER("wavelets", 0)
 }
 
+int PyBobIpGaborTransform_setWavelets(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  if (!PyList_Check(value)){
+    PyErr_Format(PyExc_TypeError, "%s requires a list of Wavelet objects or None for the wavelets member", Py_TYPE(self)->tp_name);
+    return -1;
+  }
+  std::vector<boost::shared_ptr<bob::ip::gabor::Wavelet>> wavelets(PyList_GET_SIZE(value));
+  for (Py_ssize_t i = 0; i < (Py_ssize_t)wavelets.size(); ++i){
+    PyObject* wavelet = PyList_GET_ITEM(value, i);
+    if (wavelet == Py_None) continue;
+    if (!PyBobIpGaborWavelet_Check(wavelet)){
+      PyErr_Format(PyExc_TypeError, "%s requires a list of Wavelet objects or None for the wavelets member", Py_TYPE(self)->tp_name);
+      return -1;
+    }
+    wavelets[i] = reinterpret_cast<PyBobIpGaborWaveletObject*>(wavelet)->cxx;
+  }
+  self->cxx->wavelets(wavelets);
+  return 0;
+BOB_CATCH_MEMBER("wavelets", -1)
+}
+
+static auto engine_doc = bob::extension::VariableDoc(
+  "engine",
+  "str",
+  "The engine that is used to compute the Gabor wavelet transform; one of (``'frequency'``, ``'spatial'``, ``'automatic'``, ``'recursive'``)",
+  "By default, the ``'frequency'`` engine is used, which multiplies the image spectrum with the Gabor wavelets in frequency domain. "
+  "The ``'spatial'`` engine convolves the image with truncated Gabor wavelets in spatial domain, see :py:attr:`spatial_epsilon`. "
+  "The ``'automatic'`` engine estimates the costs of both engines for the given image resolution (and number of positions, see :py:func:`transform_at`) and selects the cheaper one. "
+  "The ``'recursive'`` engine approximates the transform with recursive (IIR) filters, whose costs are linear in the number of pixels and whose accuracy is selected by the :py:attr:`recursive_order`; it is never selected automatically. "
+  "With the default :py:attr:`recursive_order`, its relative deviation from the ``'frequency'`` engine is below :math:`10^{-3}` per layer on the test image, see :py:func:`bob.ip.gabor.engine_report`."
+);
+PyObject* PyBobIpGaborTransform_engine(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", bob::ip::gabor::Transform::engine_to_name(self->cxx->engine()).c_str());
+BOB_CATCH_MEMBER("engine", 0)
+}
+
+int PyBobIpGaborTransform_setEngine(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  const char* name = 0;
+  if (!PyArg_Parse(value, "s", &name)){
+    PyErr_Format(PyExc_TypeError, "%s requires a string for the engine member", Py_TYPE(self)->tp_name);
+    return -1;
+  }
+  self->cxx->engine(bob::ip::gabor::Transform::name_to_engine(name));
+  return 0;
+BOB_CATCH_MEMBER("engine", -1)
+}
+
+static auto spatialEpsilon_doc = bob::extension::VariableDoc(
+  "spatial_epsilon",
+  "float",
+  "The relative value of the Gaussian envelope, at which the Gabor wavelets are truncated in the ``'spatial'`` :py:attr:`engine`; for the ``'recursive'`` engine, it defines the length of the periodic warm-up of the filters",
+  "The absolute difference between the results of the ``'spatial'`` and the ``'frequency'`` engine is bounded by :math:`\\epsilon \\cdot k^{\\lambda} \\cdot (1 + e^{-\\sigma^2/2}) \\cdot \\max |\\mathcal I|`, where :math:`\\max |\\mathcal I|` is the largest absolute pixel value of the image."
+);
+PyObject* PyBobIpGaborTransform_spatialEpsilon(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->spatialEpsilon());
+BOB_CATCH_MEMBER("spatial_epsilon", 0)
+}
+
+int PyBobIpGaborTransform_setSpatialEpsilon(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  double epsilon = PyFloat_AsDouble(value);
+  if (PyErr_Occurred()) return -1;
+  self->cxx->spatialEpsilon(epsilon);
+  return 0;
+BOB_CATCH_MEMBER("spatial_epsilon", -1)
+}
+
+static auto recursiveOrder_doc = bob::extension::VariableDoc(
+  "recursive_order",
+  "int",
+  "The order of the recursive Gaussian filters of the ``'recursive'`` :py:attr:`engine`; one of (4, 6, 8), default 6",
+  "The order selects the accuracy of the recursive filters, whose costs grow linearly with the order. "
+  "The maximum deviation of the recursive Gaussian from the exact one (with peak 1) is 5e-4 for order 4, 8e-6 for order 6 and 1e-7 for order 8. "
+  "The relative RMS error of a trafo layer can be considerably larger, since the remaining filter response far from the wavelet frequency is multiplied with the large low-frequency content of the image. "
+  "On the test image, it is up to 3e-2 for order 4, 1e-3 for order 6 and, with :py:attr:`spatial_epsilon` = 1e-6, 3e-5 for order 8."
+);
+PyObject* PyBobIpGaborTransform_recursiveOrder(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->recursiveOrder());
+BOB_CATCH_MEMBER("recursive_order", 0)
+}
+
+int PyBobIpGaborTransform_setRecursiveOrder(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  int order = PyLong_AsLong(value);
+  if (PyErr_Occurred()) return -1;
+  self->cxx->recursiveOrder(order);
+  return 0;
+BOB_CATCH_MEMBER("recursive_order", -1)
+}
+
+static auto padding_doc = bob::extension::VariableDoc(
+  "padding",
+  "str",
+  "The padding that is applied to the images before the transform; one of (``'none'``, ``'zero'``, ``'reflect'``, ``'symmetric'``)",
+  "By default (``'none'``), the image is transformed in its original resolution. "
+  "Otherwise, the image is padded centrally to the next size that contains only the prime factors 2, 3 and 5, for which the FFT is fast, and the trafo image is cropped back to the original resolution. "
+  "The border is filled with zeros (``'zero'``) or with the mirrored image, either without (``'reflect'``) or with (``'symmetric'``) repeating the border pixels, similarly to :py:func:`numpy.pad`. "
+  "Mirroring the image also reduces the artifacts of the circular convolution at the image borders."
+);
+PyObject* PyBobIpGaborTransform_padding(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", bob::ip::gabor::Transform::padding_to_name(self->cxx->padding()).c_str());
+BOB_CATCH_MEMBER("padding", 0)
+}
+
+int PyBobIpGaborTransform_setPadding(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  const char* name = 0;
+  if (!PyArg_Parse(value, "s", &name)){
+    PyErr_Format(PyExc_TypeError, "%s requires a string for the padding member", Py_TYPE(self)->tp_name);
+    return -1;
+  }
+  self->cxx->padding(bob::ip::gabor::Transform::name_to_padding(name));
+  return 0;
+BOB_CATCH_MEMBER("padding", -1)
+}
+
+static auto shareWavelets_doc = bob::extension::VariableDoc(
+  "share_wavelets",
+  "bool",
+  "Shall the generated wavelets be shared with other Gabor wavelet families?",
+  "When enabled, the wavelets are shared with all other :py:class:`Transform` objects that have the same parametrization and share their wavelets, too, which saves the memory and the time to generate them. "
+  "The transforms loaded by :py:class:`Similarity` and :py:class:`JetStatistics` share their wavelets. "
+  "All other attributes, e.g., the :py:attr:`engine`, are not shared."
+);
+PyObject* PyBobIpGaborTransform_shareWavelets(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("O", self->cxx->shareWavelets() ? Py_True: Py_False);
+BOB_CATCH_MEMBER("share_wavelets", 0)
+}
+
+int PyBobIpGaborTransform_setShareWavelets(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  int share = PyObject_IsTrue(value);
+  if (share < 0) return -1;
+  self->cxx->shareWavelets(share);
+  return 0;
+BOB_CATCH_MEMBER("share_wavelets", -1)
+}
+
+static auto pickleWavelets_doc = bob::extension::VariableDoc(
+  "pickle_wavelets",
+  "bool",
+  "Shall the generated wavelets be pickled with this Gabor wavelet transform?",
+  "By default, only the parametrization of a Gabor wavelet transform is pickled, and the wavelets are generated again when the unpickled transform is first used. "
+  "When enabled, the generated :py:attr:`wavelets` are pickled as well, e.g., to send readily usable Gabor wavelet transforms to the workers of a :py:class:`multiprocessing.Pool`. "
+  "This attribute is pickled, too, and it does not influence the pickling of other transforms."
+);
+PyObject* PyBobIpGaborTransform_pickleWavelets(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("O", self->pickle_wavelets ? Py_True: Py_False);
+BOB_CATCH_MEMBER("pickle_wavelets", 0)
+}
+
+int PyBobIpGaborTransform_setPickleWavelets(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  int pickle = PyObject_IsTrue(value);
+  if (pickle < 0) return -1;
+  self->pickle_wavelets = pickle;
+  return 0;
+BOB_CATCH_MEMBER("pickle_wavelets", -1)
+}
+
+static auto fftBackend_doc = bob::extension::VariableDoc(
+  "fft_backend",
+  "str",
+  "The FFT implementation that is used by the ``'frequency'`` :py:attr:`engine`; one of :py:func:`bob.ip.gabor.fft_backends`",
+  "By default, ``'bob.sp'`` is used. "
+  "The ``'fftw'`` backend uses measured FFTW plans, which are created once per resolution and shared between all transforms and threads; "
+  "see :py:func:`bob.ip.gabor.load_fft_wisdom` to avoid the measurement at startup."
+);
+PyObject* PyBobIpGaborTransform_fftBackend(PyBobIpGaborTransformObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", bob::ip::gabor::FFT::backend_to_name(self->cxx->fftBackend()).c_str());
+BOB_CATCH_MEMBER("fft_backend", 0)
+}
+
+int PyBobIpGaborTransform_setFFTBackend(PyBobIpGaborTransformObject* self, PyObject* value, void*){
+BOB_TRY
+  const char* name = 0;
+  if (!PyArg_Parse(value, "s", &name)){
+    PyErr_Format(PyExc_TypeError, "%s requires a string for the fft_backend member", Py_TYPE(self)->tp_name);
+    return -1;
+  }
+  self->cxx->fftBackend(bob::ip::gabor::FFT::name_to_backend(name));
+  return 0;
+BOB_CATCH_MEMBER("fft_backend", -1)
+}
+
 
 static PyGetSetDef PyBobIpGaborTransform_getseters[] = {
   {
@@ -300,6 +512,13 @@ static PyGetSetDef PyBobIpGaborTransform_getseters[] = {
     dc_free_doc.doc(),
     0
   },
+  {
+    epsilon_doc.name(),
+    (getter)PyBobIpGaborTransform_epsilon,
+    0,
+    epsilon_doc.doc(),
+    0
+  },
   {
     waveletFrequencies_doc.name(),
     (getter)PyBobIpGaborTransform_waveletFrequencies,
@@ -310,10 +529,59 @@ static PyGetSetDef PyBobIpGaborTransform_getseters[] = {
   {
     wavelets_doc.name(),
     (getter)PyBobIpGaborTransform_wavelets,
-    0,
+    (setter)PyBobIpGaborTransform_setWavelets,
     wavelets_doc.doc(),
     0
   },
+  {
+    engine_doc.name(),
+    (getter)PyBobIpGaborTransform_engine,
+    (setter)PyBobIpGaborTransform_setEngine,
+    engine_doc.doc(),
+    0
+  },
+  {
+    spatialEpsilon_doc.name(),
+    (getter)PyBobIpGaborTransform_spatialEpsilon,
+    (setter)PyBobIpGaborTransform_setSpatialEpsilon,
+    spatialEpsilon_doc.doc(),
+    0
+  },
+  {
+    recursiveOrder_doc.name(),
+    (getter)PyBobIpGaborTransform_recursiveOrder,
+    (setter)PyBobIpGaborTransform_setRecursiveOrder,
+    recursiveOrder_doc.doc(),
+    0
+  },
+  {
+    padding_doc.name(),
+    (getter)PyBobIpGaborTransform_padding,
+    (setter)PyBobIpGaborTransform_setPadding,
+    padding_doc.doc(),
+    0
+  },
+  {
+    shareWavelets_doc.name(),
+    (getter)PyBobIpGaborTransform_shareWavelets,
+    (setter)PyBobIpGaborTransform_setShareWavelets,
+    shareWavelets_doc.doc(),
+    0
+  },
+  {
+    pickleWavelets_doc.name(),
+    (getter)PyBobIpGaborTransform_pickleWavelets,
+    (setter)PyBobIpGaborTransform_setPickleWavelets,
+    pickleWavelets_doc.doc(),
+    0
+  },
+  {
+    fftBackend_doc.name(),
+    (getter)PyBobIpGaborTransform_fftBackend,
+    (setter)PyBobIpGaborTransform_setFFTBackend,
+    fftBackend_doc.doc(),
+    0
+  },
   {0}  /* Sentinel */
 };
 
@@ -330,25 +598,45 @@ static auto transform_doc = bob::extension::FunctionDoc(
   ".. math::\n\n"
   "   \\forall j \\forall \\vec \\omega : \\mathcal T_{\\vec k_j}(\\vec \\omega) = \\mathcal I(\\vec \\omega) \\cdot \\psi_{\\vec k_j}(\\vec \\omega)\n\n"
   "Both the input image and the output are expected to be in spatial domain, so **don't** perform an FFT on the input image before calling this function.\n\n"
+  "Instead of an image, a :py:class:`Spectrum` computed by :py:meth:`spectrum` can be given, which might have been computed by another :py:class:`Transform` with the same :py:attr:`padding`. "
+  "In this case, the wavelets are always applied in frequency domain, regardless of the :py:attr:`engine`.\n\n"
+  "When only some of the wavelets are required, their ``indices`` can be given (see :py:meth:`wavelet_indices`). "
+  "Then, only the selected wavelets are generated and applied, and the output contains only ``len(indices)`` layers, in the given order.\n\n"
   ".. note::\n\n  The function `__call__` is a synonym for this function.",
   true
 )
-.add_prototype("input, [output]", "output")
-.add_parameter("input", "array_like (2D)", "The image in spatial domain that should be transformed")
-.add_parameter("output", "array_like (complex, 3D)", "The transformed image in spatial domain that should contain the transformed image; if given, must have shape (:py:attr:`number_of_wavelets`, input.shape[0], input.shape[1])")
-.add_return("output", "array_like (complex, 3D)", "The transformed image in spatial domain that will contain the transformed image; will have shape (:py:attr:`number_of_wavelets`, input.shape[0], input.shape[1]); identical to the ``output`` parameter, if given")
+.add_prototype("input, [output], [indices]", "output")
+.add_parameter("input", "array_like (2D) or :py:class:`bob.ip.gabor.Spectrum`", "The image in spatial domain that should be transformed, or its spectrum")
+.add_parameter("output", "array_like (complex, 3D)", "The transformed image in spatial domain that should contain the transformed image; if given, must have shape (:py:attr:`number_of_wavelets`, input.shape[0], input.shape[1]), or (len(indices), input.shape[0], input.shape[1])")
+.add_parameter("indices", "[int]", "[Default: all wavelets] The indices of the wavelets that should be applied")
+.add_return("output", "array_like (complex, 3D)", "The transformed image in spatial domain that will contain the transformed image; will have shape (:py:attr:`number_of_wavelets`, input.shape[0], input.shape[1]), or (len(indices), input.shape[0], input.shape[1]); identical to the ``output`` parameter, if given")
 ;
 
+// converts the given sequence of integers into a vector
+static bool convert_indices(PyObject* o, std::vector<int>& indices){
+  PyObject* seq = PySequence_Fast(o, "the indices must be a sequence of integers");
+  if (!seq) return false;
+  auto seq_ = make_safe(seq);
+  Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+  indices.resize(size);
+  for (Py_ssize_t i = 0; i < size; ++i){
+    indices[i] = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+    if (PyErr_Occurred()) return false;
+  }
+  return true;
+}
+
 static PyObject* PyBobIpGaborTransform_transform(PyBobIpGaborTransformObject* self, PyObject* args, PyObject* kwargs) {
 BOB_TRY
   char** kwlist = transform_doc.kwlist();
 
+  PyObject* object = 0;
   PyBlitzArrayObject* input = 0;
   PyBlitzArrayObject* output = 0;
+  PyObject* index_list = 0;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O&", kwlist, &PyBlitzArray_Converter, &input, &PyBlitzArray_OutputConverter, &output)) return 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O&O", kwlist, &object, &PyBlitzArray_OutputConverter, &output, &index_list)) return 0;
 
-  auto input_ = make_safe(input);
   auto output_ = make_xsafe(output);
 
   if (output && output->type_num != NPY_COMPLEX128) {
@@ -356,6 +644,40 @@ BOB_TRY
     return 0;
   }
 
+  // the wavelets to apply
+  std::vector<int> indices;
+  if (index_list && index_list != Py_None){
+    if (!convert_indices(index_list, indices)) return 0;
+  } else {
+    indices.resize(self->cxx->numberOfWavelets());
+    for (int i = 0; i < (int)indices.size(); ++i) indices[i] = i;
+  }
+  const Py_ssize_t layers = indices.size();
+
+  if (PyBobIpGaborSpectrum_Check(object)){
+    // transform the given spectrum
+    const bob::ip::gabor::Spectrum& spectrum = *reinterpret_cast<PyBobIpGaborSpectrumObject*>(object)->cxx;
+    if (output){
+      if (output->ndim != 3) {
+        PyErr_Format(PyExc_RuntimeError, "`%s' only accepts 3-dimensional arrays for `output' (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, output->ndim);
+        return 0;
+      }
+      if (output->shape[0] != layers || output->shape[1] != spectrum.height() || output->shape[2] != spectrum.width()){
+        PyErr_Format(PyExc_RuntimeError, "The shape of the output image should be (%" PY_FORMAT_SIZE_T "d,%d,%d), but is (%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d)", layers, spectrum.height(), spectrum.width(), output->shape[0], output->shape[1], output->shape[2]);
+        return 0;
+      }
+    } else {
+      Py_ssize_t osize[3] = {layers, spectrum.height(), spectrum.width()};
+      output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_COMPLEX128, 3, osize);
+      output_ = make_safe(output);
+    }
+    self->cxx->transform(spectrum, indices, *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
+    return PyBlitzArray_AsNumpyArray(output, 0);
+  }
+
+  if (!PyBlitzArray_Converter(object, &input)) return 0;
+  auto input_ = make_safe(input);
+
   if (input->ndim != 2) {
     PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, input->ndim);
     return 0;
@@ -366,30 +688,30 @@ BOB_TRY
       PyErr_Format(PyExc_RuntimeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, output->ndim);
       return 0;
     }
-    if (output->shape[0] != self->cxx->numberOfWavelets() || output->shape[1] != input->shape[0] || output->shape[2] != input->shape[1]){
-      PyErr_Format(PyExc_RuntimeError, "The shape of the output image should be (%d,%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d), but is (%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d)", self->cxx->numberOfWavelets(), input->shape[0], input->shape[0], output->shape[0], output->shape[1], output->shape[2]);
+    if (output->shape[0] != layers || output->shape[1] != input->shape[0] || output->shape[2] != input->shape[1]){
+      PyErr_Format(PyExc_RuntimeError, "The shape of the output image should be (%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d), but is (%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d)", layers, input->shape[0], input->shape[1], output->shape[0], output->shape[1], output->shape[2]);
       return 0;
     }
   }
 
   /** if ``output`` was not pre-allocated, do it now **/
   if (!output) {
-    Py_ssize_t osize[3] = {self->cxx->numberOfWavelets(), input->shape[0], input->shape[1]};
+    Py_ssize_t osize[3] = {layers, input->shape[0], input->shape[1]};
     output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_COMPLEX128, 3, osize);
     output_ = make_safe(output);
   }
 
   switch (input->type_num){
     case NPY_UINT8:
-      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(input),
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(input), indices,
           *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
       break;
     case NPY_FLOAT64:
-      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<double,2>(input),
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<double,2>(input), indices,
           *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
       break;
     case NPY_COMPLEX128:
-      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(input),
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(input), indices,
           *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
       break;
     default:
@@ -401,6 +723,382 @@ BOB_CATCH_MEMBER("transform", 0)
 }
 
 
+static auto waveletIndices_doc = bob::extension::FunctionDoc(
+  "wavelet_indices",
+  "Returns the indices of the wavelets with the given scales and directions",
+  "The returned indices can be passed to :py:meth:`transform` to compute only the selected wavelets. "
+  "The wavelet with scale :math:`\\zeta` and direction :math:`\\nu` has index :math:`\\zeta \\cdot` :py:attr:`number_of_directions` :math:`+ \\nu`, and the indices are returned in this order.",
+  true
+)
+.add_prototype("[scales], [directions]", "indices")
+.add_parameter("scales", "[int] or ``None``", "[Default: all scales] The indices of the scales, in the range [0, :py:attr:`number_of_scales`[")
+.add_parameter("directions", "[int] or ``None``", "[Default: all directions] The indices of the directions, in the range [0, :py:attr:`number_of_directions`[")
+.add_return("indices", "[int]", "The indices of the selected wavelets")
+;
+
+static PyObject* PyBobIpGaborTransform_waveletIndices(PyBobIpGaborTransformObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = waveletIndices_doc.kwlist();
+
+  PyObject* scale_list = 0,* direction_list = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OO", kwlist, &scale_list, &direction_list)) return 0;
+
+  std::vector<int> scales, directions;
+  if (scale_list && scale_list != Py_None){
+    if (!convert_indices(scale_list, scales)) return 0;
+  } else {
+    for (int s = 0; s < self->cxx->numberOfScales(); ++s) scales.push_back(s);
+  }
+  if (direction_list && direction_list != Py_None){
+    if (!convert_indices(direction_list, directions)) return 0;
+  } else {
+    for (int d = 0; d < self->cxx->numberOfDirections(); ++d) directions.push_back(d);
+  }
+
+  std::vector<int> indices = self->cxx->waveletIndices(scales, directions);
+  PyObject* list = PyList_New(indices.size());
+  for (Py_ssize_t i = 0; i < (Py_ssize_t)indices.size(); ++i){
+    PyList_SET_ITEM(list, i, Py_BuildValue("i", indices[i]));
+  }
+  return list;
+BOB_CATCH_MEMBER("wavelet_indices", 0)
+}
+
+
+static auto spectrum_doc = bob::extension::FunctionDoc(
+  "spectrum",
+  "This function computes the spectrum (the FFT) of the given image, which can be transformed by several Gabor wavelet families",
+  "The image is padded according to the :py:attr:`padding` before the FFT is computed. "
+  "The resulting :py:class:`Spectrum` can be passed to :py:meth:`transform` of this or any other :py:class:`Transform` with the same :py:attr:`padding`, "
+  "so that the forward FFT is computed only once when several wavelet families are applied to the same image.",
+  true
+)
+.add_prototype("input, [spectrum]", "spectrum")
+.add_parameter("input", "array_like (2D)", "The image in spatial domain")
+.add_parameter("spectrum", ":py:class:`bob.ip.gabor.Spectrum`", "If given, the spectrum will be computed into this object, re-using its memory")
+.add_return("spectrum", ":py:class:`bob.ip.gabor.Spectrum`", "The spectrum of the image; identical to the ``spectrum`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborTransform_spectrum(PyBobIpGaborTransformObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = spectrum_doc.kwlist();
+
+  PyBlitzArrayObject* input = 0;
+  PyBobIpGaborSpectrumObject* spectrum = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O!", kwlist, &PyBlitzArray_Converter, &input, &PyBobIpGaborSpectrum_Type, &spectrum)) return 0;
+
+  auto input_ = make_safe(input);
+
+  if (input->ndim != 2) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, input->ndim);
+    return 0;
+  }
+
+  if (spectrum){
+    Py_INCREF(spectrum);
+  } else {
+    spectrum = reinterpret_cast<PyBobIpGaborSpectrumObject*>(PyBobIpGaborSpectrum_Type.tp_alloc(&PyBobIpGaborSpectrum_Type, 0));
+    spectrum->cxx.reset(new bob::ip::gabor::Spectrum());
+  }
+  auto spectrum_ = make_safe(spectrum);
+
+  switch (input->type_num){
+    case NPY_UINT8:
+      self->cxx->spectrum(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(input), *spectrum->cxx);
+      break;
+    case NPY_FLOAT64:
+      self->cxx->spectrum(*PyBlitzArrayCxx_AsBlitz<double,2>(input), *spectrum->cxx);
+      break;
+    case NPY_COMPLEX128:
+      self->cxx->spectrum(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(input), *spectrum->cxx);
+      break;
+    default:
+      PyErr_Format(PyExc_RuntimeError, "`%s' only supports arrays of type uint8, float and complex for array `input'", Py_TYPE(self)->tp_name);
+      return 0;
+  }
+  return Py_BuildValue("O", spectrum);
+BOB_CATCH_MEMBER("spectrum", 0)
+}
+
+
+static auto transformAt_doc = bob::extension::FunctionDoc(
+  "transform_at",
+  "This function computes the Gabor wavelet responses of the given input image only at the given positions",
+  "The input image must be of two dimensions and might be of any supported type: ``uint8``, ``float`` or ``complex``. "
+  "The responses are identical to ``transform(input)[:, y, x]`` for all positions ``(y, x)``. "
+  "When the :py:attr:`engine` is ``'spatial'`` (or ``'automatic'`` and the number of positions is small), only the requested responses are computed.",
+  true
+)
+.add_prototype("input, positions, [output]", "output")
+.add_parameter("input", "array_like (2D)", "The image in spatial domain that should be transformed")
+.add_parameter("positions", "[(int, int)]", "The positions (y, x) inside the image, where the responses should be computed")
+.add_parameter("output", "array_like (complex, 2D)", "The responses of the Gabor wavelets; if given, must have shape (len(positions), :py:attr:`number_of_wavelets`)")
+.add_return("output", "array_like (complex, 2D)", "The responses of the Gabor wavelets of shape (len(positions), :py:attr:`number_of_wavelets`); identical to the ``output`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborTransform_transformAt(PyBobIpGaborTransformObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = transformAt_doc.kwlist();
+
+  PyBlitzArrayObject* input = 0;
+  PyObject* list = 0;
+  PyBlitzArrayObject* output = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O!|O&", kwlist, &PyBlitzArray_Converter, &input, &PyList_Type, &list, &PyBlitzArray_OutputConverter, &output)) return 0;
+
+  auto input_ = make_safe(input);
+  auto output_ = make_xsafe(output);
+
+  if (input->ndim != 2) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, input->ndim);
+    return 0;
+  }
+
+  std::vector<blitz::TinyVector<int,2>> positions(PyList_GET_SIZE(list));
+  Py_ssize_t i = 0;
+  for (auto pit = positions.begin(); pit != positions.end(); ++pit, ++i){
+    // check that the object inside the list is a two-element int tuple
+    if (!PyArg_ParseTuple(PyList_GET_ITEM(list, i), "ii", &((*pit)[0]), &((*pit)[1]))){
+      PyErr_Format(PyExc_TypeError, "`%s' requires only tuples of two integral positions in the positions list", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  }
+
+  if (output){
+    if (output->type_num != NPY_COMPLEX128 || output->ndim != 2) {
+      PyErr_Format(PyExc_TypeError, "`%s' only supports 2D 128-bit complex arrays for output array `output'", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    if (output->shape[0] != (Py_ssize_t)positions.size() || output->shape[1] != self->cxx->numberOfWavelets()){
+      PyErr_Format(PyExc_RuntimeError, "The shape of the output array should be (%" PY_FORMAT_SIZE_T "d,%d), but is (%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d)", (Py_ssize_t)positions.size(), self->cxx->numberOfWavelets(), output->shape[0], output->shape[1]);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[2] = {(Py_ssize_t)positions.size(), self->cxx->numberOfWavelets()};
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_COMPLEX128, 2, osize);
+    output_ = make_safe(output);
+  }
+
+  switch (input->type_num){
+    case NPY_UINT8:
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(input), positions,
+          *PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(output));
+      break;
+    case NPY_FLOAT64:
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<double,2>(input), positions,
+          *PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(output));
+      break;
+    case NPY_COMPLEX128:
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(input), positions,
+          *PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(output));
+      break;
+    default:
+      PyErr_Format(PyExc_RuntimeError, "`%s' only supports arrays of type uint8, float and complex for array `input'", Py_TYPE(self)->tp_name);
+      return 0;
+  }
+  return PyBlitzArray_AsNumpyArray(output, 0);
+BOB_CATCH_MEMBER("transform_at", 0)
+}
+
+
+static auto transformRoi_doc = bob::extension::FunctionDoc(
+  "transform_roi",
+  "This function computes the Gabor wavelet transform of the given input image only inside the given region of interest",
+  "The input image must be of two dimensions and might be of any supported type: ``uint8``, ``float`` or ``complex``. "
+  "The result is identical to ``transform(input)[:, y:y+height, x:x+width]``, i.e., the complete image is used for filtering. "
+  "In frequency domain, the inverse FFTs are pruned to the region of interest; "
+  "when the :py:attr:`engine` is ``'spatial'`` (or ``'automatic'`` and the region is small), only the responses inside the region are computed.",
+  true
+)
+.add_prototype("input, roi, [output]", "output")
+.add_parameter("input", "array_like (2D)", "The image in spatial domain that should be transformed")
+.add_parameter("roi", "(int, int, int, int)", "The region of interest (y, x, height, width) inside the image")
+.add_parameter("output", "array_like (complex, 3D)", "The transformed region of interest; if given, must have shape (:py:attr:`number_of_wavelets`, height, width)")
+.add_return("output", "array_like (complex, 3D)", "The transformed region of interest of shape (:py:attr:`number_of_wavelets`, height, width); identical to the ``output`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborTransform_transformRoi(PyBobIpGaborTransformObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = transformRoi_doc.kwlist();
+
+  PyBlitzArrayObject* input = 0;
+  PyBlitzArrayObject* output = 0;
+  blitz::TinyVector<int,2> offset;
+  Py_ssize_t height, width;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(iinn)|O&", kwlist, &PyBlitzArray_Converter, &input, &offset[0], &offset[1], &height, &width, &PyBlitzArray_OutputConverter, &output)) return 0;
+
+  auto input_ = make_safe(input);
+  auto output_ = make_xsafe(output);
+
+  if (input->ndim != 2) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, input->ndim);
+    return 0;
+  }
+  if (height <= 0 || width <= 0) {
+    PyErr_Format(PyExc_RuntimeError, "`%s' requires a region of interest with positive height and width", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  if (output){
+    if (output->type_num != NPY_COMPLEX128 || output->ndim != 3) {
+      PyErr_Format(PyExc_TypeError, "`%s' only supports 3D 128-bit complex arrays for output array `output'", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    if (output->shape[0] != self->cxx->numberOfWavelets() || output->shape[1] != height || output->shape[2] != width){
+      PyErr_Format(PyExc_RuntimeError, "The shape of the output array should be (%d,%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d), but is (%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d,%" PY_FORMAT_SIZE_T "d)", self->cxx->numberOfWavelets(), height, width, output->shape[0], output->shape[1], output->shape[2]);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[3] = {self->cxx->numberOfWavelets(), height, width};
+    output = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_COMPLEX128, 3, osize);
+    output_ = make_safe(output);
+  }
+
+  switch (input->type_num){
+    case NPY_UINT8:
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(input), offset,
+          *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
+      break;
+    case NPY_FLOAT64:
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<double,2>(input), offset,
+          *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
+      break;
+    case NPY_COMPLEX128:
+      self->cxx->transform(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(input), offset,
+          *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
+      break;
+    default:
+      PyErr_Format(PyExc_RuntimeError, "`%s' only supports arrays of type uint8, float and complex for array `input'", Py_TYPE(self)->tp_name);
+      return 0;
+  }
+  return PyBlitzArray_AsNumpyArray(output, 0);
+BOB_CATCH_MEMBER("transform_roi", 0)
+}
+
+
+static auto transformTiled_doc = bob::extension::FunctionDoc(
+  "transform_tiled",
+  "This function computes the Gabor wavelet transform of a large image tile by tile, using only memory bounded by the tile size",
+  "Each tile is extended by a margin of the size of the largest truncated wavelet (see :py:attr:`spatial_epsilon`), which is taken from the neighboring tiles (overlap-save). "
+  "Outside of the image, the margin is filled according to :py:attr:`padding`, or periodically when no padding is selected. "
+  "The tile size is enlarged such that the extended tiles have FFT friendly sizes. "
+  "Hence, when no :py:attr:`padding` is selected, the result deviates from :py:func:`transform` by no more than the truncation error of the wavelets.\n\n"
+  ".. note::\n\n  With :py:attr:`padding`, the result corresponds to the transform of the image that is padded by the margin on each side. "
+  "In contrast, :py:func:`transform` pads the image only up to an FFT friendly size and wraps around periodically beyond, so that both results differ close to the image borders.\n\n"
+  "The ``sink`` parameter defines, what happens to the transformed tiles:\n\n"
+  "* an array_like (complex, 3D) of shape (:py:attr:`number_of_wavelets`, input.shape[0], input.shape[1]), e.g., a :py:class:`numpy.memmap`: the tiles are written into this array, which is returned\n"
+  "* a :py:class:`bob.ip.gabor.Graph`: only the Gabor jets at the nodes of the graph are kept and returned as a list of :py:class:`bob.ip.gabor.Jet`\n"
+  "* a callable: it is called for each tile as ``sink(offset, trafo_tile)``, where ``offset`` is the (y, x) position of the tile in the image; ``None`` is returned",
+  true
+)
+.add_prototype("input, sink, [tile_size]", "result")
+.add_parameter("input", "array_like (2D)", "The image in spatial domain that should be transformed")
+.add_parameter("sink", "array_like (complex, 3D) or :py:class:`bob.ip.gabor.Graph` or callable", "The destination of the transformed tiles, see above")
+.add_parameter("tile_size", "(int, int)", "[default: ``(256, 256)``] The minimum size (height, width) of the tiles, excluding the margin")
+.add_return("result", "array_like (complex, 3D) or [:py:class:`bob.ip.gabor.Jet`] or None", "The output array, the list of Gabor jets or ``None``, depending on the ``sink``")
+;
+
+// signals that a Python error was set inside a tile sink
+struct PythonError {};
+
+template <typename T>
+static void transformTiled(bob::ip::gabor::Transform& transform, PyBlitzArrayObject* input, const blitz::TinyVector<int,2>& tile_size, PyObject* sink, PyBlitzArrayObject* output, bool graph_sink, const std::vector<blitz::TinyVector<int,2>>& positions, blitz::Array<std::complex<double>,2>& responses){
+  const blitz::Array<T,2>& image = *PyBlitzArrayCxx_AsBlitz<T,2>(input);
+  if (output){
+    transform.transformTiled(image, tile_size, *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(output));
+  } else if (graph_sink){
+    transform.transformTiled(image, tile_size, positions, responses);
+  } else {
+    transform.transformTiled(image, tile_size, bob::ip::gabor::Transform::TileSink(
+      [sink](const blitz::TinyVector<int,2>& offset, const blitz::Array<std::complex<double>,3>& trafo_tile){
+        // the tile is only valid during this call, so we hand out a copy
+        blitz::Array<std::complex<double>,3> copy(trafo_tile.shape());
+        copy = trafo_tile;
+        PyObject* result = PyObject_CallFunction(sink, "(ii)N", offset[0], offset[1], PyBlitzArrayCxx_AsNumpy(copy));
+        if (!result) throw PythonError();
+        Py_DECREF(result);
+      }
+    ));
+  }
+}
+
+static PyObject* PyBobIpGaborTransform_transformTiled(PyBobIpGaborTransformObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = transformTiled_doc.kwlist();
+
+  PyBlitzArrayObject* input = 0;
+  PyObject* sink = 0;
+  blitz::TinyVector<int,2> tile_size(256, 256);
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O|(ii)", kwlist, &PyBlitzArray_Converter, &input, &sink, &tile_size[0], &tile_size[1])) return 0;
+
+  auto input_ = make_safe(input);
+
+  if (input->ndim != 2) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, input->ndim);
+    return 0;
+  }
+
+  PyBlitzArrayObject* output = 0;
+  std::vector<blitz::TinyVector<int,2>> positions;
+  blitz::Array<std::complex<double>,2> responses;
+
+  const bool graph_sink = PyBobIpGaborGraph_Check(sink);
+  if (graph_sink){
+    positions = reinterpret_cast<PyBobIpGaborGraphObject*>(sink)->cxx->nodes();
+    // a graph without nodes does not need any transform
+    if (positions.empty()) return PyList_New(0);
+    responses.resize(positions.size(), self->cxx->numberOfWavelets());
+  } else if (!PyCallable_Check(sink)){
+    if (!PyBlitzArray_OutputConverter(sink, &output)) return 0;
+    if (output->type_num != NPY_COMPLEX128 || output->ndim != 3) {
+      Py_DECREF(output);
+      PyErr_Format(PyExc_TypeError, "`%s' only supports 3D 128-bit complex arrays for output array `sink'", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  }
+  auto output_ = make_xsafe(output);
+
+  try {
+    switch (input->type_num){
+      case NPY_UINT8:
+        transformTiled<uint8_t>(*self->cxx, input, tile_size, sink, output, graph_sink, positions, responses);
+        break;
+      case NPY_FLOAT64:
+        transformTiled<double>(*self->cxx, input, tile_size, sink, output, graph_sink, positions, responses);
+        break;
+      case NPY_COMPLEX128:
+        transformTiled<std::complex<double>>(*self->cxx, input, tile_size, sink, output, graph_sink, positions, responses);
+        break;
+      default:
+        PyErr_Format(PyExc_RuntimeError, "`%s' only supports arrays of type uint8, float and complex for array `input'", Py_TYPE(self)->tp_name);
+        return 0;
+    }
+  } catch (PythonError&){
+    // the error was already set by the sink
+    return 0;
+  }
+
+  if (output) return PyBlitzArray_AsNumpyArray(output, 0);
+
+  if (graph_sink){
+    // create one Gabor jet for each node of the graph
+    PyObject* jets = PyList_New(positions.size());
+    for (Py_ssize_t i = 0; i < (Py_ssize_t)positions.size(); ++i){
+      PyBobIpGaborJetObject* jet = reinterpret_cast<PyBobIpGaborJetObject*>(PyBobIpGaborJet_Type.tp_alloc(&PyBobIpGaborJet_Type, 0));
+      jet->cxx.reset(new bob::ip::gabor::Jet(responses(i, blitz::Range::all()), true));
+      PyList_SET_ITEM(jets, i, Py_BuildValue("N",jet));
+    }
+    return jets;
+  }
+
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("transform_tiled", 0)
+}
+
+
 static auto generateWavelets_doc = bob::extension::FunctionDoc(
   "generate_wavelets",
   "This function generates the Gabor wavelets for the given image resolution",
@@ -479,6 +1177,36 @@ static PyMethodDef PyBobIpGaborTransform_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     transform_doc.doc()
   },
+  {
+    waveletIndices_doc.name(),
+    (PyCFunction)PyBobIpGaborTransform_waveletIndices,
+    METH_VARARGS|METH_KEYWORDS,
+    waveletIndices_doc.doc()
+  },
+  {
+    spectrum_doc.name(),
+    (PyCFunction)PyBobIpGaborTransform_spectrum,
+    METH_VARARGS|METH_KEYWORDS,
+    spectrum_doc.doc()
+  },
+  {
+    transformAt_doc.name(),
+    (PyCFunction)PyBobIpGaborTransform_transformAt,
+    METH_VARARGS|METH_KEYWORDS,
+    transformAt_doc.doc()
+  },
+  {
+    transformRoi_doc.name(),
+    (PyCFunction)PyBobIpGaborTransform_transformRoi,
+    METH_VARARGS|METH_KEYWORDS,
+    transformRoi_doc.doc()
+  },
+  {
+    transformTiled_doc.name(),
+    (PyCFunction)PyBobIpGaborTransform_transformTiled,
+    METH_VARARGS|METH_KEYWORDS,
+    transformTiled_doc.doc()
+  },
   {
     generateWavelets_doc.name(),
     (PyCFunction)PyBobIpGaborTransform_generateWavelets,
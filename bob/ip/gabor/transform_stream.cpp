@@ -0,0 +1,316 @@
+/**
+ * @brief Bindings for the asynchronous Gabor wavelet transform of streams of images
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto TransformStream_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".TransformStream",
+  "Computes the Gabor wavelet transform of a stream of images (e.g., video frames) asynchronously",
+  "Frames are added with :py:meth:`push` and transformed in a two-stage pipeline: a dedicated thread computes the :py:class:`Spectrum` of each frame, and the inverse FFTs of the wavelets of one frame are spread over several worker threads. "
+  "The pipeline is double-buffered, i.e., the spectrum of the next frame is computed while the inverse FFTs of the current frame are still running, also with a single worker thread. "
+  "Each thread uses its own copy of the given :py:class:`Transform`, but all share the generated wavelets. "
+  "When the :py:attr:`Transform.engine` transforms the frames in spatial domain or with recursive filters, each frame is passed to a single worker as a whole. "
+  "The results are returned by :py:meth:`pop` in the order, in which the frames were pushed. "
+  "When :py:attr:`capacity` frames have been pushed, but not popped, :py:meth:`push` blocks until the oldest result is popped.\n\n"
+  "Both :py:meth:`push` and :py:meth:`pop` release the GIL while waiting, so that several cameras can be served from different Python threads."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a stream for the given Gabor wavelet transform",
+    "If a ``graph`` is given, only the Gabor jets at the nodes of the graph are computed and returned by :py:meth:`pop`; otherwise, the complete trafo images are returned.",
+    true
+  )
+  .add_prototype("transform, [graph], [number_of_threads], [capacity]", "")
+  .add_parameter("transform", ":py:class:`bob.ip.gabor.Transform`", "The Gabor wavelet transform that should be applied to the frames")
+  .add_parameter("graph", ":py:class:`bob.ip.gabor.Graph` or ``None``", "[default: ``None``] The graph defining the positions, where Gabor jets should be extracted")
+  .add_parameter("number_of_threads", "int", "[default: ``0``] The number of worker threads that compute the inverse FFTs (in addition to the thread computing the spectra); if 0, one thread per CPU core is used")
+  .add_parameter("capacity", "int", "[default: ``0``] The maximum number of frames that are pushed but not popped; if 0, twice the number of threads")
+);
+
+static int PyBobIpGaborTransformStream_init(PyBobIpGaborTransformStreamObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = TransformStream_doc.kwlist();
+
+  PyBobIpGaborTransformObject* transform;
+  PyObject* graph = 0;
+  int number_of_threads = 0, capacity = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|Oii", kwlist, &PyBobIpGaborTransform_Type, &transform, &graph, &number_of_threads, &capacity)) return -1;
+
+  if (graph && graph != Py_None){
+    if (!PyBobIpGaborGraph_Check(graph)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `graph' parameter to be of type bob.ip.gabor.Graph", Py_TYPE(self)->tp_name);
+      return -1;
+    }
+    self->cxx.reset(new bob::ip::gabor::TransformStream(*transform->cxx, *reinterpret_cast<PyBobIpGaborGraphObject*>(graph)->cxx, number_of_threads, capacity));
+  } else {
+    self->cxx.reset(new bob::ip::gabor::TransformStream(*transform->cxx, number_of_threads, capacity));
+  }
+  return 0;
+BOB_CATCH_MEMBER("cannot create TransformStream", -1)
+}
+
+static void PyBobIpGaborTransformStream_delete(PyBobIpGaborTransformStreamObject* self) {
+  {
+    // the worker threads might need some time to finish
+    ReleaseGIL gil;
+    self->cxx.reset();
+  }
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborTransformStream_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborTransformStream_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto numberOfThreads_doc = bob::extension::VariableDoc(
+  "number_of_threads",
+  "int",
+  "The number of worker threads of this stream, not counting the thread that computes the spectra"
+);
+PyObject* PyBobIpGaborTransformStream_numberOfThreads(PyBobIpGaborTransformStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfThreads());
+BOB_CATCH_MEMBER("number_of_threads", 0)
+}
+
+static auto capacity_doc = bob::extension::VariableDoc(
+  "capacity",
+  "int",
+  "The maximum number of frames that can be pushed, but not yet popped"
+);
+PyObject* PyBobIpGaborTransformStream_capacity(PyBobIpGaborTransformStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->capacity());
+BOB_CATCH_MEMBER("capacity", 0)
+}
+
+static auto pending_doc = bob::extension::VariableDoc(
+  "pending",
+  "int",
+  "The number of frames that were pushed, but not yet popped"
+);
+PyObject* PyBobIpGaborTransformStream_pending(PyBobIpGaborTransformStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->pending());
+BOB_CATCH_MEMBER("pending", 0)
+}
+
+static PyGetSetDef PyBobIpGaborTransformStream_getseters[] = {
+  {
+    numberOfThreads_doc.name(),
+    (getter)PyBobIpGaborTransformStream_numberOfThreads,
+    0,
+    numberOfThreads_doc.doc(),
+    0
+  },
+  {
+    capacity_doc.name(),
+    (getter)PyBobIpGaborTransformStream_capacity,
+    0,
+    capacity_doc.doc(),
+    0
+  },
+  {
+    pending_doc.name(),
+    (getter)PyBobIpGaborTransformStream_pending,
+    0,
+    pending_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto push_doc = bob::extension::FunctionDoc(
+  "push",
+  "Adds the given frame to the stream",
+  "The frame must be of two dimensions and might be of any supported type: ``uint8``, ``float`` or ``complex``; it is copied, so it can be re-used afterwards. "
+  "When :py:attr:`capacity` frames are pending, this function blocks until :py:meth:`pop` is called.",
+  true
+)
+.add_prototype("frame")
+.add_parameter("frame", "array_like (2D)", "The image in spatial domain that should be transformed")
+;
+
+static PyObject* PyBobIpGaborTransformStream_push(PyBobIpGaborTransformStreamObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = push_doc.kwlist();
+
+  PyBlitzArrayObject* frame = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBlitzArray_Converter, &frame)) return 0;
+  auto frame_ = make_safe(frame);
+
+  if (frame->ndim != 2) {
+    PyErr_Format(PyExc_TypeError, "`%s' only accepts 2-dimensional arrays (not %" PY_FORMAT_SIZE_T "dD arrays)", Py_TYPE(self)->tp_name, frame->ndim);
+    return 0;
+  }
+
+  // copy the frame while holding the GIL
+  blitz::Array<std::complex<double>,2> image;
+  switch (frame->type_num){
+    case NPY_UINT8:
+      image.reference(bob::core::array::cast<std::complex<double> >(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(frame)));
+      break;
+    case NPY_FLOAT64:
+      image.reference(bob::core::array::cast<std::complex<double> >(*PyBlitzArrayCxx_AsBlitz<double,2>(frame)));
+      break;
+    case NPY_COMPLEX128:
+      image.resize(frame->shape[0], frame->shape[1]);
+      image = *PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(frame);
+      break;
+    default:
+      PyErr_Format(PyExc_RuntimeError, "`%s' only supports arrays of type uint8, float and complex for array `frame'", Py_TYPE(self)->tp_name);
+      return 0;
+  }
+
+  {
+    ReleaseGIL gil;
+    self->cxx->pushFrame(image);
+  }
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("push", 0)
+}
+
+
+static auto pop_doc = bob::extension::FunctionDoc(
+  "pop",
+  "Returns the result of the oldest pending frame",
+  "This function blocks until the oldest frame is transformed. "
+  "Errors that occurred while transforming the frame are raised here.",
+  true
+)
+.add_prototype("", "result")
+.add_return("result", "array_like (complex, 3D) or [:py:class:`bob.ip.gabor.Jet`]", "The trafo image of the frame, or the Gabor jets at the nodes of the graph, if the stream was created with a graph")
+;
+
+static PyObject* PyBobIpGaborTransformStream_pop(PyBobIpGaborTransformStreamObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = pop_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  if (self->cxx->extractsJets()){
+    std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+    {
+      ReleaseGIL gil;
+      self->cxx->pop(jets);
+    }
+    PyObject* list = PyList_New(jets.size());
+    for (Py_ssize_t i = 0; i < (Py_ssize_t)jets.size(); ++i){
+      PyBobIpGaborJetObject* jet = reinterpret_cast<PyBobIpGaborJetObject*>(PyBobIpGaborJet_Type.tp_alloc(&PyBobIpGaborJet_Type, 0));
+      jet->cxx = jets[i];
+      PyList_SET_ITEM(list, i, Py_BuildValue("N", jet));
+    }
+    return list;
+  }
+
+  blitz::Array<std::complex<double>,3> trafo_image;
+  {
+    ReleaseGIL gil;
+    self->cxx->pop(trafo_image);
+  }
+  return PyBlitzArrayCxx_AsNumpy(trafo_image);
+BOB_CATCH_MEMBER("pop", 0)
+}
+
+
+static auto close_doc = bob::extension::FunctionDoc(
+  "close",
+  "Signals that no more frames will be pushed",
+  "The pending frames are still transformed and can be popped. "
+  "Afterwards, :py:meth:`push` raises an exception, and so does :py:meth:`pop` when no frame is pending.",
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborTransformStream_close(PyBobIpGaborTransformStreamObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = close_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+  self->cxx->close();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("close", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborTransformStream_methods[] = {
+  {
+    push_doc.name(),
+    (PyCFunction)PyBobIpGaborTransformStream_push,
+    METH_VARARGS|METH_KEYWORDS,
+    push_doc.doc()
+  },
+  {
+    pop_doc.name(),
+    (PyCFunction)PyBobIpGaborTransformStream_pop,
+    METH_VARARGS|METH_KEYWORDS,
+    pop_doc.doc()
+  },
+  {
+    close_doc.name(),
+    (PyCFunction)PyBobIpGaborTransformStream_close,
+    METH_VARARGS|METH_KEYWORDS,
+    close_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the TransformStream type struct; will be initialized later
+PyTypeObject PyBobIpGaborTransformStream_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpGaborTransformStream(PyObject* module)
+{
+
+  // initialize the TransformStream type struct
+  PyBobIpGaborTransformStream_Type.tp_name = TransformStream_doc.name();
+  PyBobIpGaborTransformStream_Type.tp_basicsize = sizeof(PyBobIpGaborTransformStreamObject);
+  PyBobIpGaborTransformStream_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborTransformStream_Type.tp_doc = TransformStream_doc.doc();
+
+  // set the functions
+  PyBobIpGaborTransformStream_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborTransformStream_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborTransformStream_init);
+  PyBobIpGaborTransformStream_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborTransformStream_delete);
+  PyBobIpGaborTransformStream_Type.tp_methods = PyBobIpGaborTransformStream_methods;
+  PyBobIpGaborTransformStream_Type.tp_getset = PyBobIpGaborTransformStream_getseters;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborTransformStream_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborTransformStream_Type);
+  return PyModule_AddObject(module, "TransformStream", (PyObject*)&PyBobIpGaborTransformStream_Type) >= 0;
+}
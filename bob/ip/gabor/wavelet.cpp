@@ -37,18 +37,48 @@ static auto wavelet_doc = bob::extension::ClassDoc(
     true
   )
   .add_prototype("resolution, frequency, [sigma], [power_of_k], [dc_free], [epsilon]", "")
+  .add_prototype("resolution, frequency, sigma, power_of_k, dc_free, epsilon, runs, values", "")
   .add_parameter("resolution", "(int, int)", "The resolution (height, width) of the Gabor wavelet; this must be the same resolution as the image that the Gabor wavelet is applied on later")
   .add_parameter("frequency", "(float, float)", "The location :math:`\\vec k = (ky, kx)` of the Gabor wavelet in frequency domain; the values should be limited between :math:`-\\pi` and :math:`\\pi`")
   .add_parameter("sigma", "float", "[default: :math:`2\\pi`] The spatial resolution :math:`\\sigma` of the Gabor wavelet")
   .add_parameter("power_of_k", "float", "[default: 0] The :math:`\\lambda` factor to regularize the Gabor wavelet prefactor to generate comparable results for images, see Appendix C of [Guenther2011]_")
   .add_parameter("dc_free", "bool", "[default: True] Should the Gabor wavelet be without DC factor (i.e. should the integral under the wavelet in spatial domain vanish)?")
   .add_parameter("epsilon", "float", "[default: 1e-10] For speed reasons: all wavelet pixels in frequency domain with an absolute value below this should be considered as 0")
+  .add_parameter("runs", "array_like (int32, 2D)", "The runs (y, x, length) of consecutive non-zero wavelet pixels, as returned by :py:attr:`runs`")
+  .add_parameter("values", ":py:class:`numpy.ndarray` (float, 1D)", "The values of all non-zero wavelet pixels, as returned by :py:attr:`values`")
 );
 
 
 static int PyBobIpGaborWavelet_init(PyBobIpGaborWaveletObject* self, PyObject* args, PyObject* kwargs) {
 BOB_TRY
-  char** kwlist = wavelet_doc.kwlist();
+  char** kwlist = wavelet_doc.kwlist(0);
+  char** kwlist2 = wavelet_doc.kwlist(1);
+
+  // restore the wavelet from its runs and values, when these are given
+  PyObject* k = Py_BuildValue("s", kwlist2[6]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) == 8)
+  ){
+    blitz::TinyVector<int,2> r;
+    blitz::TinyVector<double,2> f;
+    double sigma, pow_k, eps;
+    PyObject* dc;
+    PyBlitzArrayObject* runs,* values;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "(ii)(dd)ddO!dO&O&", kwlist2, &r[0], &r[1], &f[0], &f[1], &sigma, &pow_k, &PyBool_Type, &dc, &eps, &PyBlitzArray_Converter, &runs, &PyBlitzArray_Converter, &values)) return -1;
+    auto runs_ = make_safe(runs), values_ = make_safe(values);
+    if (runs->type_num != NPY_INT32 || runs->ndim != 2) {
+      PyErr_Format(PyExc_TypeError, "`%s' only supports 32-bit integral 2D arrays for parameter `runs'", Py_TYPE(self)->tp_name);
+      return -1;
+    }
+    if (values->type_num != NPY_FLOAT64 || values->ndim != 1) {
+      PyErr_Format(PyExc_TypeError, "`%s' only supports 64-bit float 1D arrays for parameter `values'", Py_TYPE(self)->tp_name);
+      return -1;
+    }
+    self->cxx.reset(new bob::ip::gabor::Wavelet(r, f, sigma, pow_k, PyObject_IsTrue(dc), eps, *PyBlitzArrayCxx_AsBlitz<int32_t,2>(runs), *PyBlitzArrayCxx_AsBlitz<double,1>(values)));
+    return 0;
+  }
 
   blitz::TinyVector<int,2> r(-1,-1);
   blitz::TinyVector<double,2> k;
@@ -89,6 +119,95 @@ BOB_TRY
 BOB_CATCH_MEMBER("wavelet", 0)
 }
 
+static auto resolution_doc = bob::extension::VariableDoc(
+  "resolution",
+  "(int, int)",
+  "The resolution (height, width) of the image that this Gabor wavelet is applied on"
+);
+PyObject* PyBobIpGaborWavelet_resolution(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("(ii)", self->cxx->m_y_resolution, self->cxx->m_x_resolution);
+BOB_CATCH_MEMBER("resolution", 0)
+}
+
+static auto runs_doc = bob::extension::VariableDoc(
+  "runs",
+  "2D-array int32",
+  "The runs (y, x, length) of consecutive non-zero pixels of the Gabor wavelet in frequency domain",
+  "Together with :py:attr:`values`, this is the sparse representation of the Gabor wavelet, from which the wavelet can be restored without generating it again."
+);
+PyObject* PyBobIpGaborWavelet_runs(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->runs());
+BOB_CATCH_MEMBER("runs", 0)
+}
+
+static auto values_doc = bob::extension::VariableDoc(
+  "values",
+  "1D-array float",
+  "The values of all non-zero pixels of the Gabor wavelet in frequency domain, in the order of the :py:attr:`runs`"
+);
+PyObject* PyBobIpGaborWavelet_values(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->values());
+BOB_CATCH_MEMBER("values", 0)
+}
+
+static auto frequency_doc = bob::extension::VariableDoc(
+  "frequency",
+  "(float, float)",
+  "The location :math:`\\vec k = (ky, kx)` of the Gabor wavelet in frequency domain"
+);
+PyObject* PyBobIpGaborWavelet_frequency(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("(dd)", self->cxx->frequency()[0], self->cxx->frequency()[1]);
+BOB_CATCH_MEMBER("frequency", 0)
+}
+
+static auto sigma_doc = bob::extension::VariableDoc(
+  "sigma",
+  "float",
+  "The spatial resolution :math:`\\sigma` of the Gabor wavelet"
+);
+PyObject* PyBobIpGaborWavelet_sigma(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->sigma());
+BOB_CATCH_MEMBER("sigma", 0)
+}
+
+static auto powOfK_doc = bob::extension::VariableDoc(
+  "power_of_k",
+  "float",
+  "The :math:`\\lambda` factor of the Gabor wavelet prefactor"
+);
+PyObject* PyBobIpGaborWavelet_powOfK(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->powOfK());
+BOB_CATCH_MEMBER("power_of_k", 0)
+}
+
+static auto dcFree_doc = bob::extension::VariableDoc(
+  "dc_free",
+  "bool",
+  "Is the Gabor wavelet DC free?"
+);
+PyObject* PyBobIpGaborWavelet_dcFree(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("O", self->cxx->dcFree() ? Py_True : Py_False);
+BOB_CATCH_MEMBER("dc_free", 0)
+}
+
+static auto epsilon_doc = bob::extension::VariableDoc(
+  "epsilon",
+  "float",
+  "The threshold below which the wavelet values were discarded"
+);
+PyObject* PyBobIpGaborWavelet_epsilon(PyBobIpGaborWaveletObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->epsilon());
+BOB_CATCH_MEMBER("epsilon", 0)
+}
+
 
 static PyGetSetDef PyBobIpGaborWavelet_getseters[] = {
     {
@@ -98,6 +217,62 @@ static PyGetSetDef PyBobIpGaborWavelet_getseters[] = {
       getWavelet_doc.doc(),
       0
     },
+    {
+      resolution_doc.name(),
+      (getter)PyBobIpGaborWavelet_resolution,
+      0,
+      resolution_doc.doc(),
+      0
+    },
+    {
+      runs_doc.name(),
+      (getter)PyBobIpGaborWavelet_runs,
+      0,
+      runs_doc.doc(),
+      0
+    },
+    {
+      values_doc.name(),
+      (getter)PyBobIpGaborWavelet_values,
+      0,
+      values_doc.doc(),
+      0
+    },
+    {
+      frequency_doc.name(),
+      (getter)PyBobIpGaborWavelet_frequency,
+      0,
+      frequency_doc.doc(),
+      0
+    },
+    {
+      sigma_doc.name(),
+      (getter)PyBobIpGaborWavelet_sigma,
+      0,
+      sigma_doc.doc(),
+      0
+    },
+    {
+      powOfK_doc.name(),
+      (getter)PyBobIpGaborWavelet_powOfK,
+      0,
+      powOfK_doc.doc(),
+      0
+    },
+    {
+      dcFree_doc.name(),
+      (getter)PyBobIpGaborWavelet_dcFree,
+      0,
+      dcFree_doc.doc(),
+      0
+    },
+    {
+      epsilon_doc.name(),
+      (getter)PyBobIpGaborWavelet_epsilon,
+      0,
+      epsilon_doc.doc(),
+      0
+    },
     {0}  /* Sentinel */
 };
 
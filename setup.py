@@ -17,6 +17,21 @@ version = open("version.txt").read().rstrip()
 
 packages = ['boost']
 boost_modules = ['system']
+define_macros = []
+
+# use FFTW3 as an additional FFT backend, when it is available
+from bob.extension import pkgconfig
+try:
+  pkgconfig('fftw3')
+  packages.append('fftw3')
+  define_macros.append(('HAVE_FFTW3', '1'))
+except RuntimeError:
+  pass
+
+# compile the per-stage timers and counters into the library, see bob.ip.gabor.stats()
+import os
+if os.environ.get('BOB_IP_GABOR_STATS', '0') not in ('', '0'):
+  define_macros.append(('BOB_IP_GABOR_STATS', '1'))
 
 setup(
 
@@ -52,17 +67,28 @@ setup(
 
       Library("bob.ip.gabor.bob_ip_gabor",
         [
+          "bob/ip/gabor/cpp/FFT.cpp",
+          "bob/ip/gabor/cpp/Simd.cpp",
+          "bob/ip/gabor/cpp/Stats.cpp",
           "bob/ip/gabor/cpp/Wavelet.cpp",
+          "bob/ip/gabor/cpp/SpatialWavelet.cpp",
+          "bob/ip/gabor/cpp/RecursiveWavelet.cpp",
           "bob/ip/gabor/cpp/Transform.cpp",
           "bob/ip/gabor/cpp/Jet.cpp",
           "bob/ip/gabor/cpp/Graph.cpp",
           "bob/ip/gabor/cpp/Similarity.cpp",
           "bob/ip/gabor/cpp/JetStatistics.cpp",
+          "bob/ip/gabor/cpp/TransformStream.cpp",
+          "bob/ip/gabor/cpp/FeatureExtractor.cpp",
+          "bob/ip/gabor/cpp/Index.cpp",
+          "bob/ip/gabor/cpp/PhaseCode.cpp",
+          "bob/ip/gabor/cpp/Benchmark.cpp",
         ],
         version = version,
         bob_packages = bob_packages,
         packages = packages,
         boost_modules = boost_modules,
+        define_macros = define_macros,
       ),
 
       Extension("bob.ip.gabor._library",
@@ -73,6 +99,11 @@ setup(
           "bob/ip/gabor/graph.cpp",
           "bob/ip/gabor/similarity.cpp",
           "bob/ip/gabor/jet_statistics.cpp",
+          "bob/ip/gabor/transform_stream.cpp",
+          "bob/ip/gabor/spectrum.cpp",
+          "bob/ip/gabor/feature_extractor.cpp",
+          "bob/ip/gabor/index.cpp",
+          "bob/ip/gabor/phase_code.cpp",
           "bob/ip/gabor/main.cpp",
         ],
         bob_packages = bob_packages,
@@ -86,6 +117,12 @@ setup(
       'build_ext': build_ext
     },
 
+    entry_points = {
+      'console_scripts': [
+        'bob_ip_gabor_benchmark.py = bob.ip.gabor.script.benchmark:main',
+      ],
+    },
+
     classifiers = [
       'Framework :: Bob',
       'Development Status :: 4 - Beta',